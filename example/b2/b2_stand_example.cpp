@@ -9,6 +9,7 @@
 #include <unitree/common/time/time_tool.hpp>
 #include <unitree/common/thread/thread.hpp>
 #include <unitree/robot/b2/motion_switcher/motion_switcher_client.hpp>
+#include <unitree/common/crc32.hpp>
 
 using namespace unitree::common;
 using namespace unitree::robot;
@@ -86,38 +87,6 @@ private:
     bool done = false;
 };
 
-uint32_t crc32_core(uint32_t* ptr, uint32_t len)
-{
-    unsigned int xbit = 0;
-    unsigned int data = 0;
-    unsigned int CRC32 = 0xFFFFFFFF;
-    const unsigned int dwPolynomial = 0x04c11db7;
-
-    for (unsigned int i = 0; i < len; i++)
-    {
-        xbit = 1 << 31;
-        data = ptr[i];
-        for (unsigned int bits = 0; bits < 32; bits++)
-        {
-            if (CRC32 & 0x80000000)
-            {
-                CRC32 <<= 1;
-                CRC32 ^= dwPolynomial;
-            }
-            else
-            {
-                CRC32 <<= 1;
-            }
-
-            if (data & xbit)
-                CRC32 ^= dwPolynomial;
-            xbit >>= 1;
-        }
-    }
-
-    return CRC32;
-}
-
 void Custom::Init()
 {
     InitLowCmd();
@@ -316,7 +285,7 @@ void Custom::LowCmdWrite()
                 low_cmd.motor_cmd()[j].tau() = 0;
             }
         }
-        low_cmd.crc() = crc32_core((uint32_t *)&low_cmd, (sizeof(unitree_go::msg::dds_::LowCmd_)>>2)-1);
+        low_cmd.crc() = Crc32Word((uint32_t *)&low_cmd, (sizeof(unitree_go::msg::dds_::LowCmd_)>>2)-1);
     
         lowcmd_publisher->Write(low_cmd);
     }
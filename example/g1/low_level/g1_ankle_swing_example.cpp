@@ -1,19 +1,21 @@
 #include <cmath>
 #include <memory>
-#include <mutex>
-#include <shared_mutex>
 
 #include "gamepad.hpp"
 
 // DDS
 #include <unitree/robot/channel/channel_publisher.hpp>
 #include <unitree/robot/channel/channel_subscriber.hpp>
+#include <unitree/common/latest_value.hpp>
+#include <unitree/common/thread/deadline_thread.hpp>
 
 // IDL
 #include <unitree/idl/hg/IMUState_.hpp>
 #include <unitree/idl/hg/LowCmd_.hpp>
 #include <unitree/idl/hg/LowState_.hpp>
 #include <unitree/robot/b2/motion_switcher/motion_switcher_client.hpp>
+#include <unitree/common/crc32.hpp>
+#include <unitree/robot/low_level/robot_model.hpp>
 
 static const std::string HG_CMD_TOPIC = "rt/lowcmd";
 static const std::string HG_IMU_TORSO = "rt/secondary_imu";
@@ -23,30 +25,7 @@ using namespace unitree::common;
 using namespace unitree::robot;
 using namespace unitree_hg::msg::dds_;
 
-template <typename T>
-class DataBuffer {
- public:
-  void SetData(const T &newData) {
-    std::unique_lock<std::shared_mutex> lock(mutex);
-    data = std::make_shared<T>(newData);
-  }
-
-  std::shared_ptr<const T> GetData() {
-    std::shared_lock<std::shared_mutex> lock(mutex);
-    return data ? data : nullptr;
-  }
-
-  void Clear() {
-    std::unique_lock<std::shared_mutex> lock(mutex);
-    data = nullptr;
-  }
-
- private:
-  std::shared_ptr<T> data;
-  std::shared_mutex mutex;
-};
-
-const int G1_NUM_MOTOR = 29;
+const int G1_NUM_MOTOR = G1_29Model::DOF;
 struct ImuState {
   std::array<float, 3> rpy = {};
   std::array<float, 3> omega = {};
@@ -63,24 +42,6 @@ struct MotorState {
   std::array<float, G1_NUM_MOTOR> dq = {};
 };
 
-// Stiffness for all G1 Joints
-std::array<float, G1_NUM_MOTOR> Kp{
-    60, 60, 60, 100, 40, 40,      // legs
-    60, 60, 60, 100, 40, 40,      // legs
-    60, 40, 40,                   // waist
-    40, 40, 40, 40,  40, 40, 40,  // arms
-    40, 40, 40, 40,  40, 40, 40   // arms
-};
-
-// Damping for all G1 Joints
-std::array<float, G1_NUM_MOTOR> Kd{
-    1, 1, 1, 2, 1, 1,     // legs
-    1, 1, 1, 2, 1, 1,     // legs
-    1, 1, 1,              // waist
-    1, 1, 1, 1, 1, 1, 1,  // arms
-    1, 1, 1, 1, 1, 1, 1   // arms
-};
-
 enum class Mode {
   PR = 0,  // Series Control for Ptich/Roll Joints
   AB = 1   // Parallel Control for A/B Joints
@@ -124,28 +85,6 @@ enum G1JointIndex {
   RightWristYaw = 28     // NOTE INVALID for g1 23dof
 };
 
-inline uint32_t Crc32Core(uint32_t *ptr, uint32_t len) {
-  uint32_t xbit = 0;
-  uint32_t data = 0;
-  uint32_t CRC32 = 0xFFFFFFFF;
-  const uint32_t dwPolynomial = 0x04c11db7;
-  for (uint32_t i = 0; i < len; i++) {
-    xbit = 1 << 31;
-    data = ptr[i];
-    for (uint32_t bits = 0; bits < 32; bits++) {
-      if (CRC32 & 0x80000000) {
-        CRC32 <<= 1;
-        CRC32 ^= dwPolynomial;
-      } else
-        CRC32 <<= 1;
-      if (data & xbit) CRC32 ^= dwPolynomial;
-
-      xbit >>= 1;
-    }
-  }
-  return CRC32;
-};
-
 class G1Example {
  private:
   double time_;
@@ -158,14 +97,14 @@ class G1Example {
   Gamepad gamepad_;
   REMOTE_DATA_RX rx_;
 
-  DataBuffer<MotorState> motor_state_buffer_;
-  DataBuffer<MotorCommand> motor_command_buffer_;
-  DataBuffer<ImuState> imu_state_buffer_;
+  LatestValue<MotorState> motor_state_buffer_;
+  LatestValue<MotorCommand> motor_command_buffer_;
+  LatestValue<ImuState> imu_state_buffer_;
 
   ChannelPublisherPtr<LowCmd_> lowcmd_publisher_;
   ChannelSubscriberPtr<LowState_> lowstate_subscriber_;
   ChannelSubscriberPtr<IMUState_> imutorso_subscriber_;
-  ThreadPtr command_writer_ptr_, control_thread_ptr_;
+  DeadlineThreadPtr command_writer_ptr_, control_thread_ptr_;
 
   std::shared_ptr<unitree::robot::b2::MotionSwitcherClient> msc_;
 
@@ -199,8 +138,28 @@ class G1Example {
     imutorso_subscriber_.reset(new ChannelSubscriber<IMUState_>(HG_IMU_TORSO));
     imutorso_subscriber_->InitChannel(std::bind(&G1Example::imuTorsoHandler, this, std::placeholders::_1), 1);
     // create threads
-    command_writer_ptr_ = CreateRecurrentThreadEx("command_writer", UT_CPU_ID_NONE, 2000, &G1Example::LowCommandWriter, this);
-    control_thread_ptr_ = CreateRecurrentThreadEx("control", UT_CPU_ID_NONE, 2000, &G1Example::Control, this);
+    // both loops run on absolute 2ms deadlines, a late period is dropped
+    // instead of sending stale commands back to back
+    DeadlinePolicy policy(UT_DEADLINE_OVERRUN_SKIP);
+    command_writer_ptr_ = CreateDeadlineThreadEx("command_writer", UT_CPU_ID_NONE, 2000, policy,
+                                                 &G1Example::LowCommandWriter, this);
+    control_thread_ptr_ = CreateDeadlineThreadEx("control", UT_CPU_ID_NONE, 2000, policy,
+                                                 &G1Example::Control, this);
+  }
+
+  void PrintTiming() {
+    PrintTiming("command_writer", command_writer_ptr_);
+    PrintTiming("control", control_thread_ptr_);
+  }
+
+  static void PrintTiming(const char *name, const DeadlineThreadPtr &thread) {
+    DeadlineStatistics stat;
+    thread->GetStatistics(stat);
+    thread->ResetStatistics();
+    printf("%s: periods %lu missed %lu skipped %lu, jitter p99 %lu us max %lu us\n", name,
+           (unsigned long)stat.mPeriods, (unsigned long)stat.mMissed, (unsigned long)stat.mSkipped,
+           (unsigned long)(stat.mJitter.GetPercentile(0.99) / 1000),
+           (unsigned long)(stat.mJitter.mMax / 1000));
   }
 
   void imuTorsoHandler(const void *message) {
@@ -212,7 +171,7 @@ class G1Example {
 
   void LowStateHandler(const void *message) {
     LowState_ low_state = *(const LowState_ *)message;
-    if (low_state.crc() != Crc32Core((uint32_t *)&low_state, (sizeof(LowState_) >> 2) - 1)) {
+    if (low_state.crc() != Crc32Word((uint32_t *)&low_state, (sizeof(LowState_) >> 2) - 1)) {
       std::cout << "[ERROR] CRC Error" << std::endl;
       return;
     }
@@ -225,13 +184,13 @@ class G1Example {
       if (low_state.motor_state()[i].motorstate() && i <= RightAnkleRoll)
         std::cout << "[ERROR] motor " << i << " with code " << low_state.motor_state()[i].motorstate() << "\n";
     }
-    motor_state_buffer_.SetData(ms_tmp);
+    motor_state_buffer_.Set(ms_tmp);
 
     // get imu state
     ImuState imu_tmp;
     imu_tmp.omega = low_state.imu_state().gyroscope();
     imu_tmp.rpy = low_state.imu_state().rpy();
-    imu_state_buffer_.SetData(imu_tmp);
+    imu_state_buffer_.Set(imu_tmp);
 
     // update gamepad
     memcpy(rx_.buff, &low_state.wireless_remote()[0], 40);
@@ -286,7 +245,7 @@ class G1Example {
     dds_low_command.mode_pr() = static_cast<uint8_t>(mode_pr_);
     dds_low_command.mode_machine() = mode_machine_;
 
-    const std::shared_ptr<const MotorCommand> mc = motor_command_buffer_.GetData();
+    const MotorCommand *mc = motor_command_buffer_.Read();
     if (mc) {
       for (size_t i = 0; i < G1_NUM_MOTOR; i++) {
         dds_low_command.motor_cmd().at(i).mode() = 1;  // 1:Enable, 0:Disable
@@ -297,21 +256,21 @@ class G1Example {
         dds_low_command.motor_cmd().at(i).kd() = mc->kd.at(i);
       }
 
-      dds_low_command.crc() = Crc32Core((uint32_t *)&dds_low_command, (sizeof(dds_low_command) >> 2) - 1);
+      dds_low_command.crc() = Crc32Word((uint32_t *)&dds_low_command, (sizeof(dds_low_command) >> 2) - 1);
       lowcmd_publisher_->Write(dds_low_command);
     }
   }
 
   void Control() {
     MotorCommand motor_command_tmp;
-    const std::shared_ptr<const MotorState> ms = motor_state_buffer_.GetData();
+    const MotorState *ms = motor_state_buffer_.Read();
 
     for (int i = 0; i < G1_NUM_MOTOR; ++i) {
       motor_command_tmp.tau_ff.at(i) = 0.0;
       motor_command_tmp.q_target.at(i) = 0.0;
       motor_command_tmp.dq_target.at(i) = 0.0;
-      motor_command_tmp.kp.at(i) = Kp[i];
-      motor_command_tmp.kd.at(i) = Kd[i];
+      motor_command_tmp.kp.at(i) = G1_29Model::KP[i];
+      motor_command_tmp.kd.at(i) = G1_29Model::KD[i];
     }
 
     if (ms) {
@@ -354,7 +313,7 @@ class G1Example {
         motor_command_tmp.q_target.at(RightAnkleB) = R_B_des;
       }
 
-      motor_command_buffer_.SetData(motor_command_tmp);
+      motor_command_buffer_.Set(motor_command_tmp);
     }
   }
 };
@@ -366,6 +325,9 @@ int main(int argc, char const *argv[]) {
   }
   std::string networkInterface = argv[1];
   G1Example custom(networkInterface);
-  while (true) sleep(10);
+  while (true) {
+    sleep(10);
+    custom.PrintTiming();
+  }
   return 0;
 }
@@ -1,19 +1,22 @@
-#include <yaml-cpp/yaml.h>
-
 #include <cmath>
 #include <memory>
-#include <mutex>
-#include <shared_mutex>
+#include <vector>
 
 // DDS
 #include <unitree/robot/channel/channel_publisher.hpp>
 #include <unitree/robot/channel/channel_subscriber.hpp>
+#include <unitree/common/latest_value.hpp>
 
 // IDL
 #include <unitree/idl/hg/LowCmd_.hpp>
 #include <unitree/idl/hg/LowState_.hpp>
 
 #include <unitree/robot/b2/motion_switcher/motion_switcher_client.hpp>
+#include <unitree/robot/low_level/low_cmd_builder.hpp>
+#include <unitree/robot/low_level/motion_sequence.hpp>
+#include <unitree/robot/low_level/robot_model.hpp>
+#include <unitree/robot/low_level/state_view.hpp>
+#include <unitree/robot/low_level/trajectory.hpp>
 using namespace unitree::robot::b2;
 
 static const std::string HG_CMD_TOPIC = "rt/lowcmd";
@@ -22,30 +25,7 @@ static const std::string HG_STATE_TOPIC = "rt/lowstate";
 using namespace unitree::common;
 using namespace unitree::robot;
 
-const int G1_NUM_MOTOR = 29;
-
-template <typename T>
-class DataBuffer {
- public:
-  void SetData(const T &newData) {
-    std::unique_lock<std::shared_mutex> lock(mutex);
-    data = std::make_shared<T>(newData);
-  }
-
-  std::shared_ptr<const T> GetData() {
-    std::shared_lock<std::shared_mutex> lock(mutex);
-    return data ? data : nullptr;
-  }
-
-  void Clear() {
-    std::unique_lock<std::shared_mutex> lock(mutex);
-    data = nullptr;
-  }
-
- private:
-  std::shared_ptr<T> data;
-  std::shared_mutex mutex;
-};
+const int G1_NUM_MOTOR = G1_29Model::DOF;
 
 struct ImuState {
   std::array<float, 3> rpy = {};
@@ -65,21 +45,6 @@ struct MotorState {
   std::array<float, G1_NUM_MOTOR> dq = {};
 };
 
-enum MotorType { GearboxS = 0, GearboxM = 1, GearboxL = 2 };
-
-std::array<MotorType, G1_NUM_MOTOR> G1MotorType{
-    // clang-format off
-    // legs
-    GearboxM, GearboxM, GearboxM, GearboxL, GearboxS, GearboxS,
-    GearboxM, GearboxM, GearboxM, GearboxL, GearboxS, GearboxS,
-    // waist
-    GearboxM, GearboxS, GearboxS,
-    // arms
-    GearboxS, GearboxS, GearboxS, GearboxS, GearboxS, GearboxS, GearboxS,
-    GearboxS, GearboxS, GearboxS, GearboxS, GearboxS, GearboxS, GearboxS
-    // clang-format on
-};
-
 enum PRorAB { PR = 0, AB = 1 };
 
 enum G1JointValidIndex {
@@ -99,48 +64,26 @@ enum G1JointValidIndex {
   RightWristYaw = 28
 };
 
-inline uint32_t Crc32Core(uint32_t *ptr, uint32_t len) {
-  uint32_t xbit = 0;
-  uint32_t data = 0;
-  uint32_t CRC32 = 0xFFFFFFFF;
-  const uint32_t dwPolynomial = 0x04c11db7;
-  for (uint32_t i = 0; i < len; i++) {
-    xbit = 1 << 31;
-    data = ptr[i];
-    for (uint32_t bits = 0; bits < 32; bits++) {
-      if (CRC32 & 0x80000000) {
-        CRC32 <<= 1;
-        CRC32 ^= dwPolynomial;
-      } else
-        CRC32 <<= 1;
-      if (data & xbit) CRC32 ^= dwPolynomial;
-
-      xbit >>= 1;
-    }
-  }
-  return CRC32;
-};
-
-float GetMotorKp(MotorType type) {
-  switch (type) {
-    case GearboxS:
+float GetMotorKp(uint8_t gearbox) {
+  switch (gearbox) {
+    case UT_GEARBOX_S:
       return 40;
-    case GearboxM:
+    case UT_GEARBOX_M:
       return 40;
-    case GearboxL:
+    case UT_GEARBOX_L:
       return 100;
     default:
       return 0;
   }
 }
 
-float GetMotorKd(MotorType type) {
-  switch (type) {
-    case GearboxS:
+float GetMotorKd(uint8_t gearbox) {
+  switch (gearbox) {
+    case UT_GEARBOX_S:
       return 1;
-    case GearboxM:
+    case UT_GEARBOX_M:
       return 1;
-    case GearboxL:
+    case UT_GEARBOX_L:
       return 1;
     default:
       return 0;
@@ -154,13 +97,20 @@ class G1Example {
   double duration_;    // [3 s]
   PRorAB mode_;
   uint8_t mode_machine_;
-  std::vector<std::vector<double>> frames_data_;
+  MotionSeqFilePtr motion_;
+  int32_t joint_component_;
+  const uint32_t *joint_slots_;
+  uint32_t joint_num_;
+  std::shared_ptr<JointTrajectory> joint_trajectory_;
+  std::vector<float> joint_buffer_;
 
-  DataBuffer<MotorState> motor_state_buffer_;
-  DataBuffer<MotorCommand> motor_command_buffer_;
-  DataBuffer<ImuState> imu_state_buffer_;
+  LatestValue<MotorState> motor_state_buffer_;
+  LatestValue<MotorCommand> motor_command_buffer_;
+  LatestValue<ImuState> imu_state_buffer_;
 
   ChannelPublisherPtr<unitree_hg::msg::dds_::LowCmd_> lowcmd_publisher_;
+  HgLowCmdBuilder low_command_builder_;
+  HgStateView<G1_NUM_MOTOR, UT_STATE_FIELD_Q | UT_STATE_FIELD_DQ> motor_state_view_;
   ChannelSubscriberPtr<unitree_hg::msg::dds_::LowState_> lowstate_subscriber_;
   ThreadPtr command_writer_ptr_, control_thread_ptr_;
 
@@ -172,7 +122,10 @@ class G1Example {
         control_dt_(0.002),
         duration_(3.0),
         mode_(PR),
-        mode_machine_(0) {
+        mode_machine_(0),
+        joint_component_(-1),
+        joint_slots_(nullptr),
+        joint_num_(0) {
     ChannelFactory::Instance()->Init(0, networkInterface);
 
     msc.reset(new MotionSwitcherClient());
@@ -214,32 +167,41 @@ class G1Example {
         "control", UT_CPU_ID_NONE, 2000, &G1Example::Control, this);
   }
 
+  // behavior_lib/<name>.useq is compiled from <name>.seq by
+  // g1_motion_seq_convert at build time and mapped, not parsed
   void loadBehaviorLibrary(std::string behavior_name) {
     std::string resource_dir = BLIB_DIR;
-    YAML::Node motion = YAML::LoadFile(resource_dir + behavior_name + ".seq");
-
-    std::string content = motion["components"][1]["content"].as<std::string>();
-    int num_parts = motion["components"][1]["num_parts"].as<int>();
-    std::cout << "BehaviorName: " << behavior_name + ".seq\n";
-    std::cout << content << " with " << num_parts << "\n";
-
-    auto frames = motion["components"][1]["frames"];
+    motion_.reset(new MotionSeqFile(resource_dir + behavior_name + ".useq"));
+
+    joint_component_ = motion_->FindComponent("JointDisplacement");
+    joint_slots_ =
+        joint_component_ < 0 ? nullptr : motion_->GetSlots(joint_component_);
+    if (joint_slots_ == nullptr) {
+      std::cout << behavior_name << ".useq has no joint component" << std::endl;
+      exit(-1);
+    }
 
-    for (const auto &frame : frames) {
-      std::vector<double> frame_data;
-      for (const auto &element : frame) {
-        frame_data.push_back(element.as<double>());
+    joint_num_ = motion_->GetComponent(joint_component_).mWidth;
+    for (uint32_t k = 0; k < joint_num_; ++k) {
+      if (joint_slots_[k] >= G1_NUM_MOTOR) {
+        std::cout << behavior_name << ".useq maps a joint to slot "
+                  << joint_slots_[k] << std::endl;
+        exit(-1);
       }
-      frames_data_.push_back(frame_data);
     }
 
-    std::cout << frames_data_.size() << " knots with " << frames_data_[0].size()
+    // sampled at the control time, not at the knots, so playback does not
+    // depend on the control period matching the frame rate
+    joint_trajectory_.reset(new JointTrajectory(*motion_, joint_component_));
+    joint_buffer_.resize(joint_num_);
+
+    std::cout << "BehaviorName: " << behavior_name + ".useq\n";
+    std::cout << motion_->GetFrameNum() << " knots with " << joint_num_
               << " DOF\n";
   }
 
   void ReportRPY() {
-    const std::shared_ptr<const ImuState> imu_tmp_ptr =
-        imu_state_buffer_.GetData();
+    const ImuState *imu_tmp_ptr = imu_state_buffer_.Read();
     if (imu_tmp_ptr) {
       std::cout << "rpy: [" << imu_tmp_ptr->rpy.at(0) << ", "
                 << imu_tmp_ptr->rpy.at(1) << ", " << imu_tmp_ptr->rpy.at(2)
@@ -252,7 +214,7 @@ class G1Example {
         *(const unitree_hg::msg::dds_::LowState_ *)message;
 
     if (low_state.crc() !=
-        Crc32Core((uint32_t *)&low_state,
+        Crc32Word((uint32_t *)&low_state,
                   (sizeof(unitree_hg::msg::dds_::LowState_) >> 2) - 1)) {
       std::cout << "low_state CRC Error" << std::endl;
       return;
@@ -260,17 +222,16 @@ class G1Example {
 
     // get motor state
     MotorState ms_tmp;
-    for (int i = 0; i < G1_NUM_MOTOR; ++i) {
-      ms_tmp.q.at(i) = low_state.motor_state()[i].q();
-      ms_tmp.dq.at(i) = low_state.motor_state()[i].dq();
-    }
-    motor_state_buffer_.SetData(ms_tmp);
+    motor_state_view_.Extract(low_state.motor_state());
+    std::copy_n(motor_state_view_.Q(), G1_NUM_MOTOR, ms_tmp.q.begin());
+    std::copy_n(motor_state_view_.Dq(), G1_NUM_MOTOR, ms_tmp.dq.begin());
+    motor_state_buffer_.Set(ms_tmp);
 
     // get imu state
     ImuState imu_tmp;
     imu_tmp.omega = low_state.imu_state().gyroscope();
     imu_tmp.rpy = low_state.imu_state().rpy();
-    imu_state_buffer_.SetData(imu_tmp);
+    imu_state_buffer_.Set(imu_tmp);
 
     // update mode machine
     if (mode_machine_ != low_state.mode_machine()) {
@@ -282,72 +243,75 @@ class G1Example {
   }
 
   void LowCommandWriter() {
-    unitree_hg::msg::dds_::LowCmd_ dds_low_command;
-    dds_low_command.mode_pr() = mode_;
-    dds_low_command.mode_machine() = mode_machine_;
+    const unitree_hg::msg::dds_::LowCmd_ &current = low_command_builder_.Get();
+    if (current.mode_pr() != mode_ || current.mode_machine() != mode_machine_) {
+      low_command_builder_.Mutable().mode_pr() = mode_;
+      low_command_builder_.Mutable().mode_machine() = mode_machine_;
+    }
 
-    const std::shared_ptr<const MotorCommand> mc =
-        motor_command_buffer_.GetData();
+    const MotorCommand *mc = motor_command_buffer_.Read();
     if (mc) {
+      // unchanged joints stay clean, see LowCmdBuilder::Build
       for (size_t i = 0; i < G1_NUM_MOTOR; i++) {
-        dds_low_command.motor_cmd().at(i).mode() = 1;  // 1:Enable, 0:Disable
-        dds_low_command.motor_cmd().at(i).tau() = mc->tau_ff.at(i);
-        dds_low_command.motor_cmd().at(i).q() = mc->q_target.at(i);
-        dds_low_command.motor_cmd().at(i).dq() = mc->dq_target.at(i);
-        dds_low_command.motor_cmd().at(i).kp() = mc->kp.at(i);
-        dds_low_command.motor_cmd().at(i).kd() = mc->kd.at(i);
+        unitree_hg::msg::dds_::MotorCmd_ motor_cmd = current.motor_cmd().at(i);
+        motor_cmd.mode() = 1;  // 1:Enable, 0:Disable
+        motor_cmd.tau() = mc->tau_ff.at(i);
+        motor_cmd.q() = mc->q_target.at(i);
+        motor_cmd.dq() = mc->dq_target.at(i);
+        motor_cmd.kp() = mc->kp.at(i);
+        motor_cmd.kd() = mc->kd.at(i);
+        low_command_builder_.SetMotor(i, motor_cmd);
       }
 
-      dds_low_command.crc() = Crc32Core((uint32_t *)&dds_low_command,
-                                        (sizeof(dds_low_command) >> 2) - 1);
-      lowcmd_publisher_->Write(dds_low_command);
+      lowcmd_publisher_->Write(low_command_builder_.Build());
     }
   }
 
   void Control() {
     MotorCommand motor_command_tmp;
-    const std::shared_ptr<const MotorState> ms = motor_state_buffer_.GetData();
+    const MotorState *ms = motor_state_buffer_.Read();
 
     if (ms) {
       time_ += control_dt_;
       if (time_ < duration_) {
         // [Stage 1]: set robot to zero posture
-        for (int i = 0; i < G1_NUM_MOTOR; ++i) {
-          double ratio = std::clamp(time_ / duration_, 0.0, 1.0);
+        const std::array<float, G1_NUM_MOTOR> zero_posture = {};
+        JointLerp(motor_command_tmp.q_target, ms->q, zero_posture,
+                  time_ / duration_);
 
-          double q_des = 0;
+        for (int i = 0; i < G1_NUM_MOTOR; ++i) {
           motor_command_tmp.tau_ff.at(i) = 0.0;
-          motor_command_tmp.q_target.at(i) =
-              (q_des - ms->q.at(i)) * ratio + ms->q.at(i);
           motor_command_tmp.dq_target.at(i) = 0.0;
-          motor_command_tmp.kp.at(i) = GetMotorKp(G1MotorType[i]);
-          motor_command_tmp.kd.at(i) = GetMotorKd(G1MotorType[i]);
+          motor_command_tmp.kp.at(i) = GetMotorKp(G1_29Model::GEARBOX[i]);
+          motor_command_tmp.kd.at(i) = GetMotorKd(G1_29Model::GEARBOX[i]);
         }
       } else {
         // [Stage 2]: tracking the offline trajectory
-        size_t frame_index = (size_t)((time_ - duration_) / control_dt_);
-        if (frame_index >= frames_data_.size()) {
-          frame_index = frames_data_.size() - 1;
+        double play_time = time_ - duration_;
+        if (play_time >= joint_trajectory_->GetDuration()) {
+          play_time = joint_trajectory_->GetDuration();
           time_ = 0.0;  // RESET
         }
 
+        size_t frame_index = (size_t)(play_time * motion_->GetFrameRate());
         if (frame_index % 100 == 0)
           std::cout << "Frame Index: " << frame_index << std::endl;
 
         for (int i = 0; i < G1_NUM_MOTOR; ++i) {
-          size_t index_in_frame = i - LeftShoulderPitch;
-          motor_command_tmp.q_target.at(i) =
-              (i >= LeftShoulderPitch)
-                  ? frames_data_[frame_index][index_in_frame]
-                  : 0.0;
+          motor_command_tmp.q_target.at(i) = 0.0;
           motor_command_tmp.dq_target.at(i) = 0.0;
           motor_command_tmp.tau_ff.at(i) = 0.0;
-          motor_command_tmp.kp.at(i) = GetMotorKp(G1MotorType[i]);
-          motor_command_tmp.kd.at(i) = GetMotorKd(G1MotorType[i]);
+          motor_command_tmp.kp.at(i) = GetMotorKp(G1_29Model::GEARBOX[i]);
+          motor_command_tmp.kd.at(i) = GetMotorKd(G1_29Model::GEARBOX[i]);
+        }
+
+        joint_trajectory_->Evaluate(play_time, joint_buffer_.data());
+        for (uint32_t k = 0; k < joint_num_; ++k) {
+          motor_command_tmp.q_target.at(joint_slots_[k]) = joint_buffer_[k];
         }
       }
 
-      motor_command_buffer_.SetData(motor_command_tmp);
+      motor_command_buffer_.Set(motor_command_tmp);
     }
   }
 
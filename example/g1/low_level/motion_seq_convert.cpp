@@ -0,0 +1,105 @@
+#include <yaml-cpp/yaml.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <unitree/robot/low_level/motion_sequence.hpp>
+
+using namespace unitree::robot;
+
+// strtod also takes the "-nan" written by some exporters, which the yaml
+// scalar conversion rejects
+float ParseValue(const YAML::Node &node) {
+  const std::string &scalar = node.Scalar();
+  char *end = nullptr;
+  double value = std::strtod(scalar.c_str(), &end);
+  if (scalar.empty() || *end != '\0') {
+    throw YAML::TypedBadConversion<double>(node.Mark());
+  }
+  return (float)value;
+}
+
+// flatten one frame, e.g. [ [ x, y, z, qw, qx, qy, qz ] ] of a MultiSE3Seq
+void FlattenFrame(const YAML::Node &node, std::vector<float> &out) {
+  if (node.IsSequence()) {
+    for (const auto &element : node) FlattenFrame(element, out);
+  } else {
+    out.push_back(ParseValue(node));
+  }
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 3) {
+    std::cout << "Usage: " << argv[0]
+              << " input.seq output.useq [first_joint_slot]\n"
+              << "  joint columns of MultiValueSeq components are mapped to "
+                 "consecutive motor slots from first_joint_slot (default 0)"
+              << std::endl;
+    return 1;
+  }
+
+  uint32_t first_slot = argc > 3 ? (uint32_t)std::atoi(argv[3]) : 0;
+
+  try {
+    YAML::Node seq = YAML::LoadFile(argv[1]);
+    const YAML::Node &components = seq["components"];
+
+    MotionSeqWriter writer(seq["frame_rate"].as<float>(),
+                           seq["num_frames"].as<uint32_t>());
+    uint32_t num_frames = seq["num_frames"].as<uint32_t>();
+
+    for (const auto &component : components) {
+      std::string type = component["type"].as<std::string>();
+      std::string content = component["content"].as<std::string>();
+      const YAML::Node &frames = component["frames"];
+
+      if (component["frame_rate"] &&
+          component["frame_rate"].as<float>() != seq["frame_rate"].as<float>()) {
+        std::cerr << content << ": frame rate differs from the sequence"
+                  << std::endl;
+        return 1;
+      }
+      if (frames.size() != num_frames) {
+        std::cerr << content << ": " << frames.size() << " frames, expected "
+                  << num_frames << std::endl;
+        return 1;
+      }
+
+      std::vector<float> frame;
+      FlattenFrame(frames[0], frame);
+      uint32_t width = (uint32_t)frame.size();
+      uint32_t num_parts =
+          component["num_parts"] ? component["num_parts"].as<uint32_t>() : 1;
+
+      std::vector<uint32_t> slots;
+      if (type == "MultiValueSeq") {
+        for (uint32_t i = 0; i < width; ++i) slots.push_back(first_slot + i);
+      }
+
+      uint32_t index =
+          writer.AddComponent(type, content, width, num_parts, slots);
+
+      for (uint32_t i = 0; i < num_frames; ++i) {
+        frame.clear();
+        FlattenFrame(frames[i], frame);
+        if (frame.size() != width) {
+          std::cerr << content << ": frame " << i << " has " << frame.size()
+                    << " values, expected " << width << std::endl;
+          return 1;
+        }
+        std::copy(frame.begin(), frame.end(), writer.Get(index, i));
+      }
+
+      std::cout << type << " " << content << ": " << width << " values x "
+                << num_frames << " frames" << std::endl;
+    }
+
+    writer.Save(argv[2]);
+  } catch (const std::exception &e) {
+    std::cerr << "convert failed: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
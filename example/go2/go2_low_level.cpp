@@ -8,6 +8,8 @@
 #include <unitree/idl/go2/LowCmd_.hpp>
 #include <unitree/common/time/time_tool.hpp>
 #include <unitree/common/thread/thread.hpp>
+#include <unitree/common/crc32.hpp>
+#include <unitree/robot/low_level/joint_math.hpp>
 
 using namespace unitree::common;
 using namespace unitree::robot;
@@ -58,38 +60,6 @@ private:
     ThreadPtr lowCmdWriteThreadPtr;
 };
 
-uint32_t crc32_core(uint32_t* ptr, uint32_t len)
-{
-    unsigned int xbit = 0;
-    unsigned int data = 0;
-    unsigned int CRC32 = 0xFFFFFFFF;
-    const unsigned int dwPolynomial = 0x04c11db7;
-
-    for (unsigned int i = 0; i < len; i++)
-    {
-        xbit = 1 << 31;
-        data = ptr[i];
-        for (unsigned int bits = 0; bits < 32; bits++)
-        {
-            if (CRC32 & 0x80000000)
-            {
-                CRC32 <<= 1;
-                CRC32 ^= dwPolynomial;
-            }
-            else
-            {
-                CRC32 <<= 1;
-            }
-
-            if (data & xbit)
-                CRC32 ^= dwPolynomial;
-            xbit >>= 1;
-        }
-    }
-
-    return CRC32;
-}
-
 void Custom::Init()
 {
     InitLowCmd();
@@ -129,14 +99,6 @@ void Custom::LowStateMessageHandler(const void* message)
     low_state = *(unitree_go::msg::dds_::LowState_*)message;
 }
 
-double jointLinearInterpolation(double initPos, double targetPos, double rate)
-{
-    double p;
-    rate = std::min(std::max(rate, 0.0), 1.0);
-    p = initPos * (1 - rate) + targetPos * rate;
-    return p;
-}
-
 void Custom::LowCmdWrite()
 {
     motiontime++;
@@ -159,9 +121,7 @@ void Custom::LowCmdWrite()
             Kp[0] = 5.0; Kp[1] = 5.0; Kp[2] = 5.0;
             Kd[0] = 1.0; Kd[1] = 1.0; Kd[2] = 1.0;
 
-            qDes[0] = jointLinearInterpolation(qInit[0], sin_mid_q[0], rate);
-            qDes[1] = jointLinearInterpolation(qInit[1], sin_mid_q[1], rate);
-            qDes[2] = jointLinearInterpolation(qInit[2], sin_mid_q[2], rate);
+            JointLerp(qDes, qInit, sin_mid_q, rate, 3);
         }
 
         double sin_joint1, sin_joint2;
@@ -188,7 +148,7 @@ void Custom::LowCmdWrite()
         low_cmd.motor_cmd()[2].tau() = 0;
     }
 
-    low_cmd.crc() = crc32_core((uint32_t *)&low_cmd, (sizeof(unitree_go::msg::dds_::LowCmd_)>>2)-1);
+    low_cmd.crc() = Crc32Word((uint32_t *)&low_cmd, (sizeof(unitree_go::msg::dds_::LowCmd_)>>2)-1);
     
     lowcmd_publisher->Write(low_cmd);
 }
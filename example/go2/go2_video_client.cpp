@@ -25,7 +25,7 @@ int main()
 
     while (true)
     {
-        ret = video_client.GetImageSample(image_sample);
+        ret = video_client.TakeImageSample(image_sample);
 
         if (ret == 0) {
             time_t rawtime;
@@ -1,16 +1,17 @@
 #include <algorithm>
 #include <cmath>
 #include <memory>
-#include <mutex>
-#include <shared_mutex>
 
 // DDS
 #include <unitree/robot/channel/channel_publisher.hpp>
 #include <unitree/robot/channel/channel_subscriber.hpp>
+#include <unitree/common/latest_value.hpp>
 
 // IDL
 #include <unitree/idl/hg/LowCmd_.hpp>
 #include <unitree/idl/hg/LowState_.hpp>
+#include <unitree/common/crc32.hpp>
+#include <unitree/robot/low_level/robot_model.hpp>
 
 static const std::string HG_CMD_TOPIC = "rt/lowcmd";
 static const std::string HG_STATE_TOPIC = "rt/lowstate";
@@ -18,30 +19,7 @@ static const std::string HG_STATE_TOPIC = "rt/lowstate";
 using namespace unitree::common;
 using namespace unitree::robot;
 
-const int H1_NUM_MOTOR = 27;
-
-template <typename T>
-class DataBuffer {
- public:
-  void SetData(const T &newData) {
-    std::unique_lock<std::shared_mutex> lock(mutex);
-    data = std::make_shared<T>(newData);
-  }
-
-  std::shared_ptr<const T> GetData() {
-    std::shared_lock<std::shared_mutex> lock(mutex);
-    return data ? data : nullptr;
-  }
-
-  void Clear() {
-    std::unique_lock<std::shared_mutex> lock(mutex);
-    data = nullptr;
-  }
-
- private:
-  std::shared_ptr<T> data;
-  std::shared_mutex mutex;
-};
+const int H1_NUM_MOTOR = H1_2Model::DOF;
 
 struct ImuState {
   std::array<float, 3> rpy = {};
@@ -61,21 +39,6 @@ struct MotorState {
   std::array<float, H1_NUM_MOTOR> dq = {};
 };
 
-enum MotorType { GearboxS = 0, GearboxM = 1, GearboxL = 2 };
-
-std::array<MotorType, H1_NUM_MOTOR> H1MotorType{
-    // clang-format off
-    // legs
-    GearboxM, GearboxM, GearboxM, GearboxL, GearboxS, GearboxS,
-    GearboxM, GearboxM, GearboxM, GearboxL, GearboxS, GearboxS,
-    // waist
-    GearboxM,
-    // arms
-    GearboxS, GearboxS, GearboxS, GearboxS, GearboxS, GearboxS, GearboxS,
-    GearboxS, GearboxS, GearboxS, GearboxS, GearboxS, GearboxS, GearboxS
-    // clang-format on
-};
-
 enum PRorAB { PR = 0, AB = 1 };
 
 enum H1JointIndex {
@@ -115,54 +78,6 @@ enum H1JointIndex {
   RightWristYaw = 26
 };
 
-inline uint32_t Crc32Core(uint32_t *ptr, uint32_t len) {
-  uint32_t xbit = 0;
-  uint32_t data = 0;
-  uint32_t CRC32 = 0xFFFFFFFF;
-  const uint32_t dwPolynomial = 0x04c11db7;
-  for (uint32_t i = 0; i < len; i++) {
-    xbit = 1 << 31;
-    data = ptr[i];
-    for (uint32_t bits = 0; bits < 32; bits++) {
-      if (CRC32 & 0x80000000) {
-        CRC32 <<= 1;
-        CRC32 ^= dwPolynomial;
-      } else
-        CRC32 <<= 1;
-      if (data & xbit) CRC32 ^= dwPolynomial;
-
-      xbit >>= 1;
-    }
-  }
-  return CRC32;
-};
-
-float GetMotorKp(MotorType type) {
-  switch (type) {
-    case GearboxS:
-      return 80;
-    case GearboxM:
-      return 100;
-    case GearboxL:
-      return 200;
-    default:
-      return 0;
-  }
-}
-
-float GetMotorKd(MotorType type) {
-  switch (type) {
-    case GearboxS:
-      return 2;
-    case GearboxM:
-      return 3;
-    case GearboxL:
-      return 5;
-    default:
-      return 0;
-  }
-}
-
 class H1Example {
  private:
   double time_;
@@ -171,9 +86,9 @@ class H1Example {
   PRorAB mode_;
   uint8_t mode_machine_;
 
-  DataBuffer<MotorState> motor_state_buffer_;
-  DataBuffer<MotorCommand> motor_command_buffer_;
-  DataBuffer<ImuState> imu_state_buffer_;
+  LatestValue<MotorState> motor_state_buffer_;
+  LatestValue<MotorCommand> motor_command_buffer_;
+  LatestValue<ImuState> imu_state_buffer_;
 
   ChannelPublisherPtr<unitree_hg::msg::dds_::LowCmd_> lowcmd_publisher_;
   ChannelSubscriberPtr<unitree_hg::msg::dds_::LowState_> lowstate_subscriber_;
@@ -209,8 +124,7 @@ class H1Example {
   }
 
   void ReportRPY() {
-    const std::shared_ptr<const ImuState> imu_tmp_ptr =
-        imu_state_buffer_.GetData();
+    const ImuState *imu_tmp_ptr = imu_state_buffer_.Read();
     if (imu_tmp_ptr) {
       std::cout << "rpy: [" << imu_tmp_ptr->rpy.at(0) << ", "
                 << imu_tmp_ptr->rpy.at(1) << ", " << imu_tmp_ptr->rpy.at(2)
@@ -223,7 +137,7 @@ class H1Example {
         *(const unitree_hg::msg::dds_::LowState_ *)message;
 
     if (low_state.crc() !=
-        Crc32Core((uint32_t *)&low_state,
+        Crc32Word((uint32_t *)&low_state,
                   (sizeof(unitree_hg::msg::dds_::LowState_) >> 2) - 1)) {
       std::cout << "low_state CRC Error" << std::endl;
       return;
@@ -239,13 +153,13 @@ class H1Example {
         std::cout << "[ERROR] motor " << i << " with code "
                   << low_state.motor_state()[i].motorstate() << "\n";
     }
-    motor_state_buffer_.SetData(ms_tmp);
+    motor_state_buffer_.Set(ms_tmp);
 
     // get imu state
     ImuState imu_tmp;
     imu_tmp.omega = low_state.imu_state().gyroscope();
     imu_tmp.rpy = low_state.imu_state().rpy();
-    imu_state_buffer_.SetData(imu_tmp);
+    imu_state_buffer_.Set(imu_tmp);
 
     // update mode machine
     if (mode_machine_ != low_state.mode_machine()) {
@@ -261,8 +175,7 @@ class H1Example {
     dds_low_command.mode_pr() = mode_;
     dds_low_command.mode_machine() = mode_machine_;
 
-    const std::shared_ptr<const MotorCommand> mc =
-        motor_command_buffer_.GetData();
+    const MotorCommand *mc = motor_command_buffer_.Read();
     if (mc) {
       for (size_t i = 0; i < H1_NUM_MOTOR; i++) {
         dds_low_command.motor_cmd().at(i).mode() = 1;  // 1:Enable, 0:Disable
@@ -273,7 +186,7 @@ class H1Example {
         dds_low_command.motor_cmd().at(i).kd() = mc->kd.at(i);
       }
 
-      dds_low_command.crc() = Crc32Core((uint32_t *)&dds_low_command,
+      dds_low_command.crc() = Crc32Word((uint32_t *)&dds_low_command,
                                         (sizeof(dds_low_command) >> 2) - 1);
       lowcmd_publisher_->Write(dds_low_command);
     }
@@ -283,22 +196,21 @@ class H1Example {
     ReportRPY();
 
     MotorCommand motor_command_tmp;
-    const std::shared_ptr<const MotorState> ms = motor_state_buffer_.GetData();
+    const MotorState *ms = motor_state_buffer_.Read();
 
     if (ms) {
       time_ += control_dt_;
       if (time_ < duration_ * 1) {
         // [Stage 1]: set robot to zero posture
-        for (int i = 0; i < H1_NUM_MOTOR; ++i) {
-          double ratio = std::clamp(time_ / duration_, 0.0, 1.0);
+        const std::array<float, H1_NUM_MOTOR> zero_posture = {};
+        JointLerp(motor_command_tmp.q_target, ms->q, zero_posture,
+                  time_ / duration_);
 
-          double q_des = 0;
+        for (int i = 0; i < H1_NUM_MOTOR; ++i) {
           motor_command_tmp.tau_ff.at(i) = 0.0;
-          motor_command_tmp.q_target.at(i) =
-              (q_des - ms->q.at(i)) * ratio + ms->q.at(i);
           motor_command_tmp.dq_target.at(i) = 0.0;
-          motor_command_tmp.kp.at(i) = GetMotorKp(H1MotorType[i]);
-          motor_command_tmp.kd.at(i) = GetMotorKd(H1MotorType[i]);
+          motor_command_tmp.kp.at(i) = H1_2Model::KP[i];
+          motor_command_tmp.kd.at(i) = H1_2Model::KD[i];
         }
       } else if (time_ < duration_ * 2) {
         // [Stage 2]: swing ankle's PR
@@ -315,8 +227,8 @@ class H1Example {
           motor_command_tmp.tau_ff.at(i) = 0.0;
           motor_command_tmp.q_target.at(i) = 0.0;
           motor_command_tmp.dq_target.at(i) = 0.0;
-          motor_command_tmp.kp.at(i) = GetMotorKp(H1MotorType[i]);
-          motor_command_tmp.kd.at(i) = GetMotorKd(H1MotorType[i]);
+          motor_command_tmp.kp.at(i) = H1_2Model::KP[i];
+          motor_command_tmp.kd.at(i) = H1_2Model::KD[i];
         }
 
         motor_command_tmp.q_target.at(LeftAnklePitch) = L_P_des;
@@ -338,8 +250,8 @@ class H1Example {
           motor_command_tmp.tau_ff.at(i) = 0.0;
           motor_command_tmp.q_target.at(i) = 0.0;
           motor_command_tmp.dq_target.at(i) = 0.0;
-          motor_command_tmp.kp.at(i) = GetMotorKp(H1MotorType[i]);
-          motor_command_tmp.kd.at(i) = GetMotorKd(H1MotorType[i]);
+          motor_command_tmp.kp.at(i) = H1_2Model::KP[i];
+          motor_command_tmp.kd.at(i) = H1_2Model::KD[i];
         }
 
         motor_command_tmp.q_target.at(LeftAnkleA) = L_A_des;
@@ -348,7 +260,7 @@ class H1Example {
         motor_command_tmp.q_target.at(RightAnkleB) = R_B_des;
       }
 
-      motor_command_buffer_.SetData(motor_command_tmp);
+      motor_command_buffer_.Set(motor_command_tmp);
     }
   }
 };
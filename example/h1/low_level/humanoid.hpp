@@ -6,15 +6,17 @@
 
 #include "unitree/robot/channel/channel_publisher.hpp"
 #include "unitree/robot/channel/channel_subscriber.hpp"
+#include <unitree/common/latest_value.hpp>
 #include <unitree/common/thread/thread.hpp>
+#include <unitree/common/thread/timer_service.hpp>
 #include <unitree/idl/go2/LowCmd_.hpp>
 #include <unitree/idl/go2/LowState_.hpp>
 
 #include "base_state.h"
-#include "data_buffer.hpp"
 #include "motors.hpp"
 
 #include <unitree/robot/b2/motion_switcher/motion_switcher_client.hpp>
+#include <unitree/robot/low_level/low_cmd_builder.hpp>
 using namespace unitree::robot::b2;
 
 static const std::string kTopicLowCommand = "rt/lowcmd";
@@ -43,6 +45,12 @@ public:
         sleep(5);
     }
 
+    unitree_go::msg::dds_::LowCmd_ &low_command = low_command_builder_.Mutable();
+    low_command.head()[0] = 0xFE;
+    low_command.head()[1] = 0xEF;
+    low_command.level_flag() = 0xFF;
+    low_command.gpio() = 0;
+
     lowcmd_publisher_.reset(
         new unitree::robot::ChannelPublisher<unitree_go::msg::dds_::LowCmd_>(
             kTopicLowCommand));
@@ -63,39 +71,37 @@ public:
         "control", UT_CPU_ID_NONE, control_period_us, &HumanoidExample::Control,
         this);
 
+    // cheap periodic report shares the timer service thread
     int report_period_us = report_dt_ * 1e6;
-    report_rpy_ptr_ = unitree::common::CreateRecurrentThreadEx(
-        "report_rpy", UT_CPU_ID_NONE, report_period_us,
-        &HumanoidExample::ReportRPY, this);
+    report_rpy_timer_ = unitree::common::TimerService::Instance()->AddRecurrent(
+        report_period_us, &HumanoidExample::ReportRPY, this);
   }
 
-  ~HumanoidExample() = default;
+  ~HumanoidExample() {
+    // returns once a running ReportRPY, which uses this, has finished
+    unitree::common::TimerService::Instance()->Cancel(report_rpy_timer_);
+  }
 
   void LowCommandWriter() {
-    unitree_go::msg::dds_::LowCmd_ dds_low_command{};
-    dds_low_command.head()[0] = 0xFE;
-    dds_low_command.head()[1] = 0xEF;
-    dds_low_command.level_flag() = 0xFF;
-    dds_low_command.gpio() = 0;
-
-    const std::shared_ptr<const MotorCommand> mc_tmp_ptr =
-        motor_command_buffer_.GetData();
+    const MotorCommand *mc_tmp_ptr = motor_command_buffer_.Read();
     if (mc_tmp_ptr) {
+      // unchanged joints stay clean, see LowCmdBuilder::Build
       for (int i = 0; i < kNumMotors; ++i) {
+        unitree_go::msg::dds_::MotorCmd_ motor_cmd =
+            low_command_builder_.Get().motor_cmd().at(i);
         if (IsWeakMotor(i)) {
-          dds_low_command.motor_cmd().at(i).mode() = (0x01);
+          motor_cmd.mode() = (0x01);
         } else {
-          dds_low_command.motor_cmd().at(i).mode() = (0x0A);
+          motor_cmd.mode() = (0x0A);
         }
-        dds_low_command.motor_cmd().at(i).tau() = mc_tmp_ptr->tau_ff.at(i);
-        dds_low_command.motor_cmd().at(i).q() = mc_tmp_ptr->q_ref.at(i);
-        dds_low_command.motor_cmd().at(i).dq() = mc_tmp_ptr->dq_ref.at(i);
-        dds_low_command.motor_cmd().at(i).kp() = mc_tmp_ptr->kp.at(i);
-        dds_low_command.motor_cmd().at(i).kd() = mc_tmp_ptr->kd.at(i);
+        motor_cmd.tau() = mc_tmp_ptr->tau_ff.at(i);
+        motor_cmd.q() = mc_tmp_ptr->q_ref.at(i);
+        motor_cmd.dq() = mc_tmp_ptr->dq_ref.at(i);
+        motor_cmd.kp() = mc_tmp_ptr->kp.at(i);
+        motor_cmd.kd() = mc_tmp_ptr->kd.at(i);
+        low_command_builder_.SetMotor(i, motor_cmd);
       }
-      dds_low_command.crc() = Crc32Core((uint32_t *)&dds_low_command,
-                                        (sizeof(dds_low_command) >> 2) - 1);
-      lowcmd_publisher_->Write(dds_low_command);
+      lowcmd_publisher_->Write(low_command_builder_.Build());
     }
   }
 
@@ -109,8 +115,7 @@ public:
 
   void Control() {
     MotorCommand motor_command_tmp;
-    const std::shared_ptr<const MotorState> ms_tmp_ptr =
-        motor_state_buffer_.GetData();
+    const MotorState *ms_tmp_ptr = motor_state_buffer_.Read();
 
     if (ms_tmp_ptr) {
       time_ += control_dt_;
@@ -141,13 +146,12 @@ public:
         motor_command_tmp.q_ref.at(i) = q_des;
       }
 
-      motor_command_buffer_.SetData(motor_command_tmp);
+      motor_command_buffer_.Set(motor_command_tmp);
     }
   }
 
   void ReportRPY() {
-    const std::shared_ptr<const BaseState> bs_tmp_ptr =
-        base_state_buffer_.GetData();
+    const BaseState *bs_tmp_ptr = base_state_buffer_.Read();
     if (bs_tmp_ptr) {
       std::cout << "rpy: [" << bs_tmp_ptr->rpy.at(0) << ", "
                 << bs_tmp_ptr->rpy.at(1) << ", " << bs_tmp_ptr->rpy.at(2) << "]"
@@ -163,7 +167,7 @@ private:
       ms_tmp.dq.at(i) = msg.motor_state()[i].dq();
     }
 
-    motor_state_buffer_.SetData(ms_tmp);
+    motor_state_buffer_.Set(ms_tmp);
   }
 
   void RecordBaseState(const unitree_go::msg::dds_::LowState_ &msg) {
@@ -171,7 +175,7 @@ private:
     bs_tmp.omega = msg.imu_state().gyroscope();
     bs_tmp.rpy = msg.imu_state().rpy();
 
-    base_state_buffer_.SetData(bs_tmp);
+    base_state_buffer_.Set(bs_tmp);
   }
 
   inline bool IsWeakMotor(int motor_index) {
@@ -229,12 +233,13 @@ private:
 
   unitree::robot::ChannelPublisherPtr<unitree_go::msg::dds_::LowCmd_>
       lowcmd_publisher_;
+  unitree::robot::GoLowCmdBuilder low_command_builder_;
   unitree::robot::ChannelSubscriberPtr<unitree_go::msg::dds_::LowState_>
       lowstate_subscriber_;
 
-  DataBuffer<MotorState> motor_state_buffer_;
-  DataBuffer<MotorCommand> motor_command_buffer_;
-  DataBuffer<BaseState> base_state_buffer_;
+  unitree::common::LatestValue<MotorState> motor_state_buffer_;
+  unitree::common::LatestValue<MotorCommand> motor_command_buffer_;
+  unitree::common::LatestValue<BaseState> base_state_buffer_;
 
   std::shared_ptr<MotionSwitcherClient> msc;
 
@@ -259,5 +264,5 @@ private:
   // multithreading
   unitree::common::ThreadPtr command_writer_ptr_;
   unitree::common::ThreadPtr control_thread_ptr_;
-  unitree::common::ThreadPtr report_rpy_ptr_;
+  uint64_t report_rpy_timer_ = 0;
 };
@@ -0,0 +1,43 @@
+/**
+ * decode a binary log file written by LogBinaryStore into text.
+ * usage: log_binary_decode <binary log file> [text output file]
+ */
+#include <iostream>
+
+#include <unitree/common/log/log_binary.hpp>
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cout << "usage: " << argv[0]
+              << " <binary log file> [text output file]" << std::endl;
+    return 1;
+  }
+
+  std::string data, text;
+
+  try {
+    unitree::common::File input(argv[1], unitree::common::UT_OPEN_FLAG_R,
+                                unitree::common::UT_OPEN_MODE_NONE);
+    input.ReadAll(data);
+  } catch (const unitree::common::Exception &e) {
+    std::cout << "read file failed: " << e.what() << std::endl;
+    return 1;
+  }
+
+  bool ok = unitree::common::LogBinaryDecoder::Decode(data, text);
+
+  if (argc > 2) {
+    unitree::common::File output(argv[2], unitree::common::UT_OPEN_FLAG_CWT,
+                                 unitree::common::UT_OPEN_MODE_RW);
+    output.Write(text);
+  } else {
+    std::cout << text;
+  }
+
+  if (!ok) {
+    std::cout << "binary log is invalid or truncated." << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
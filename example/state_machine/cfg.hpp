@@ -1,4 +1,4 @@
-#include "unitree/common/json/jsonize.hpp"
+#include "unitree/common/json/json_reflect.hpp"
 #include <vector>
 #include <iostream>
 
@@ -11,21 +11,11 @@ namespace unitree::common
         {
         }
 
-        void fromJson(JsonMap &json)
-        {
-            FromJson(json["kp"], kp);
-            FromJson(json["kd"], kd);
-            FromJson(json["dt"], dt);
-            FromAny<float>(json["init_pos"], init_pos);
-        }
-
-        void toJson(JsonMap &json) const
-        {
-            ToJson(kp, json["kp"]);
-            ToJson(kd, json["kd"]);
-            ToJson(dt, json["dt"]);
-            ToAny<float>(init_pos, json["init_pos"]);
-        }
+        JN_REFLECT(ExampleCfg,
+            JN_FIELD("kp", kp),
+            JN_FIELD("kd", kd),
+            JN_FIELD("dt", dt),
+            JN_FIELD("init_pos", init_pos))
 
         float kp;
         float kd;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <iostream>
 
@@ -7,6 +8,7 @@
 #include "unitree/idl/go2/LowState_.hpp"
 #include "unitree/idl/go2/LowCmd_.hpp"
 #include "conversion.hpp"
+#include <unitree/robot/low_level/robot_model.hpp>
 
 namespace unitree::common
 {
@@ -17,6 +19,8 @@ namespace unitree::common
     class BasicRobotInterface
     {
     public:
+        typedef unitree::robot::Go2Model Model;
+
         BasicRobotInterface()
         {
             jpos_des.fill(0.);
@@ -38,24 +42,22 @@ namespace unitree::common
             UpdateProjectedGravity();
 
             // motor
-            const std::array<unitree_go::msg::dds_::MotorState_, 20> &motor = state.motor_state();
-            for (size_t i = 0; i < 12; ++i)
-            {
-                const unitree_go::msg::dds_::MotorState_ &m = motor.at(i);
-                jpos.at(i) = m.q();
-                jvel.at(i) = m.dq();
-                tau.at(i) = m.tau_est();
-            }
+            motor_view.Extract(state.motor_state());
+            std::copy_n(motor_view.Q(), Model::DOF, jpos.begin());
+            std::copy_n(motor_view.Dq(), Model::DOF, jvel.begin());
+            std::copy_n(motor_view.TauEst(), Model::DOF, tau.begin());
         }
 
         virtual void SetCommand(unitree_go::msg::dds_::LowCmd_ &cmd) = 0;
 
-        std::array<float, 12> jpos, jvel, tau;
+        unitree::robot::JointArray<Model> jpos, jvel, tau;
         std::array<float, 4> quat;
         std::array<float, 3> rpy, gyro, projected_gravity;
-        std::array<float, 12> jpos_des, jvel_des, kp, kd, tau_ff;
+        unitree::robot::JointArray<Model> jpos_des, jvel_des, kp, kd, tau_ff;
 
     private:
+        unitree::robot::ModelStateView<Model> motor_view;
+
         inline void UpdateProjectedGravity()
         {
             // inverse quat
@@ -91,40 +93,33 @@ namespace unitree::common
 
         void SetCommand(unitree_go::msg::dds_::LowCmd_ &cmd)
         {
+            // unchanged joints stay clean, see LowCmdBuilder::Build
+            unitree::robot::PackCommand<Model>(low_cmd, jpos_des, jvel_des, kp, kd, tau_ff);
 
-            for (int i = 0; i < 12; ++i)
-            {
-                low_cmd.motor_cmd()[i].q() = jpos_des.at(i);
-                low_cmd.motor_cmd()[i].dq() = jvel_des.at(i);
-                low_cmd.motor_cmd()[i].kp() = kp.at(i);
-                low_cmd.motor_cmd()[i].kd() = kd.at(i);
-                low_cmd.motor_cmd()[i].tau() = tau_ff.at(i);
-            }
-
-            low_cmd.crc() = crc32_core((uint32_t *)&low_cmd, (sizeof(unitree_go::msg::dds_::LowCmd_)>>2)-1);
             // lowCmd2Dds(low_cmd_raw, cmd);
-            cmd = low_cmd;
+            cmd = low_cmd.Build();
         }
 
     private:
         void InitLowCmd()
         {
-            low_cmd.head()[0] = 0xFE;
-            low_cmd.head()[1] = 0xEF;
-            low_cmd.level_flag() = 0xFF;
-            low_cmd.gpio() = 0;
+            unitree_go::msg::dds_::LowCmd_ &init_cmd = low_cmd.Mutable();
+            init_cmd.head()[0] = 0xFE;
+            init_cmd.head()[1] = 0xEF;
+            init_cmd.level_flag() = 0xFF;
+            init_cmd.gpio() = 0;
 
-            for(int i=0; i<20; i++)
+            for(size_t i=0; i<Model::SLOT_NUM; i++)
             {
-                low_cmd.motor_cmd()[i].mode() = (0x01);   // motor switch to servo (PMSM) mode
-                low_cmd.motor_cmd()[i].q() = (PosStopF);
-                low_cmd.motor_cmd()[i].kp() = (0);
-                low_cmd.motor_cmd()[i].dq() = (VelStopF);
-                low_cmd.motor_cmd()[i].kd() = (0);
-                low_cmd.motor_cmd()[i].tau() = (0);
+                init_cmd.motor_cmd()[i].mode() = (0x01);   // motor switch to servo (PMSM) mode
+                init_cmd.motor_cmd()[i].q() = (PosStopF);
+                init_cmd.motor_cmd()[i].kp() = (0);
+                init_cmd.motor_cmd()[i].dq() = (VelStopF);
+                init_cmd.motor_cmd()[i].kd() = (0);
+                init_cmd.motor_cmd()[i].tau() = (0);
             }
         }
 
-        unitree_go::msg::dds_::LowCmd_ low_cmd;
+        unitree::robot::GoLowCmdBuilder low_cmd;
     };
 } // namespace unitree::common
\ No newline at end of file
@@ -19,6 +19,16 @@ public:
         : mContent(new Holder<ValueType>(value))
     {}
 
+    /*
+     * move a temporary value into the holder instead of copying it.
+     */
+    template<typename ValueType, typename = typename std::enable_if<
+        !std::is_lvalue_reference<ValueType>::value &&
+        !std::is_same<typename std::decay<ValueType>::type, Any>::value>::type>
+    Any(ValueType&& value)
+        : mContent(new Holder<typename std::decay<ValueType>::type>(std::move(value)))
+    {}
+
     Any(const char* s)
         : Any(std::string(s))
     {}
@@ -31,6 +41,12 @@ public:
         : mContent(other.mContent ? other.mContent->Clone() : 0)
     {}
 
+    Any(Any&& other) noexcept
+        : mContent(other.mContent)
+    {
+        other.mContent = 0;
+    }
+
     ~Any()
     {
         delete mContent;
@@ -53,6 +69,11 @@ public:
         return mContent ? mContent->GetTypeInfo() : typeid(void);
     }
 
+    /*
+     * UT_ANY_TYPE_* of the held value.
+     */
+    int32_t GetTypeTag() const;
+
     template<typename ValueType>
     Any& operator=(const ValueType& other)
     {
@@ -60,6 +81,15 @@ public:
         return *this;
     }
 
+    template<typename ValueType, typename = typename std::enable_if<
+        !std::is_lvalue_reference<ValueType>::value &&
+        !std::is_same<typename std::decay<ValueType>::type, Any>::value>::type>
+    Any& operator=(ValueType&& other)
+    {
+        Any(std::move(other)).Swap(*this);
+        return *this;
+    }
+
     Any& operator=(Any other)
     {
         other.Swap(*this);
@@ -86,6 +116,10 @@ public:
             : mValue(value)
         {}
 
+        explicit Holder(ValueType&& value)
+            : mValue(std::move(value))
+        {}
+
         virtual const std::type_info& GetTypeInfo() const
         {
             return typeid(ValueType);
@@ -109,6 +143,112 @@ public:
  */
 static const Any UT_EMPTY_ANY = Any();
 
+/*
+ * type tags of the values Any carries for json. numbers are contiguous
+ * from UT_ANY_TYPE_BOOL to UT_ANY_TYPE_LONG_DOUBLE.
+ */
+enum
+{
+    UT_ANY_TYPE_EMPTY = 0,
+    UT_ANY_TYPE_BOOL,
+    UT_ANY_TYPE_INT8,
+    UT_ANY_TYPE_UINT8,
+    UT_ANY_TYPE_INT16,
+    UT_ANY_TYPE_UINT16,
+    UT_ANY_TYPE_INT32,
+    UT_ANY_TYPE_UINT32,
+    UT_ANY_TYPE_INT64,
+    UT_ANY_TYPE_UINT64,
+    UT_ANY_TYPE_FLOAT,
+    UT_ANY_TYPE_DOUBLE,
+    UT_ANY_TYPE_LONG_DOUBLE,
+    UT_ANY_TYPE_STRING,
+    UT_ANY_TYPE_MAP,
+    UT_ANY_TYPE_ARRAY,
+    UT_ANY_TYPE_OTHER
+};
+
+template<typename T>
+struct AnyTypeTag
+{
+    static const int32_t value = UT_ANY_TYPE_OTHER;
+};
+
+#define __UT_ANY_TYPE_TAG(type, tag)                    \
+    template<>                                          \
+    struct AnyTypeTag<type>                             \
+    {                                                   \
+        static const int32_t value = tag;               \
+    };
+
+__UT_ANY_TYPE_TAG(bool, UT_ANY_TYPE_BOOL)
+__UT_ANY_TYPE_TAG(int8_t, UT_ANY_TYPE_INT8)
+__UT_ANY_TYPE_TAG(uint8_t, UT_ANY_TYPE_UINT8)
+__UT_ANY_TYPE_TAG(int16_t, UT_ANY_TYPE_INT16)
+__UT_ANY_TYPE_TAG(uint16_t, UT_ANY_TYPE_UINT16)
+__UT_ANY_TYPE_TAG(int32_t, UT_ANY_TYPE_INT32)
+__UT_ANY_TYPE_TAG(uint32_t, UT_ANY_TYPE_UINT32)
+__UT_ANY_TYPE_TAG(int64_t, UT_ANY_TYPE_INT64)
+__UT_ANY_TYPE_TAG(uint64_t, UT_ANY_TYPE_UINT64)
+__UT_ANY_TYPE_TAG(float, UT_ANY_TYPE_FLOAT)
+__UT_ANY_TYPE_TAG(double, UT_ANY_TYPE_DOUBLE)
+__UT_ANY_TYPE_TAG(long double, UT_ANY_TYPE_LONG_DOUBLE)
+__UT_ANY_TYPE_TAG(std::string, UT_ANY_TYPE_STRING)
+
+#undef __UT_ANY_TYPE_TAG
+
+/*
+ * type_info objects of the fundamental types are defined once, in the
+ * c++ runtime, so they are matched by address. only the class types,
+ * which may be emitted by several shared objects, fall back to ==.
+ */
+static inline int32_t GetAnyTypeTag(const std::type_info& t)
+{
+    static const std::type_info* const types[] =
+    {
+        &typeid(void), &typeid(bool), &typeid(int8_t), &typeid(uint8_t),
+        &typeid(int16_t), &typeid(uint16_t), &typeid(int32_t), &typeid(uint32_t),
+        &typeid(int64_t), &typeid(uint64_t), &typeid(float), &typeid(double),
+        &typeid(long double), &typeid(std::string), &typeid(std::map<std::string,Any>),
+        &typeid(std::vector<Any>)
+    };
+
+    const int32_t count = sizeof(types) / sizeof(types[0]);
+
+    for (int32_t i=0; i<count; i++)
+    {
+        if (&t == types[i])
+        {
+            return i;
+        }
+    }
+
+    for (int32_t i=UT_ANY_TYPE_STRING; i<count; i++)
+    {
+        if (t == *types[i])
+        {
+            return i;
+        }
+    }
+
+    return UT_ANY_TYPE_OTHER;
+}
+
+static inline bool IsNumberTypeTag(int32_t tag)
+{
+    return tag >= UT_ANY_TYPE_BOOL && tag <= UT_ANY_TYPE_LONG_DOUBLE;
+}
+
+static inline bool IsIntegerTypeTag(int32_t tag)
+{
+    return tag >= UT_ANY_TYPE_INT8 && tag <= UT_ANY_TYPE_UINT64;
+}
+
+inline int32_t Any::GetTypeTag() const
+{
+    return mContent ? GetAnyTypeTag(mContent->GetTypeInfo()) : UT_ANY_TYPE_EMPTY;
+}
+
 static inline bool IsBool(const Any& any)
 {
     return any.GetTypeInfo() == typeid(bool);
@@ -176,14 +316,12 @@ static inline bool IsLongDouble(const Any& any)
 
 static inline bool IsInteger(const Any& any)
 {
-    return IsInt(any) || IsUint(any) || IsInt64(any) || IsUint64(any)
-        || IsInt16(any) || IsUint16(any) || IsInt8(any) || IsUint8(any);
+    return IsIntegerTypeTag(any.GetTypeTag());
 }
 
 static inline bool IsNumber(const Any& any)
 {
-    return IsBool(any) || IsInteger(any) || IsFloat(any) || IsDouble(any)
-        || IsLongDouble(any);
+    return IsNumberTypeTag(any.GetTypeTag());
 }
 
 static inline bool IsBoolType(const std::type_info& t)
@@ -233,8 +371,7 @@ static inline bool IsUint64Type(const std::type_info& t)
 
 static inline bool IsIntegerType(const std::type_info& t)
 {
-    return IsIntType(t) || IsUintType(t) || IsInt64Type(t) || IsUint64Type(t) ||
-           IsInt8Type(t) || IsUint8Type(t) || IsInt16Type(t) || IsUint16Type(t);
+    return IsIntegerTypeTag(GetAnyTypeTag(t));
 }
 
 static inline bool IsFloatType(const std::type_info& t)
@@ -254,8 +391,7 @@ static inline bool IsLongDoubleType(const std::type_info& t)
 
 static inline bool IsNumberType(const std::type_info& t)
 {
-    return IsBoolType(t) || IsIntegerType(t) || IsFloatType(t)
-        || IsDoubleType(t) || IsLongDoubleType(t);
+    return IsNumberTypeTag(GetAnyTypeTag(t));
 }
 
 static inline bool IsTypeEqual(const std::type_info& t1, const std::type_info& t2)
@@ -284,65 +420,51 @@ const ValueType& AnyCast(const Any& operand)
     return AnyCast<ValueType>(&operand);
 }
 
+template<typename ValueType, typename SourceType>
+ValueType AnyHolderCast(const Any* operand)
+{
+    return (ValueType)((Any::Holder<SourceType>*)(operand->mContent))->mValue;
+}
+
 template<typename ValueType>
 ValueType AnyNumberCast(const Any* operand)
 {
-    const std::type_info& t1 = typeid(ValueType);
-    const std::type_info& t2 = operand->GetTypeInfo();
+    const int32_t tag = operand->GetTypeTag();
 
-    if (IsNumberType(t1) && IsNumberType(t2))
+    if (IsNumberTypeTag(AnyTypeTag<ValueType>::value) && IsNumberTypeTag(tag))
     {
-        if (IsTypeEqual(t1, t2))
+        if (tag == AnyTypeTag<ValueType>::value)
         {
             return ((Any::Holder<ValueType>*)(operand->mContent))->mValue;
         }
-        else if (IsFloatType(t2))
-        {
-            return (ValueType)((Any::Holder<float>*)(operand->mContent))->mValue;
-        }
-        else if (IsDoubleType(t2))
-        {
-            return (ValueType)((Any::Holder<double>*)(operand->mContent))->mValue;
-        }
-        else if (IsLongDoubleType(t2))
-        {
-            return (ValueType)((Any::Holder<long double>*)(operand->mContent))->mValue;
-        }
-        else if (IsInt8Type(t2))
-        {
-            return (ValueType)((Any::Holder<int8_t>*)(operand->mContent))->mValue;
-        }
-        else if (IsUint8Type(t2))
-        {
-            return (ValueType)((Any::Holder<uint8_t>*)(operand->mContent))->mValue;
-        }
-        else if (IsInt16Type(t2))
-        {
-            return (ValueType)((Any::Holder<int16_t>*)(operand->mContent))->mValue;
-        }
-        else if (IsUint16Type(t2))
-        {
-            return (ValueType)((Any::Holder<uint16_t>*)(operand->mContent))->mValue;
-        }
-        else if (IsIntType(t2))
-        {
-            return (ValueType)((Any::Holder<int32_t>*)(operand->mContent))->mValue;
-        }
-        else if (IsUintType(t2))
-        {
-            return (ValueType)((Any::Holder<uint32_t>*)(operand->mContent))->mValue;
-        }
-        else if (IsInt64Type(t2))
-        {
-            return (ValueType)((Any::Holder<int64_t>*)(operand->mContent))->mValue;
-        }
-        else if (IsUint64Type(t2))
-        {
-            return (ValueType)((Any::Holder<uint64_t>*)(operand->mContent))->mValue;
-        }
-        else
+
+        switch (tag)
         {
-            UT_THROW(BadCastException, std::string("AnyNumberCast error. unknown number type:", t2.name()));
+        case UT_ANY_TYPE_FLOAT:
+            return AnyHolderCast<ValueType,float>(operand);
+        case UT_ANY_TYPE_DOUBLE:
+            return AnyHolderCast<ValueType,double>(operand);
+        case UT_ANY_TYPE_LONG_DOUBLE:
+            return AnyHolderCast<ValueType,long double>(operand);
+        case UT_ANY_TYPE_INT8:
+            return AnyHolderCast<ValueType,int8_t>(operand);
+        case UT_ANY_TYPE_UINT8:
+            return AnyHolderCast<ValueType,uint8_t>(operand);
+        case UT_ANY_TYPE_INT16:
+            return AnyHolderCast<ValueType,int16_t>(operand);
+        case UT_ANY_TYPE_UINT16:
+            return AnyHolderCast<ValueType,uint16_t>(operand);
+        case UT_ANY_TYPE_INT32:
+            return AnyHolderCast<ValueType,int32_t>(operand);
+        case UT_ANY_TYPE_UINT32:
+            return AnyHolderCast<ValueType,uint32_t>(operand);
+        case UT_ANY_TYPE_INT64:
+            return AnyHolderCast<ValueType,int64_t>(operand);
+        case UT_ANY_TYPE_UINT64:
+            return AnyHolderCast<ValueType,uint64_t>(operand);
+        default:
+            UT_THROW(BadCastException, std::string("AnyNumberCast error. unknown number type:") +
+                operand->GetTypeInfo().name());
         }
     }
 
@@ -23,38 +23,12 @@ public:
 
     bool Put(const T& t, bool replace = false, bool putfront = false)
     {
-        /*
-         * if queue is full or full-replaced occured return false
-         */
-        bool noneReplaced = true;
-
-        LockGuard<MutexCond> guard(mMutexCond);
-        if (mCurSize >= mMaxSize)
-        {
-            if (!replace)
-            {
-                return false;
-            }
-
-            noneReplaced = false;
-
-            mQueue.pop_front();
-            mCurSize --;
-        }
-
-        if (putfront)
-        {
-            mQueue.emplace_front(t);
-        }
-        else
-        {
-            mQueue.emplace_back(t);
-        }
-
-        mCurSize ++;
-        mMutexCond.Notify();
+        return PutInner(t, replace, putfront);
+    }
 
-        return noneReplaced;
+    bool Put(T&& t, bool replace = false, bool putfront = false)
+    {
+        return PutInner(std::move(t), replace, putfront);
     }
 
     bool Get(T& t, uint64_t microsec = 0)
@@ -77,11 +51,13 @@ public:
 
     bool Empty()
     {
+        LockGuard<MutexCond> guard(mMutexCond);
         return mCurSize == 0;
     }
 
     uint64_t Size()
     {
+        LockGuard<MutexCond> guard(mMutexCond);
         return mCurSize;
     }
 
@@ -99,6 +75,43 @@ public:
     }
 
 private:
+    template<typename V>
+    bool PutInner(V&& t, bool replace, bool putfront)
+    {
+        /*
+         * if queue is full or full-replaced occured return false
+         */
+        bool noneReplaced = true;
+
+        LockGuard<MutexCond> guard(mMutexCond);
+        if (mCurSize >= mMaxSize)
+        {
+            if (!replace)
+            {
+                return false;
+            }
+
+            noneReplaced = false;
+
+            mQueue.pop_front();
+            mCurSize --;
+        }
+
+        if (putfront)
+        {
+            mQueue.emplace_front(std::forward<V>(t));
+        }
+        else
+        {
+            mQueue.emplace_back(std::forward<V>(t));
+        }
+
+        mCurSize ++;
+        mMutexCond.Notify();
+
+        return noneReplaced;
+    }
+
     bool GetTimeout(T& t, uint64_t microsec = 0)
     {
         if (mQueue.empty())
@@ -114,7 +127,7 @@ private:
             }
         }
 
-        t = mQueue.front();
+        t = std::move(mQueue.front());
         mQueue.pop_front();
 
         mCurSize--;
@@ -0,0 +1,279 @@
+#ifndef __UT_CRC32_HPP__
+#define __UT_CRC32_HPP__
+
+#include <unitree/common/decl.hpp>
+#include <array>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+/*
+ * crc of LowCmd_/LowState_ and the other low level messages: polynomial
+ * 0x04C11DB7, not reflected, no final xor, each 32 bit word fed from its
+ * most significant bit.
+ */
+#define UT_CRC32_POLY   0x04C11DB7
+#define UT_CRC32_INIT   0xFFFFFFFF
+
+namespace unitree
+{
+namespace common
+{
+typedef std::array<std::array<uint32_t,256>,8> Crc32TableType;
+
+/*
+ * x^n mod P, the fold constants of the carry-less multiply paths.
+ */
+static constexpr uint32_t Crc32XPow(uint32_t n)
+{
+    uint32_t r = 1;
+    for (uint32_t i=0; i<n; i++)
+    {
+        r = (r & 0x80000000) ? ((r << 1) ^ UT_CRC32_POLY) : (r << 1);
+    }
+
+    return r;
+}
+
+/*
+ * slice-by-8 tables. t[k][b] is the crc of byte b followed by k zero bytes.
+ */
+static constexpr Crc32TableType Crc32MakeTable()
+{
+    Crc32TableType t = {};
+
+    for (uint32_t b=0; b<256; b++)
+    {
+        uint32_t c = b << 24;
+        for (int32_t i=0; i<8; i++)
+        {
+            c = (c & 0x80000000) ? ((c << 1) ^ UT_CRC32_POLY) : (c << 1);
+        }
+
+        t[0][b] = c;
+    }
+
+    for (size_t k=1; k<8; k++)
+    {
+        for (uint32_t b=0; b<256; b++)
+        {
+            uint32_t c = t[k-1][b];
+            t[k][b] = (c << 8) ^ t[0][c >> 24];
+        }
+    }
+
+    return t;
+}
+
+/*
+ * built at compile time, one copy per program.
+ */
+class Crc32Table
+{
+public:
+    static constexpr Crc32TableType mTable = Crc32MakeTable();
+};
+
+/*
+ * portable version, two words per step.
+ */
+static inline uint32_t Crc32WordTable(const uint32_t* ptr, uint32_t len, uint32_t crc = UT_CRC32_INIT)
+{
+    const Crc32TableType& t = Crc32Table::mTable;
+
+    uint32_t i = 0;
+    for (; i + 2 <= len; i += 2)
+    {
+        uint32_t v0 = crc ^ ptr[i];
+        uint32_t v1 = ptr[i+1];
+
+        crc = t[7][v0 >> 24] ^ t[6][(v0 >> 16) & 0xFF] ^ t[5][(v0 >> 8) & 0xFF] ^ t[4][v0 & 0xFF] ^
+              t[3][v1 >> 24] ^ t[2][(v1 >> 16) & 0xFF] ^ t[1][(v1 >> 8) & 0xFF] ^ t[0][v1 & 0xFF];
+    }
+
+    if (i < len)
+    {
+        uint32_t v = crc ^ ptr[i];
+        crc = t[3][v >> 24] ^ t[2][(v >> 16) & 0xFF] ^ t[1][(v >> 8) & 0xFF] ^ t[0][v & 0xFF];
+    }
+
+    return crc;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/*
+ * pclmul folding. 128 bit blocks hold four words with the first word in
+ * the high lane, four blocks are folded in parallel and the final 128 bit
+ * remainder is reduced with the tables.
+ */
+__attribute__((target("pclmul,sse2")))
+static inline __m128i Crc32Fold(__m128i x, __m128i k)
+{
+    return _mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x11), _mm_clmulepi64_si128(x, k, 0x00));
+}
+
+__attribute__((target("pclmul,sse2")))
+static inline uint32_t Crc32WordClmul(const uint32_t* ptr, uint32_t len, uint32_t crc = UT_CRC32_INIT)
+{
+    if (len < 16)
+    {
+        return Crc32WordTable(ptr, len, crc);
+    }
+
+    const __m128i* p = (const __m128i*)ptr;
+    uint32_t count = len / 4;
+
+    __m128i x0 = _mm_xor_si128(_mm_shuffle_epi32(_mm_loadu_si128(p), 0x1B),
+        _mm_set_epi32((int32_t)crc, 0, 0, 0));
+    __m128i x1 = _mm_shuffle_epi32(_mm_loadu_si128(p + 1), 0x1B);
+    __m128i x2 = _mm_shuffle_epi32(_mm_loadu_si128(p + 2), 0x1B);
+    __m128i x3 = _mm_shuffle_epi32(_mm_loadu_si128(p + 3), 0x1B);
+
+    const __m128i k512 = _mm_set_epi64x(Crc32XPow(512 + 64), Crc32XPow(512));
+    const __m128i k128 = _mm_set_epi64x(Crc32XPow(128 + 64), Crc32XPow(128));
+
+    uint32_t i = 4;
+    for (; i + 4 <= count; i += 4)
+    {
+        x0 = _mm_xor_si128(Crc32Fold(x0, k512), _mm_shuffle_epi32(_mm_loadu_si128(p + i), 0x1B));
+        x1 = _mm_xor_si128(Crc32Fold(x1, k512), _mm_shuffle_epi32(_mm_loadu_si128(p + i + 1), 0x1B));
+        x2 = _mm_xor_si128(Crc32Fold(x2, k512), _mm_shuffle_epi32(_mm_loadu_si128(p + i + 2), 0x1B));
+        x3 = _mm_xor_si128(Crc32Fold(x3, k512), _mm_shuffle_epi32(_mm_loadu_si128(p + i + 3), 0x1B));
+    }
+
+    __m128i x = _mm_xor_si128(Crc32Fold(x0, k128), x1);
+    x = _mm_xor_si128(Crc32Fold(x, k128), x2);
+    x = _mm_xor_si128(Crc32Fold(x, k128), x3);
+
+    for (; i < count; i++)
+    {
+        x = _mm_xor_si128(Crc32Fold(x, k128), _mm_shuffle_epi32(_mm_loadu_si128(p + i), 0x1B));
+    }
+
+    uint32_t words[4];
+    _mm_storeu_si128((__m128i*)words, _mm_shuffle_epi32(x, 0x1B));
+
+    crc = Crc32WordTable(words, 4, 0);
+
+    return Crc32WordTable(ptr + count * 4, len - count * 4, crc);
+}
+#elif defined(__aarch64__)
+/*
+ * the crc32 instructions compute the reflected form of the same
+ * polynomial, so state and data are bit reversed around them.
+ */
+static inline uint32_t Crc32Rbit(uint32_t x)
+{
+    __asm__("rbit %w0, %w1" : "=r"(x) : "r"(x));
+    return x;
+}
+
+static inline uint64_t Crc32Rbit64(uint64_t x)
+{
+    __asm__("rbit %x0, %x1" : "=r"(x) : "r"(x));
+    return x;
+}
+
+__attribute__((target("+crc")))
+static inline uint32_t Crc32WordArm(const uint32_t* ptr, uint32_t len, uint32_t crc = UT_CRC32_INIT)
+{
+    uint32_t c = Crc32Rbit(crc);
+
+    uint32_t i = 0;
+    for (; i + 2 <= len; i += 2)
+    {
+        uint64_t v;
+        memcpy(&v, ptr + i, sizeof(v));
+
+        /*
+         * low half is the first word on little endian.
+         */
+        v = Crc32Rbit64(v);
+        c = __crc32d(c, (v >> 32) | (v << 32));
+    }
+
+    if (i < len)
+    {
+        c = __crc32w(c, Crc32Rbit(ptr[i]));
+    }
+
+    return Crc32Rbit(c);
+}
+#endif
+
+/*
+ * a * b mod P. the crc is linear, so changing words of a message changes
+ * its crc by Crc32MulMod(crc of the xor delta with init 0, x^(32 * words after)).
+ */
+static inline uint32_t Crc32MulMod(uint32_t a, uint32_t b)
+{
+    /*
+     * carry-less a * b four bits at a time, then reduce the high word
+     * with the tables.
+     */
+    uint64_t m[16];
+    m[0] = 0;
+    for (uint32_t i=1; i<16; i++)
+    {
+        m[i] = (i & 1) ? (m[i-1] ^ b) : (m[i>>1] << 1);
+    }
+
+    uint64_t p = 0;
+    for (int32_t i=28; i>=0; i-=4)
+    {
+        p = (p << 4) ^ m[(a >> i) & 0xF];
+    }
+
+    const Crc32TableType& t = Crc32Table::mTable;
+    uint32_t h = (uint32_t)(p >> 32);
+
+    return (uint32_t)p ^ t[3][h >> 24] ^ t[2][(h >> 16) & 0xFF] ^ t[1][(h >> 8) & 0xFF] ^ t[0][h & 0xFF];
+}
+
+typedef uint32_t (*Crc32WordFunc)(const uint32_t*, uint32_t, uint32_t);
+
+static inline Crc32WordFunc GetCrc32WordFunc()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("pclmul"))
+    {
+        return Crc32WordClmul;
+    }
+#elif defined(__aarch64__)
+    if (getauxval(AT_HWCAP) & HWCAP_CRC32)
+    {
+        return Crc32WordArm;
+    }
+#endif
+
+    return Crc32WordTable;
+}
+
+/*
+ * the back end Crc32Word dispatches to, detected once.
+ */
+static inline Crc32WordFunc GetCrc32Word()
+{
+    static const Crc32WordFunc func = GetCrc32WordFunc();
+    return func;
+}
+
+/*
+ * crc of len words. bit-identical to the crc32_core of the low level
+ * examples, and crc may carry the result of the preceding words.
+ */
+static inline uint32_t Crc32Word(const uint32_t* ptr, uint32_t len, uint32_t crc = UT_CRC32_INIT)
+{
+    return GetCrc32Word()(ptr, len, crc);
+}
+
+}
+}
+
+#endif//__UT_CRC32_HPP__
@@ -4,6 +4,7 @@
 #include <dds/dds.hpp>
 #include <unitree/common/log/log.hpp>
 #include <unitree/common/block_queue.hpp>
+#include <unitree/common/ring_block_queue.hpp>
 #include <unitree/common/thread/thread.hpp>
 #include <unitree/common/time/time_tool.hpp>
 #include <unitree/common/time/sleep.hpp>
@@ -216,14 +217,66 @@ using DdsWriterPtr = std::shared_ptr<DdsWriter<MSG>>;
 
 
 /*
- * @brief: DdsReaderListener
+ * @brief: DdsBlockQueuePolicy
+ * queue policy of DdsReaderListener. Copy makes the queued copy of a
+ * sample, Take waits for queued messages and appends them to dataList.
  */
 template<typename MSG>
+class DdsBlockQueuePolicy
+{
+public:
+    using MSG_PTR = std::shared_ptr<MSG>;
+    using QUEUE_TYPE = BlockQueue<MSG_PTR>;
+
+    static MSG_PTR Copy(const MSG& m)
+    {
+        return MSG_PTR(new MSG(m));
+    }
+
+    static void Take(QUEUE_TYPE& queue, std::vector<MSG_PTR>& dataList)
+    {
+        MSG_PTR dataPtr;
+        if (queue.Get(dataPtr))
+        {
+            dataList.push_back(std::move(dataPtr));
+        }
+    }
+};
+
+/*
+ * @brief: DdsRingQueuePolicy
+ * RingBlockQueue policy. a sample is copied into one make_shared
+ * allocation and every queued message is taken under one lock.
+ */
+template<typename MSG>
+class DdsRingQueuePolicy
+{
+public:
+    using MSG_PTR = std::shared_ptr<MSG>;
+    using QUEUE_TYPE = RingBlockQueue<MSG_PTR>;
+
+    static MSG_PTR Copy(const MSG& m)
+    {
+        return std::make_shared<MSG>(m);
+    }
+
+    static void Take(QUEUE_TYPE& queue, std::vector<MSG_PTR>& dataList)
+    {
+        queue.GetAll(dataList);
+    }
+};
+
+
+/*
+ * @brief: DdsReaderListener
+ */
+template<typename MSG, typename QUEUE_POLICY = DdsBlockQueuePolicy<MSG>>
 class DdsReaderListener : public ::dds::sub::NoOpDataReaderListener<MSG>, DdsLogger
 {
 public:
     using NATIVE_TYPE = ::dds::sub::DataReaderListener<MSG>;
     using MSG_PTR = std::shared_ptr<MSG>;
+    using QUEUE_TYPE = typename QUEUE_POLICY::QUEUE_TYPE;
 
     explicit DdsReaderListener() :
         mHasQueue(false), mQuit(false), mMask(::dds::core::status::StatusMask::none()), mLastDataAvailableTime(0)
@@ -257,7 +310,7 @@ public:
         }
 
         mHasQueue = true;
-        mDataQueuePtr.reset(new BlockQueue<MSG_PTR>(len));
+        mDataQueuePtr.reset(new QUEUE_TYPE(len));
 
         auto queueThreadFunc = [this]() {
             while (true)
@@ -271,16 +324,20 @@ public:
                     MicroSleep(__UT_DDS_WAIT_MATCHED_TIME_SLICE);
                 }
             }
+            std::vector<MSG_PTR> dataList;
             while (!mQuit)
             {
-                MSG_PTR dataPtr;
-                if (mDataQueuePtr->Get(dataPtr))
+                QUEUE_POLICY::Take(*mDataQueuePtr, dataList);
+
+                for (size_t i=0; i<dataList.size() && !mQuit; i++)
                 {
-                    if (dataPtr)
+                    if (dataList[i])
                     {
-                        mCallbackPtr->OnDataAvailable(dataPtr.get());
+                        mCallbackPtr->OnDataAvailable(dataList[i].get());
                     }
                 }
+
+                dataList.clear();
             }
             return 0;
         };
@@ -324,9 +381,10 @@ private:
 
                 if (mHasQueue)
                 {
-                    if (!mDataQueuePtr->Put(MSG_PTR(new MSG(m)), true))
+                    if (!mDataQueuePtr->Put(QUEUE_POLICY::Copy(m), true))
                     {
-                        LOG_WARNING(mLogger, "earliest mesage was evicted. type:", DdsGetTypeName(MSG));
+                        LOG_WARNING_RATE_LIMIT(mLogger, 1, "earliest mesage was evicted. type:",
+                            DdsGetTypeName(MSG));
                     }
                 }
                 else
@@ -345,18 +403,24 @@ private:
     int64_t mLastDataAvailableTime;
 
     DdsReaderCallbackPtr mCallbackPtr;
-    BlockQueuePtr<MSG_PTR> mDataQueuePtr;
+    std::shared_ptr<QUEUE_TYPE> mDataQueuePtr;
     ThreadPtr mDataQueueThreadPtr;
 };
 
+template<typename MSG, typename QUEUE_POLICY = DdsBlockQueuePolicy<MSG>>
+using DdsReaderListenerPtr = std::shared_ptr<DdsReaderListener<MSG, QUEUE_POLICY>>;
+
+template<typename MSG>
+using DdsRingReaderListener = DdsReaderListener<MSG, DdsRingQueuePolicy<MSG>>;
+
 template<typename MSG>
-using DdsReaderListenerPtr = std::shared_ptr<DdsReaderListener<MSG>>;
+using DdsRingReaderListenerPtr = std::shared_ptr<DdsRingReaderListener<MSG>>;
 
 
 /*
  * @brief: DdsReader
  */
-template<typename MSG>
+template<typename MSG, typename QUEUE_POLICY = DdsBlockQueuePolicy<MSG>>
 class DdsReader : public DdsLogger
 {
 public:
@@ -399,11 +463,17 @@ public:
 
 private:
     NATIVE_TYPE mNative;
-    DdsReaderListener<MSG> mListener;
+    DdsReaderListener<MSG, QUEUE_POLICY> mListener;
 };
 
+template<typename MSG, typename QUEUE_POLICY = DdsBlockQueuePolicy<MSG>>
+using DdsReaderPtr = std::shared_ptr<DdsReader<MSG, QUEUE_POLICY>>;
+
+template<typename MSG>
+using DdsRingReader = DdsReader<MSG, DdsRingQueuePolicy<MSG>>;
+
 template<typename MSG>
-using DdsReaderPtr = std::shared_ptr<DdsReader<MSG>>;
+using DdsRingReaderPtr = std::shared_ptr<DdsRingReader<MSG>>;
 
 }
 }
@@ -59,6 +59,14 @@
 #define UT_LIKELY(x)    (x)
 #endif//__GLIBC__
 
+#if defined(__x86_64__) || defined(__i386__)
+#define UT_CPU_RELAX()  __builtin_ia32_pause()
+#elif defined(__aarch64__)
+#define UT_CPU_RELAX()  __asm__ __volatile__("yield" ::: "memory")
+#else
+#define UT_CPU_RELAX()  __asm__ __volatile__("" ::: "memory")
+#endif
+
 #define __UT_CAT(x, y)  x##y
 #define UT_CAT(x, y)    __UT_CAT(x, y)
 
@@ -0,0 +1,1125 @@
+#ifndef __UT_JSON_CBOR_HPP__
+#define __UT_JSON_CBOR_HPP__
+
+#include <unitree/common/json/json_reflect.hpp>
+#include <cfloat>
+
+namespace unitree
+{
+namespace common
+{
+/*
+ * cbor(rfc 8949) major types.
+ */
+enum
+{
+    UT_CBOR_MAJOR_UINT = 0,
+    UT_CBOR_MAJOR_NINT,
+    UT_CBOR_MAJOR_BYTES,
+    UT_CBOR_MAJOR_TEXT,
+    UT_CBOR_MAJOR_ARRAY,
+    UT_CBOR_MAJOR_MAP,
+    UT_CBOR_MAJOR_TAG,
+    UT_CBOR_MAJOR_SIMPLE
+};
+
+/*
+ * @brief: CborWriter
+ * binary counterpart of JsonWriter over the same data model. containers
+ * are written with definite lengths and doubles which are exact as float
+ * are stored in 4 bytes.
+ */
+class CborWriter
+{
+public:
+    explicit CborWriter(std::string& s) :
+        mBuffer(s)
+    {}
+
+    void StartObject(size_t count)
+    {
+        Head(UT_CBOR_MAJOR_MAP, count);
+    }
+
+    void StartArray(size_t count)
+    {
+        Head(UT_CBOR_MAJOR_ARRAY, count);
+    }
+
+    void Key(const char* name, size_t len)
+    {
+        String(name, len);
+    }
+
+    void Key(const std::string& name)
+    {
+        String(name.c_str(), name.size());
+    }
+
+    void Null()
+    {
+        mBuffer += (char)0xF6;
+    }
+
+    void Bool(bool b)
+    {
+        mBuffer += (char)(b ? 0xF5 : 0xF4);
+    }
+
+    void Int(int64_t n)
+    {
+        if (n < 0)
+        {
+            Head(UT_CBOR_MAJOR_NINT, ~(uint64_t)n);
+        }
+        else
+        {
+            Head(UT_CBOR_MAJOR_UINT, (uint64_t)n);
+        }
+    }
+
+    void Uint(uint64_t n)
+    {
+        Head(UT_CBOR_MAJOR_UINT, n);
+    }
+
+    void Float(float f)
+    {
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+
+        char buf[5];
+        buf[0] = (char)0xFA;
+        Store(buf + 1, bits, 4);
+        mBuffer.append(buf, sizeof(buf));
+    }
+
+    /*
+     * written as a float when a float holds d exactly. (float)d is
+     * undefined outside the float range, so that is checked first.
+     */
+    void Double(double d)
+    {
+        if ((std::fabs(d) <= FLT_MAX || std::isinf(d)) && (double)(float)d == d)
+        {
+            Float((float)d);
+            return;
+        }
+
+        uint64_t bits;
+        memcpy(&bits, &d, sizeof(bits));
+
+        char buf[9];
+        buf[0] = (char)0xFB;
+        Store(buf + 1, bits, 8);
+        mBuffer.append(buf, sizeof(buf));
+    }
+
+    void String(const char* s, size_t len)
+    {
+        Head(UT_CBOR_MAJOR_TEXT, len);
+        mBuffer.append(s, len);
+    }
+
+    void String(const std::string& s)
+    {
+        String(s.c_str(), s.size());
+    }
+
+    void Value(const Any& a)
+    {
+        switch (a.GetTypeTag())
+        {
+        case UT_ANY_TYPE_EMPTY:
+            Null();
+            break;
+        case UT_ANY_TYPE_BOOL:
+            Bool(AnyCast<bool>(a));
+            break;
+        case UT_ANY_TYPE_FLOAT:
+            Float(AnyCast<float>(a));
+            break;
+        case UT_ANY_TYPE_DOUBLE:
+        case UT_ANY_TYPE_LONG_DOUBLE:
+            Double(AnyNumberCast<double>(a));
+            break;
+        case UT_ANY_TYPE_UINT64:
+            Uint(AnyCast<uint64_t>(a));
+            break;
+        case UT_ANY_TYPE_STRING:
+            String(AnyCast<std::string>(a));
+            break;
+        case UT_ANY_TYPE_MAP:
+            Value(AnyCast<JsonMap>(a));
+            break;
+        case UT_ANY_TYPE_ARRAY:
+            Value(AnyCast<JsonArray>(a));
+            break;
+        case UT_ANY_TYPE_OTHER:
+            UT_THROW(JsonException, std::string("cbor unsupported any type:") +
+                a.GetTypeInfo().name());
+        default:
+            Int(AnyNumberCast<int64_t>(a));
+        }
+    }
+
+    void Value(const JsonMap& m)
+    {
+        StartObject(m.size());
+
+        JsonMap::const_iterator iter;
+        for (iter = m.begin(); iter != m.end(); ++iter)
+        {
+            Key(iter->first);
+            Value(iter->second);
+        }
+    }
+
+    void Value(const JsonArray& arr)
+    {
+        StartArray(arr.size());
+
+        for (size_t i=0; i<arr.size(); i++)
+        {
+            Value(arr[i]);
+        }
+    }
+
+private:
+    void Head(int32_t major, uint64_t n)
+    {
+        char buf[9];
+        size_t len;
+
+        if (n < 24)
+        {
+            buf[0] = (char)((major << 5) | n);
+            len = 1;
+        }
+        else if (n <= 0xFF)
+        {
+            buf[0] = (char)((major << 5) | 24);
+            Store(buf + 1, n, 1);
+            len = 2;
+        }
+        else if (n <= 0xFFFF)
+        {
+            buf[0] = (char)((major << 5) | 25);
+            Store(buf + 1, n, 2);
+            len = 3;
+        }
+        else if (n <= 0xFFFFFFFF)
+        {
+            buf[0] = (char)((major << 5) | 26);
+            Store(buf + 1, n, 4);
+            len = 5;
+        }
+        else
+        {
+            buf[0] = (char)((major << 5) | 27);
+            Store(buf + 1, n, 8);
+            len = 9;
+        }
+
+        mBuffer.append(buf, len);
+    }
+
+    /*
+     * big endian.
+     */
+    static void Store(char* p, uint64_t n, size_t size)
+    {
+        for (size_t i=0; i<size; i++)
+        {
+            p[i] = (char)(n >> ((size - 1 - i) * 8));
+        }
+    }
+
+private:
+    std::string& mBuffer;
+};
+
+/*
+ * @brief: CborReader
+ * pull reader over cbor bytes with the JsonReader shape. containers
+ * report their length on Start, keys point into the input.
+ */
+class CborReader
+{
+public:
+    CborReader(const char* begin, const char* end) :
+        mBegin((const uint8_t*)begin), mPos((const uint8_t*)begin), mEnd((const uint8_t*)end),
+        mKey(NULL), mKeySize(0)
+    {}
+
+    explicit CborReader(const std::string& s) :
+        CborReader(s.c_str(), s.c_str() + s.size())
+    {}
+
+    /*
+     * UT_JSON_TYPE_* of the next item. byte strings read as strings.
+     */
+    int32_t Peek()
+    {
+        SkipTags();
+
+        switch (*mPos >> 5)
+        {
+        case UT_CBOR_MAJOR_UINT:
+            return UT_JSON_TYPE_UINT;
+        case UT_CBOR_MAJOR_NINT:
+            return UT_JSON_TYPE_INT;
+        case UT_CBOR_MAJOR_BYTES:
+        case UT_CBOR_MAJOR_TEXT:
+            return UT_JSON_TYPE_STRING;
+        case UT_CBOR_MAJOR_ARRAY:
+            return UT_JSON_TYPE_ARRAY;
+        case UT_CBOR_MAJOR_MAP:
+            return UT_JSON_TYPE_OBJECT;
+        default:
+            break;
+        }
+
+        switch (*mPos)
+        {
+        case 0xF4:
+        case 0xF5:
+            return UT_JSON_TYPE_BOOL;
+        case 0xF6:
+        case 0xF7:
+            return UT_JSON_TYPE_NULL;
+        case 0xF9:
+        case 0xFA:
+        case 0xFB:
+            return UT_JSON_TYPE_DOUBLE;
+        default:
+            Error("unsupported simple value");
+        }
+
+        return UT_JSON_TYPE_NULL;
+    }
+
+    /*
+     * consume null or undefined and return true, or leave any other item.
+     */
+    bool ReadNull()
+    {
+        SkipTags();
+        if (*mPos == 0xF6 || *mPos == 0xF7)
+        {
+            mPos++;
+            return true;
+        }
+
+        return false;
+    }
+
+    size_t StartObject()
+    {
+        return ReadCount(UT_CBOR_MAJOR_MAP, 2, "expect map");
+    }
+
+    size_t StartArray()
+    {
+        return ReadCount(UT_CBOR_MAJOR_ARRAY, 1, "expect array");
+    }
+
+    void ReadKey()
+    {
+        SkipTags();
+        if ((*mPos >> 5) != UT_CBOR_MAJOR_TEXT)
+        {
+            Error("expect text key");
+        }
+
+        ReadBytes(mKey, mKeySize);
+    }
+
+    bool IsKey(const char* name) const
+    {
+        size_t len = strlen(name);
+        return len == mKeySize && memcmp(mKey, name, len) == 0;
+    }
+
+    bool IsKey(const std::string& name) const
+    {
+        return name.size() == mKeySize && memcmp(mKey, name.c_str(), mKeySize) == 0;
+    }
+
+    std::string GetKey() const
+    {
+        return std::string(mKey, mKeySize);
+    }
+
+    const char* GetKeyData() const
+    {
+        return mKey;
+    }
+
+    size_t GetKeySize() const
+    {
+        return mKeySize;
+    }
+
+    void ReadBool(bool& b)
+    {
+        SkipTags();
+        if (*mPos == 0xF4 || *mPos == 0xF5)
+        {
+            b = (*mPos++ == 0xF5);
+            return;
+        }
+
+        Error("expect bool");
+    }
+
+    template<typename T>
+    void ReadNumber(T& value)
+    {
+        SkipTags();
+
+        int32_t major = *mPos >> 5;
+        if (major == UT_CBOR_MAJOR_UINT)
+        {
+            value = (T)ReadHead();
+        }
+        else if (major == UT_CBOR_MAJOR_NINT)
+        {
+            value = (T)(int64_t)~ReadHead();
+        }
+        else
+        {
+            value = (T)ReadFloat();
+        }
+    }
+
+    void ReadString(std::string& s)
+    {
+        SkipTags();
+
+        int32_t major = *mPos >> 5;
+        if (major != UT_CBOR_MAJOR_TEXT && major != UT_CBOR_MAJOR_BYTES)
+        {
+            Error("expect string");
+        }
+
+        const char* p;
+        size_t len;
+        ReadBytes(p, len);
+        s.assign(p, len);
+    }
+
+    /*
+     * read one item into the Any tree used by Jsonize.
+     */
+    void ReadValue(Any& a, int32_t depth = 0)
+    {
+        switch (Peek())
+        {
+        case UT_JSON_TYPE_NULL:
+            mPos++;
+            a = Any();
+            break;
+        case UT_JSON_TYPE_BOOL:
+        {
+            bool b;
+            ReadBool(b);
+            a = b;
+            break;
+        }
+        case UT_JSON_TYPE_UINT:
+        {
+            uint64_t n = ReadHead();
+            if (n <= (uint64_t)INT32_MAX)
+            {
+                a = (int32_t)n;
+            }
+            else if (n <= (uint64_t)INT64_MAX)
+            {
+                a = (int64_t)n;
+            }
+            else
+            {
+                a = n;
+            }
+            break;
+        }
+        case UT_JSON_TYPE_INT:
+        {
+            int64_t n = (int64_t)~ReadHead();
+            if (n >= INT32_MIN)
+            {
+                a = (int32_t)n;
+            }
+            else
+            {
+                a = n;
+            }
+            break;
+        }
+        case UT_JSON_TYPE_DOUBLE:
+            a = ReadFloat();
+            break;
+        case UT_JSON_TYPE_STRING:
+        {
+            std::string s;
+            ReadString(s);
+            a = std::move(s);
+            break;
+        }
+        case UT_JSON_TYPE_ARRAY:
+        {
+            Enter(depth);
+            a = JsonArray();
+            JsonArray& arr = ((Any::Holder<JsonArray>*)a.mContent)->mValue;
+            arr.resize(StartArray());
+
+            for (size_t i=0; i<arr.size(); i++)
+            {
+                ReadValue(arr[i], depth + 1);
+            }
+            break;
+        }
+        case UT_JSON_TYPE_OBJECT:
+        {
+            Enter(depth);
+            a = JsonMap();
+            JsonMap& m = ((Any::Holder<JsonMap>*)a.mContent)->mValue;
+            size_t count = StartObject();
+
+            for (size_t i=0; i<count; i++)
+            {
+                ReadKey();
+                ReadValue(m[GetKey()], depth + 1);
+            }
+            break;
+        }
+        }
+    }
+
+    void Skip(int32_t depth = 0)
+    {
+        SkipTags();
+
+        int32_t major = *mPos >> 5;
+        switch (major)
+        {
+        case UT_CBOR_MAJOR_UINT:
+        case UT_CBOR_MAJOR_NINT:
+            ReadHead();
+            break;
+        case UT_CBOR_MAJOR_BYTES:
+        case UT_CBOR_MAJOR_TEXT:
+        {
+            const char* p;
+            size_t len;
+            ReadBytes(p, len);
+            break;
+        }
+        case UT_CBOR_MAJOR_ARRAY:
+        case UT_CBOR_MAJOR_MAP:
+        {
+            Enter(depth);
+            size_t count = (major == UT_CBOR_MAJOR_MAP) ? StartObject() * 2 : StartArray();
+            for (size_t i=0; i<count; i++)
+            {
+                Skip(depth + 1);
+            }
+            break;
+        }
+        default:
+            if (Peek() == UT_JSON_TYPE_DOUBLE)
+            {
+                ReadFloat();
+            }
+            else
+            {
+                mPos++;
+            }
+        }
+    }
+
+    /*
+     * throw JsonException if bytes follow the root item.
+     */
+    void Finish()
+    {
+        if (mPos != mEnd)
+        {
+            Error("unexpected data after root item");
+        }
+    }
+
+private:
+    /*
+     * depth containers enclose the one being entered, UT_JSON_MAX_DEPTH
+     * in total as for json.
+     */
+    void Enter(int32_t depth)
+    {
+        if (depth >= UT_JSON_MAX_DEPTH)
+        {
+            Error("nesting too deep");
+        }
+    }
+
+    void Need(size_t size)
+    {
+        if ((size_t)(mEnd - mPos) < size)
+        {
+            Error("unexpected end");
+        }
+    }
+
+    void SkipTags()
+    {
+        Need(1);
+        while ((*mPos >> 5) == UT_CBOR_MAJOR_TAG)
+        {
+            ReadHead();
+            Need(1);
+        }
+    }
+
+    /*
+     * argument of the item head. indefinite lengths are not supported.
+     */
+    uint64_t ReadHead()
+    {
+        Need(1);
+
+        uint8_t info = *mPos++ & 0x1F;
+        if (info < 24)
+        {
+            return info;
+        }
+
+        size_t size;
+        switch (info)
+        {
+        case 24: size = 1; break;
+        case 25: size = 2; break;
+        case 26: size = 4; break;
+        case 27: size = 8; break;
+        default:
+            Error("unsupported item length");
+            return 0;
+        }
+
+        Need(size);
+
+        uint64_t n = 0;
+        for (size_t i=0; i<size; i++)
+        {
+            n = (n << 8) | *mPos++;
+        }
+
+        return n;
+    }
+
+    /*
+     * every item takes at least minSize bytes, which bounds the count by
+     * the input left before anything is allocated for it.
+     */
+    size_t ReadCount(int32_t major, size_t minSize, const char* message)
+    {
+        SkipTags();
+        if ((*mPos >> 5) != major)
+        {
+            Error(message);
+        }
+
+        uint64_t count = ReadHead();
+        if (count > (uint64_t)(mEnd - mPos) / minSize)
+        {
+            Error("container length exceeds input");
+        }
+
+        return (size_t)count;
+    }
+
+    void ReadBytes(const char*& p, size_t& len)
+    {
+        uint64_t n = ReadHead();
+        Need(n);
+
+        p = (const char*)mPos;
+        len = (size_t)n;
+        mPos += n;
+    }
+
+    double ReadFloat()
+    {
+        SkipTags();
+
+        uint8_t type = *mPos++;
+        if (type == 0xF9)
+        {
+            Need(2);
+            uint32_t half = ((uint32_t)mPos[0] << 8) | mPos[1];
+            mPos += 2;
+
+            uint32_t exp = (half >> 10) & 0x1F;
+            uint32_t mant = half & 0x3FF;
+
+            double d;
+            if (exp == 0)
+            {
+                d = ldexp(mant, -24);
+            }
+            else if (exp != 31)
+            {
+                d = ldexp(mant + 1024, exp - 25);
+            }
+            else
+            {
+                d = (mant == 0) ? INFINITY : NAN;
+            }
+
+            return (half & 0x8000) ? -d : d;
+        }
+        else if (type == 0xFA)
+        {
+            Need(4);
+            uint32_t bits = 0;
+            for (int32_t i=0; i<4; i++)
+            {
+                bits = (bits << 8) | *mPos++;
+            }
+
+            float f;
+            memcpy(&f, &bits, sizeof(f));
+            return f;
+        }
+        else if (type == 0xFB)
+        {
+            Need(8);
+            uint64_t bits = 0;
+            for (int32_t i=0; i<8; i++)
+            {
+                bits = (bits << 8) | *mPos++;
+            }
+
+            double d;
+            memcpy(&d, &bits, sizeof(d));
+            return d;
+        }
+
+        mPos--;
+        Error("expect number");
+
+        return 0.0;
+    }
+
+    void Error(const char* message)
+    {
+        UT_THROW(JsonException, std::string("cbor decode error. ") + message +
+            " at offset " + std::to_string(mPos - mBegin));
+    }
+
+private:
+    const uint8_t* mBegin;
+    const uint8_t* mPos;
+    const uint8_t* mEnd;
+
+    const char* mKey;
+    size_t mKeySize;
+};
+
+/*
+ * detect classes described with JN_REFLECT.
+ */
+template<typename T, typename = void>
+struct HasJsonFields : std::false_type
+{};
+
+template<typename T>
+struct HasJsonFields<T, decltype((void)T::jsonFields())> : std::true_type
+{};
+
+/*
+ * WriteCbor
+ */
+static inline void WriteCbor(CborWriter& w, const bool& value)
+{
+    w.Bool(value);
+}
+
+static inline void WriteCbor(CborWriter& w, const int8_t& value)
+{
+    w.Int(value);
+}
+
+static inline void WriteCbor(CborWriter& w, const uint8_t& value)
+{
+    w.Uint(value);
+}
+
+static inline void WriteCbor(CborWriter& w, const int16_t& value)
+{
+    w.Int(value);
+}
+
+static inline void WriteCbor(CborWriter& w, const uint16_t& value)
+{
+    w.Uint(value);
+}
+
+static inline void WriteCbor(CborWriter& w, const int32_t& value)
+{
+    w.Int(value);
+}
+
+static inline void WriteCbor(CborWriter& w, const uint32_t& value)
+{
+    w.Uint(value);
+}
+
+static inline void WriteCbor(CborWriter& w, const int64_t& value)
+{
+    w.Int(value);
+}
+
+static inline void WriteCbor(CborWriter& w, const uint64_t& value)
+{
+    w.Uint(value);
+}
+
+static inline void WriteCbor(CborWriter& w, const float& value)
+{
+    w.Float(value);
+}
+
+static inline void WriteCbor(CborWriter& w, const double& value)
+{
+    w.Double(value);
+}
+
+static inline void WriteCbor(CborWriter& w, const std::string& value)
+{
+    w.String(value);
+}
+
+static inline void WriteCbor(CborWriter& w, const Any& value)
+{
+    w.Value(value);
+}
+
+static inline void WriteCbor(CborWriter& w, const JsonMap& value)
+{
+    w.Value(value);
+}
+
+static inline void WriteCbor(CborWriter& w, const JsonArray& value)
+{
+    w.Value(value);
+}
+
+template<typename T>
+void WriteCbor(CborWriter& w, const T& value);
+
+template<typename E>
+void WriteCbor(CborWriter& w, const std::vector<E>& value)
+{
+    w.StartArray(value.size());
+
+    size_t i, count = value.size();
+    for (i=0; i<count; i++)
+    {
+        WriteCbor(w, value[i]);
+    }
+}
+
+template<typename E>
+void WriteCbor(CborWriter& w, const std::list<E>& value)
+{
+    w.StartArray(value.size());
+
+    typename std::list<E>::const_iterator iter;
+    for (iter = value.begin(); iter != value.end(); ++iter)
+    {
+        WriteCbor(w, *iter);
+    }
+}
+
+template<typename E>
+void WriteCbor(CborWriter& w, const std::set<E>& value)
+{
+    w.StartArray(value.size());
+
+    typename std::set<E>::const_iterator iter;
+    for (iter = value.begin(); iter != value.end(); ++iter)
+    {
+        WriteCbor(w, *iter);
+    }
+}
+
+template<typename E>
+void WriteCbor(CborWriter& w, const std::map<std::string,E>& value)
+{
+    w.StartObject(value.size());
+
+    typename std::map<std::string,E>::const_iterator iter;
+    for (iter = value.begin(); iter != value.end(); ++iter)
+    {
+        w.Key(iter->first);
+        WriteCbor(w, iter->second);
+    }
+}
+
+/*
+ * reflected classes write their fields, other Jsonize types go through
+ * the Any tree.
+ */
+template<typename T>
+void WriteCbor(CborWriter& w, const T& value)
+{
+    if constexpr (HasJsonFields<T>::value)
+    {
+        w.StartObject(JsonFieldTable<T>::SIZE);
+
+        ForEachJsonField(value, [&w](const char* name, size_t size, const auto& field)
+        {
+            w.Key(name, size);
+            WriteCbor(w, field);
+        });
+    }
+    else
+    {
+        Any a;
+        ToJson<T>(value, a);
+        w.Value(a);
+    }
+}
+
+/*
+ * ReadCbor
+ * a null leaves the value unchanged, as ReadJson does.
+ */
+template<typename T>
+void ReadCborNumber(CborReader& r, T& value)
+{
+    if (!r.ReadNull())
+    {
+        r.ReadNumber(value);
+    }
+}
+
+static inline void ReadCbor(CborReader& r, bool& value)
+{
+    if (!r.ReadNull())
+    {
+        r.ReadBool(value);
+    }
+}
+
+static inline void ReadCbor(CborReader& r, int8_t& value)
+{
+    ReadCborNumber(r, value);
+}
+
+static inline void ReadCbor(CborReader& r, uint8_t& value)
+{
+    ReadCborNumber(r, value);
+}
+
+static inline void ReadCbor(CborReader& r, int16_t& value)
+{
+    ReadCborNumber(r, value);
+}
+
+static inline void ReadCbor(CborReader& r, uint16_t& value)
+{
+    ReadCborNumber(r, value);
+}
+
+static inline void ReadCbor(CborReader& r, int32_t& value)
+{
+    ReadCborNumber(r, value);
+}
+
+static inline void ReadCbor(CborReader& r, uint32_t& value)
+{
+    ReadCborNumber(r, value);
+}
+
+static inline void ReadCbor(CborReader& r, int64_t& value)
+{
+    ReadCborNumber(r, value);
+}
+
+static inline void ReadCbor(CborReader& r, uint64_t& value)
+{
+    ReadCborNumber(r, value);
+}
+
+static inline void ReadCbor(CborReader& r, float& value)
+{
+    ReadCborNumber(r, value);
+}
+
+static inline void ReadCbor(CborReader& r, double& value)
+{
+    ReadCborNumber(r, value);
+}
+
+static inline void ReadCbor(CborReader& r, std::string& value)
+{
+    if (!r.ReadNull())
+    {
+        r.ReadString(value);
+    }
+}
+
+static inline void ReadCbor(CborReader& r, Any& value)
+{
+    r.ReadValue(value);
+}
+
+template<typename T>
+void ReadCbor(CborReader& r, T& value);
+
+template<typename E>
+void ReadCbor(CborReader& r, std::vector<E>& value)
+{
+    if (r.ReadNull())
+    {
+        return;
+    }
+
+    size_t count = r.StartArray();
+    value.reserve(value.size() + count);
+
+    for (size_t i=0; i<count; i++)
+    {
+        value.emplace_back();
+        ReadCbor(r, value.back());
+    }
+}
+
+template<typename E>
+void ReadCbor(CborReader& r, std::list<E>& value)
+{
+    if (r.ReadNull())
+    {
+        return;
+    }
+
+    size_t count = r.StartArray();
+    for (size_t i=0; i<count; i++)
+    {
+        value.emplace_back();
+        ReadCbor(r, value.back());
+    }
+}
+
+template<typename E>
+void ReadCbor(CborReader& r, std::set<E>& value)
+{
+    if (r.ReadNull())
+    {
+        return;
+    }
+
+    size_t count = r.StartArray();
+    for (size_t i=0; i<count; i++)
+    {
+        E e;
+        ReadCbor(r, e);
+        value.insert(std::move(e));
+    }
+}
+
+template<typename E>
+void ReadCbor(CborReader& r, std::map<std::string,E>& value)
+{
+    if (r.ReadNull())
+    {
+        return;
+    }
+
+    size_t count = r.StartObject();
+    for (size_t i=0; i<count; i++)
+    {
+        r.ReadKey();
+        ReadCbor(r, value[r.GetKey()]);
+    }
+}
+
+template<typename T>
+void ReadCbor(CborReader& r, T& value)
+{
+    if constexpr (HasJsonFields<T>::value)
+    {
+        typedef JsonFieldTable<T> Table;
+
+        if (r.ReadNull())
+        {
+            return;
+        }
+
+        size_t count = r.StartObject();
+        size_t next = 0;
+
+        for (size_t i=0; i<count; i++)
+        {
+            r.ReadKey();
+
+            int32_t index = Table::Find(r.GetKeyData(), r.GetKeySize(), next);
+            if (index < 0)
+            {
+                r.Skip();
+                continue;
+            }
+
+            VisitJsonField(value, index, [&r](auto& field)
+            {
+                ReadCbor(r, field);
+            },
+            std::make_index_sequence<Table::SIZE>());
+
+            next = Table::Next(index);
+        }
+    }
+    else
+    {
+        Any a;
+        r.ReadValue(a);
+        FromJson<T>(a, value);
+    }
+}
+
+/*
+ * encode t as cbor into s, reusing the capacity of s.
+ */
+template<typename T>
+void ToCborString(const T& t, std::string& s)
+{
+    s.clear();
+    CborWriter w(s);
+    WriteCbor(w, t);
+}
+
+template<typename T>
+std::string ToCborString(const T& t)
+{
+    std::string s;
+    ToCborString(t, s);
+    return s;
+}
+
+/*
+ * fill t from cbor bytes. throw JsonException on malformed input.
+ */
+template<typename T>
+void FromCborString(const std::string& s, T& t)
+{
+    CborReader r(s);
+    ReadCbor(r, t);
+    r.Finish();
+}
+
+}
+}
+
+#endif//__UT_JSON_CBOR_HPP__
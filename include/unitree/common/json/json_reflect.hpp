@@ -0,0 +1,353 @@
+#ifndef __UT_JSON_REFLECT_HPP__
+#define __UT_JSON_REFLECT_HPP__
+
+#include <unitree/common/json/json_stream.hpp>
+#include <array>
+#include <tuple>
+
+/*
+ * describe the json fields of a class once, inside its public section:
+ *
+ *   JN_REFLECT(ServiceSwitchParameter,
+ *       JN_FIELD("name", name),
+ *       JN_FIELD("switch", swit))
+ *
+ * generates jsonFields(), toJson/fromJson for the Jsonize interface,
+ * writeJson/readJson for the stream path, and operator==/!=.
+ */
+#define JN_FIELD(name, member) \
+    unitree::common::MakeJsonField(name, &__UtJsonSelf::member)
+
+#define JN_REFLECT(Class, ...)                                          \
+    static constexpr auto jsonFields()                                  \
+    {                                                                   \
+        typedef Class __UtJsonSelf;                                     \
+        return std::make_tuple(__VA_ARGS__);                            \
+    }                                                                   \
+                                                                        \
+    void toJson(unitree::common::JsonMap& json) const                   \
+    {                                                                   \
+        unitree::common::ToJsonFields(*this, json);                     \
+    }                                                                   \
+                                                                        \
+    void fromJson(unitree::common::JsonMap& json)                       \
+    {                                                                   \
+        unitree::common::FromJsonFields(json, *this);                   \
+    }                                                                   \
+                                                                        \
+    void writeJson(unitree::common::JsonWriter& w) const                \
+    {                                                                   \
+        unitree::common::WriteJsonFields(w, *this);                     \
+    }                                                                   \
+                                                                        \
+    void readJson(unitree::common::JsonReader& r)                       \
+    {                                                                   \
+        unitree::common::ReadJsonFields(r, *this);                      \
+    }                                                                   \
+                                                                        \
+    bool operator==(const Class& other) const                           \
+    {                                                                   \
+        return unitree::common::EqualJsonFields(*this, other);          \
+    }                                                                   \
+                                                                        \
+    bool operator!=(const Class& other) const                           \
+    {                                                                   \
+        return !unitree::common::EqualJsonFields(*this, other);         \
+    }
+
+namespace unitree
+{
+namespace common
+{
+/*
+ * @brief: JsonField
+ * json name and member pointer of one reflected field.
+ */
+template<typename C, typename T>
+class JsonField
+{
+public:
+    typedef T Type;
+
+    const char* mName;
+    size_t mSize;
+    T C::* mMember;
+};
+
+template<typename C, typename T, size_t N>
+constexpr JsonField<C,T> MakeJsonField(const char (&name)[N], T C::* member)
+{
+    return JsonField<C,T>{name, N - 1, member};
+}
+
+class JsonFieldKey
+{
+public:
+    const char* mName;
+    size_t mSize;
+    size_t mIndex;
+};
+
+/*
+ * @brief: JsonFieldTable
+ * field keys of a reflected class sorted at compile time in the order of
+ * JsonMap keys, which is also the order the writers emit them, so the
+ * stream output matches ToJsonString byte for byte. Find tries the
+ * expected field first, since input usually comes in that order, then
+ * binary searches.
+ */
+template<typename C>
+class JsonFieldTable
+{
+public:
+    typedef decltype(C::jsonFields()) Fields;
+
+    static constexpr size_t SIZE = std::tuple_size<Fields>::value;
+
+    static int32_t Find(const char* key, size_t len, size_t hint = 0)
+    {
+        if (hint < SIZE && Compare(mKeys[hint], key, len) == 0)
+        {
+            return (int32_t)hint;
+        }
+
+        size_t low = 0, high = SIZE;
+        while (low < high)
+        {
+            size_t mid = (low + high) / 2;
+            const JsonFieldKey& k = mSorted[mid];
+
+            int32_t c = Compare(k, key, len);
+            if (c == 0)
+            {
+                return (int32_t)k.mIndex;
+            }
+            else if (c < 0)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+
+        return -1;
+    }
+
+    /*
+     * index of the field at position pos in write order.
+     */
+    static constexpr size_t GetIndex(size_t pos)
+    {
+        return mSorted[pos].mIndex;
+    }
+
+    /*
+     * the field written after field index, the hint for the next Find.
+     */
+    static size_t Next(size_t index)
+    {
+        return mNext[index];
+    }
+
+private:
+    /*
+     * std::string order: bytes compared unsigned, a prefix first.
+     */
+    static constexpr int32_t Compare(const JsonFieldKey& k, const char* key, size_t len)
+    {
+        size_t n = k.mSize < len ? k.mSize : len;
+        for (size_t i=0; i<n; i++)
+        {
+            if (k.mName[i] != key[i])
+            {
+                return (unsigned char)k.mName[i] < (unsigned char)key[i] ? -1 : 1;
+            }
+        }
+
+        return (k.mSize == len) ? 0 : (k.mSize < len ? -1 : 1);
+    }
+
+    template<size_t... I>
+    static constexpr std::array<JsonFieldKey,SIZE> MakeKeys(std::index_sequence<I...>)
+    {
+        constexpr Fields fields = C::jsonFields();
+        (void)fields;
+        return std::array<JsonFieldKey,SIZE>{{
+            JsonFieldKey{std::get<I>(fields).mName, std::get<I>(fields).mSize, I}...}};
+    }
+
+    static constexpr std::array<JsonFieldKey,SIZE> MakeSorted()
+    {
+        std::array<JsonFieldKey,SIZE> keys = MakeKeys(std::make_index_sequence<SIZE>());
+
+        for (size_t i=1; i<SIZE; i++)
+        {
+            JsonFieldKey k = keys[i];
+            size_t j = i;
+            while (j > 0 && Compare(k, keys[j-1].mName, keys[j-1].mSize) < 0)
+            {
+                keys[j] = keys[j-1];
+                j--;
+            }
+            keys[j] = k;
+        }
+
+        return keys;
+    }
+
+    static constexpr std::array<size_t,SIZE> MakeNext()
+    {
+        std::array<JsonFieldKey,SIZE> sorted = MakeSorted();
+        std::array<size_t,SIZE> next{};
+
+        for (size_t i=0; i<SIZE; i++)
+        {
+            next[sorted[i].mIndex] = (i + 1 < SIZE) ? sorted[i+1].mIndex : SIZE;
+        }
+
+        return next;
+    }
+
+private:
+    static constexpr std::array<JsonFieldKey,SIZE> mKeys = MakeKeys(std::make_index_sequence<SIZE>());
+    static constexpr std::array<JsonFieldKey,SIZE> mSorted = MakeSorted();
+    static constexpr std::array<size_t,SIZE> mNext = MakeNext();
+};
+
+/*
+ * call f(name, size, member) for every field in write order.
+ * C may be const, binary codecs walk a reflected class the same way.
+ */
+template<typename C, typename F, size_t... I>
+void ForEachJsonField(C& obj, F&& f, std::index_sequence<I...>)
+{
+    typedef typename std::remove_const<C>::type Class;
+    typedef JsonFieldTable<Class> Table;
+
+    constexpr auto fields = Class::jsonFields();
+    (void)fields;
+    (void)std::initializer_list<int>{
+        (f(std::get<Table::GetIndex(I)>(fields).mName, std::get<Table::GetIndex(I)>(fields).mSize,
+            obj.*(std::get<Table::GetIndex(I)>(fields).mMember)), 0)...};
+}
+
+template<typename C, typename F>
+void ForEachJsonField(C& obj, F&& f)
+{
+    typedef typename std::remove_const<C>::type Class;
+    ForEachJsonField(obj, f, std::make_index_sequence<JsonFieldTable<Class>::SIZE>());
+}
+
+template<typename C>
+void ToJsonFields(const C& obj, JsonMap& json)
+{
+    ForEachJsonField(obj, [&json](const char* name, size_t size, const auto& value)
+    {
+        ToJson(value, json[std::string(name, size)]);
+    });
+}
+
+template<typename C>
+void WriteJsonFields(JsonWriter& w, const C& obj)
+{
+    w.StartObject();
+
+    ForEachJsonField(obj, [&w](const char* name, size_t size, const auto& value)
+    {
+        w.Key(name, size);
+        WriteJson(w, value);
+    });
+
+    w.EndObject();
+}
+
+/*
+ * dispatch a field index found at runtime to its typed member.
+ */
+template<typename C, typename F, size_t... I>
+void VisitJsonField(C& obj, size_t index, F&& f, std::index_sequence<I...>)
+{
+    constexpr auto fields = C::jsonFields();
+    (void)fields;
+    (void)std::initializer_list<int>{
+        (index == I ? (f(obj.*(std::get<I>(fields).mMember)), 0) : 0)...};
+}
+
+/*
+ * members missing from json are left unchanged, like JN_FROM_WEAK.
+ */
+template<typename C>
+void FromJsonFields(JsonMap& json, C& obj)
+{
+    typedef JsonFieldTable<C> Table;
+
+    JsonMap::const_iterator iter;
+    for (iter = json.begin(); iter != json.end(); ++iter)
+    {
+        int32_t index = Table::Find(iter->first.c_str(), iter->first.size());
+        if (index < 0)
+        {
+            continue;
+        }
+
+        const Any& a = iter->second;
+        VisitJsonField(obj, index, [&a](auto& value)
+        {
+            FromJson(a, value);
+        },
+        std::make_index_sequence<Table::SIZE>());
+    }
+}
+
+template<typename C>
+void ReadJsonFields(JsonReader& r, C& obj)
+{
+    typedef JsonFieldTable<C> Table;
+
+    r.StartObject();
+
+    size_t next = 0;
+    while (r.NextMember())
+    {
+        int32_t index = Table::Find(r.GetKeyData(), r.GetKeySize(), next);
+        if (index < 0)
+        {
+            r.Skip();
+            continue;
+        }
+
+        VisitJsonField(obj, index, [&r](auto& value)
+        {
+            ReadJson(r, value);
+        },
+        std::make_index_sequence<Table::SIZE>());
+
+        next = Table::Next(index);
+    }
+}
+
+template<typename C, size_t... I>
+bool EqualJsonFields(const C& a, const C& b, std::index_sequence<I...>)
+{
+    constexpr auto fields = C::jsonFields();
+    (void)fields;
+
+    bool equal = true;
+    (void)std::initializer_list<int>{
+        (equal = equal && (a.*(std::get<I>(fields).mMember) == b.*(std::get<I>(fields).mMember)), 0)...};
+
+    return equal;
+}
+
+template<typename C>
+bool EqualJsonFields(const C& a, const C& b)
+{
+    return EqualJsonFields(a, b, std::make_index_sequence<JsonFieldTable<C>::SIZE>());
+}
+
+}
+}
+
+#endif//__UT_JSON_REFLECT_HPP__
@@ -0,0 +1,1321 @@
+#ifndef __UT_JSON_STREAM_HPP__
+#define __UT_JSON_STREAM_HPP__
+
+#include <unitree/common/json/jsonize.hpp>
+#include <unitree/common/json/json_value.hpp>
+
+/*
+ * write/read one member inside writeJson/readJson of a Jsonize type.
+ * JN_READ continues the NextMember loop when the key matches.
+ */
+#define JN_WRITE(w, name, value) \
+    w.Key(name); unitree::common::WriteJson(w, value)
+
+#define JN_READ(r, name, value) \
+    if (r.IsKey(name)) { unitree::common::ReadJson(r, value); continue; }
+
+namespace unitree
+{
+namespace common
+{
+/*
+ * @brief: JsonWriter
+ * appends compact json to a caller owned buffer, so the buffer capacity is
+ * reused across messages. separators are tracked by the writer.
+ */
+class JsonWriter
+{
+public:
+    explicit JsonWriter(std::string& s) :
+        mBuffer(s), mComma(false)
+    {}
+
+    void StartObject()
+    {
+        Separate();
+        mBuffer += '{';
+        mComma = false;
+    }
+
+    void EndObject()
+    {
+        mBuffer += '}';
+        mComma = true;
+    }
+
+    void StartArray()
+    {
+        Separate();
+        mBuffer += '[';
+        mComma = false;
+    }
+
+    void EndArray()
+    {
+        mBuffer += ']';
+        mComma = true;
+    }
+
+    void Key(const char* name)
+    {
+        Key(name, strlen(name));
+    }
+
+    void Key(const std::string& name)
+    {
+        Key(name.c_str(), name.size());
+    }
+
+    void Key(const char* name, size_t len)
+    {
+        Separate();
+        JsonDocument::WriteString(name, len, mBuffer);
+        mBuffer += ':';
+        mComma = false;
+    }
+
+    void Null()
+    {
+        Separate();
+        mBuffer += "null";
+        mComma = true;
+    }
+
+    void Bool(bool b)
+    {
+        Separate();
+        mBuffer += b ? "true" : "false";
+        mComma = true;
+    }
+
+    void Int(int64_t n)
+    {
+        Separate();
+        if (n < 0)
+        {
+            mBuffer += '-';
+            AppendUint(0 - (uint64_t)n);
+        }
+        else
+        {
+            AppendUint((uint64_t)n);
+        }
+        mComma = true;
+    }
+
+    void Uint(uint64_t n)
+    {
+        Separate();
+        AppendUint(n);
+        mComma = true;
+    }
+
+    /*
+     * shortest of %.7g/%.9g which reads back the same float.
+     */
+    void Float(float f)
+    {
+        if (!std::isfinite(f))
+        {
+            Null();
+            return;
+        }
+
+        Separate();
+
+        char buf[32];
+        int32_t len = snprintf(buf, sizeof(buf), "%.7g", f);
+        if (strtof(buf, NULL) != f)
+        {
+            len = snprintf(buf, sizeof(buf), "%.9g", f);
+        }
+
+        mBuffer.append(buf, len);
+        if (strpbrk(buf, ".eEn") == NULL)
+        {
+            mBuffer += ".0";
+        }
+
+        mComma = true;
+    }
+
+    void Double(double d)
+    {
+        Separate();
+        JsonDocument::WriteDouble(d, mBuffer);
+        mComma = true;
+    }
+
+    void String(const char* s, size_t len)
+    {
+        Separate();
+        JsonDocument::WriteString(s, len, mBuffer);
+        mComma = true;
+    }
+
+    void String(const std::string& s)
+    {
+        String(s.c_str(), s.size());
+    }
+
+    /*
+     * write a JsonMap/JsonArray tree or any scalar held by Jsonize.
+     */
+    void Value(const Any& a)
+    {
+        const std::type_info& t = a.GetTypeInfo();
+
+        if (a.Empty())
+        {
+            Null();
+        }
+        else if (t == typeid(JsonMap))
+        {
+            Value(AnyCast<JsonMap>(a));
+        }
+        else if (t == typeid(JsonArray))
+        {
+            Value(AnyCast<JsonArray>(a));
+        }
+        else if (t == typeid(std::string))
+        {
+            String(AnyCast<std::string>(a));
+        }
+        else if (t == typeid(bool))
+        {
+            Bool(AnyCast<bool>(a));
+        }
+        else if (IsFloatType(t))
+        {
+            Float(AnyCast<float>(a));
+        }
+        else if (IsDoubleType(t) || IsLongDoubleType(t))
+        {
+            Double(AnyNumberCast<double>(a));
+        }
+        else if (IsUint64Type(t))
+        {
+            Uint(AnyCast<uint64_t>(a));
+        }
+        else if (IsIntegerType(t))
+        {
+            Int(AnyNumberCast<int64_t>(a));
+        }
+        else
+        {
+            UT_THROW(JsonException, std::string("json unsupported any type:") + t.name());
+        }
+    }
+
+    void Value(const JsonMap& m)
+    {
+        StartObject();
+
+        JsonMap::const_iterator iter;
+        for (iter = m.begin(); iter != m.end(); ++iter)
+        {
+            Key(iter->first);
+            Value(iter->second);
+        }
+
+        EndObject();
+    }
+
+    void Value(const JsonArray& arr)
+    {
+        StartArray();
+
+        for (size_t i=0; i<arr.size(); i++)
+        {
+            Value(arr[i]);
+        }
+
+        EndArray();
+    }
+
+    std::string& GetBuffer()
+    {
+        return mBuffer;
+    }
+
+private:
+    void Separate()
+    {
+        if (mComma)
+        {
+            mBuffer += ',';
+        }
+    }
+
+    void AppendUint(uint64_t n)
+    {
+        char buf[24];
+        char* p = buf + sizeof(buf);
+
+        do
+        {
+            *--p = (char)('0' + n % 10);
+            n /= 10;
+        }
+        while (n > 0);
+
+        mBuffer.append(p, buf + sizeof(buf) - p);
+    }
+
+private:
+    std::string& mBuffer;
+    bool mComma;
+};
+
+/*
+ * @brief: JsonReader
+ * pull reader over json text. containers are walked with
+ * StartObject/NextMember and StartArray/NextItem, and values are read
+ * straight into typed fields. keys without escapes point into the input.
+ */
+class JsonReader
+{
+public:
+    JsonReader(const char* begin, const char* end) :
+        mBegin(begin), mPos(begin), mEnd(end), mFirst(false), mDepth(0),
+        mKey(NULL), mKeySize(0)
+    {}
+
+    explicit JsonReader(const std::string& s) :
+        JsonReader(s.c_str(), s.c_str() + s.size())
+    {}
+
+    /*
+     * type of the next value. numbers are reported as UT_JSON_TYPE_DOUBLE.
+     */
+    int32_t Peek()
+    {
+        SkipSpace();
+        if (mPos >= mEnd)
+        {
+            Error("unexpected end");
+        }
+
+        switch (*mPos)
+        {
+        case '{':
+            return UT_JSON_TYPE_OBJECT;
+        case '[':
+            return UT_JSON_TYPE_ARRAY;
+        case '"':
+            return UT_JSON_TYPE_STRING;
+        case 't':
+        case 'f':
+            return UT_JSON_TYPE_BOOL;
+        case 'n':
+            return UT_JSON_TYPE_NULL;
+        default:
+            return UT_JSON_TYPE_DOUBLE;
+        }
+    }
+
+    /*
+     * consume a null and return true, or leave any other value.
+     */
+    bool ReadNull()
+    {
+        SkipSpace();
+        if (mPos < mEnd && *mPos == 'n')
+        {
+            Expect("null");
+            return true;
+        }
+
+        return false;
+    }
+
+    void StartObject()
+    {
+        SkipSpace();
+        ExpectChar('{', "expect '{'");
+        Enter();
+    }
+
+    /*
+     * move to the next member and read its key. return false after '}'.
+     * every member value must be read or skipped before the next call.
+     */
+    bool NextMember()
+    {
+        if (!Next('}', "expect ',' or '}'"))
+        {
+            return false;
+        }
+
+        ReadKey();
+
+        SkipSpace();
+        ExpectChar(':', "expect ':'");
+
+        return true;
+    }
+
+    void StartArray()
+    {
+        SkipSpace();
+        ExpectChar('[', "expect '['");
+        Enter();
+    }
+
+    /*
+     * return false after ']'.
+     */
+    bool NextItem()
+    {
+        return Next(']', "expect ',' or ']'");
+    }
+
+    bool IsKey(const char* name) const
+    {
+        size_t len = strlen(name);
+        return len == mKeySize && memcmp(mKey, name, len) == 0;
+    }
+
+    bool IsKey(const std::string& name) const
+    {
+        return name.size() == mKeySize && memcmp(mKey, name.c_str(), mKeySize) == 0;
+    }
+
+    std::string GetKey() const
+    {
+        return std::string(mKey, mKeySize);
+    }
+
+    const char* GetKeyData() const
+    {
+        return mKey;
+    }
+
+    size_t GetKeySize() const
+    {
+        return mKeySize;
+    }
+
+    void ReadBool(bool& b)
+    {
+        SkipSpace();
+        if (mPos < mEnd && *mPos == 't')
+        {
+            Expect("true");
+            b = true;
+        }
+        else if (mPos < mEnd && *mPos == 'f')
+        {
+            Expect("false");
+            b = false;
+        }
+        else
+        {
+            Error("expect bool");
+        }
+    }
+
+    /*
+     * read any json number into an arithmetic field.
+     */
+    template<typename T>
+    void ReadNumber(T& value)
+    {
+        int64_t i = 0;
+        uint64_t u = 0;
+        double d = 0.0;
+
+        switch (ParseNumber(i, u, d))
+        {
+        case UT_JSON_TYPE_INT:
+            value = (T)i;
+            break;
+        case UT_JSON_TYPE_UINT:
+            value = (T)u;
+            break;
+        default:
+            value = (T)d;
+        }
+    }
+
+    /*
+     * assign into s, reusing its capacity.
+     */
+    void ReadString(std::string& s)
+    {
+        SkipSpace();
+        ExpectChar('"', "expect string");
+
+        const char* begin = ScanString();
+        if (*mPos == '"')
+        {
+            s.assign(begin, mPos - begin);
+            mPos++;
+            return;
+        }
+
+        s.assign(begin, mPos - begin);
+        ParseEscaped(s);
+    }
+
+    /*
+     * skip one value of any type.
+     */
+    void Skip()
+    {
+        switch (Peek())
+        {
+        case UT_JSON_TYPE_OBJECT:
+            StartObject();
+            while (NextMember())
+            {
+                Skip();
+            }
+            break;
+        case UT_JSON_TYPE_ARRAY:
+            StartArray();
+            while (NextItem())
+            {
+                Skip();
+            }
+            break;
+        case UT_JSON_TYPE_STRING:
+            mPos++;
+            ScanString();
+            while (*mPos != '"')
+            {
+                /*
+                 * \uXXXX is checked for hex digits, not for surrogate pairs.
+                 */
+                if (mEnd - mPos < 3)
+                {
+                    Error("unterminated string");
+                }
+                if (mPos[1] == 0 || strchr("\"\\/bfnrtu", mPos[1]) == NULL)
+                {
+                    Error("invalid escape");
+                }
+                mPos += 2;
+                if (mPos[-1] == 'u')
+                {
+                    ParseHex4();
+                }
+                ScanString();
+            }
+            mPos++;
+            break;
+        case UT_JSON_TYPE_BOOL:
+            Expect(*mPos == 't' ? "true" : "false");
+            break;
+        case UT_JSON_TYPE_NULL:
+            Expect("null");
+            break;
+        default:
+        {
+            int64_t i;
+            uint64_t u;
+            double d;
+            ParseNumber(i, u, d);
+        }
+        }
+    }
+
+    /*
+     * skip one value and return the text it spans.
+     */
+    void Capture(const char*& begin, size_t& len)
+    {
+        SkipSpace();
+        begin = mPos;
+        Skip();
+        len = mPos - begin;
+    }
+
+    /*
+     * throw JsonException if anything but space follows the root value.
+     */
+    void Finish()
+    {
+        SkipSpace();
+        if (mPos != mEnd)
+        {
+            Error("unexpected data after root value");
+        }
+    }
+
+private:
+    void SkipSpace()
+    {
+        while (mPos < mEnd && (*mPos == ' ' || *mPos == '\n' || *mPos == '\r' || *mPos == '\t'))
+        {
+            mPos++;
+        }
+    }
+
+    void Enter()
+    {
+        if (++mDepth > UT_JSON_MAX_DEPTH)
+        {
+            Error("nesting too deep");
+        }
+
+        mFirst = true;
+    }
+
+    /*
+     * nested values are always consumed before the enclosing container
+     * continues, so one flag is enough to track the first element.
+     */
+    bool Next(char close, const char* message)
+    {
+        SkipSpace();
+        if (mPos < mEnd && *mPos == close)
+        {
+            mPos++;
+            mDepth--;
+            mFirst = false;
+            return false;
+        }
+
+        if (mFirst)
+        {
+            mFirst = false;
+        }
+        else
+        {
+            ExpectChar(',', message);
+            SkipSpace();
+        }
+
+        return true;
+    }
+
+    void ReadKey()
+    {
+        ExpectChar('"', "expect object key");
+
+        const char* begin = ScanString();
+        if (*mPos == '"')
+        {
+            mKey = begin;
+            mKeySize = mPos - begin;
+            mPos++;
+            return;
+        }
+
+        mKeyBuffer.assign(begin, mPos - begin);
+        ParseEscaped(mKeyBuffer);
+
+        mKey = mKeyBuffer.c_str();
+        mKeySize = mKeyBuffer.size();
+    }
+
+    /*
+     * advance to the closing quote or the first escape.
+     */
+    const char* ScanString()
+    {
+        const char* begin = mPos;
+        while (mPos < mEnd && *mPos != '"' && *mPos != '\\')
+        {
+            if ((unsigned char)*mPos < 0x20)
+            {
+                Error("control character in string");
+            }
+            mPos++;
+        }
+
+        if (mPos >= mEnd)
+        {
+            Error("unterminated string");
+        }
+
+        return begin;
+    }
+
+    /*
+     * decode from the first escape to the closing quote, appending to s.
+     */
+    void ParseEscaped(std::string& s)
+    {
+        while (true)
+        {
+            if (mPos >= mEnd)
+            {
+                Error("unterminated string");
+            }
+
+            char c = *mPos++;
+            if (c == '"')
+            {
+                break;
+            }
+            else if ((unsigned char)c < 0x20)
+            {
+                Error("control character in string");
+            }
+            else if (c != '\\')
+            {
+                s += c;
+                continue;
+            }
+
+            if (mPos >= mEnd)
+            {
+                Error("unterminated string");
+            }
+
+            c = *mPos++;
+            switch (c)
+            {
+            case '"':  s += '"';  break;
+            case '\\': s += '\\'; break;
+            case '/':  s += '/';  break;
+            case 'b':  s += '\b'; break;
+            case 'f':  s += '\f'; break;
+            case 'n':  s += '\n'; break;
+            case 'r':  s += '\r'; break;
+            case 't':  s += '\t'; break;
+            case 'u':
+                ParseUnicode(s);
+                break;
+            default:
+                Error("invalid escape");
+            }
+        }
+    }
+
+    void ParseUnicode(std::string& s)
+    {
+        uint32_t code = ParseHex4();
+
+        if (code >= 0xD800 && code <= 0xDBFF)
+        {
+            if (mEnd - mPos < 6 || mPos[0] != '\\' || mPos[1] != 'u')
+            {
+                Error("invalid surrogate pair");
+            }
+
+            mPos += 2;
+            uint32_t low = ParseHex4();
+            if (low < 0xDC00 || low > 0xDFFF)
+            {
+                Error("invalid surrogate pair");
+            }
+
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        }
+        else if (code >= 0xDC00 && code <= 0xDFFF)
+        {
+            Error("invalid surrogate pair");
+        }
+
+        if (code < 0x80)
+        {
+            s += (char)code;
+        }
+        else if (code < 0x800)
+        {
+            s += (char)(0xC0 | (code >> 6));
+            s += (char)(0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000)
+        {
+            s += (char)(0xE0 | (code >> 12));
+            s += (char)(0x80 | ((code >> 6) & 0x3F));
+            s += (char)(0x80 | (code & 0x3F));
+        }
+        else
+        {
+            s += (char)(0xF0 | (code >> 18));
+            s += (char)(0x80 | ((code >> 12) & 0x3F));
+            s += (char)(0x80 | ((code >> 6) & 0x3F));
+            s += (char)(0x80 | (code & 0x3F));
+        }
+    }
+
+    uint32_t ParseHex4()
+    {
+        if (mEnd - mPos < 4)
+        {
+            Error("invalid unicode escape");
+        }
+
+        uint32_t code = 0;
+        for (int32_t i=0; i<4; i++)
+        {
+            char c = *mPos++;
+            code <<= 4;
+
+            if (c >= '0' && c <= '9')
+            {
+                code |= c - '0';
+            }
+            else if (c >= 'a' && c <= 'f')
+            {
+                code |= c - 'a' + 10;
+            }
+            else if (c >= 'A' && c <= 'F')
+            {
+                code |= c - 'A' + 10;
+            }
+            else
+            {
+                Error("invalid unicode escape");
+            }
+        }
+
+        return code;
+    }
+
+    /*
+     * integers are accumulated directly, anything else goes to strtod
+     * from a stack copy. the grammar is checked here, as strtod also takes
+     * "012" or "1.".
+     */
+    int32_t ParseNumber(int64_t& i, uint64_t& u, double& d)
+    {
+        SkipSpace();
+
+        const char* begin = mPos;
+        bool negative = false;
+
+        if (mPos < mEnd && *mPos == '-')
+        {
+            negative = true;
+            mPos++;
+        }
+
+        if (mPos >= mEnd || *mPos < '0' || *mPos > '9')
+        {
+            Error("invalid value");
+        }
+
+        uint64_t n = 0;
+        bool overflow = false;
+
+        if (*mPos == '0')
+        {
+            mPos++;
+            if (IsDigit())
+            {
+                Error("invalid number. leading zero");
+            }
+        }
+
+        while (IsDigit())
+        {
+            uint64_t digit = *mPos - '0';
+            if (n > (UINT64_MAX - digit) / 10)
+            {
+                overflow = true;
+            }
+            n = n * 10 + digit;
+            mPos++;
+        }
+
+        bool isDouble = overflow;
+        if (mPos < mEnd && *mPos == '.')
+        {
+            isDouble = true;
+            mPos++;
+            SkipDigits();
+        }
+
+        if (mPos < mEnd && (*mPos == 'e' || *mPos == 'E'))
+        {
+            isDouble = true;
+            mPos++;
+            if (mPos < mEnd && (*mPos == '+' || *mPos == '-'))
+            {
+                mPos++;
+            }
+            SkipDigits();
+        }
+
+        if (!isDouble)
+        {
+            if (!negative)
+            {
+                if (n <= (uint64_t)INT64_MAX)
+                {
+                    i = (int64_t)n;
+                    return UT_JSON_TYPE_INT;
+                }
+
+                u = n;
+                return UT_JSON_TYPE_UINT;
+            }
+            else if (n <= (uint64_t)INT64_MAX + 1)
+            {
+                i = (int64_t)(0 - n);
+                return UT_JSON_TYPE_INT;
+            }
+        }
+
+        char buf[64];
+        size_t len = mPos - begin;
+        if (len >= sizeof(buf))
+        {
+            Error("invalid number");
+        }
+
+        memcpy(buf, begin, len);
+        buf[len] = 0;
+
+        char* end = NULL;
+        d = strtod(buf, &end);
+        if (end != buf + len)
+        {
+            Error("invalid number");
+        }
+
+        return UT_JSON_TYPE_DOUBLE;
+    }
+
+    bool IsDigit() const
+    {
+        return mPos < mEnd && *mPos >= '0' && *mPos <= '9';
+    }
+
+    /*
+     * one or more digits.
+     */
+    void SkipDigits()
+    {
+        if (!IsDigit())
+        {
+            Error("invalid number. expect digit");
+        }
+
+        while (IsDigit())
+        {
+            mPos++;
+        }
+    }
+
+    void ExpectChar(char c, const char* message)
+    {
+        if (mPos >= mEnd || *mPos != c)
+        {
+            Error(message);
+        }
+
+        mPos++;
+    }
+
+    void Expect(const char* word)
+    {
+        size_t len = strlen(word);
+        if ((size_t)(mEnd - mPos) < len || memcmp(mPos, word, len) != 0)
+        {
+            Error("invalid value");
+        }
+
+        mPos += len;
+    }
+
+    void Error(const char* message)
+    {
+        UT_THROW(JsonException, std::string("json parse error. ") + message +
+            " at offset " + std::to_string(mPos - mBegin));
+    }
+
+private:
+    const char* mBegin;
+    const char* mPos;
+    const char* mEnd;
+    bool mFirst;
+    int32_t mDepth;
+
+    const char* mKey;
+    size_t mKeySize;
+    std::string mKeyBuffer;
+};
+
+/*
+ * detect the optional streaming members of a Jsonize type:
+ *   void writeJson(JsonWriter& w) const;
+ *   void readJson(JsonReader& r);
+ * types without them go through the Any tree.
+ */
+template<typename T, typename = void>
+struct HasJsonWriter : std::false_type
+{};
+
+template<typename T>
+struct HasJsonWriter<T, decltype(std::declval<const T&>().writeJson(std::declval<JsonWriter&>()))> :
+    std::true_type
+{};
+
+template<typename T, typename = void>
+struct HasJsonReader : std::false_type
+{};
+
+template<typename T>
+struct HasJsonReader<T, decltype(std::declval<T&>().readJson(std::declval<JsonReader&>()))> :
+    std::true_type
+{};
+
+/*
+ * WriteJson
+ */
+static inline void WriteJson(JsonWriter& w, const bool& value)
+{
+    w.Bool(value);
+}
+
+static inline void WriteJson(JsonWriter& w, const int8_t& value)
+{
+    w.Int(value);
+}
+
+static inline void WriteJson(JsonWriter& w, const uint8_t& value)
+{
+    w.Uint(value);
+}
+
+static inline void WriteJson(JsonWriter& w, const int16_t& value)
+{
+    w.Int(value);
+}
+
+static inline void WriteJson(JsonWriter& w, const uint16_t& value)
+{
+    w.Uint(value);
+}
+
+static inline void WriteJson(JsonWriter& w, const int32_t& value)
+{
+    w.Int(value);
+}
+
+static inline void WriteJson(JsonWriter& w, const uint32_t& value)
+{
+    w.Uint(value);
+}
+
+static inline void WriteJson(JsonWriter& w, const int64_t& value)
+{
+    w.Int(value);
+}
+
+static inline void WriteJson(JsonWriter& w, const uint64_t& value)
+{
+    w.Uint(value);
+}
+
+static inline void WriteJson(JsonWriter& w, const float& value)
+{
+    w.Float(value);
+}
+
+static inline void WriteJson(JsonWriter& w, const double& value)
+{
+    w.Double(value);
+}
+
+static inline void WriteJson(JsonWriter& w, const std::string& value)
+{
+    w.String(value);
+}
+
+static inline void WriteJson(JsonWriter& w, const Any& value)
+{
+    w.Value(value);
+}
+
+static inline void WriteJson(JsonWriter& w, const JsonMap& value)
+{
+    w.Value(value);
+}
+
+static inline void WriteJson(JsonWriter& w, const JsonArray& value)
+{
+    w.Value(value);
+}
+
+template<typename T>
+void WriteJson(JsonWriter& w, const T& value);
+
+template<typename E>
+void WriteJson(JsonWriter& w, const std::vector<E>& value)
+{
+    w.StartArray();
+
+    size_t i, count = value.size();
+    for (i=0; i<count; i++)
+    {
+        WriteJson(w, value[i]);
+    }
+
+    w.EndArray();
+}
+
+template<typename E>
+void WriteJson(JsonWriter& w, const std::list<E>& value)
+{
+    w.StartArray();
+
+    typename std::list<E>::const_iterator iter;
+    for (iter = value.begin(); iter != value.end(); ++iter)
+    {
+        WriteJson(w, *iter);
+    }
+
+    w.EndArray();
+}
+
+template<typename E>
+void WriteJson(JsonWriter& w, const std::set<E>& value)
+{
+    w.StartArray();
+
+    typename std::set<E>::const_iterator iter;
+    for (iter = value.begin(); iter != value.end(); ++iter)
+    {
+        WriteJson(w, *iter);
+    }
+
+    w.EndArray();
+}
+
+template<typename E>
+void WriteJson(JsonWriter& w, const std::map<std::string,E>& value)
+{
+    w.StartObject();
+
+    typename std::map<std::string,E>::const_iterator iter;
+    for (iter = value.begin(); iter != value.end(); ++iter)
+    {
+        w.Key(iter->first);
+        WriteJson(w, iter->second);
+    }
+
+    w.EndObject();
+}
+
+template<typename T>
+void WriteJson(JsonWriter& w, const T& value)
+{
+    if constexpr (HasJsonWriter<T>::value)
+    {
+        value.writeJson(w);
+    }
+    else
+    {
+        Any a;
+        ToJson<T>(value, a);
+        w.Value(a);
+    }
+}
+
+/*
+ * ReadJson
+ * a null leaves the value unchanged, as FromJson does for an empty Any.
+ */
+template<typename T>
+void ReadJsonNumber(JsonReader& r, T& value)
+{
+    if (!r.ReadNull())
+    {
+        r.ReadNumber(value);
+    }
+}
+
+static inline void ReadJson(JsonReader& r, bool& value)
+{
+    if (!r.ReadNull())
+    {
+        r.ReadBool(value);
+    }
+}
+
+static inline void ReadJson(JsonReader& r, int8_t& value)
+{
+    ReadJsonNumber(r, value);
+}
+
+static inline void ReadJson(JsonReader& r, uint8_t& value)
+{
+    ReadJsonNumber(r, value);
+}
+
+static inline void ReadJson(JsonReader& r, int16_t& value)
+{
+    ReadJsonNumber(r, value);
+}
+
+static inline void ReadJson(JsonReader& r, uint16_t& value)
+{
+    ReadJsonNumber(r, value);
+}
+
+static inline void ReadJson(JsonReader& r, int32_t& value)
+{
+    ReadJsonNumber(r, value);
+}
+
+static inline void ReadJson(JsonReader& r, uint32_t& value)
+{
+    ReadJsonNumber(r, value);
+}
+
+static inline void ReadJson(JsonReader& r, int64_t& value)
+{
+    ReadJsonNumber(r, value);
+}
+
+static inline void ReadJson(JsonReader& r, uint64_t& value)
+{
+    ReadJsonNumber(r, value);
+}
+
+static inline void ReadJson(JsonReader& r, float& value)
+{
+    ReadJsonNumber(r, value);
+}
+
+static inline void ReadJson(JsonReader& r, double& value)
+{
+    ReadJsonNumber(r, value);
+}
+
+static inline void ReadJson(JsonReader& r, std::string& value)
+{
+    if (!r.ReadNull())
+    {
+        r.ReadString(value);
+    }
+}
+
+static inline void ReadJson(JsonReader& r, Any& value)
+{
+    const char* begin;
+    size_t len;
+    r.Capture(begin, len);
+
+    JsonDocument doc;
+    doc.Parse(begin, len);
+    doc.ToAny(value);
+}
+
+template<typename T>
+void ReadJson(JsonReader& r, T& value);
+
+template<typename E>
+void ReadJson(JsonReader& r, std::vector<E>& value)
+{
+    if (r.ReadNull())
+    {
+        return;
+    }
+
+    r.StartArray();
+    while (r.NextItem())
+    {
+        value.emplace_back();
+        ReadJson(r, value.back());
+    }
+}
+
+template<typename E>
+void ReadJson(JsonReader& r, std::list<E>& value)
+{
+    if (r.ReadNull())
+    {
+        return;
+    }
+
+    r.StartArray();
+    while (r.NextItem())
+    {
+        value.emplace_back();
+        ReadJson(r, value.back());
+    }
+}
+
+template<typename E>
+void ReadJson(JsonReader& r, std::set<E>& value)
+{
+    if (r.ReadNull())
+    {
+        return;
+    }
+
+    r.StartArray();
+    while (r.NextItem())
+    {
+        E e;
+        ReadJson(r, e);
+        value.insert(std::move(e));
+    }
+}
+
+template<typename E>
+void ReadJson(JsonReader& r, std::map<std::string,E>& value)
+{
+    if (r.ReadNull())
+    {
+        return;
+    }
+
+    r.StartObject();
+    while (r.NextMember())
+    {
+        ReadJson(r, value[r.GetKey()]);
+    }
+}
+
+template<typename T>
+void ReadJson(JsonReader& r, T& value)
+{
+    if constexpr (HasJsonReader<T>::value)
+    {
+        if (!r.ReadNull())
+        {
+            value.readJson(r);
+        }
+    }
+    else
+    {
+        Any a;
+        ReadJson(r, a);
+        FromJson<T>(a, value);
+    }
+}
+
+/*
+ * serialize t into s through JsonWriter, reusing the capacity of s.
+ */
+template<typename T>
+void StreamToJsonString(const T& t, std::string& s)
+{
+    s.clear();
+    JsonWriter w(s);
+    WriteJson(w, t);
+}
+
+template<typename T>
+std::string StreamToJsonString(const T& t)
+{
+    std::string s;
+    StreamToJsonString(t, s);
+    return s;
+}
+
+/*
+ * fill t from s through JsonReader. throw JsonException on malformed input.
+ */
+template<typename T>
+void StreamFromJsonString(const std::string& s, T& t)
+{
+    JsonReader r(s);
+    ReadJson(r, t);
+    r.Finish();
+}
+
+}
+}
+
+#endif//__UT_JSON_STREAM_HPP__
@@ -0,0 +1,1322 @@
+#ifndef __UT_JSON_VALUE_HPP__
+#define __UT_JSON_VALUE_HPP__
+
+#include <unitree/common/json/json.hpp>
+#include <cmath>
+
+/*
+ * arena block size and the longest string stored inside a JsonValue.
+ */
+#define UT_JSON_ARENA_BLOCK_SIZE    4096
+#define UT_JSON_SMALL_STRING_SIZE   15
+#define UT_JSON_MAX_DEPTH           256
+
+namespace unitree
+{
+namespace common
+{
+enum
+{
+    UT_JSON_TYPE_NULL = 0,
+    UT_JSON_TYPE_BOOL,
+    UT_JSON_TYPE_INT,
+    UT_JSON_TYPE_UINT,
+    UT_JSON_TYPE_DOUBLE,
+    UT_JSON_TYPE_STRING,
+    UT_JSON_TYPE_ARRAY,
+    UT_JSON_TYPE_OBJECT
+};
+
+/*
+ * @brief: JsonArena
+ * bump allocator for one document. memory is released all at once by
+ * Reset or on destruction, and the first block is kept for reuse.
+ */
+class JsonArena
+{
+public:
+    JsonArena() :
+        mPos(NULL), mEnd(NULL), mFirstSize(0)
+    {}
+
+    JsonArena(const JsonArena&) = delete;
+    JsonArena& operator=(const JsonArena&) = delete;
+
+    ~JsonArena()
+    {
+        for (size_t i=0; i<mBlocks.size(); i++)
+        {
+            free(mBlocks[i]);
+        }
+    }
+
+    void* Allocate(size_t size)
+    {
+        size = (size + 7) & ~(size_t)7;
+
+        if (mPos == NULL || (size_t)(mEnd - mPos) < size)
+        {
+            NewBlock(size);
+        }
+
+        void* p = mPos;
+        mPos += size;
+
+        return p;
+    }
+
+    void Reset()
+    {
+        for (size_t i=1; i<mBlocks.size(); i++)
+        {
+            free(mBlocks[i]);
+        }
+
+        if (mBlocks.empty())
+        {
+            return;
+        }
+
+        mBlocks.resize(1);
+        mPos = (char*)mBlocks[0];
+        mEnd = mPos + mFirstSize;
+    }
+
+private:
+    void NewBlock(size_t size)
+    {
+        size_t blockSize = UT_JSON_ARENA_BLOCK_SIZE;
+        if (!mBlocks.empty())
+        {
+            blockSize = (size_t)(mEnd - (char*)mBlocks.back()) * 2;
+        }
+
+        blockSize = std::max(blockSize, size);
+
+        void* block = malloc(blockSize);
+        UT_THROW_IF(block == NULL, JsonException, "json arena allocate failed");
+
+        if (mBlocks.empty())
+        {
+            mFirstSize = blockSize;
+        }
+
+        mBlocks.push_back(block);
+        mPos = (char*)block;
+        mEnd = mPos + blockSize;
+    }
+
+private:
+    char* mPos;
+    char* mEnd;
+    size_t mFirstSize;
+    std::vector<void*> mBlocks;
+};
+
+class JsonMember;
+
+/*
+ * @brief: JsonValue
+ * tagged json value. short strings are stored inline, longer strings,
+ * arrays and objects point into the document arena. object members are
+ * kept sorted by key.
+ */
+class JsonValue
+{
+public:
+    JsonValue() :
+        mSize(0), mType(UT_JSON_TYPE_NULL)
+    {
+        mData.mUint = 0;
+    }
+
+    int32_t GetType() const
+    {
+        return mType;
+    }
+
+    bool IsNull() const
+    {
+        return mType == UT_JSON_TYPE_NULL;
+    }
+
+    bool IsBool() const
+    {
+        return mType == UT_JSON_TYPE_BOOL;
+    }
+
+    bool IsNumber() const
+    {
+        return mType == UT_JSON_TYPE_INT || mType == UT_JSON_TYPE_UINT ||
+            mType == UT_JSON_TYPE_DOUBLE;
+    }
+
+    bool IsString() const
+    {
+        return mType == UT_JSON_TYPE_STRING;
+    }
+
+    bool IsArray() const
+    {
+        return mType == UT_JSON_TYPE_ARRAY;
+    }
+
+    bool IsObject() const
+    {
+        return mType == UT_JSON_TYPE_OBJECT;
+    }
+
+    bool GetBool() const
+    {
+        CheckType(UT_JSON_TYPE_BOOL);
+        return mData.mBool;
+    }
+
+    int64_t GetInt64() const
+    {
+        return GetNumber<int64_t>();
+    }
+
+    uint64_t GetUint64() const
+    {
+        return GetNumber<uint64_t>();
+    }
+
+    double GetDouble() const
+    {
+        return GetNumber<double>();
+    }
+
+    template<typename T>
+    T GetNumber() const
+    {
+        switch (mType)
+        {
+        case UT_JSON_TYPE_INT:
+            return (T)mData.mInt;
+        case UT_JSON_TYPE_UINT:
+            return (T)mData.mUint;
+        case UT_JSON_TYPE_DOUBLE:
+            return (T)mData.mDouble;
+        case UT_JSON_TYPE_BOOL:
+            return (T)mData.mBool;
+        }
+
+        UT_THROW(JsonException, "json value is not a number");
+    }
+
+    const char* GetStringData() const
+    {
+        CheckType(UT_JSON_TYPE_STRING);
+        return mSize <= UT_JSON_SMALL_STRING_SIZE ? mData.mSmall : mData.mString;
+    }
+
+    std::string GetString() const
+    {
+        return std::string(GetStringData(), mSize);
+    }
+
+    /*
+     * string length, array item count or object member count.
+     */
+    uint32_t Size() const
+    {
+        return (mType == UT_JSON_TYPE_STRING || mType == UT_JSON_TYPE_ARRAY ||
+            mType == UT_JSON_TYPE_OBJECT) ? mSize : 0;
+    }
+
+    const JsonValue& operator[](size_t index) const
+    {
+        CheckType(UT_JSON_TYPE_ARRAY);
+        UT_THROW_IF(index >= mSize, JsonException, "json array index out of range");
+        return mData.mItems[index];
+    }
+
+    const JsonMember& GetMember(size_t index) const;
+
+    /*
+     * binary search, NULL if the object has no such key.
+     */
+    const JsonValue* Find(const char* key, size_t len) const;
+
+    const JsonValue* Find(const std::string& key) const
+    {
+        return Find(key.c_str(), key.size());
+    }
+
+    bool Has(const std::string& key) const
+    {
+        return Find(key) != NULL;
+    }
+
+    /*
+     * compare string value with s.
+     */
+    int32_t Compare(const char* s, size_t len) const
+    {
+        const char* data = GetStringData();
+        int32_t r = memcmp(data, s, std::min((size_t)mSize, len));
+        if (r != 0)
+        {
+            return r;
+        }
+
+        return mSize < len ? -1 : (mSize > len ? 1 : 0);
+    }
+
+private:
+    friend class JsonDocument;
+
+    void CheckType(int32_t type) const
+    {
+        UT_THROW_IF(mType != type, JsonException, "json value type mismatch");
+    }
+
+private:
+    union
+    {
+        bool mBool;
+        int64_t mInt;
+        uint64_t mUint;
+        double mDouble;
+        const char* mString;
+        JsonValue* mItems;
+        JsonMember* mMembers;
+        char mSmall[UT_JSON_SMALL_STRING_SIZE + 1];
+    } mData;
+    uint32_t mSize;
+    uint8_t mType;
+};
+
+class JsonMember
+{
+public:
+    JsonValue mKey;
+    JsonValue mValue;
+};
+
+inline const JsonMember& JsonValue::GetMember(size_t index) const
+{
+    CheckType(UT_JSON_TYPE_OBJECT);
+    UT_THROW_IF(index >= mSize, JsonException, "json object index out of range");
+    return mData.mMembers[index];
+}
+
+inline const JsonValue* JsonValue::Find(const char* key, size_t len) const
+{
+    if (mType != UT_JSON_TYPE_OBJECT)
+    {
+        return NULL;
+    }
+
+    size_t low = 0, high = mSize;
+    while (low < high)
+    {
+        size_t mid = (low + high) / 2;
+        int32_t r = mData.mMembers[mid].mKey.Compare(key, len);
+
+        if (r == 0)
+        {
+            return &mData.mMembers[mid].mValue;
+        }
+        else if (r < 0)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * @brief: JsonDocument
+ * owns the arena and the root value. Parse and Write are compact, and
+ * ToAny/FromAny bridge to the JsonMap/JsonArray tree used by Jsonize.
+ */
+class JsonDocument
+{
+public:
+    JsonDocument()
+    {}
+
+    JsonDocument(const JsonDocument&) = delete;
+    JsonDocument& operator=(const JsonDocument&) = delete;
+
+    const JsonValue& GetRoot() const
+    {
+        return mRoot;
+    }
+
+    JsonValue& GetRoot()
+    {
+        return mRoot;
+    }
+
+    void Clear()
+    {
+        mRoot = JsonValue();
+        mArena.Reset();
+    }
+
+    /*
+     * throw JsonException on malformed input.
+     */
+    void Parse(const std::string& s)
+    {
+        Parse(s.c_str(), s.size());
+    }
+
+    void Parse(const char* s, size_t len)
+    {
+        Clear();
+
+        Parser parser(*this, s, s + len);
+        parser.SkipSpace();
+        parser.ParseValue(mRoot, 0);
+        parser.SkipSpace();
+
+        UT_THROW_IF(parser.mPos != parser.mEnd, JsonException,
+            "json parse error. unexpected data after root value");
+    }
+
+    void Write(std::string& s) const
+    {
+        WriteValue(mRoot, s);
+    }
+
+    std::string ToString() const
+    {
+        std::string s;
+        Write(s);
+        return s;
+    }
+
+    /*
+     * value setters, allocating from this document's arena.
+     */
+    void SetNull(JsonValue& value)
+    {
+        value = JsonValue();
+    }
+
+    void SetBool(JsonValue& value, bool b)
+    {
+        value.mType = UT_JSON_TYPE_BOOL;
+        value.mData.mBool = b;
+    }
+
+    void SetInt(JsonValue& value, int64_t n)
+    {
+        value.mType = UT_JSON_TYPE_INT;
+        value.mData.mInt = n;
+    }
+
+    void SetUint(JsonValue& value, uint64_t n)
+    {
+        value.mType = UT_JSON_TYPE_UINT;
+        value.mData.mUint = n;
+    }
+
+    void SetDouble(JsonValue& value, double n)
+    {
+        value.mType = UT_JSON_TYPE_DOUBLE;
+        value.mData.mDouble = n;
+    }
+
+    void SetString(JsonValue& value, const char* s, size_t len)
+    {
+        UT_THROW_IF(len > UINT32_MAX, JsonException, "json string too long");
+
+        value.mType = UT_JSON_TYPE_STRING;
+        value.mSize = (uint32_t)len;
+
+        char* p;
+        if (len <= UT_JSON_SMALL_STRING_SIZE)
+        {
+            p = value.mData.mSmall;
+        }
+        else
+        {
+            p = (char*)mArena.Allocate(len + 1);
+            value.mData.mString = p;
+        }
+
+        memcpy(p, s, len);
+        p[len] = 0;
+    }
+
+    void SetString(JsonValue& value, const std::string& s)
+    {
+        SetString(value, s.c_str(), s.size());
+    }
+
+    /*
+     * return size uninitialized items to fill in.
+     */
+    JsonValue* SetArray(JsonValue& value, size_t size)
+    {
+        value.mType = UT_JSON_TYPE_ARRAY;
+        value.mSize = (uint32_t)size;
+        value.mData.mItems = NewArray<JsonValue>(size);
+
+        return value.mData.mItems;
+    }
+
+    /*
+     * return size members to fill in. call SortObject after filling keys.
+     */
+    JsonMember* SetObject(JsonValue& value, size_t size)
+    {
+        value.mType = UT_JSON_TYPE_OBJECT;
+        value.mSize = (uint32_t)size;
+        value.mData.mMembers = NewArray<JsonMember>(size);
+
+        return value.mData.mMembers;
+    }
+
+    /*
+     * sort members by key. for duplicated keys the last one is kept.
+     */
+    static void SortObject(JsonValue& value)
+    {
+        JsonMember* begin = value.mData.mMembers;
+        JsonMember* end = begin + value.mSize;
+
+        auto less = [](const JsonMember& a, const JsonMember& b)
+        {
+            return a.mKey.Compare(b.mKey.GetStringData(), b.mKey.mSize) < 0;
+        };
+
+        /*
+         * insertion sort for the usual few members, it is stable and does
+         * not allocate.
+         */
+        if (value.mSize <= 32)
+        {
+            for (JsonMember* p = begin + 1; p < end; ++p)
+            {
+                if (!less(*p, p[-1]))
+                {
+                    continue;
+                }
+
+                JsonMember member = *p;
+                JsonMember* q = p;
+                for (; q > begin && less(member, q[-1]); --q)
+                {
+                    *q = q[-1];
+                }
+                *q = member;
+            }
+        }
+        else
+        {
+            std::stable_sort(begin, end, less);
+        }
+
+        JsonMember* out = begin;
+        for (JsonMember* p = begin; p != end; ++p)
+        {
+            if (p + 1 != end && p[1].mKey.Compare(p->mKey.GetStringData(), p->mKey.mSize) == 0)
+            {
+                continue;
+            }
+
+            *out++ = *p;
+        }
+
+        value.mSize = (uint32_t)(out - begin);
+    }
+
+    /*
+     * convert to the JsonMap/JsonArray tree. integers become int32_t or
+     * int64_t/uint64_t when they do not fit.
+     */
+    static void ToAny(const JsonValue& value, Any& a)
+    {
+        switch (value.mType)
+        {
+        case UT_JSON_TYPE_NULL:
+            a = Any();
+            break;
+        case UT_JSON_TYPE_BOOL:
+            a = value.mData.mBool;
+            break;
+        case UT_JSON_TYPE_INT:
+            if (value.mData.mInt >= INT32_MIN && value.mData.mInt <= INT32_MAX)
+            {
+                a = (int32_t)value.mData.mInt;
+            }
+            else
+            {
+                a = value.mData.mInt;
+            }
+            break;
+        case UT_JSON_TYPE_UINT:
+            a = value.mData.mUint;
+            break;
+        case UT_JSON_TYPE_DOUBLE:
+            a = value.mData.mDouble;
+            break;
+        case UT_JSON_TYPE_STRING:
+            a = value.GetString();
+            break;
+        case UT_JSON_TYPE_ARRAY:
+        {
+            a = JsonArray();
+            JsonArray& arr = ((Any::Holder<JsonArray>*)a.mContent)->mValue;
+            arr.resize(value.mSize);
+
+            for (uint32_t i=0; i<value.mSize; i++)
+            {
+                ToAny(value.mData.mItems[i], arr[i]);
+            }
+            break;
+        }
+        case UT_JSON_TYPE_OBJECT:
+        {
+            a = JsonMap();
+            JsonMap& m = ((Any::Holder<JsonMap>*)a.mContent)->mValue;
+
+            for (uint32_t i=0; i<value.mSize; i++)
+            {
+                const JsonMember& member = value.mData.mMembers[i];
+                ToAny(member.mValue, m.emplace_hint(m.end(), member.mKey.GetString(), Any())->second);
+            }
+            break;
+        }
+        }
+    }
+
+    void ToAny(Any& a) const
+    {
+        ToAny(mRoot, a);
+    }
+
+    /*
+     * build the document from a JsonMap/JsonArray tree.
+     */
+    void FromAny(const Any& a)
+    {
+        Clear();
+        FromAny(a, mRoot);
+    }
+
+    void FromAny(const Any& a, JsonValue& value)
+    {
+        const std::type_info& t = a.GetTypeInfo();
+
+        if (a.Empty())
+        {
+            SetNull(value);
+        }
+        else if (t == typeid(JsonMap))
+        {
+            const JsonMap& m = AnyCast<JsonMap>(a);
+            JsonMember* members = SetObject(value, m.size());
+
+            JsonMap::const_iterator iter;
+            for (iter = m.begin(); iter != m.end(); ++iter, ++members)
+            {
+                SetString(members->mKey, iter->first);
+                FromAny(iter->second, members->mValue);
+            }
+
+            /*
+             * std::map order is already the member order.
+             */
+        }
+        else if (t == typeid(JsonArray))
+        {
+            const JsonArray& arr = AnyCast<JsonArray>(a);
+            JsonValue* items = SetArray(value, arr.size());
+
+            for (size_t i=0; i<arr.size(); i++)
+            {
+                FromAny(arr[i], items[i]);
+            }
+        }
+        else if (t == typeid(std::string))
+        {
+            SetString(value, AnyCast<std::string>(a));
+        }
+        else if (t == typeid(bool))
+        {
+            SetBool(value, AnyCast<bool>(a));
+        }
+        else if (IsFloatType(t) || IsDoubleType(t) || IsLongDoubleType(t))
+        {
+            SetDouble(value, AnyNumberCast<double>(a));
+        }
+        else if (IsUint64Type(t))
+        {
+            SetUint(value, AnyCast<uint64_t>(a));
+        }
+        else if (IsIntegerType(t))
+        {
+            SetInt(value, AnyNumberCast<int64_t>(a));
+        }
+        else
+        {
+            UT_THROW(JsonException, std::string("json unsupported any type:") + t.name());
+        }
+    }
+
+private:
+    friend class JsonWriter;
+
+    template<typename T>
+    T* NewArray(size_t size)
+    {
+        if (size == 0)
+        {
+            return NULL;
+        }
+
+        T* p = (T*)mArena.Allocate(sizeof(T) * size);
+        for (size_t i=0; i<size; i++)
+        {
+            new (p + i) T();
+        }
+
+        return p;
+    }
+
+    static void WriteValue(const JsonValue& value, std::string& s)
+    {
+        char buf[32];
+
+        switch (value.mType)
+        {
+        case UT_JSON_TYPE_NULL:
+            s += "null";
+            break;
+        case UT_JSON_TYPE_BOOL:
+            s += value.mData.mBool ? "true" : "false";
+            break;
+        case UT_JSON_TYPE_INT:
+            s.append(buf, snprintf(buf, sizeof(buf), "%lld", (long long)value.mData.mInt));
+            break;
+        case UT_JSON_TYPE_UINT:
+            s.append(buf, snprintf(buf, sizeof(buf), "%llu", (unsigned long long)value.mData.mUint));
+            break;
+        case UT_JSON_TYPE_DOUBLE:
+            WriteDouble(value.mData.mDouble, s);
+            break;
+        case UT_JSON_TYPE_STRING:
+            WriteString(value.GetStringData(), value.mSize, s);
+            break;
+        case UT_JSON_TYPE_ARRAY:
+            s += '[';
+            for (uint32_t i=0; i<value.mSize; i++)
+            {
+                if (i > 0)
+                {
+                    s += ',';
+                }
+                WriteValue(value.mData.mItems[i], s);
+            }
+            s += ']';
+            break;
+        case UT_JSON_TYPE_OBJECT:
+            s += '{';
+            for (uint32_t i=0; i<value.mSize; i++)
+            {
+                const JsonMember& member = value.mData.mMembers[i];
+                if (i > 0)
+                {
+                    s += ',';
+                }
+                WriteString(member.mKey.GetStringData(), member.mKey.mSize, s);
+                s += ':';
+                WriteValue(member.mValue, s);
+            }
+            s += '}';
+            break;
+        }
+    }
+
+    static void WriteDouble(double d, std::string& s)
+    {
+        if (!std::isfinite(d))
+        {
+            s += "null";
+            return;
+        }
+
+        /*
+         * shortest of %.15g/%.17g which reads back the same value.
+         */
+        char buf[32];
+        int32_t len = snprintf(buf, sizeof(buf), "%.15g", d);
+        if (strtod(buf, NULL) != d)
+        {
+            len = snprintf(buf, sizeof(buf), "%.17g", d);
+        }
+
+        s.append(buf, len);
+
+        if (strpbrk(buf, ".eEn") == NULL)
+        {
+            s += ".0";
+        }
+    }
+
+    static void WriteString(const char* p, size_t len, std::string& s)
+    {
+        static const char hex[] = "0123456789abcdef";
+
+        s += '"';
+
+        const char* begin = p;
+        const char* end = p + len;
+
+        for (; p != end; ++p)
+        {
+            unsigned char c = (unsigned char)*p;
+            if (c >= 0x20 && c != '"' && c != '\\')
+            {
+                continue;
+            }
+
+            s.append(begin, p - begin);
+            begin = p + 1;
+
+            switch (c)
+            {
+            case '"':  s += "\\\""; break;
+            case '\\': s += "\\\\"; break;
+            case '\b': s += "\\b";  break;
+            case '\f': s += "\\f";  break;
+            case '\n': s += "\\n";  break;
+            case '\r': s += "\\r";  break;
+            case '\t': s += "\\t";  break;
+            default:
+                s += "\\u00";
+                s += hex[c >> 4];
+                s += hex[c & 0xF];
+            }
+        }
+
+        s.append(begin, end - begin);
+        s += '"';
+    }
+
+    /*
+     * recursive descent parser. items of open containers are collected on
+     * one shared stack and copied into the arena when the container closes.
+     */
+    class Parser
+    {
+    public:
+        Parser(JsonDocument& doc, const char* begin, const char* end) :
+            mDoc(doc), mBegin(begin), mPos(begin), mEnd(end), mItems(doc.mItems),
+            mMembers(doc.mMembers), mString(doc.mString)
+        {
+            mItems.clear();
+            mMembers.clear();
+        }
+
+        void SkipSpace()
+        {
+            while (mPos < mEnd && (*mPos == ' ' || *mPos == '\n' || *mPos == '\r' || *mPos == '\t'))
+            {
+                mPos++;
+            }
+        }
+
+        void ParseValue(JsonValue& value, int32_t depth)
+        {
+            if (mPos >= mEnd)
+            {
+                Error("unexpected end");
+            }
+
+            switch (*mPos)
+            {
+            case '{':
+                ParseObject(value, depth + 1);
+                break;
+            case '[':
+                ParseArray(value, depth + 1);
+                break;
+            case '"':
+                ParseString(value);
+                break;
+            case 't':
+                Expect("true");
+                mDoc.SetBool(value, true);
+                break;
+            case 'f':
+                Expect("false");
+                mDoc.SetBool(value, false);
+                break;
+            case 'n':
+                Expect("null");
+                mDoc.SetNull(value);
+                break;
+            default:
+                ParseNumber(value);
+            }
+        }
+
+    private:
+        void ParseObject(JsonValue& value, int32_t depth)
+        {
+            CheckDepth(depth);
+            mPos++;
+
+            size_t base = mMembers.size();
+
+            SkipSpace();
+            if (mPos < mEnd && *mPos == '}')
+            {
+                mPos++;
+                mDoc.SetObject(value, 0);
+                return;
+            }
+
+            while (true)
+            {
+                SkipSpace();
+                if (mPos >= mEnd || *mPos != '"')
+                {
+                    Error("expect object key");
+                }
+
+                mMembers.push_back(JsonMember());
+                ParseString(mMembers.back().mKey);
+
+                SkipSpace();
+                if (mPos >= mEnd || *mPos != ':')
+                {
+                    Error("expect ':'");
+                }
+                mPos++;
+                SkipSpace();
+
+                JsonValue item;
+                ParseValue(item, depth);
+                mMembers[mMembers.size() - 1].mValue = item;
+
+                SkipSpace();
+                if (mPos < mEnd && *mPos == ',')
+                {
+                    mPos++;
+                    continue;
+                }
+
+                if (mPos < mEnd && *mPos == '}')
+                {
+                    mPos++;
+                    break;
+                }
+
+                Error("expect ',' or '}'");
+            }
+
+            size_t count = mMembers.size() - base;
+            JsonMember* members = mDoc.SetObject(value, count);
+            std::copy(mMembers.begin() + base, mMembers.end(), members);
+            mMembers.resize(base);
+
+            SortObject(value);
+        }
+
+        void ParseArray(JsonValue& value, int32_t depth)
+        {
+            CheckDepth(depth);
+            mPos++;
+
+            size_t base = mItems.size();
+
+            SkipSpace();
+            if (mPos < mEnd && *mPos == ']')
+            {
+                mPos++;
+                mDoc.SetArray(value, 0);
+                return;
+            }
+
+            while (true)
+            {
+                SkipSpace();
+
+                JsonValue item;
+                ParseValue(item, depth);
+                mItems.push_back(item);
+
+                SkipSpace();
+                if (mPos < mEnd && *mPos == ',')
+                {
+                    mPos++;
+                    continue;
+                }
+
+                if (mPos < mEnd && *mPos == ']')
+                {
+                    mPos++;
+                    break;
+                }
+
+                Error("expect ',' or ']'");
+            }
+
+            size_t count = mItems.size() - base;
+            JsonValue* items = mDoc.SetArray(value, count);
+            std::copy(mItems.begin() + base, mItems.end(), items);
+            mItems.resize(base);
+        }
+
+        void ParseString(JsonValue& value)
+        {
+            mPos++;
+
+            /*
+             * fast path without escapes.
+             */
+            const char* begin = mPos;
+            while (mPos < mEnd && *mPos != '"' && *mPos != '\\')
+            {
+                if ((unsigned char)*mPos < 0x20)
+                {
+                    Error("control character in string");
+                }
+                mPos++;
+            }
+
+            if (mPos < mEnd && *mPos == '"')
+            {
+                mDoc.SetString(value, begin, mPos - begin);
+                mPos++;
+                return;
+            }
+
+            mString.assign(begin, mPos - begin);
+
+            while (true)
+            {
+                if (mPos >= mEnd)
+                {
+                    Error("unterminated string");
+                }
+
+                char c = *mPos++;
+                if (c == '"')
+                {
+                    break;
+                }
+                else if ((unsigned char)c < 0x20)
+                {
+                    Error("control character in string");
+                }
+                else if (c != '\\')
+                {
+                    mString += c;
+                    continue;
+                }
+
+                if (mPos >= mEnd)
+                {
+                    Error("unterminated string");
+                }
+
+                c = *mPos++;
+                switch (c)
+                {
+                case '"':  mString += '"';  break;
+                case '\\': mString += '\\'; break;
+                case '/':  mString += '/';  break;
+                case 'b':  mString += '\b'; break;
+                case 'f':  mString += '\f'; break;
+                case 'n':  mString += '\n'; break;
+                case 'r':  mString += '\r'; break;
+                case 't':  mString += '\t'; break;
+                case 'u':
+                    ParseUnicode();
+                    break;
+                default:
+                    Error("invalid escape");
+                }
+            }
+
+            mDoc.SetString(value, mString);
+        }
+
+        void ParseUnicode()
+        {
+            uint32_t code = ParseHex4();
+
+            if (code >= 0xD800 && code <= 0xDBFF)
+            {
+                if (mEnd - mPos < 6 || mPos[0] != '\\' || mPos[1] != 'u')
+                {
+                    Error("invalid surrogate pair");
+                }
+
+                mPos += 2;
+                uint32_t low = ParseHex4();
+                if (low < 0xDC00 || low > 0xDFFF)
+                {
+                    Error("invalid surrogate pair");
+                }
+
+                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+            }
+            else if (code >= 0xDC00 && code <= 0xDFFF)
+            {
+                Error("invalid surrogate pair");
+            }
+
+            if (code < 0x80)
+            {
+                mString += (char)code;
+            }
+            else if (code < 0x800)
+            {
+                mString += (char)(0xC0 | (code >> 6));
+                mString += (char)(0x80 | (code & 0x3F));
+            }
+            else if (code < 0x10000)
+            {
+                mString += (char)(0xE0 | (code >> 12));
+                mString += (char)(0x80 | ((code >> 6) & 0x3F));
+                mString += (char)(0x80 | (code & 0x3F));
+            }
+            else
+            {
+                mString += (char)(0xF0 | (code >> 18));
+                mString += (char)(0x80 | ((code >> 12) & 0x3F));
+                mString += (char)(0x80 | ((code >> 6) & 0x3F));
+                mString += (char)(0x80 | (code & 0x3F));
+            }
+        }
+
+        uint32_t ParseHex4()
+        {
+            if (mEnd - mPos < 4)
+            {
+                Error("invalid unicode escape");
+            }
+
+            uint32_t code = 0;
+            for (int32_t i=0; i<4; i++)
+            {
+                char c = *mPos++;
+                code <<= 4;
+
+                if (c >= '0' && c <= '9')
+                {
+                    code |= c - '0';
+                }
+                else if (c >= 'a' && c <= 'f')
+                {
+                    code |= c - 'a' + 10;
+                }
+                else if (c >= 'A' && c <= 'F')
+                {
+                    code |= c - 'A' + 10;
+                }
+                else
+                {
+                    Error("invalid unicode escape");
+                }
+            }
+
+            return code;
+        }
+
+        void ParseNumber(JsonValue& value)
+        {
+            const char* begin = mPos;
+            bool negative = false;
+
+            if (*mPos == '-')
+            {
+                negative = true;
+                mPos++;
+            }
+
+            if (mPos >= mEnd || *mPos < '0' || *mPos > '9')
+            {
+                Error("invalid value");
+            }
+
+            /*
+             * integers are accumulated directly, anything else goes to strtod.
+             * the grammar is checked here, as strtod also takes "012" or "1.".
+             */
+            uint64_t n = 0;
+            bool overflow = false;
+
+            if (*mPos == '0')
+            {
+                mPos++;
+                if (IsDigit())
+                {
+                    Error("invalid number. leading zero");
+                }
+            }
+
+            while (IsDigit())
+            {
+                uint64_t digit = *mPos - '0';
+                if (n > (UINT64_MAX - digit) / 10)
+                {
+                    overflow = true;
+                }
+                n = n * 10 + digit;
+                mPos++;
+            }
+
+            bool isDouble = overflow;
+            if (mPos < mEnd && *mPos == '.')
+            {
+                isDouble = true;
+                mPos++;
+                SkipDigits();
+            }
+
+            if (mPos < mEnd && (*mPos == 'e' || *mPos == 'E'))
+            {
+                isDouble = true;
+                mPos++;
+                if (mPos < mEnd && (*mPos == '+' || *mPos == '-'))
+                {
+                    mPos++;
+                }
+                SkipDigits();
+            }
+
+            if (!isDouble)
+            {
+                if (!negative)
+                {
+                    if (n <= (uint64_t)INT64_MAX)
+                    {
+                        mDoc.SetInt(value, (int64_t)n);
+                    }
+                    else
+                    {
+                        mDoc.SetUint(value, n);
+                    }
+                    return;
+                }
+                else if (n <= (uint64_t)INT64_MAX + 1)
+                {
+                    mDoc.SetInt(value, (int64_t)(0 - n));
+                    return;
+                }
+            }
+
+            std::string s(begin, mPos - begin);
+            char* end = NULL;
+            double d = strtod(s.c_str(), &end);
+            if (end != s.c_str() + s.size())
+            {
+                Error("invalid number");
+            }
+
+            mDoc.SetDouble(value, d);
+        }
+
+        bool IsDigit() const
+        {
+            return mPos < mEnd && *mPos >= '0' && *mPos <= '9';
+        }
+
+        /*
+         * one or more digits.
+         */
+        void SkipDigits()
+        {
+            if (!IsDigit())
+            {
+                Error("invalid number. expect digit");
+            }
+
+            while (IsDigit())
+            {
+                mPos++;
+            }
+        }
+
+        void Expect(const char* word)
+        {
+            size_t len = strlen(word);
+            if ((size_t)(mEnd - mPos) < len || memcmp(mPos, word, len) != 0)
+            {
+                Error("invalid value");
+            }
+
+            mPos += len;
+        }
+
+        void CheckDepth(int32_t depth)
+        {
+            if (depth > UT_JSON_MAX_DEPTH)
+            {
+                Error("nesting too deep");
+            }
+        }
+
+        void Error(const char* message)
+        {
+            UT_THROW(JsonException, std::string("json parse error. ") + message +
+                " at offset " + std::to_string(mPos - mBegin));
+        }
+
+    public:
+        JsonDocument& mDoc;
+        const char* mBegin;
+        const char* mPos;
+        const char* mEnd;
+
+    private:
+        std::vector<JsonValue>& mItems;
+        std::vector<JsonMember>& mMembers;
+        std::string& mString;
+    };
+
+private:
+    JsonArena mArena;
+    JsonValue mRoot;
+
+    /*
+     * parser stacks, kept to reuse their memory across Parse calls.
+     */
+    std::vector<JsonValue> mItems;
+    std::vector<JsonMember> mMembers;
+    std::string mString;
+};
+
+typedef std::shared_ptr<JsonDocument> JsonDocumentPtr;
+
+/*
+ * parse s into the Any tree used by Jsonize with the arena parser.
+ */
+static inline void ParseJsonString(const std::string& s, Any& a)
+{
+    JsonDocument doc;
+    doc.Parse(s);
+    doc.ToAny(a);
+}
+
+/*
+ * write an Any tree as compact json with the arena writer.
+ */
+static inline std::string WriteJsonString(const Any& a)
+{
+    JsonDocument doc;
+    doc.FromAny(a);
+    return doc.ToString();
+}
+
+}
+}
+
+#endif//__UT_JSON_VALUE_HPP__
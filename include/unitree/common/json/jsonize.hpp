@@ -206,7 +206,7 @@ void ToAny(const std::vector<E>& value, Any& a)
         arr.push_back(std::move(a_in));
     }
 
-    a = Any(arr);
+    a = Any(std::move(arr));
 }
 
 template<typename E>
@@ -224,7 +224,7 @@ void ToAny(const std::list<E>& value, Any& a)
         arr.push_back(std::move(a_in));
     }
 
-    a = Any(arr);
+    a = Any(std::move(arr));
 }
 
 template<typename E>
@@ -242,7 +242,7 @@ void ToAny(const std::set<E>& value, Any& a)
         arr.push_back(std::move(a_in));
     }
 
-    a = Any(arr);
+    a = Any(std::move(arr));
 }
 
 template<typename E>
@@ -258,10 +258,10 @@ void ToAny(const std::map<std::string,E>& value, Any& a)
         const E& e = iter->second;
 
         ToJson<E>(e, a_in);
-        m[name] = a_in;
+        m[name] = std::move(a_in);
     }
 
-    a = Any(m);
+    a = Any(std::move(m));
 }
 
 template<typename T>
@@ -0,0 +1,182 @@
+#ifndef __UT_LATEST_VALUE_HPP__
+#define __UT_LATEST_VALUE_HPP__
+
+#include <unitree/common/decl.hpp>
+
+namespace unitree
+{
+namespace common
+{
+/*
+ * @brief: LatestValue
+ * wait-free triple buffer handing the latest value from one writer thread
+ * to one reader thread. the writer never waits for the reader, the reader
+ * always sees the newest complete value, and nothing is allocated after
+ * construction.
+ */
+template<typename T>
+class LatestValue
+{
+public:
+    LatestValue() :
+        mBack(0), mMiddle(1), mFront(2), mReaderHasValue(false)
+    {}
+
+    /*
+     * writer side.
+     */
+    void Set(const T& value)
+    {
+        mSlots[mBack] = value;
+        Publish();
+    }
+
+    void Set(T&& value)
+    {
+        mSlots[mBack] = std::move(value);
+        Publish();
+    }
+
+    /*
+     * reader side. return the latest value, or NULL if nothing was set yet.
+     * the pointer stays valid until the next Read/Get of this reader.
+     */
+    const T* Read()
+    {
+        if (mMiddle.load(std::memory_order_relaxed) & FLAG_NEW)
+        {
+            uint8_t middle = mMiddle.exchange(mFront, std::memory_order_acq_rel);
+            mFront = middle & INDEX_MASK;
+            mReaderHasValue = true;
+        }
+
+        return mReaderHasValue ? &mSlots[mFront] : NULL;
+    }
+
+    bool Get(T& value)
+    {
+        const T* p = Read();
+        if (p == NULL)
+        {
+            return false;
+        }
+
+        value = *p;
+
+        return true;
+    }
+
+private:
+    enum
+    {
+        INDEX_MASK = 0x3,
+        FLAG_NEW = 0x4
+    };
+
+    void Publish()
+    {
+        uint8_t middle = mMiddle.exchange(mBack | FLAG_NEW, std::memory_order_acq_rel);
+        mBack = middle & INDEX_MASK;
+    }
+
+private:
+    T mSlots[3];
+
+    alignas(64) uint8_t mBack;
+    alignas(64) std::atomic<uint8_t> mMiddle;
+    alignas(64) uint8_t mFront;
+    bool mReaderHasValue;
+};
+
+/*
+ * @brief: SeqLockLatestValue
+ * latest value from one writer thread to any number of reader threads.
+ * readers retry while the writer is in the middle of Set. T must be
+ * trivially copyable, it is copied word by word through relaxed atomics.
+ */
+template<typename T>
+class SeqLockLatestValue
+{
+public:
+    static_assert(std::is_trivially_copyable<T>::value,
+        "SeqLockLatestValue requires a trivially copyable type");
+
+    SeqLockLatestValue() :
+        mSequence(0)
+    {
+        for (size_t i=0; i<WORD_NUMBER; i++)
+        {
+            mWords[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /*
+     * writer side. only one thread may call Set.
+     */
+    void Set(const T& value)
+    {
+        uint64_t words[WORD_NUMBER] = {};
+        memcpy(words, &value, sizeof(T));
+
+        uint64_t seq = mSequence.load(std::memory_order_relaxed);
+        mSequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i=0; i<WORD_NUMBER; i++)
+        {
+            mWords[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        mSequence.store(seq + 2, std::memory_order_release);
+    }
+
+    /*
+     * return false if nothing was set yet.
+     */
+    bool Get(T& value) const
+    {
+        uint64_t words[WORD_NUMBER];
+        uint64_t seq;
+
+        while (true)
+        {
+            seq = mSequence.load(std::memory_order_acquire);
+            if (seq & 1)
+            {
+                UT_CPU_RELAX();
+                continue;
+            }
+
+            for (size_t i=0; i<WORD_NUMBER; i++)
+            {
+                words[i] = mWords[i].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (mSequence.load(std::memory_order_relaxed) == seq)
+            {
+                break;
+            }
+        }
+
+        if (seq == 0)
+        {
+            return false;
+        }
+
+        memcpy(&value, words, sizeof(T));
+
+        return true;
+    }
+
+private:
+    static const size_t WORD_NUMBER = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    alignas(64) std::atomic<uint64_t> mSequence;
+    std::atomic<uint64_t> mWords[WORD_NUMBER];
+};
+
+}
+}
+
+#endif//__UT_LATEST_VALUE_HPP__
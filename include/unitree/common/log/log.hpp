@@ -2,5 +2,8 @@
 #define __UT_LOG_HPP__
 
 #include <unitree/common/log/log_initor.hpp>
+#include <unitree/common/log/log_limit.hpp>
+#include <unitree/common/log/log_binary.hpp>
+#include <unitree/common/log/log_mapped_store.hpp>
 
 #endif//__UT_LOG_HPP__
@@ -0,0 +1,1095 @@
+#ifndef __UT_LOG_BINARY_HPP__
+#define __UT_LOG_BINARY_HPP__
+
+#include <unitree/common/log/log_store.hpp>
+#include <unitree/common/time/time_tool.hpp>
+
+/*
+ * per thread ring buffer size(bytes), rounded up to a power of 2.
+ */
+#define UT_LOG_BINARY_RING_SIZE         262144          //256K
+/*
+ * longer string arguments are truncated.
+ */
+#define UT_LOG_BINARY_MAX_STRING        1024
+
+#define UT_LOG_BINARY_MAGIC             "UTBLOG01"
+#define UT_LOG_BINARY_MAGIC_LEN         8
+
+//write binary log macro wrapper
+/*
+ * the 1st argument is a string literal format, "{}" is replaced by the next
+ * argument and remaining arguments are appended.
+ * BLOG_WARNING(logger, "queue full. topic:{} size:{}", topic, size);
+ */
+#define __UT_BLOG_FORMAT(format, ...) format
+
+#define __UT_BLOG(logger, level, ...)   \
+    do {                                \
+        if (UT_LOG_IS_ENABLED(logger, level))   \
+        {                               \
+            static const unitree::common::LogBinaryFormat __ut_blog_format(  \
+                level, __UT_BLOG_FORMAT(__VA_ARGS__, 0), __FILE__, __LINE__); \
+            logger->Log(__ut_blog_format, __VA_ARGS__); \
+        }                               \
+    } while (0)
+
+//debug
+#define BLOG_DEBUG(logger, ...)     \
+    __UT_BLOG(logger, UT_LOG_DEBUG, __VA_ARGS__)
+
+//info
+#define BLOG_INFO(logger, ...)      \
+    __UT_BLOG(logger, UT_LOG_INFO, __VA_ARGS__)
+
+//warning
+#define BLOG_WARNING(logger, ...)   \
+    __UT_BLOG(logger, UT_LOG_WARNING, __VA_ARGS__)
+
+//error
+#define BLOG_ERROR(logger, ...)     \
+    __UT_BLOG(logger, UT_LOG_ERROR, __VA_ARGS__)
+
+//fatal
+#define BLOG_FATAL(logger, ...)     \
+    __UT_BLOG(logger, UT_LOG_FATAL, __VA_ARGS__)
+
+namespace unitree
+{
+namespace common
+{
+/*
+ * argument type tags.
+ */
+enum
+{
+    UT_LOG_BINARY_ARG_BOOL = 1,
+    UT_LOG_BINARY_ARG_CHAR,
+    UT_LOG_BINARY_ARG_INT,
+    UT_LOG_BINARY_ARG_UINT,
+    UT_LOG_BINARY_ARG_DOUBLE,
+    UT_LOG_BINARY_ARG_STRING,
+    UT_LOG_BINARY_ARG_POINTER
+};
+
+/*
+ * binary file entry kinds.
+ */
+enum
+{
+    UT_LOG_BINARY_ENTRY_FORMAT = 1,
+    UT_LOG_BINARY_ENTRY_RECORD,
+    UT_LOG_BINARY_ENTRY_DROP
+};
+
+/*
+ * record format id used for ring padding.
+ */
+#define UT_LOG_BINARY_FORMAT_PAD        0xFFFFFFFF
+
+/*
+ * @brief: LogBinaryFormat
+ * static description of one log call site. it is registered once, the
+ * first time the call site is reached, and records only carry its id.
+ */
+class LogBinaryFormat
+{
+public:
+    LogBinaryFormat(int32_t level, const char* format, const char* file, int32_t line);
+
+public:
+    uint32_t mId;
+    int32_t mLevel;
+    const char* mFormat;
+    const char* mFile;
+    int32_t mLine;
+};
+
+class LogBinaryFormatRegistry
+{
+public:
+    static LogBinaryFormatRegistry* Instance()
+    {
+        static LogBinaryFormatRegistry inst;
+        return &inst;
+    }
+
+    uint32_t Register(const LogBinaryFormat* format)
+    {
+        LockGuard<Mutex> guard(mMutex);
+        mFormats.push_back(format);
+        return (uint32_t)(mFormats.size() - 1);
+    }
+
+    const LogBinaryFormat* Get(uint32_t id)
+    {
+        LockGuard<Mutex> guard(mMutex);
+        return id < mFormats.size() ? mFormats[id] : NULL;
+    }
+
+private:
+    LogBinaryFormatRegistry()
+    {}
+
+private:
+    Mutex mMutex;
+    std::vector<const LogBinaryFormat*> mFormats;
+};
+
+inline LogBinaryFormat::LogBinaryFormat(int32_t level, const char* format, const char* file,
+    int32_t line) :
+    mLevel(level), mFormat(format), mFile(file), mLine(line)
+{
+    mId = LogBinaryFormatRegistry::Instance()->Register(this);
+}
+
+/*
+ * record header in the thread ring, followed by tagged arguments.
+ */
+struct LogBinaryRecord
+{
+    uint32_t mSize;
+    uint32_t mFormatId;
+    uint64_t mTime;
+};
+
+/*
+ * @brief: LogBinaryArg
+ * encodes one argument as a type tag and a fixed or length prefixed payload.
+ */
+class LogBinaryArg
+{
+public:
+    static size_t Size(bool)
+    {
+        return 2;
+    }
+
+    static size_t Size(char)
+    {
+        return 2;
+    }
+
+    template<typename T>
+    static typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value, size_t>::type
+    Size(T)
+    {
+        return 1 + sizeof(uint64_t);
+    }
+
+    static size_t Size(const char* s)
+    {
+        return 1 + sizeof(uint16_t) + (s == NULL ? 0 : strnlen(s, UT_LOG_BINARY_MAX_STRING));
+    }
+
+    static size_t Size(const std::string& s)
+    {
+        return 1 + sizeof(uint16_t) + std::min(s.size(), (size_t)UT_LOG_BINARY_MAX_STRING);
+    }
+
+    static size_t Size(const void*)
+    {
+        return 1 + sizeof(uint64_t);
+    }
+
+    static void Write(char*& p, bool value)
+    {
+        *p++ = UT_LOG_BINARY_ARG_BOOL;
+        *p++ = value ? 1 : 0;
+    }
+
+    static void Write(char*& p, char value)
+    {
+        *p++ = UT_LOG_BINARY_ARG_CHAR;
+        *p++ = value;
+    }
+
+    template<typename T>
+    static typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value>::type
+    Write(char*& p, T value)
+    {
+        if (std::is_floating_point<T>::value)
+        {
+            WriteWord(p, UT_LOG_BINARY_ARG_DOUBLE, (double)value);
+        }
+        else if (std::is_signed<T>::value || std::is_enum<T>::value)
+        {
+            WriteWord(p, UT_LOG_BINARY_ARG_INT, (int64_t)value);
+        }
+        else
+        {
+            WriteWord(p, UT_LOG_BINARY_ARG_UINT, (uint64_t)value);
+        }
+    }
+
+    static void Write(char*& p, const char* s)
+    {
+        WriteString(p, s, s == NULL ? 0 : strnlen(s, UT_LOG_BINARY_MAX_STRING));
+    }
+
+    static void Write(char*& p, const std::string& s)
+    {
+        WriteString(p, s.c_str(), std::min(s.size(), (size_t)UT_LOG_BINARY_MAX_STRING));
+    }
+
+    static void Write(char*& p, const void* ptr)
+    {
+        WriteWord(p, UT_LOG_BINARY_ARG_POINTER, (uint64_t)(uintptr_t)ptr);
+    }
+
+    static size_t SizeAll()
+    {
+        return 0;
+    }
+
+    template<typename T, typename ...Args>
+    static size_t SizeAll(const T& value, const Args&... args)
+    {
+        return Size(value) + SizeAll(args...);
+    }
+
+    static void WriteAll(char*&)
+    {}
+
+    template<typename T, typename ...Args>
+    static void WriteAll(char*& p, const T& value, const Args&... args)
+    {
+        Write(p, value);
+        WriteAll(p, args...);
+    }
+
+    /*
+     * append the text of the argument at p to s and move p past it.
+     * return false on malformed input.
+     */
+    static bool Format(const char*& p, const char* end, std::string& s)
+    {
+        if (p >= end)
+        {
+            return false;
+        }
+
+        char tag = *p++;
+        char buf[32];
+
+        switch (tag)
+        {
+        case UT_LOG_BINARY_ARG_BOOL:
+        case UT_LOG_BINARY_ARG_CHAR:
+            if (p + 1 > end)
+            {
+                return false;
+            }
+            if (tag == UT_LOG_BINARY_ARG_BOOL)
+            {
+                s += (*p ? '1' : '0');
+            }
+            else
+            {
+                s += *p;
+            }
+            p++;
+            return true;
+
+        case UT_LOG_BINARY_ARG_STRING:
+        {
+            uint16_t len;
+            if (p + sizeof(len) > end)
+            {
+                return false;
+            }
+            memcpy(&len, p, sizeof(len));
+            p += sizeof(len);
+            if (p + len > end)
+            {
+                return false;
+            }
+            s.append(p, len);
+            p += len;
+            return true;
+        }
+
+        case UT_LOG_BINARY_ARG_INT:
+        case UT_LOG_BINARY_ARG_UINT:
+        case UT_LOG_BINARY_ARG_DOUBLE:
+        case UT_LOG_BINARY_ARG_POINTER:
+        {
+            uint64_t word;
+            if (p + sizeof(word) > end)
+            {
+                return false;
+            }
+            memcpy(&word, p, sizeof(word));
+            p += sizeof(word);
+
+            if (tag == UT_LOG_BINARY_ARG_INT)
+            {
+                snprintf(buf, sizeof(buf), "%lld", (long long)(int64_t)word);
+            }
+            else if (tag == UT_LOG_BINARY_ARG_UINT)
+            {
+                snprintf(buf, sizeof(buf), "%llu", (unsigned long long)word);
+            }
+            else if (tag == UT_LOG_BINARY_ARG_DOUBLE)
+            {
+                double value;
+                memcpy(&value, &word, sizeof(value));
+                snprintf(buf, sizeof(buf), "%.6f", value);
+            }
+            else
+            {
+                snprintf(buf, sizeof(buf), "0x%llx", (unsigned long long)word);
+            }
+
+            s += buf;
+            return true;
+        }
+        }
+
+        return false;
+    }
+
+private:
+    template<typename T>
+    static void WriteWord(char*& p, char tag, T value)
+    {
+        *p++ = tag;
+        memcpy(p, &value, sizeof(uint64_t));
+        p += sizeof(uint64_t);
+    }
+
+    static void WriteString(char*& p, const char* s, size_t len)
+    {
+        uint16_t len16 = (uint16_t)len;
+        *p++ = UT_LOG_BINARY_ARG_STRING;
+        memcpy(p, &len16, sizeof(len16));
+        p += sizeof(len16);
+        memcpy(p, s, len);
+        p += len;
+    }
+};
+
+/*
+ * one log line: "[time] [LEVEL] [pid] [tid] " followed by the formatted
+ * message. shared by the writer thread and the offline decoder.
+ */
+static inline void LogBinaryFormatLine(std::string& s, uint64_t realtimeNanosec, int32_t level,
+    uint32_t pid, int32_t tid, const char* format, const char* args, size_t len)
+{
+    char buf[64];
+
+    s += "[";
+    s += TimeMillisecondFormatString(realtimeNanosec / 1000000);
+    s += "] [";
+    s += GetLogLevelDesc(level);
+    snprintf(buf, sizeof(buf), "] [%u] [%d] ", pid, tid);
+    s += buf;
+
+    const char* p = args;
+    const char* end = args + len;
+
+    for (const char* f = format; *f != 0; f++)
+    {
+        if (f[0] == '{' && f[1] == '}' && p < end)
+        {
+            if (!LogBinaryArg::Format(p, end, s))
+            {
+                break;
+            }
+            f++;
+        }
+        else
+        {
+            s += *f;
+        }
+    }
+
+    while (p < end && LogBinaryArg::Format(p, end, s))
+    {}
+
+    s += "\n";
+}
+
+/*
+ * @brief: LogBinaryRing
+ * single producer single consumer byte ring of LogBinaryRecord. the owner
+ * thread writes, the store writer thread reads. a full ring drops records
+ * instead of blocking the producer.
+ */
+class LogBinaryRing
+{
+public:
+    explicit LogBinaryRing(size_t size, int32_t tid) :
+        mHead(0), mPendingHead(0), mTailCache(0), mTail(0), mDropped(0), mClosed(false),
+        mTid(tid)
+    {
+        mCapacity = 64;
+        while (mCapacity < size)
+        {
+            mCapacity <<= 1;
+        }
+
+        mMask = mCapacity - 1;
+        mBuffer.reset(new uint64_t[mCapacity / sizeof(uint64_t)]);
+    }
+
+    /*
+     * producer side. return NULL and count a drop if there is no room.
+     */
+    char* Reserve(size_t size)
+    {
+        uint64_t total = Align(size);
+        uint64_t head = mHead.load(std::memory_order_relaxed);
+        uint64_t contiguous = mCapacity - (head & mMask);
+        uint64_t need = total + (contiguous < total ? contiguous : 0);
+
+        if (need > mCapacity - (head - mTailCache))
+        {
+            mTailCache = mTail.load(std::memory_order_acquire);
+            if (need > mCapacity - (head - mTailCache))
+            {
+                mDropped.fetch_add(1, std::memory_order_relaxed);
+                return NULL;
+            }
+        }
+
+        if (contiguous < total)
+        {
+            LogBinaryRecord* pad = GetRecord(head);
+            pad->mSize = (uint32_t)contiguous;
+            pad->mFormatId = UT_LOG_BINARY_FORMAT_PAD;
+            head += contiguous;
+        }
+
+        mPendingHead = head + total;
+
+        return (char*)GetRecord(head);
+    }
+
+    void Commit()
+    {
+        mHead.store(mPendingHead, std::memory_order_release);
+    }
+
+    /*
+     * consumer side. call func(const LogBinaryRecord&) for every record and
+     * return the count.
+     */
+    template<typename Func>
+    size_t Consume(Func&& func)
+    {
+        uint64_t head = mHead.load(std::memory_order_acquire);
+        uint64_t tail = mTail.load(std::memory_order_relaxed);
+        size_t count = 0;
+
+        while (tail != head)
+        {
+            const LogBinaryRecord* record = GetRecord(tail);
+            if (record->mFormatId == UT_LOG_BINARY_FORMAT_PAD)
+            {
+                tail += record->mSize;
+                continue;
+            }
+
+            func(*record);
+            tail += Align(record->mSize);
+            count++;
+        }
+
+        mTail.store(tail, std::memory_order_release);
+
+        return count;
+    }
+
+    uint64_t GetDropped() const
+    {
+        return mDropped.load(std::memory_order_relaxed);
+    }
+
+    int32_t GetTid() const
+    {
+        return mTid;
+    }
+
+    size_t GetCapacity() const
+    {
+        return mCapacity;
+    }
+
+    /*
+     * set by the owner thread on exit. the store releases the ring once it
+     * has been drained.
+     */
+    void Close()
+    {
+        mClosed.store(true, std::memory_order_release);
+    }
+
+    bool IsClosed() const
+    {
+        return mClosed.load(std::memory_order_acquire);
+    }
+
+    bool Empty() const
+    {
+        return mHead.load(std::memory_order_acquire) == mTail.load(std::memory_order_relaxed);
+    }
+
+private:
+    static uint64_t Align(uint64_t size)
+    {
+        return (size + 7) & ~(uint64_t)7;
+    }
+
+    LogBinaryRecord* GetRecord(uint64_t pos) const
+    {
+        return (LogBinaryRecord*)((char*)mBuffer.get() + (pos & mMask));
+    }
+
+private:
+    alignas(64) std::atomic<uint64_t> mHead;
+    uint64_t mPendingHead;
+    uint64_t mTailCache;
+    alignas(64) std::atomic<uint64_t> mTail;
+    alignas(64) std::atomic<uint64_t> mDropped;
+    std::atomic<bool> mClosed;
+    int32_t mTid;
+    size_t mCapacity;
+    size_t mMask;
+    std::unique_ptr<uint64_t[]> mBuffer;
+};
+
+typedef std::shared_ptr<LogBinaryRing> LogBinaryRingPtr;
+
+class LogBinaryStore;
+
+/*
+ * rings owned by the calling thread, one per store. they are closed when
+ * the thread exits.
+ */
+class LogBinaryThreadRings
+{
+public:
+    LogBinaryThreadRings() :
+        mSerial(0), mRing(NULL)
+    {}
+
+    ~LogBinaryThreadRings()
+    {
+        for (size_t i=0; i<mRings.size(); i++)
+        {
+            mRings[i].second->Close();
+        }
+    }
+
+    LogBinaryRing* Get(LogBinaryStore* store, uint64_t serial);
+
+private:
+    uint64_t mSerial;
+    LogBinaryRing* mRing;
+    std::vector<std::pair<uint64_t,LogBinaryRingPtr>> mRings;
+};
+
+/*
+ * @brief: LogBinaryStore
+ * collects binary records from per thread rings on a writer thread, which
+ * either formats them into a text LogStore, or appends them raw to a binary
+ * file for LogBinaryDecoder, or both.
+ */
+class LogBinaryStore
+{
+public:
+    explicit LogBinaryStore(LogStorePtr textStorePtr, const std::string& binaryFileName = "",
+        uint64_t writeInterMicrosec = UT_LOG_WRITE_INTER, int32_t cpuId = UT_CPU_ID_NONE,
+        size_t ringSize = UT_LOG_BINARY_RING_SIZE) :
+        mTextStorePtr(textStorePtr), mRingSize(ringSize), mDropped(0), mRemovedDropped(0)
+    {
+        static std::atomic<uint64_t> serial(0);
+        mSerial = ++serial;
+
+        mPid = OsHelper::Instance()->GetProcessId();
+
+        struct timespec mono, real;
+        clock_gettime(CLOCK_MONOTONIC, &mono);
+        clock_gettime(CLOCK_REALTIME, &real);
+        mRealtimeOffset = (int64_t)ToNanosec(real) - (int64_t)ToNanosec(mono);
+
+        if (!binaryFileName.empty())
+        {
+            mFilePtr = FilePtr(new File(binaryFileName, UT_OPEN_FLAG_CWT, UT_OPEN_MODE_RW));
+            WriteFileHeader();
+        }
+
+        mThreadPtr = CreateRecurrentThreadEx("blog_writer", cpuId, writeInterMicrosec,
+            &LogBinaryStore::Flush, this);
+    }
+
+    ~LogBinaryStore()
+    {
+        mThreadPtr->Wait();
+        mThreadPtr.reset();
+        Flush();
+
+        if (mFilePtr)
+        {
+            mFilePtr->Close();
+        }
+    }
+
+    /*
+     * the calling thread's ring. the first call of each thread takes a lock.
+     */
+    LogBinaryRing* GetThreadRing()
+    {
+        static thread_local LogBinaryThreadRings rings;
+        return rings.Get(this, mSerial);
+    }
+
+    LogBinaryRingPtr CreateRing()
+    {
+        LogBinaryRingPtr ringPtr(new LogBinaryRing(mRingSize, OsHelper::Instance()->GetTid()));
+
+        LockGuard<Mutex> guard(mRingMutex);
+        mRings.push_back(ringPtr);
+
+        return ringPtr;
+    }
+
+    static uint64_t GetMonotonicNanosec()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ToNanosec(ts);
+    }
+
+    /*
+     * total records dropped because a ring was full.
+     */
+    uint64_t GetDropped()
+    {
+        LockGuard<Mutex> guard(mFlushMutex);
+        return mDropped;
+    }
+
+    /*
+     * drain every ring. runs on the writer thread, and may be called by
+     * others to flush early.
+     */
+    void Flush()
+    {
+        LockGuard<Mutex> guard(mFlushMutex);
+
+        std::vector<LogBinaryRingPtr> rings;
+        {
+            LockGuard<Mutex> ringGuard(mRingMutex);
+            rings = mRings;
+        }
+
+        mText.clear();
+        mBinary.clear();
+
+        uint64_t dropped = 0;
+
+        for (size_t i=0; i<rings.size(); i++)
+        {
+            LogBinaryRing* ring = rings[i].get();
+            bool closed = ring->IsClosed();
+
+            ring->Consume([this, ring](const LogBinaryRecord& record)
+            {
+                Output(ring->GetTid(), record);
+            });
+
+            /*
+             * a removed ring's drops move to mRemovedDropped, they are
+             * counted there only.
+             */
+            if (closed && ring->Empty())
+            {
+                RemoveRing(rings[i]);
+            }
+            else
+            {
+                dropped += ring->GetDropped();
+            }
+        }
+
+        dropped += mRemovedDropped;
+        if (dropped > mDropped)
+        {
+            OutputDrop(dropped - mDropped);
+            mDropped = dropped;
+        }
+
+        if (mTextStorePtr && !mText.empty())
+        {
+            mTextStorePtr->Append(mText);
+        }
+
+        if (mFilePtr && !mBinary.empty())
+        {
+            mFilePtr->Write(mBinary);
+        }
+    }
+
+private:
+    static uint64_t ToNanosec(const struct timespec& ts)
+    {
+        return (uint64_t)ts.tv_sec * UT_NUMER_NANO + ts.tv_nsec;
+    }
+
+    void RemoveRing(const LogBinaryRingPtr& ringPtr)
+    {
+        mRemovedDropped += ringPtr->GetDropped();
+
+        LockGuard<Mutex> guard(mRingMutex);
+        mRings.erase(std::remove(mRings.begin(), mRings.end(), ringPtr), mRings.end());
+    }
+
+    void Output(int32_t tid, const LogBinaryRecord& record)
+    {
+        const LogBinaryFormat* format = GetFormat(record.mFormatId);
+        if (format == NULL)
+        {
+            return;
+        }
+
+        const char* args = (const char*)&record + sizeof(LogBinaryRecord);
+        size_t len = record.mSize - sizeof(LogBinaryRecord);
+
+        if (mTextStorePtr)
+        {
+            LogBinaryFormatLine(mText, record.mTime + mRealtimeOffset, format->mLevel, mPid,
+                tid, format->mFormat, args, len);
+        }
+
+        if (mFilePtr)
+        {
+            if (mFormatWritten.size() <= record.mFormatId)
+            {
+                mFormatWritten.resize(record.mFormatId + 1, false);
+            }
+
+            if (!mFormatWritten[record.mFormatId])
+            {
+                WriteFormatEntry(*format);
+                mFormatWritten[record.mFormatId] = true;
+            }
+
+            AppendEntry(UT_LOG_BINARY_ENTRY_RECORD, sizeof(tid) + record.mSize);
+            AppendBinary(&tid, sizeof(tid));
+            AppendBinary(&record, record.mSize);
+        }
+    }
+
+    void OutputDrop(uint64_t count)
+    {
+        if (mTextStorePtr)
+        {
+            char buf[64];
+            snprintf(buf, sizeof(buf), "] [%u] [%d] binary log dropped %llu records\n", mPid,
+                OsHelper::Instance()->GetTid(), (unsigned long long)count);
+
+            mText += "[";
+            mText += GetTimeMillisecondString();
+            mText += "] [";
+            mText += GetLogLevelDesc(UT_LOG_WARNING);
+            mText += buf;
+        }
+
+        if (mFilePtr)
+        {
+            AppendEntry(UT_LOG_BINARY_ENTRY_DROP, sizeof(count));
+            AppendBinary(&count, sizeof(count));
+        }
+    }
+
+    const LogBinaryFormat* GetFormat(uint32_t id)
+    {
+        if (id >= mFormats.size() || mFormats[id] == NULL)
+        {
+            if (id >= mFormats.size())
+            {
+                mFormats.resize(id + 1, NULL);
+            }
+
+            mFormats[id] = LogBinaryFormatRegistry::Instance()->Get(id);
+        }
+
+        return mFormats[id];
+    }
+
+    void WriteFileHeader()
+    {
+        mBinary.assign(UT_LOG_BINARY_MAGIC, UT_LOG_BINARY_MAGIC_LEN);
+        AppendBinary(&mRealtimeOffset, sizeof(mRealtimeOffset));
+        AppendBinary(&mPid, sizeof(mPid));
+
+        mFilePtr->Write(mBinary);
+        mBinary.clear();
+    }
+
+    void WriteFormatEntry(const LogBinaryFormat& format)
+    {
+        uint32_t fileLen = strlen(format.mFile);
+        uint32_t formatLen = strlen(format.mFormat);
+
+        AppendEntry(UT_LOG_BINARY_ENTRY_FORMAT, 5 * sizeof(uint32_t) + fileLen + formatLen);
+        AppendBinary(&format.mId, sizeof(format.mId));
+        AppendBinary(&format.mLevel, sizeof(format.mLevel));
+        AppendBinary(&format.mLine, sizeof(format.mLine));
+        AppendBinary(&fileLen, sizeof(fileLen));
+        AppendBinary(format.mFile, fileLen);
+        AppendBinary(&formatLen, sizeof(formatLen));
+        AppendBinary(format.mFormat, formatLen);
+    }
+
+    void AppendEntry(uint32_t kind, uint32_t len)
+    {
+        AppendBinary(&kind, sizeof(kind));
+        AppendBinary(&len, sizeof(len));
+    }
+
+    void AppendBinary(const void* p, size_t len)
+    {
+        mBinary.append((const char*)p, len);
+    }
+
+private:
+    uint64_t mSerial;
+    uint32_t mPid;
+    int64_t mRealtimeOffset;
+    LogStorePtr mTextStorePtr;
+    FilePtr mFilePtr;
+    size_t mRingSize;
+
+    Mutex mRingMutex;
+    std::vector<LogBinaryRingPtr> mRings;
+
+    /*
+     * writer thread state, guarded by mFlushMutex.
+     */
+    Mutex mFlushMutex;
+    uint64_t mDropped;
+    uint64_t mRemovedDropped;
+    std::string mText;
+    std::string mBinary;
+    std::vector<const LogBinaryFormat*> mFormats;
+    std::vector<bool> mFormatWritten;
+
+    ThreadPtr mThreadPtr;
+};
+
+typedef std::shared_ptr<LogBinaryStore> LogBinaryStorePtr;
+
+inline LogBinaryRing* LogBinaryThreadRings::Get(LogBinaryStore* store, uint64_t serial)
+{
+    if (mSerial == serial)
+    {
+        return mRing;
+    }
+
+    LogBinaryRingPtr ringPtr;
+    for (size_t i=0; i<mRings.size(); i++)
+    {
+        if (mRings[i].first == serial)
+        {
+            ringPtr = mRings[i].second;
+            break;
+        }
+    }
+
+    if (ringPtr == NULL)
+    {
+        ringPtr = store->CreateRing();
+        mRings.push_back(std::make_pair(serial, ringPtr));
+    }
+
+    mSerial = serial;
+    mRing = ringPtr.get();
+
+    return mRing;
+}
+
+/*
+ * @brief: LogBinaryLogger
+ * logger for the BLOG_* macros. a call encodes the format id, a monotonic
+ * timestamp and the raw arguments into the thread ring. it takes no lock,
+ * allocates nothing after the thread's first call and never blocks.
+ */
+class LogBinaryLogger
+{
+public:
+    explicit LogBinaryLogger(int32_t level, LogBinaryStorePtr storePtr) :
+        mLevel(level), mStorePtr(storePtr)
+    {}
+
+    bool IsEnabled(int32_t level) const
+    {
+        return level <= mLevel && mStorePtr != NULL;
+    }
+
+    template<typename ...Args>
+    void Log(const LogBinaryFormat& format, const char*, const Args&... args)
+    {
+        LogBinaryRing* ring = mStorePtr->GetThreadRing();
+
+        size_t size = sizeof(LogBinaryRecord) + LogBinaryArg::SizeAll(args...);
+        char* p = ring->Reserve(size);
+        if (p == NULL)
+        {
+            return;
+        }
+
+        LogBinaryRecord* record = (LogBinaryRecord*)p;
+        record->mSize = (uint32_t)size;
+        record->mFormatId = format.mId;
+        record->mTime = LogBinaryStore::GetMonotonicNanosec();
+
+        p += sizeof(LogBinaryRecord);
+        LogBinaryArg::WriteAll(p, args...);
+
+        ring->Commit();
+    }
+
+    LogBinaryStorePtr GetStore() const
+    {
+        return mStorePtr;
+    }
+
+private:
+    int32_t mLevel;
+    LogBinaryStorePtr mStorePtr;
+};
+
+typedef std::shared_ptr<LogBinaryLogger> LogBinaryLoggerPtr;
+
+/*
+ * @brief: LogBinaryDecoder
+ * turns a binary file written by LogBinaryStore back into text lines.
+ */
+class LogBinaryDecoder
+{
+public:
+    /*
+     * return false if data is not a binary log or is truncated. lines
+     * decoded before the error are kept in text.
+     */
+    static bool Decode(const std::string& data, std::string& text)
+    {
+        const char* p = data.data();
+        const char* end = p + data.size();
+
+        int64_t realtimeOffset;
+        uint32_t pid;
+
+        if (data.size() < UT_LOG_BINARY_MAGIC_LEN + sizeof(realtimeOffset) + sizeof(pid) ||
+            memcmp(p, UT_LOG_BINARY_MAGIC, UT_LOG_BINARY_MAGIC_LEN) != 0)
+        {
+            return false;
+        }
+
+        p += UT_LOG_BINARY_MAGIC_LEN;
+        Read(p, realtimeOffset);
+        Read(p, pid);
+
+        std::map<uint32_t,std::pair<int32_t,std::string>> formats;
+
+        while (p < end)
+        {
+            uint32_t kind, len;
+            if (p + sizeof(kind) + sizeof(len) > end)
+            {
+                return false;
+            }
+
+            Read(p, kind);
+            Read(p, len);
+
+            const char* entry = p;
+            if (entry + len > end)
+            {
+                return false;
+            }
+
+            p += len;
+
+            if (kind == UT_LOG_BINARY_ENTRY_FORMAT)
+            {
+                uint32_t id, fileLen, formatLen;
+                int32_t level, line;
+
+                if (len < 5 * sizeof(uint32_t))
+                {
+                    return false;
+                }
+
+                Read(entry, id);
+                Read(entry, level);
+                Read(entry, line);
+                Read(entry, fileLen);
+                entry += fileLen;
+                if (entry + sizeof(formatLen) > p)
+                {
+                    return false;
+                }
+                Read(entry, formatLen);
+                if (entry + formatLen > p)
+                {
+                    return false;
+                }
+
+                formats[id] = std::make_pair(level, std::string(entry, formatLen));
+            }
+            else if (kind == UT_LOG_BINARY_ENTRY_RECORD)
+            {
+                int32_t tid;
+                LogBinaryRecord record;
+
+                if (len < sizeof(tid) + sizeof(record))
+                {
+                    return false;
+                }
+
+                Read(entry, tid);
+                Read(entry, record);
+
+                std::map<uint32_t,std::pair<int32_t,std::string>>::iterator iter =
+                    formats.find(record.mFormatId);
+                if (iter == formats.end())
+                {
+                    return false;
+                }
+
+                LogBinaryFormatLine(text, record.mTime + realtimeOffset, iter->second.first,
+                    pid, tid, iter->second.second.c_str(), entry, p - entry);
+            }
+            else if (kind == UT_LOG_BINARY_ENTRY_DROP)
+            {
+                uint64_t count;
+                if (len < sizeof(count))
+                {
+                    return false;
+                }
+
+                Read(entry, count);
+                text += "binary log dropped " + std::to_string(count) + " records\n";
+            }
+        }
+
+        return true;
+    }
+
+private:
+    template<typename T>
+    static void Read(const char*& p, T& value)
+    {
+        memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+    }
+};
+
+}
+}
+
+#endif//__UT_LOG_BINARY_HPP__
@@ -37,10 +37,25 @@
 
 #define UT_LOG_FILE_EXT             ".LOG"
 
+/*
+ * log calls above this level are compiled out. build with e.g.
+ * -DUT_LOG_COMPILE_LEVEL=UT_LOG_INFO to strip debug logs.
+ */
+#ifndef UT_LOG_COMPILE_LEVEL
+#define UT_LOG_COMPILE_LEVEL        UT_LOG_ALL
+#endif
+
+/*
+ * true if a log of level would be written. neither the arguments nor the
+ * message are built when it is false.
+ */
+#define UT_LOG_IS_ENABLED(logger, level)        \
+    ((level) <= UT_LOG_COMPILE_LEVEL && logger != NULL && logger->IsEnabled(level))
+
 //write log macro wrapper
 #define __UT_LOG(logger, level, ...)\
     do {                            \
-        if (logger != NULL)         \
+        if (UT_LOG_IS_ENABLED(logger, level))   \
         {                           \
             logger->Log(level, __VA_ARGS__);    \
         }                           \
@@ -48,7 +63,7 @@
 
 #define __UT_CRIT_LOG(logger, key, code, ...)   \
     do {                            \
-        if (logger != NULL)         \
+        if (UT_LOG_IS_ENABLED(logger, UT_LOG_CRIT))  \
         {                           \
             logger->CritLog(UT_LOG_CRIT, key, code, __VA_ARGS__);\
         }                           \
@@ -88,7 +103,7 @@
  */
 #define __UT_LOG_FMT(logger, level, keyvalues)  \
     do {                                        \
-        if (logger != NULL)                     \
+        if (UT_LOG_IS_ENABLED(logger, level))   \
         {                                       \
             logger->LogFormat(level, unitree::common::LogBuilder() keyvalues);    \
         }                                       \
@@ -96,7 +111,7 @@
 
 #define __UT_CRIT_LOG_FMT(logger, key, code, keyvalues)    \
     do {                                        \
-        if (logger != NULL)                     \
+        if (UT_LOG_IS_ENABLED(logger, UT_LOG_CRIT))  \
         {                                       \
             logger->CritLogFormat(UT_LOG_CRIT, key, code, unitree::common::LogBuilder() keyvalues);   \
         }                                       \
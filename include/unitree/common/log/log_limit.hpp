@@ -0,0 +1,295 @@
+#ifndef __UT_LOG_LIMIT_HPP__
+#define __UT_LOG_LIMIT_HPP__
+
+#include <unitree/common/log/log_logger.hpp>
+#include <unitree/common/thread/timer_service.hpp>
+
+/*
+ * interval(microsec) of the timer reporting suppressed counts which no
+ * passing message has reported.
+ */
+#define UT_LOG_LIMIT_FLUSH_INTER    1000000
+
+//write limited log macro wrapper
+/*
+ * one static limiter per call site. messages dropped by the limiter are
+ * counted and reported with the next message which passes, as
+ * " (suppressed N similar messages)". counts still pending are reported
+ * by a timer every UT_LOG_LIMIT_FLUSH_INTER and by LogLimitFlush().
+ */
+#define __UT_LOG_LIMIT(logger, level, limiter, ...)     \
+    do {                                                \
+        if (UT_LOG_IS_ENABLED(logger, level))           \
+        {                                               \
+            static unitree::common::limiter __ut_log_limiter(level, __FILE__, __LINE__);   \
+            uint64_t __ut_log_suppressed = 0;           \
+            if (__ut_log_limiter.Check(logger, __ut_log_suppressed))    \
+            {                                           \
+                logger->Log(level, __VA_ARGS__,         \
+                    unitree::common::LogSuppressed(__ut_log_suppressed));   \
+            }                                           \
+        }                                               \
+    } while (0)
+
+/*
+ * log the 1st and then every n-th message of the call site.
+ */
+#define __UT_LOG_EVERY_N(logger, level, n, ...)         \
+    __UT_LOG_LIMIT(logger, level, LogEveryN<n>, __VA_ARGS__)
+
+/*
+ * log at most n messages per second from the call site, allowing bursts of
+ * up to n.
+ */
+#define __UT_LOG_RATE_LIMIT(logger, level, n, ...)      \
+    __UT_LOG_LIMIT(logger, level, LogRateLimit<n>, __VA_ARGS__)
+
+//every n
+#define LOG_DEBUG_EVERY_N(logger, n, ...)       \
+    __UT_LOG_EVERY_N(logger, UT_LOG_DEBUG, n, __VA_ARGS__)
+
+#define LOG_INFO_EVERY_N(logger, n, ...)        \
+    __UT_LOG_EVERY_N(logger, UT_LOG_INFO, n, __VA_ARGS__)
+
+#define LOG_WARNING_EVERY_N(logger, n, ...)     \
+    __UT_LOG_EVERY_N(logger, UT_LOG_WARNING, n, __VA_ARGS__)
+
+#define LOG_ERROR_EVERY_N(logger, n, ...)       \
+    __UT_LOG_EVERY_N(logger, UT_LOG_ERROR, n, __VA_ARGS__)
+
+#define LOG_FATAL_EVERY_N(logger, n, ...)       \
+    __UT_LOG_EVERY_N(logger, UT_LOG_FATAL, n, __VA_ARGS__)
+
+//n per second
+#define LOG_DEBUG_RATE_LIMIT(logger, n, ...)    \
+    __UT_LOG_RATE_LIMIT(logger, UT_LOG_DEBUG, n, __VA_ARGS__)
+
+#define LOG_INFO_RATE_LIMIT(logger, n, ...)     \
+    __UT_LOG_RATE_LIMIT(logger, UT_LOG_INFO, n, __VA_ARGS__)
+
+#define LOG_WARNING_RATE_LIMIT(logger, n, ...)  \
+    __UT_LOG_RATE_LIMIT(logger, UT_LOG_WARNING, n, __VA_ARGS__)
+
+#define LOG_ERROR_RATE_LIMIT(logger, n, ...)    \
+    __UT_LOG_RATE_LIMIT(logger, UT_LOG_ERROR, n, __VA_ARGS__)
+
+#define LOG_FATAL_RATE_LIMIT(logger, n, ...)    \
+    __UT_LOG_RATE_LIMIT(logger, UT_LOG_FATAL, n, __VA_ARGS__)
+
+namespace unitree
+{
+namespace common
+{
+/*
+ * suffix appended to a limited log message.
+ */
+class LogSuppressed
+{
+public:
+    explicit LogSuppressed(uint64_t count) :
+        mCount(count)
+    {}
+
+public:
+    uint64_t mCount;
+};
+
+static inline std::ostream& operator<<(std::ostream& os, const LogSuppressed& suppressed)
+{
+    if (suppressed.mCount > 0)
+    {
+        os << " (suppressed " << suppressed.mCount << " similar messages)";
+    }
+
+    return os;
+}
+
+/*
+ * @brief: LogLimitSite
+ * suppressed count of one limited call site. the count is taken exactly
+ * once, either by the next message which passes or by the flush timer.
+ * the logger of the last suppressed message is kept for the report, so
+ * it must live as long as the process, as loggers from GetLogger do.
+ */
+class LogLimitSite
+{
+public:
+    LogLimitSite(int32_t level, const char* file, int32_t line) :
+        mLevel(level), mFile(file), mLine(line), mLogger(NULL), mSuppressed(0), mRegistered(false)
+    {}
+
+    void Suppress(Logger* logger);
+
+    uint64_t Take()
+    {
+        return mSuppressed.exchange(0, std::memory_order_relaxed);
+    }
+
+    void Report()
+    {
+        Logger* logger = mLogger.load(std::memory_order_acquire);
+        uint64_t suppressed = Take();
+
+        if (logger != NULL && suppressed > 0)
+        {
+            logger->Log(mLevel, "suppressed ", suppressed, " similar messages. ", mFile, ":", mLine);
+        }
+    }
+
+private:
+    int32_t mLevel;
+    const char* mFile;
+    int32_t mLine;
+    std::atomic<Logger*> mLogger;
+    std::atomic<uint64_t> mSuppressed;
+    std::atomic<bool> mRegistered;
+};
+
+/*
+ * @brief: LogLimitRegistry
+ * call sites which have suppressed a message, and the timer reporting
+ * their pending counts.
+ */
+class LogLimitRegistry
+{
+public:
+    static LogLimitRegistry* Instance()
+    {
+        static LogLimitRegistry inst;
+        return &inst;
+    }
+
+    void Add(LogLimitSite* site)
+    {
+        LockGuard<Mutex> guard(mMutex);
+        mSites.push_back(site);
+
+        if (mTimerId == 0)
+        {
+            mTimerId = TimerService::Instance()->AddRecurrent(UT_LOG_LIMIT_FLUSH_INTER,
+                &LogLimitRegistry::Flush, this);
+        }
+    }
+
+    void Flush()
+    {
+        LockGuard<Mutex> guard(mMutex);
+        for (size_t i=0; i<mSites.size(); i++)
+        {
+            mSites[i]->Report();
+        }
+    }
+
+private:
+    LogLimitRegistry() :
+        mTimerId(0)
+    {}
+
+private:
+    Mutex mMutex;
+    std::vector<LogLimitSite*> mSites;
+    uint64_t mTimerId;
+};
+
+inline void LogLimitSite::Suppress(Logger* logger)
+{
+    mLogger.store(logger, std::memory_order_release);
+    mSuppressed.fetch_add(1, std::memory_order_relaxed);
+
+    if (!mRegistered.exchange(true, std::memory_order_relaxed))
+    {
+        LogLimitRegistry::Instance()->Add(this);
+    }
+}
+
+/*
+ * report every pending suppressed count now, e.g. before exit.
+ */
+static inline void LogLimitFlush()
+{
+    LogLimitRegistry::Instance()->Flush();
+}
+
+/*
+ * @brief: LogEveryN
+ * passes the 1st and every N-th check.
+ */
+template<uint64_t N>
+class LogEveryN : public LogLimitSite
+{
+public:
+    static_assert(N > 0, "LogEveryN requires N > 0");
+
+    LogEveryN(int32_t level, const char* file, int32_t line) :
+        LogLimitSite(level, file, line), mCount(0)
+    {}
+
+    bool Check(Logger* logger, uint64_t& suppressed)
+    {
+        uint64_t count = mCount.fetch_add(1, std::memory_order_relaxed);
+        if (count % N != 0)
+        {
+            Suppress(logger);
+            return false;
+        }
+
+        suppressed = Take();
+
+        return true;
+    }
+
+private:
+    std::atomic<uint64_t> mCount;
+};
+
+/*
+ * @brief: LogRateLimit
+ * token bucket of N tokens refilled at N per second, kept as one atomic
+ * theoretical arrival time(GCRA), so checks never take a lock.
+ */
+template<uint64_t N>
+class LogRateLimit : public LogLimitSite
+{
+public:
+    static_assert(N > 0, "LogRateLimit requires N > 0");
+
+    LogRateLimit(int32_t level, const char* file, int32_t line) :
+        LogLimitSite(level, file, line), mArrival(0)
+    {}
+
+    bool Check(Logger* logger, uint64_t& suppressed)
+    {
+        const uint64_t interval = UT_NUMER_NANO / N;
+        const uint64_t burst = interval * (N - 1);
+
+        uint64_t now = GetCurrentMonotonicTimeNanosecond();
+        uint64_t arrival = mArrival.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            if (arrival > now + burst)
+            {
+                Suppress(logger);
+                return false;
+            }
+
+            uint64_t next = std::max(arrival, now) + interval;
+            if (mArrival.compare_exchange_weak(arrival, next, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+
+        suppressed = Take();
+
+        return true;
+    }
+
+private:
+    std::atomic<uint64_t> mArrival;
+};
+
+}
+}
+
+#endif//__UT_LOG_LIMIT_HPP__
@@ -30,6 +30,11 @@ public:
         mLevel(level), mStorePtr(storePtr)
     {}
 
+    bool IsEnabled(int32_t level) const
+    {
+        return level <= mLevel && mStorePtr != NULL;
+    }
+
     template<typename ...Args>
     void Log(int32_t level, Args&&... args)
     {
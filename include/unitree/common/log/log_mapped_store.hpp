@@ -0,0 +1,468 @@
+#ifndef __UT_LOG_MAPPED_STORE_HPP__
+#define __UT_LOG_MAPPED_STORE_HPP__
+
+#include <unitree/common/log/log_store.hpp>
+#include <deque>
+
+/*
+ * bytes at the head of a new segment written once while it is prepared,
+ * so the first appends after a rotation do not take page faults.
+ */
+#define UT_LOG_MMAP_PREFAULT_SIZE   1048576         //1M
+
+namespace unitree
+{
+namespace common
+{
+/*
+ * @brief: LogMappedSegment
+ * one preallocated log file mapped into memory. written bytes are
+ * truncated to the written length when the segment is closed.
+ */
+class LogMappedSegment
+{
+public:
+    LogMappedSegment(const std::string& fileName, uint64_t index, int64_t size) :
+        mFileName(fileName), mIndex(index), mFd(UT_FD_INVALID), mSize(size), mOffset(0),
+        mData(NULL)
+    {
+        mFd = open(fileName.c_str(), UT_OPEN_FLAG_C | UT_OPEN_FLAG_RW | UT_OPEN_FLAG_T,
+            UT_OPEN_MODE_RW);
+        UT_THROW_IF(mFd < 0, FileException, "open log segment failed. file:" + fileName +
+            ", error:" + strerror(errno));
+
+        /*
+         * reserve the blocks now, so writing never extends the file.
+         * fall back to a sparse file where fallocate is not supported.
+         */
+        if (posix_fallocate(mFd, 0, size) != 0 && ftruncate(mFd, size) != 0)
+        {
+            int32_t error = errno;
+            Close();
+            UT_THROW(FileException, "allocate log segment failed. file:" + fileName +
+                ", error:" + strerror(error));
+        }
+
+        void* data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, mFd, 0);
+        if (data == MAP_FAILED)
+        {
+            int32_t error = errno;
+            Close();
+            UT_THROW(FileException, "map log segment failed. file:" + fileName +
+                ", error:" + strerror(error));
+        }
+
+        mData = (char*)data;
+        madvise(mData, mSize, MADV_SEQUENTIAL);
+
+        int64_t prefaultSize = std::min((int64_t)UT_LOG_MMAP_PREFAULT_SIZE, mSize);
+        long pageSize = sysconf(_SC_PAGESIZE);
+        for (int64_t i=0; i<prefaultSize; i+=pageSize)
+        {
+            ((volatile char*)mData)[i] = 0;
+        }
+    }
+
+    ~LogMappedSegment()
+    {
+        Close();
+    }
+
+    /*
+     * return bytes written, less than len if the segment is full.
+     */
+    int64_t Write(const char* s, int64_t len)
+    {
+        len = std::min(len, mSize - mOffset);
+        memcpy(mData + mOffset, s, len);
+        mOffset += len;
+
+        return len;
+    }
+
+    int64_t GetFree() const
+    {
+        return mSize - mOffset;
+    }
+
+    bool Empty() const
+    {
+        return mOffset == 0;
+    }
+
+    uint64_t GetIndex() const
+    {
+        return mIndex;
+    }
+
+    const std::string& GetFileName() const
+    {
+        return mFileName;
+    }
+
+    void Sync()
+    {
+        if (mData != NULL)
+        {
+            msync(mData, mOffset, MS_ASYNC);
+        }
+    }
+
+    /*
+     * unmap and cut the file to the written length.
+     */
+    void Close()
+    {
+        if (mData != NULL)
+        {
+            munmap(mData, mSize);
+            mData = NULL;
+        }
+
+        if (mFd != UT_FD_INVALID)
+        {
+            if (ftruncate(mFd, mOffset) != 0)
+            {
+                /*
+                 * keep the file, the tail is zero filled.
+                 */
+            }
+
+            close(mFd);
+            mFd = UT_FD_INVALID;
+        }
+    }
+
+private:
+    std::string mFileName;
+    uint64_t mIndex;
+    int32_t mFd;
+    int64_t mSize;
+    int64_t mOffset;
+    char* mData;
+};
+
+typedef std::shared_ptr<LogMappedSegment> LogMappedSegmentPtr;
+
+/*
+ * @brief: LogMappedFileStore
+ * file store writing through memory-mapped, preallocated segments named
+ * <fileName>.<index>.LOG. a background thread prepares the next segment
+ * ahead of time, closes full ones and removes segments beyond fileNumber,
+ * so a rotation inside Append is a pointer switch.
+ */
+class LogMappedFileStore : public LogStore
+{
+public:
+    explicit LogMappedFileStore(const std::string& directory, const std::string& fileName,
+        int64_t fileSize = UT_LOG_FILE_SIZE, int32_t fileNumber = UT_LOG_FILE_NUMBER,
+        int32_t cpuId = UT_CPU_ID_NONE) :
+        mDirectory(directory), mFileName(fileName), mFileSize(fileSize),
+        mFileNumber(fileNumber), mQuit(false), mPreparing(false), mNextIndex(0)
+    {
+        UT_THROW_IF(fileSize <= 0 || fileNumber <= 0, CommonException,
+            "log segment size and number must be positive");
+
+        if (mDirectory.empty())
+        {
+            mDirectory = ".";
+        }
+
+        ScanSegments();
+
+        mCurrentPtr = CreateSegment();
+        mNextPtr = CreateSegment();
+        RemoveOldSegments(mFileNumber + 1);
+
+        mThreadPtr = CreateThreadEx("log_mmap", cpuId, &LogMappedFileStore::BackgroundFunc, this);
+    }
+
+    ~LogMappedFileStore()
+    {
+        {
+            LockGuard<MutexCond> guard(mMutexCond);
+            mQuit = true;
+            mMutexCond.NotifyAll();
+        }
+
+        mThreadPtr->Wait();
+
+        /*
+         * the background thread may have quit before the work of the last
+         * rotation. the prepared segment is newest, drop it first so
+         * exactly fileNumber segments are kept.
+         */
+        CloseSegments();
+
+        mCurrentPtr->Close();
+        if (mNextPtr)
+        {
+            mNextPtr->Close();
+            unlink(mNextPtr->GetFileName().c_str());
+
+            LockGuard<Mutex> guard(mIndexLock);
+            mIndexes.pop_back();
+        }
+
+        RemoveOldSegments(mFileNumber);
+    }
+
+    void Append(const std::string& s)
+    {
+        const char* p = s.c_str();
+        int64_t len = s.size();
+
+        LockGuard<Mutex> guard(mLock);
+
+        while (len > 0)
+        {
+            if (mCurrentPtr->GetFree() == 0)
+            {
+                Switch();
+            }
+
+            int64_t written = mCurrentPtr->Write(p, len);
+            p += written;
+            len -= written;
+        }
+    }
+
+    /*
+     * schedule writeback of the current segment.
+     */
+    void Sync()
+    {
+        LockGuard<Mutex> guard(mLock);
+        mCurrentPtr->Sync();
+    }
+
+    std::string GetCurrentFileName()
+    {
+        LockGuard<Mutex> guard(mLock);
+        return mCurrentPtr->GetFileName();
+    }
+
+private:
+    /*
+     * called with mLock held.
+     */
+    void Switch()
+    {
+        LogMappedSegmentPtr nextPtr;
+
+        {
+            LockGuard<MutexCond> guard(mMutexCond);
+
+            /*
+             * a segment the background thread is creating has the next
+             * index, wait for it.
+             */
+            while (mNextPtr == NULL && mPreparing)
+            {
+                mMutexCond.Wait(0);
+            }
+
+            nextPtr.swap(mNextPtr);
+
+            /*
+             * the background thread fell behind or failed. prepare inline
+             * rather than lose logs, under the lock so the background
+             * thread cannot take an index in between.
+             */
+            if (nextPtr == NULL)
+            {
+                nextPtr = CreateSegment();
+            }
+
+            mClosing.push_back(mCurrentPtr);
+            mMutexCond.NotifyAll();
+        }
+
+        mCurrentPtr = nextPtr;
+    }
+
+    int32_t BackgroundFunc()
+    {
+        /*
+         * batch scheduling keeps the wakeup at a rotation from preempting
+         * the logging thread on the same cpu.
+         */
+        struct sched_param param;
+        param.sched_priority = 0;
+        pthread_setschedparam(pthread_self(), SCHED_BATCH, &param);
+
+        while (true)
+        {
+            bool needNext = false;
+            std::vector<LogMappedSegmentPtr> closing;
+
+            {
+                LockGuard<MutexCond> guard(mMutexCond);
+                if (mNextPtr != NULL && mClosing.empty() && !mQuit)
+                {
+                    mMutexCond.Wait(0);
+                }
+
+                if (mQuit)
+                {
+                    break;
+                }
+
+                needNext = (mNextPtr == NULL);
+                mPreparing = needNext;
+                closing.swap(mClosing);
+            }
+
+            for (size_t i=0; i<closing.size(); i++)
+            {
+                closing[i]->Close();
+            }
+
+            if (needNext)
+            {
+                LogMappedSegmentPtr nextPtr;
+
+                try
+                {
+                    nextPtr = CreateSegment();
+                }
+                catch (const Exception&)
+                {
+                    /*
+                     * Switch prepares inline and reports the error.
+                     */
+                }
+
+                LockGuard<MutexCond> guard(mMutexCond);
+                mNextPtr = nextPtr;
+                mPreparing = false;
+                mMutexCond.NotifyAll();
+            }
+
+            RemoveOldSegments(mFileNumber + 1);
+        }
+
+        return 0;
+    }
+
+    void CloseSegments()
+    {
+        LockGuard<MutexCond> guard(mMutexCond);
+        for (size_t i=0; i<mClosing.size(); i++)
+        {
+            mClosing[i]->Close();
+        }
+
+        mClosing.clear();
+    }
+
+    LogMappedSegmentPtr CreateSegment()
+    {
+        uint64_t index;
+        {
+            LockGuard<Mutex> guard(mIndexLock);
+            index = mNextIndex++;
+            mIndexes.push_back(index);
+        }
+
+        return LogMappedSegmentPtr(new LogMappedSegment(MakeFileName(index), index, mFileSize));
+    }
+
+    /*
+     * keep the newest keep segments, fileNumber plus the prepared one while
+     * running.
+     */
+    void RemoveOldSegments(int32_t keep)
+    {
+        std::vector<uint64_t> removing;
+        {
+            LockGuard<Mutex> guard(mIndexLock);
+            while ((int32_t)mIndexes.size() > keep)
+            {
+                removing.push_back(mIndexes.front());
+                mIndexes.pop_front();
+            }
+        }
+
+        for (size_t i=0; i<removing.size(); i++)
+        {
+            unlink(MakeFileName(removing[i]).c_str());
+        }
+    }
+
+    /*
+     * continue after segments left by an earlier run.
+     */
+    void ScanSegments()
+    {
+        DIR* dir = opendir(mDirectory.c_str());
+        UT_THROW_IF(dir == NULL, FileException, "open log directory failed. directory:" +
+            mDirectory + ", error:" + strerror(errno));
+
+        std::string prefix = mFileName + ".";
+        std::string ext = UT_LOG_FILE_EXT;
+        std::vector<uint64_t> indexes;
+
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != NULL)
+        {
+            std::string name = entry->d_name;
+            if (name.size() <= prefix.size() + ext.size() ||
+                name.compare(0, prefix.size(), prefix) != 0 ||
+                name.compare(name.size() - ext.size(), ext.size(), ext) != 0)
+            {
+                continue;
+            }
+
+            std::string digits = name.substr(prefix.size(), name.size() - prefix.size() - ext.size());
+            if (digits.find_first_not_of("0123456789") != std::string::npos)
+            {
+                continue;
+            }
+
+            indexes.push_back(strtoull(digits.c_str(), NULL, 10));
+        }
+
+        closedir(dir);
+
+        std::sort(indexes.begin(), indexes.end());
+        mIndexes.assign(indexes.begin(), indexes.end());
+        mNextIndex = indexes.empty() ? 0 : indexes.back() + 1;
+    }
+
+    std::string MakeFileName(uint64_t index) const
+    {
+        char buf[32];
+        snprintf(buf, sizeof(buf), ".%06llu", (unsigned long long)index);
+
+        return mDirectory + UT_PATH_DELIM_STR + mFileName + buf + UT_LOG_FILE_EXT;
+    }
+
+private:
+    std::string mDirectory;
+    std::string mFileName;
+    int64_t mFileSize;
+    int32_t mFileNumber;
+
+    Mutex mLock;
+    LogMappedSegmentPtr mCurrentPtr;
+
+    MutexCond mMutexCond;
+    LogMappedSegmentPtr mNextPtr;
+    std::vector<LogMappedSegmentPtr> mClosing;
+    bool mQuit;
+    bool mPreparing;
+
+    Mutex mIndexLock;
+    uint64_t mNextIndex;
+    std::deque<uint64_t> mIndexes;
+
+    ThreadPtr mThreadPtr;
+};
+
+typedef std::shared_ptr<LogMappedFileStore> LogMappedFileStorePtr;
+
+}
+}
+
+#endif//__UT_LOG_MAPPED_STORE_HPP__
@@ -0,0 +1,626 @@
+#ifndef __UT_RING_BLOCK_QUEUE_HPP__
+#define __UT_RING_BLOCK_QUEUE_HPP__
+
+#include <unitree/common/exception.hpp>
+#include <unitree/common/lock/lock.hpp>
+
+namespace unitree
+{
+namespace common
+{
+/*
+ * @brief: RingBlockQueue
+ * bounded blocking queue with the same Put/Get/Interrupt semantics as
+ * BlockQueue, backed by a ring buffer instead of a std::list. the ring
+ * grows by doubling up to maxSize, so Put does not allocate once the queue
+ * has reached its working size. elements are moved in and out, and
+ * GetAll/Drain take a batch under one lock.
+ */
+template<typename T>
+class RingBlockQueue
+{
+public:
+    enum
+    {
+        INIT_CAPACITY = 16
+    };
+
+    explicit RingBlockQueue(uint64_t maxSize = UT_QUEUE_MAX_LEN) :
+        mMaxSize(maxSize), mHead(0), mSize(0)
+    {
+        if (mMaxSize == 0)
+        {
+            mMaxSize = UT_QUEUE_MAX_LEN;
+        }
+
+        mBuffer.resize(std::min<uint64_t>(mMaxSize, INIT_CAPACITY));
+    }
+
+    bool Put(const T& t, bool replace = false, bool putfront = false)
+    {
+        return PutInner(t, replace, putfront);
+    }
+
+    bool Put(T&& t, bool replace = false, bool putfront = false)
+    {
+        return PutInner(std::move(t), replace, putfront);
+    }
+
+    bool Get(T& t, uint64_t microsec = 0)
+    {
+        LockGuard<MutexCond> guard(mMutexCond);
+        if (!WaitNotEmpty(microsec))
+        {
+            return false;
+        }
+
+        t = PopFront();
+
+        return true;
+    }
+
+    T Get(uint64_t microsec = 0)
+    {
+        T t;
+        if (Get(t, microsec))
+        {
+            return t;
+        }
+
+        UT_THROW(TimeoutException, "ring block queue get timeout or interrupted");
+    }
+
+    /*
+     * wait as Get, then append every queued element to list.
+     * return the number of elements appended.
+     */
+    uint64_t GetAll(std::vector<T>& list, uint64_t microsec = 0)
+    {
+        return Drain(list, UT_QUEUE_MAX_LEN, microsec);
+    }
+
+    /*
+     * wait as Get, then append up to number queued elements to list.
+     * return the number of elements appended.
+     */
+    uint64_t Drain(std::vector<T>& list, uint64_t number, uint64_t microsec = 0)
+    {
+        LockGuard<MutexCond> guard(mMutexCond);
+        if (!WaitNotEmpty(microsec))
+        {
+            return 0;
+        }
+
+        uint64_t count = std::min<uint64_t>(number, mSize.load(std::memory_order_relaxed));
+        list.reserve(list.size() + count);
+
+        for (uint64_t i=0; i<count; i++)
+        {
+            list.emplace_back(PopFront());
+        }
+
+        return count;
+    }
+
+    bool Empty() const
+    {
+        return mSize.load(std::memory_order_relaxed) == 0;
+    }
+
+    uint64_t Size() const
+    {
+        return mSize.load(std::memory_order_relaxed);
+    }
+
+    void Interrupt(bool all = false)
+    {
+        LockGuard<MutexCond> guard(mMutexCond);
+        if (all)
+        {
+            mMutexCond.NotifyAll();
+        }
+        else
+        {
+            mMutexCond.Notify();
+        }
+    }
+
+private:
+    template<typename V>
+    bool PutInner(V&& t, bool replace, bool putfront)
+    {
+        /*
+         * if queue is full or full-replaced occured return false
+         */
+        bool noneReplaced = true;
+
+        LockGuard<MutexCond> guard(mMutexCond);
+
+        uint64_t size = mSize.load(std::memory_order_relaxed);
+        if (size >= mMaxSize)
+        {
+            if (!replace)
+            {
+                return false;
+            }
+
+            noneReplaced = false;
+
+            PopFront();
+            size--;
+        }
+        else if (size == mBuffer.size())
+        {
+            Grow();
+        }
+
+        uint64_t capacity = mBuffer.size();
+        if (putfront)
+        {
+            mHead = (mHead + capacity - 1) % capacity;
+            mBuffer[mHead] = std::forward<V>(t);
+        }
+        else
+        {
+            mBuffer[(mHead + size) % capacity] = std::forward<V>(t);
+        }
+
+        mSize.store(size + 1, std::memory_order_relaxed);
+        mMutexCond.Notify();
+
+        return noneReplaced;
+    }
+
+    bool WaitNotEmpty(uint64_t microsec)
+    {
+        if (mSize.load(std::memory_order_relaxed) == 0)
+        {
+            if (!mMutexCond.Wait(microsec))
+            {
+                return false;
+            }
+
+            if (mSize.load(std::memory_order_relaxed) == 0)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    T PopFront()
+    {
+        T t = std::move(mBuffer[mHead]);
+        mBuffer[mHead] = T();
+
+        mHead = (mHead + 1) % mBuffer.size();
+        mSize.store(mSize.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+
+        return t;
+    }
+
+    void Grow()
+    {
+        uint64_t capacity = mBuffer.size();
+        uint64_t size = mSize.load(std::memory_order_relaxed);
+
+        std::vector<T> buffer(std::min<uint64_t>(capacity * 2, mMaxSize));
+        for (uint64_t i=0; i<size; i++)
+        {
+            buffer[i] = std::move(mBuffer[(mHead + i) % capacity]);
+        }
+
+        mBuffer.swap(buffer);
+        mHead = 0;
+    }
+
+private:
+    uint64_t mMaxSize;
+    uint64_t mHead;
+    std::atomic<uint64_t> mSize;
+    std::vector<T> mBuffer;
+    MutexCond mMutexCond;
+};
+
+template <typename T>
+using RingBlockQueuePtr = std::shared_ptr<RingBlockQueue<T>>;
+
+/*
+ * @brief: QueueWaiter
+ * parks the consumer of a lock-free queue. the producer only takes the
+ * lock when the consumer has announced it is going to sleep.
+ */
+class QueueWaiter
+{
+public:
+    QueueWaiter() :
+        mWaiting(false)
+    {}
+
+    /*
+     * wait until empty() is false, microsec passed or Interrupt is called.
+     * return false if still empty.
+     */
+    template<typename EmptyFunc>
+    bool Wait(EmptyFunc empty, uint64_t microsec)
+    {
+        if (!empty())
+        {
+            return true;
+        }
+
+        LockGuard<MutexCond> guard(mMutexCond);
+
+        mWaiting.store(true, std::memory_order_seq_cst);
+        if (empty())
+        {
+            mMutexCond.Wait(microsec);
+        }
+        mWaiting.store(false, std::memory_order_relaxed);
+
+        return !empty();
+    }
+
+    /*
+     * call after publishing an element with a seq_cst store.
+     */
+    void Notify()
+    {
+        if (mWaiting.load(std::memory_order_seq_cst))
+        {
+            LockGuard<MutexCond> guard(mMutexCond);
+            mMutexCond.Notify();
+        }
+    }
+
+    void Interrupt(bool all)
+    {
+        LockGuard<MutexCond> guard(mMutexCond);
+        if (all)
+        {
+            mMutexCond.NotifyAll();
+        }
+        else
+        {
+            mMutexCond.Notify();
+        }
+    }
+
+private:
+    std::atomic<bool> mWaiting;
+    MutexCond mMutexCond;
+};
+
+/*
+ * @brief: SpscBlockQueue
+ * lock-free fixed capacity queue for exactly one producer thread and one
+ * consumer thread. Get blocks like BlockQueue::Get. Put fails when full,
+ * there is no replace or putfront since only the consumer may pop.
+ */
+template<typename T>
+class SpscBlockQueue
+{
+public:
+    enum
+    {
+        DEFAULT_CAPACITY = 1024
+    };
+
+    explicit SpscBlockQueue(uint64_t capacity = DEFAULT_CAPACITY) :
+        mHead(0), mTail(0)
+    {
+        UT_THROW_IF(capacity == 0, CommonException, "spsc block queue capacity is 0");
+
+        uint64_t size = 1;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+
+        mMask = size - 1;
+        mBuffer.resize(size);
+    }
+
+    bool Put(const T& t)
+    {
+        return PutInner(t);
+    }
+
+    bool Put(T&& t)
+    {
+        return PutInner(std::move(t));
+    }
+
+    bool Get(T& t, uint64_t microsec = 0)
+    {
+        if (!mWaiter.Wait([this]() { return IsEmpty(); }, microsec))
+        {
+            return false;
+        }
+
+        uint64_t head = mHead.load(std::memory_order_relaxed);
+        t = std::move(mBuffer[head & mMask]);
+        mBuffer[head & mMask] = T();
+        mHead.store(head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    T Get(uint64_t microsec = 0)
+    {
+        T t;
+        if (Get(t, microsec))
+        {
+            return t;
+        }
+
+        UT_THROW(TimeoutException, "spsc block queue get timeout or interrupted");
+    }
+
+    uint64_t GetAll(std::vector<T>& list, uint64_t microsec = 0)
+    {
+        return Drain(list, UT_QUEUE_MAX_LEN, microsec);
+    }
+
+    uint64_t Drain(std::vector<T>& list, uint64_t number, uint64_t microsec = 0)
+    {
+        if (!mWaiter.Wait([this]() { return IsEmpty(); }, microsec))
+        {
+            return 0;
+        }
+
+        uint64_t head = mHead.load(std::memory_order_relaxed);
+        uint64_t tail = mTail.load(std::memory_order_acquire);
+        uint64_t count = std::min<uint64_t>(number, tail - head);
+
+        list.reserve(list.size() + count);
+        for (uint64_t i=0; i<count; i++)
+        {
+            T& slot = mBuffer[(head + i) & mMask];
+            list.emplace_back(std::move(slot));
+            slot = T();
+        }
+
+        mHead.store(head + count, std::memory_order_release);
+
+        return count;
+    }
+
+    bool Empty() const
+    {
+        return IsEmpty();
+    }
+
+    uint64_t Size() const
+    {
+        return mTail.load(std::memory_order_acquire) - mHead.load(std::memory_order_acquire);
+    }
+
+    void Interrupt(bool all = false)
+    {
+        mWaiter.Interrupt(all);
+    }
+
+private:
+    template<typename V>
+    bool PutInner(V&& t)
+    {
+        uint64_t tail = mTail.load(std::memory_order_relaxed);
+        if (tail - mHead.load(std::memory_order_acquire) > mMask)
+        {
+            return false;
+        }
+
+        mBuffer[tail & mMask] = std::forward<V>(t);
+        mTail.store(tail + 1, std::memory_order_seq_cst);
+        mWaiter.Notify();
+
+        return true;
+    }
+
+    bool IsEmpty() const
+    {
+        return mHead.load(std::memory_order_relaxed) == mTail.load(std::memory_order_seq_cst);
+    }
+
+private:
+    alignas(64) std::atomic<uint64_t> mHead;
+    alignas(64) std::atomic<uint64_t> mTail;
+    uint64_t mMask;
+    std::vector<T> mBuffer;
+    QueueWaiter mWaiter;
+};
+
+template <typename T>
+using SpscBlockQueuePtr = std::shared_ptr<SpscBlockQueue<T>>;
+
+/*
+ * @brief: MpscBlockQueue
+ * lock-free fixed capacity queue for any number of producer threads and
+ * one consumer thread. slots carry a sequence number so producers claim
+ * them with a single CAS. Put fails when full.
+ */
+template<typename T>
+class MpscBlockQueue
+{
+public:
+    enum
+    {
+        DEFAULT_CAPACITY = 1024
+    };
+
+    explicit MpscBlockQueue(uint64_t capacity = DEFAULT_CAPACITY) :
+        mHead(0), mTail(0)
+    {
+        UT_THROW_IF(capacity == 0, CommonException, "mpsc block queue capacity is 0");
+
+        uint64_t size = 2;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+
+        mMask = size - 1;
+        mCells.reset(new Cell[size]);
+
+        for (uint64_t i=0; i<size; i++)
+        {
+            mCells[i].mSequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool Put(const T& t)
+    {
+        return PutInner(t);
+    }
+
+    bool Put(T&& t)
+    {
+        return PutInner(std::move(t));
+    }
+
+    bool Get(T& t, uint64_t microsec = 0)
+    {
+        if (!mWaiter.Wait([this]() { return IsEmpty(); }, microsec))
+        {
+            return false;
+        }
+
+        return Pop(t);
+    }
+
+    T Get(uint64_t microsec = 0)
+    {
+        T t;
+        if (Get(t, microsec))
+        {
+            return t;
+        }
+
+        UT_THROW(TimeoutException, "mpsc block queue get timeout or interrupted");
+    }
+
+    uint64_t GetAll(std::vector<T>& list, uint64_t microsec = 0)
+    {
+        return Drain(list, UT_QUEUE_MAX_LEN, microsec);
+    }
+
+    uint64_t Drain(std::vector<T>& list, uint64_t number, uint64_t microsec = 0)
+    {
+        if (!mWaiter.Wait([this]() { return IsEmpty(); }, microsec))
+        {
+            return 0;
+        }
+
+        uint64_t count = 0;
+        T t;
+
+        while (count < number && Pop(t))
+        {
+            list.emplace_back(std::move(t));
+            count++;
+        }
+
+        return count;
+    }
+
+    bool Empty() const
+    {
+        return IsEmpty();
+    }
+
+    uint64_t Size() const
+    {
+        int64_t n = mTail.load(std::memory_order_relaxed) - mHead.load(std::memory_order_relaxed);
+        return n > 0 ? n : 0;
+    }
+
+    void Interrupt(bool all = false)
+    {
+        mWaiter.Interrupt(all);
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<uint64_t> mSequence;
+        T mValue;
+    };
+
+    template<typename V>
+    bool PutInner(V&& t)
+    {
+        uint64_t pos = mTail.load(std::memory_order_relaxed);
+        Cell* cell;
+
+        while (true)
+        {
+            cell = &mCells[pos & mMask];
+            int64_t dif = (int64_t)cell->mSequence.load(std::memory_order_acquire) - (int64_t)pos;
+
+            if (dif == 0)
+            {
+                if (mTail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (dif < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = mTail.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->mValue = std::forward<V>(t);
+        cell->mSequence.store(pos + 1, std::memory_order_seq_cst);
+        mWaiter.Notify();
+
+        return true;
+    }
+
+    bool Pop(T& t)
+    {
+        uint64_t head = mHead.load(std::memory_order_relaxed);
+        Cell& cell = mCells[head & mMask];
+
+        if (cell.mSequence.load(std::memory_order_acquire) != head + 1)
+        {
+            return false;
+        }
+
+        t = std::move(cell.mValue);
+        cell.mValue = T();
+        cell.mSequence.store(head + mMask + 1, std::memory_order_release);
+        mHead.store(head + 1, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    /*
+     * a claimed but not yet published slot counts as empty.
+     */
+    bool IsEmpty() const
+    {
+        uint64_t head = mHead.load(std::memory_order_relaxed);
+        return mCells[head & mMask].mSequence.load(std::memory_order_seq_cst) != head + 1;
+    }
+
+private:
+    alignas(64) std::atomic<uint64_t> mHead;
+    alignas(64) std::atomic<uint64_t> mTail;
+    uint64_t mMask;
+    std::unique_ptr<Cell[]> mCells;
+    QueueWaiter mWaiter;
+};
+
+template <typename T>
+using MpscBlockQueuePtr = std::shared_ptr<MpscBlockQueue<T>>;
+
+}
+}
+#endif//__UT_RING_BLOCK_QUEUE_HPP__
@@ -72,6 +72,117 @@ bool EndWith(const std::string& s, const std::string& end,
 
 std::string Replace(const std::string& s, const std::string& partten,
     const std::string& target);
+
+/*
+ * base64(rfc 4648) with padding, for carrying binary in text fields.
+ */
+static inline std::string Base64Encode(const std::string& s)
+{
+    static const char table[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    const uint8_t* p = (const uint8_t*)s.c_str();
+    size_t len = s.size();
+
+    std::string out;
+    out.reserve((len + 2) / 3 * 4);
+
+    size_t i = 0;
+    for (; i + 2 < len; i += 3)
+    {
+        uint32_t n = ((uint32_t)p[i] << 16) | ((uint32_t)p[i+1] << 8) | p[i+2];
+        out += table[(n >> 18) & 0x3F];
+        out += table[(n >> 12) & 0x3F];
+        out += table[(n >> 6) & 0x3F];
+        out += table[n & 0x3F];
+    }
+
+    if (i < len)
+    {
+        uint32_t n = (uint32_t)p[i] << 16;
+        if (i + 1 < len)
+        {
+            n |= (uint32_t)p[i+1] << 8;
+        }
+
+        out += table[(n >> 18) & 0x3F];
+        out += table[(n >> 12) & 0x3F];
+        out += (i + 1 < len) ? table[(n >> 6) & 0x3F] : '=';
+        out += '=';
+    }
+
+    return out;
+}
+
+/*
+ * return false on characters outside the alphabet or a bad length.
+ */
+static inline bool Base64Decode(const std::string& s, std::string& out)
+{
+    size_t len = s.size();
+    if (len % 4 != 0)
+    {
+        return false;
+    }
+
+    size_t pad = 0;
+    if (len > 0 && s[len-1] == '=')
+    {
+        pad = (s[len-2] == '=') ? 2 : 1;
+    }
+
+    out.clear();
+    out.reserve(len / 4 * 3);
+
+    for (size_t i=0; i<len; i+=4)
+    {
+        uint32_t n = 0;
+        for (size_t j=0; j<4; j++)
+        {
+            char c = s[i+j];
+            uint32_t v;
+
+            if (c >= 'A' && c <= 'Z')
+            {
+                v = c - 'A';
+            }
+            else if (c >= 'a' && c <= 'z')
+            {
+                v = c - 'a' + 26;
+            }
+            else if (c >= '0' && c <= '9')
+            {
+                v = c - '0' + 52;
+            }
+            else if (c == '+')
+            {
+                v = 62;
+            }
+            else if (c == '/')
+            {
+                v = 63;
+            }
+            else if (c == '=' && i + j >= len - pad)
+            {
+                v = 0;
+            }
+            else
+            {
+                return false;
+            }
+
+            n = (n << 6) | v;
+        }
+
+        out += (char)(n >> 16);
+        out += (char)(n >> 8);
+        out += (char)n;
+    }
+
+    out.resize(out.size() - pad);
+
+    return true;
+}
 }
 }
 #endif//__UT_STRING_TOOL_HPP__
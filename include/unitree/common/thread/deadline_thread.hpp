@@ -0,0 +1,438 @@
+#ifndef __UT_DEADLINE_THREAD_HPP__
+#define __UT_DEADLINE_THREAD_HPP__
+
+#include <unitree/common/thread/thread.hpp>
+
+/*
+ * histogram bucket number.
+ * bucket 0 counts [0, 1us), bucket i counts [2^(i-1), 2^i) us
+ * and the last bucket counts everything above.
+ */
+#define UT_DEADLINE_HISTOGRAM_BUCKETS   20
+
+namespace unitree
+{
+namespace common
+{
+enum
+{
+    /*
+     * run missed periods back to back until the schedule is caught up.
+     */
+    UT_DEADLINE_OVERRUN_CATCHUP = 0,
+    /*
+     * drop missed periods and realign to the next deadline in the future.
+     */
+    UT_DEADLINE_OVERRUN_SKIP = 1
+};
+
+class DeadlinePolicy
+{
+public:
+    explicit DeadlinePolicy(int32_t overrun = UT_DEADLINE_OVERRUN_SKIP,
+        uint64_t spinMicrosec = 0, uint32_t maxCatchup = 0) :
+        mOverrun(overrun), mSpinMicrosec(spinMicrosec), mMaxCatchup(maxCatchup)
+    {}
+
+public:
+    int32_t mOverrun;
+    /*
+     * sleep until spinMicrosec before the deadline, then busy-wait the rest.
+     * 0 disables spinning.
+     */
+    uint64_t mSpinMicrosec;
+    /*
+     * max back to back runs for UT_DEADLINE_OVERRUN_CATCHUP before
+     * falling back to skip. 0 means unbounded.
+     */
+    uint32_t mMaxCatchup;
+};
+
+class DeadlineHistogram
+{
+public:
+    DeadlineHistogram() :
+        mCount(0), mSum(0), mMin(0), mMax(0)
+    {
+        memset(mBuckets, 0, sizeof(mBuckets));
+    }
+
+    static int32_t GetBucket(uint64_t nanosec)
+    {
+        uint64_t microsec = nanosec / UT_NUMER_MILLI;
+        if (microsec == 0)
+        {
+            return 0;
+        }
+
+        int32_t bucket = 64 - __builtin_clzll(microsec);
+        return bucket < UT_DEADLINE_HISTOGRAM_BUCKETS ? bucket : UT_DEADLINE_HISTOGRAM_BUCKETS - 1;
+    }
+
+    /*
+     * upper bound of bucket in nanosecond.
+     */
+    static uint64_t GetBucketBound(int32_t bucket)
+    {
+        if (bucket >= UT_DEADLINE_HISTOGRAM_BUCKETS - 1)
+        {
+            return UINT64_MAX;
+        }
+
+        return ((uint64_t)1 << bucket) * UT_NUMER_MILLI;
+    }
+
+    uint64_t GetMean() const
+    {
+        return mCount ? mSum / mCount : 0;
+    }
+
+    /*
+     * bucket upper bound below which ratio [0,1] of all samples fall.
+     */
+    uint64_t GetPercentile(double ratio) const
+    {
+        uint64_t target = (uint64_t)(ratio * mCount), acc = 0;
+
+        for (int32_t i=0; i<UT_DEADLINE_HISTOGRAM_BUCKETS; i++)
+        {
+            acc += mBuckets[i];
+            if (acc >= target && acc > 0)
+            {
+                uint64_t bound = GetBucketBound(i);
+                return bound < mMax ? bound : mMax;
+            }
+        }
+
+        return mMax;
+    }
+
+public:
+    uint64_t mCount;
+    uint64_t mSum;
+    uint64_t mMin;
+    uint64_t mMax;
+    uint64_t mBuckets[UT_DEADLINE_HISTOGRAM_BUCKETS];
+};
+
+class DeadlineStatistics
+{
+public:
+    DeadlineStatistics() :
+        mPeriods(0), mMissed(0), mSkipped(0)
+    {}
+
+public:
+    /*
+     * number of times the function was run.
+     */
+    uint64_t mPeriods;
+    /*
+     * runs which finished after the next deadline.
+     */
+    uint64_t mMissed;
+    /*
+     * periods dropped by UT_DEADLINE_OVERRUN_SKIP.
+     */
+    uint64_t mSkipped;
+    /*
+     * wake time minus deadline, in nanosecond.
+     */
+    DeadlineHistogram mJitter;
+    /*
+     * function execution time, in nanosecond.
+     */
+    DeadlineHistogram mExecution;
+};
+
+/*
+ * @brief: DeadlineThread
+ * RecurrentThread variant which schedules on absolute deadlines of the
+ * monotonic clock, so the period does not drift with execution time, and
+ * keeps per-thread jitter/execution statistics.
+ */
+class DeadlineThread : public Thread
+{
+public:
+    __UT_THREAD_DECL_TMPL_FUNC_ARG__
+    explicit DeadlineThread(uint64_t intervalMicrosec, const DeadlinePolicy& policy,
+        __UT_THREAD_TMPL_FUNC_ARG__)
+        : mQuit(false), mReset(false), mIntervalMicrosec(intervalMicrosec), mPolicy(policy)
+    {
+        Init(__UT_THREAD_BIND_FUNC_ARG__);
+    }
+
+    __UT_THREAD_DECL_TMPL_FUNC_ARG__
+    explicit DeadlineThread(const std::string& name, int32_t cpuId, uint64_t intervalMicrosec,
+        const DeadlinePolicy& policy, __UT_THREAD_TMPL_FUNC_ARG__)
+        : Thread(name, cpuId), mQuit(false), mReset(false), mIntervalMicrosec(intervalMicrosec),
+          mPolicy(policy)
+    {
+        Init(__UT_THREAD_BIND_FUNC_ARG__);
+    }
+
+    virtual ~DeadlineThread()
+    {
+        Wait();
+    }
+
+    bool Wait(int64_t microsec = 0)
+    {
+        mQuit = true;
+        return FutureWrapper::Wait(microsec);
+    }
+
+    uint64_t GetIntervalMicrosec() const
+    {
+        return mIntervalMicrosec;
+    }
+
+    /*
+     * snapshot of the statistics. fields are read one by one while the thread
+     * keeps running, so they may be off by the period in progress.
+     */
+    void GetStatistics(DeadlineStatistics& stat) const
+    {
+        stat.mPeriods = mStat.mPeriods.load(std::memory_order_relaxed);
+        stat.mMissed = mStat.mMissed.load(std::memory_order_relaxed);
+        stat.mSkipped = mStat.mSkipped.load(std::memory_order_relaxed);
+        mStat.mJitter.Load(stat.mJitter);
+        mStat.mExecution.Load(stat.mExecution);
+    }
+
+    /*
+     * statistics are cleared by the thread itself at its next period.
+     */
+    void ResetStatistics()
+    {
+        mReset.store(true, std::memory_order_relaxed);
+    }
+
+    int32_t ThreadFunc()
+    {
+        const int64_t period = mIntervalMicrosec * UT_NUMER_MILLI;
+        const int64_t spin = mPolicy.mSpinMicrosec * UT_NUMER_MILLI;
+
+        uint32_t catchup = 0;
+        int64_t deadline = GetMonotonicNanosec();
+
+        while (!mQuit)
+        {
+            WaitUntil(deadline, spin);
+
+            if (UT_UNLIKELY(mReset.load(std::memory_order_relaxed)))
+            {
+                mStat.Clear();
+                mReset.store(false, std::memory_order_relaxed);
+            }
+
+            int64_t wake = GetMonotonicNanosec();
+            mFunc();
+            int64_t done = GetMonotonicNanosec();
+
+            mStat.mJitter.Add(wake > deadline ? wake - deadline : 0);
+            mStat.mExecution.Add(done - wake);
+            Increase(mStat.mPeriods, 1);
+
+            deadline += period;
+            if (done <= deadline)
+            {
+                catchup = 0;
+                continue;
+            }
+
+            Increase(mStat.mMissed, 1);
+
+            if (mPolicy.mOverrun == UT_DEADLINE_OVERRUN_CATCHUP &&
+                (mPolicy.mMaxCatchup == 0 || catchup < mPolicy.mMaxCatchup))
+            {
+                catchup ++;
+            }
+            else
+            {
+                int64_t skipped = (done - deadline) / period + 1;
+                deadline += skipped * period;
+                Increase(mStat.mSkipped, skipped);
+                catchup = 0;
+            }
+        }
+
+        return 0;
+    }
+
+protected:
+    /*
+     * for derived threads which bind the function and start their own
+     * entry, which then calls ThreadFunc.
+     */
+    DeadlineThread(const std::string& name, uint64_t intervalMicrosec, const DeadlinePolicy& policy)
+        : Thread(name, UT_CPU_ID_NONE), mQuit(false), mReset(false), mIntervalMicrosec(intervalMicrosec),
+          mPolicy(policy)
+    {}
+
+    __UT_THREAD_DECL_TMPL_FUNC_ARG__
+    void Bind(__UT_THREAD_TMPL_FUNC_ARG__)
+    {
+        UT_THROW_IF(mIntervalMicrosec == 0, CommonException, "deadline thread interval is 0");
+
+        mFunc = std::bind(__UT_THREAD_BIND_FUNC_ARG__);
+    }
+
+private:
+    __UT_THREAD_DECL_TMPL_FUNC_ARG__
+    void Init(__UT_THREAD_TMPL_FUNC_ARG__)
+    {
+        Bind(__UT_THREAD_BIND_FUNC_ARG__);
+        RunRegistered(&DeadlineThread::ThreadFunc, this);
+    }
+
+    static int64_t GetMonotonicNanosec()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (int64_t)ts.tv_sec * UT_NUMER_NANO + ts.tv_nsec;
+    }
+
+    static void WaitUntil(int64_t deadline, int64_t spin)
+    {
+        int64_t wake = deadline - spin;
+
+        struct timespec ts;
+        ts.tv_sec = wake / UT_NUMER_NANO;
+        ts.tv_nsec = wake % UT_NUMER_NANO;
+
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+        {}
+
+        if (spin > 0)
+        {
+            while (GetMonotonicNanosec() < deadline)
+            {
+                UT_CPU_RELAX();
+            }
+        }
+    }
+
+    /*
+     * counters have one writer, so a plain load/store avoids the locked rmw.
+     */
+    static void Increase(std::atomic<uint64_t>& counter, uint64_t n)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    class AtomicHistogram
+    {
+    public:
+        AtomicHistogram()
+        {
+            Clear();
+        }
+
+        void Clear()
+        {
+            mCount.store(0, std::memory_order_relaxed);
+            mSum.store(0, std::memory_order_relaxed);
+            mMin.store(0, std::memory_order_relaxed);
+            mMax.store(0, std::memory_order_relaxed);
+
+            for (int32_t i=0; i<UT_DEADLINE_HISTOGRAM_BUCKETS; i++)
+            {
+                mBuckets[i].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        void Add(uint64_t nanosec)
+        {
+            uint64_t count = mCount.load(std::memory_order_relaxed);
+
+            if (count == 0 || nanosec < mMin.load(std::memory_order_relaxed))
+            {
+                mMin.store(nanosec, std::memory_order_relaxed);
+            }
+            if (nanosec > mMax.load(std::memory_order_relaxed))
+            {
+                mMax.store(nanosec, std::memory_order_relaxed);
+            }
+
+            Increase(mBuckets[DeadlineHistogram::GetBucket(nanosec)], 1);
+            Increase(mSum, nanosec);
+            mCount.store(count + 1, std::memory_order_relaxed);
+        }
+
+        void Load(DeadlineHistogram& hist) const
+        {
+            hist.mCount = mCount.load(std::memory_order_relaxed);
+            hist.mSum = mSum.load(std::memory_order_relaxed);
+            hist.mMin = mMin.load(std::memory_order_relaxed);
+            hist.mMax = mMax.load(std::memory_order_relaxed);
+
+            for (int32_t i=0; i<UT_DEADLINE_HISTOGRAM_BUCKETS; i++)
+            {
+                hist.mBuckets[i] = mBuckets[i].load(std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        std::atomic<uint64_t> mCount;
+        std::atomic<uint64_t> mSum;
+        std::atomic<uint64_t> mMin;
+        std::atomic<uint64_t> mMax;
+        std::atomic<uint64_t> mBuckets[UT_DEADLINE_HISTOGRAM_BUCKETS];
+    };
+
+    class AtomicStatistics
+    {
+    public:
+        AtomicStatistics()
+        {
+            Clear();
+        }
+
+        void Clear()
+        {
+            mPeriods.store(0, std::memory_order_relaxed);
+            mMissed.store(0, std::memory_order_relaxed);
+            mSkipped.store(0, std::memory_order_relaxed);
+            mJitter.Clear();
+            mExecution.Clear();
+        }
+
+    public:
+        std::atomic<uint64_t> mPeriods;
+        std::atomic<uint64_t> mMissed;
+        std::atomic<uint64_t> mSkipped;
+        AtomicHistogram mJitter;
+        AtomicHistogram mExecution;
+    };
+
+private:
+    volatile bool mQuit;
+    std::atomic<bool> mReset;
+    uint64_t mIntervalMicrosec;
+    DeadlinePolicy mPolicy;
+    AtomicStatistics mStat;
+    std::function<void()> mFunc;
+};
+
+typedef std::shared_ptr<DeadlineThread> DeadlineThreadPtr;
+
+__UT_THREAD_DECL_TMPL_FUNC_ARG__
+DeadlineThreadPtr CreateDeadlineThread(uint64_t intervalMicrosec, const DeadlinePolicy& policy,
+    __UT_THREAD_TMPL_FUNC_ARG__)
+{
+    return DeadlineThreadPtr(new DeadlineThread(intervalMicrosec, policy, __UT_THREAD_BIND_FUNC_ARG__));
+}
+
+__UT_THREAD_DECL_TMPL_FUNC_ARG__
+DeadlineThreadPtr CreateDeadlineThreadEx(const std::string& name, int32_t cpuId, uint64_t intervalMicrosec,
+    const DeadlinePolicy& policy, __UT_THREAD_TMPL_FUNC_ARG__)
+{
+    return DeadlineThreadPtr(new DeadlineThread(name, cpuId, intervalMicrosec, policy,
+        __UT_THREAD_BIND_FUNC_ARG__));
+}
+
+}
+}
+
+#endif//__UT_DEADLINE_THREAD_HPP__
@@ -0,0 +1,424 @@
+#ifndef __UT_REALTIME_THREAD_HPP__
+#define __UT_REALTIME_THREAD_HPP__
+
+#include <unitree/common/thread/deadline_thread.hpp>
+#include <sys/mman.h>
+#include <malloc.h>
+#include <alloca.h>
+#include <atomic>
+
+/*
+ * default stack bytes touched before the thread function runs.
+ * must stay below the thread stack size.
+ */
+#define UT_REALTIME_STACK_PREFAULT_SIZE     (256 * 1024)
+
+namespace unitree
+{
+namespace common
+{
+class RealtimeProfile
+{
+public:
+    explicit RealtimeProfile(int32_t policy = SCHED_FIFO, int32_t priority = 80,
+        int32_t cpuId = UT_CPU_ID_NONE, bool lockMemory = true,
+        uint64_t stackPrefaultSize = UT_REALTIME_STACK_PREFAULT_SIZE,
+        uint64_t heapReserveSize = 0) :
+        mPolicy(policy), mPriority(priority), mCpuId(cpuId), mLockMemory(lockMemory),
+        mStackPrefaultSize(stackPrefaultSize), mHeapReserveSize(heapReserveSize)
+    {}
+
+public:
+    /*
+     * SCHED_FIFO, SCHED_RR or SCHED_OTHER(priority 0).
+     */
+    int32_t mPolicy;
+    int32_t mPriority;
+    /*
+     * UT_CPU_ID_NONE keeps the inherited affinity.
+     */
+    int32_t mCpuId;
+    /*
+     * mlockall(MCL_CURRENT|MCL_FUTURE). this is process wide.
+     */
+    bool mLockMemory;
+    /*
+     * 0 disables stack prefaulting. not granted if the size does not fit
+     * in what is left of the thread stack.
+     */
+    uint64_t mStackPrefaultSize;
+    /*
+     * bytes malloc'ed, touched and freed back to the thread arena, so later
+     * allocations up to this size do not fault. the freed memory only stays
+     * mapped once the process called RealtimeHelper::RetainHeap(), without
+     * it the reserve is not granted. 0 disables the reserve.
+     */
+    uint64_t mHeapReserveSize;
+};
+
+/*
+ * what the system actually granted for a RealtimeProfile. items which were
+ * not requested are reported as granted.
+ */
+class RealtimeGrant
+{
+public:
+    RealtimeGrant() :
+        mCpuPinned(false), mMemoryLocked(false), mHeapReserved(false),
+        mStackPrefaulted(false), mScheduled(false), mError(0)
+    {}
+
+    bool IsGranted() const
+    {
+        return mCpuPinned && mMemoryLocked && mHeapReserved && mStackPrefaulted && mScheduled;
+    }
+
+public:
+    bool mCpuPinned;
+    bool mMemoryLocked;
+    bool mHeapReserved;
+    bool mStackPrefaulted;
+    bool mScheduled;
+    /*
+     * errno of the first item which failed, 0 if none.
+     */
+    int32_t mError;
+};
+
+/*
+ * @brief: RealtimeHelper
+ * applies a RealtimeProfile to the calling thread.
+ */
+class RealtimeHelper
+{
+public:
+    /*
+     * process wide opt in for mHeapReserveSize: malloc no longer trims
+     * freed memory back to the os nor serves large blocks with mmap. this
+     * changes every allocation of the process, so it is never done by
+     * Apply. call it once, e.g. from main, before creating realtime
+     * threads with a heap reserve.
+     */
+    static bool RetainHeap()
+    {
+        if (mallopt(M_TRIM_THRESHOLD, -1) == 0 || mallopt(M_MMAP_MAX, 0) == 0)
+        {
+            return false;
+        }
+
+        HeapRetained().store(true, std::memory_order_release);
+        return true;
+    }
+
+    static void Apply(const RealtimeProfile& profile, RealtimeGrant& grant)
+    {
+        grant = RealtimeGrant();
+
+        /*
+         * pin first so the memory touched below is local to the target cpu,
+         * and raise the priority last so prefaulting does not run as RT.
+         */
+        grant.mCpuPinned = true;
+        if (profile.mCpuId != UT_CPU_ID_NONE)
+        {
+            cpu_set_t cpuSet;
+            CPU_ZERO(&cpuSet);
+            CPU_SET(profile.mCpuId, &cpuSet);
+
+            SetResult(grant, grant.mCpuPinned,
+                pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet));
+        }
+
+        grant.mMemoryLocked = true;
+        if (profile.mLockMemory)
+        {
+            SetResult(grant, grant.mMemoryLocked,
+                mlockall(MCL_CURRENT | MCL_FUTURE) == 0 ? 0 : errno);
+        }
+
+        grant.mHeapReserved = true;
+        if (profile.mHeapReserveSize > 0)
+        {
+            SetResult(grant, grant.mHeapReserved, ReserveHeap(profile.mHeapReserveSize));
+        }
+
+        grant.mStackPrefaulted = true;
+        if (profile.mStackPrefaultSize > 0)
+        {
+            SetResult(grant, grant.mStackPrefaulted, PrefaultStack(profile.mStackPrefaultSize));
+        }
+
+        struct sched_param param;
+        param.sched_priority = profile.mPriority;
+
+        SetResult(grant, grant.mScheduled,
+            pthread_setschedparam(pthread_self(), profile.mPolicy, &param));
+    }
+
+private:
+    static void SetResult(RealtimeGrant& grant, bool& item, int32_t error)
+    {
+        item = (error == 0);
+        if (error != 0 && grant.mError == 0)
+        {
+            grant.mError = error;
+        }
+    }
+
+    static std::atomic<bool>& HeapRetained()
+    {
+        static std::atomic<bool> retained(false);
+        return retained;
+    }
+
+    static int32_t ReserveHeap(uint64_t size)
+    {
+        /*
+         * without RetainHeap the memory would go back to the os on free.
+         */
+        if (!HeapRetained().load(std::memory_order_acquire))
+        {
+            return EPERM;
+        }
+
+        char* p = (char*)malloc(size);
+        if (p == NULL)
+        {
+            return ENOMEM;
+        }
+
+        long pageSize = sysconf(_SC_PAGESIZE);
+        for (uint64_t i=0; i<size; i+=pageSize)
+        {
+            ((volatile char*)p)[i] = 0;
+        }
+
+        free(p);
+
+        return 0;
+    }
+
+    static int32_t PrefaultStack(uint64_t size)
+    {
+        pthread_attr_t attr;
+        int32_t error = pthread_getattr_np(pthread_self(), &attr);
+        if (error != 0)
+        {
+            return error;
+        }
+
+        void* stackAddr = NULL;
+        size_t stackSize = 0;
+        error = pthread_attr_getstack(&attr, &stackAddr, &stackSize);
+        pthread_attr_destroy(&attr);
+
+        if (error != 0)
+        {
+            return error;
+        }
+
+        /*
+         * the stack grows down to stackAddr. leave a page for the frames
+         * below this one.
+         */
+        char here = 0;
+        uint64_t left = (uint64_t)(&here - (char*)stackAddr);
+        if (size + sysconf(_SC_PAGESIZE) > left)
+        {
+            return ENOMEM;
+        }
+
+        TouchStack(size);
+
+        return 0;
+    }
+
+    static __attribute__((noinline)) void TouchStack(uint64_t size)
+    {
+        volatile char* p = (volatile char*)alloca(size);
+
+        long pageSize = sysconf(_SC_PAGESIZE);
+        for (uint64_t i=0; i<size; i+=pageSize)
+        {
+            p[i] = 0;
+        }
+    }
+};
+
+/*
+ * @brief: RealtimeSetup
+ * applies a profile inside the thread and lets other threads wait for the
+ * grant.
+ */
+class RealtimeSetup
+{
+public:
+    explicit RealtimeSetup(const RealtimeProfile& profile) :
+        mProfile(profile), mApplied(false)
+    {}
+
+    void Apply()
+    {
+        RealtimeGrant grant;
+        RealtimeHelper::Apply(mProfile, grant);
+
+        LockGuard<MutexCond> guard(mMutexCond);
+        mGrant = grant;
+        mApplied = true;
+        mMutexCond.NotifyAll();
+    }
+
+    bool GetGrant(RealtimeGrant& grant, int64_t microsec)
+    {
+        LockGuard<MutexCond> guard(mMutexCond);
+        if (!mApplied)
+        {
+            mMutexCond.Wait(microsec);
+        }
+
+        if (mApplied)
+        {
+            grant = mGrant;
+        }
+
+        return mApplied;
+    }
+
+    const RealtimeProfile& GetProfile() const
+    {
+        return mProfile;
+    }
+
+private:
+    RealtimeProfile mProfile;
+    RealtimeGrant mGrant;
+    bool mApplied;
+    MutexCond mMutexCond;
+};
+
+/*
+ * @brief: RealtimeThread
+ * thread which applies a RealtimeProfile to itself before running func once.
+ */
+class RealtimeThread : public Thread
+{
+public:
+    __UT_THREAD_DECL_TMPL_FUNC_ARG__
+    explicit RealtimeThread(const RealtimeProfile& profile, __UT_THREAD_TMPL_FUNC_ARG__)
+        : mSetup(profile)
+    {
+        mFunc = std::bind(__UT_THREAD_BIND_FUNC_ARG__);
+        RunRegistered(&RealtimeThread::ThreadFunc, this);
+    }
+
+    __UT_THREAD_DECL_TMPL_FUNC_ARG__
+    explicit RealtimeThread(const std::string& name, const RealtimeProfile& profile,
+        __UT_THREAD_TMPL_FUNC_ARG__)
+        : Thread(name, UT_CPU_ID_NONE), mSetup(profile)
+    {
+        mFunc = std::bind(__UT_THREAD_BIND_FUNC_ARG__);
+        RunRegistered(&RealtimeThread::ThreadFunc, this);
+    }
+
+    virtual ~RealtimeThread()
+    {
+        Wait();
+    }
+
+    /*
+     * wait up to microsec(0 for ever) for the profile to be applied.
+     * return false if it has not been applied yet.
+     */
+    bool GetGrant(RealtimeGrant& grant, int64_t microsec = 0)
+    {
+        return mSetup.GetGrant(grant, microsec);
+    }
+
+    int32_t ThreadFunc()
+    {
+        mSetup.Apply();
+        mFunc();
+
+        return 0;
+    }
+
+private:
+    RealtimeSetup mSetup;
+    std::function<void()> mFunc;
+};
+
+typedef std::shared_ptr<RealtimeThread> RealtimeThreadPtr;
+
+/*
+ * @brief: RealtimeRecurrentThread
+ * DeadlineThread which applies a RealtimeProfile to itself before the
+ * first period.
+ */
+class RealtimeRecurrentThread : public DeadlineThread
+{
+public:
+    __UT_THREAD_DECL_TMPL_FUNC_ARG__
+    explicit RealtimeRecurrentThread(const std::string& name, uint64_t intervalMicrosec,
+        const RealtimeProfile& profile, const DeadlinePolicy& policy, __UT_THREAD_TMPL_FUNC_ARG__)
+        : DeadlineThread(name, intervalMicrosec, policy), mSetup(profile)
+    {
+        Bind(__UT_THREAD_BIND_FUNC_ARG__);
+        RunRegistered(&RealtimeRecurrentThread::RealtimeFunc, this);
+    }
+
+    virtual ~RealtimeRecurrentThread()
+    {
+        Wait();
+    }
+
+    bool GetGrant(RealtimeGrant& grant, int64_t microsec = 0)
+    {
+        return mSetup.GetGrant(grant, microsec);
+    }
+
+    int32_t RealtimeFunc()
+    {
+        mSetup.Apply();
+        return ThreadFunc();
+    }
+
+private:
+    RealtimeSetup mSetup;
+};
+
+typedef std::shared_ptr<RealtimeRecurrentThread> RealtimeRecurrentThreadPtr;
+
+__UT_THREAD_DECL_TMPL_FUNC_ARG__
+RealtimeThreadPtr CreateRealtimeThread(const RealtimeProfile& profile, __UT_THREAD_TMPL_FUNC_ARG__)
+{
+    return RealtimeThreadPtr(new RealtimeThread(profile, __UT_THREAD_BIND_FUNC_ARG__));
+}
+
+__UT_THREAD_DECL_TMPL_FUNC_ARG__
+RealtimeThreadPtr CreateRealtimeThreadEx(const std::string& name, const RealtimeProfile& profile,
+    __UT_THREAD_TMPL_FUNC_ARG__)
+{
+    return RealtimeThreadPtr(new RealtimeThread(name, profile, __UT_THREAD_BIND_FUNC_ARG__));
+}
+
+__UT_THREAD_DECL_TMPL_FUNC_ARG__
+RealtimeRecurrentThreadPtr CreateRealtimeRecurrentThread(uint64_t intervalMicrosec,
+    const RealtimeProfile& profile, __UT_THREAD_TMPL_FUNC_ARG__)
+{
+    return RealtimeRecurrentThreadPtr(new RealtimeRecurrentThread("", intervalMicrosec, profile,
+        DeadlinePolicy(), __UT_THREAD_BIND_FUNC_ARG__));
+}
+
+__UT_THREAD_DECL_TMPL_FUNC_ARG__
+RealtimeRecurrentThreadPtr CreateRealtimeRecurrentThreadEx(const std::string& name,
+    uint64_t intervalMicrosec, const RealtimeProfile& profile, const DeadlinePolicy& policy,
+    __UT_THREAD_TMPL_FUNC_ARG__)
+{
+    return RealtimeRecurrentThreadPtr(new RealtimeRecurrentThread(name, intervalMicrosec, profile,
+        policy, __UT_THREAD_BIND_FUNC_ARG__));
+}
+
+}
+}
+
+#endif//__UT_REALTIME_THREAD_HPP__
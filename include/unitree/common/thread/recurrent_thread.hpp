@@ -64,18 +64,23 @@ private:
 
 typedef std::shared_ptr<RecurrentThread> RecurrentThreadPtr;
 
+/*
+ * static like CreateThread/Ex: the registered variants are local to each
+ * translation unit and do not replace the library's instantiations.
+ */
 __UT_THREAD_DECL_TMPL_FUNC_ARG__
-ThreadPtr CreateRecurrentThread(uint64_t intervalMicrosec, __UT_THREAD_TMPL_FUNC_ARG__)
+static inline ThreadPtr CreateRecurrentThread(uint64_t intervalMicrosec, __UT_THREAD_TMPL_FUNC_ARG__)
 {
-    return ThreadPtr(new RecurrentThread(intervalMicrosec, __UT_THREAD_BIND_FUNC_ARG__));
+    return ThreadPtr(new RecurrentThread(intervalMicrosec,
+        MakeThreadRegistryFunc("", std::bind(__UT_THREAD_BIND_FUNC_ARG__))));
 }
 
 __UT_THREAD_DECL_TMPL_FUNC_ARG__
-ThreadPtr CreateRecurrentThreadEx(const std::string& name, int32_t cpuId, uint64_t intervalMicrosec,
+static inline ThreadPtr CreateRecurrentThreadEx(const std::string& name, int32_t cpuId, uint64_t intervalMicrosec,
     __UT_THREAD_TMPL_FUNC_ARG__)
 {
     return ThreadPtr(new RecurrentThread(name, cpuId, intervalMicrosec,
-        __UT_THREAD_BIND_FUNC_ARG__));
+        MakeThreadRegistryFunc(name, std::bind(__UT_THREAD_BIND_FUNC_ARG__))));
 }
 
 }
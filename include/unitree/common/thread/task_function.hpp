@@ -0,0 +1,200 @@
+#ifndef __UT_TASK_FUNCTION_HPP__
+#define __UT_TASK_FUNCTION_HPP__
+
+#include <unitree/common/thread/thread_decl.hpp>
+#include <cstddef>
+#include <tuple>
+
+/*
+ * callables up to this size are stored inside TaskFunction itself.
+ */
+#define UT_TASK_FUNCTION_INLINE_SIZE    48
+
+namespace unitree
+{
+namespace common
+{
+/*
+ * @brief: TaskFunction
+ * move-only void() callable with small-buffer storage. unlike
+ * std::function<Any()> it neither requires a copyable target nor allocates
+ * for callables that fit in UT_TASK_FUNCTION_INLINE_SIZE.
+ */
+class TaskFunction
+{
+public:
+    TaskFunction() :
+        mOps(NULL)
+    {}
+
+    template<typename F, typename = typename std::enable_if<
+        !std::is_same<typename std::decay<F>::type, TaskFunction>::value>::type>
+    TaskFunction(F&& f) :
+        mOps(NULL)
+    {
+        Construct<typename std::decay<F>::type>(std::forward<F>(f));
+    }
+
+    TaskFunction(TaskFunction&& other) noexcept :
+        mOps(NULL)
+    {
+        MoveFrom(other);
+    }
+
+    TaskFunction& operator=(TaskFunction&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Reset();
+            MoveFrom(other);
+        }
+
+        return *this;
+    }
+
+    TaskFunction(const TaskFunction&) = delete;
+    TaskFunction& operator=(const TaskFunction&) = delete;
+
+    ~TaskFunction()
+    {
+        Reset();
+    }
+
+    void Reset()
+    {
+        if (mOps != NULL)
+        {
+            mOps->mDestroy(mStorage);
+            mOps = NULL;
+        }
+    }
+
+    bool Empty() const
+    {
+        return mOps == NULL;
+    }
+
+    explicit operator bool() const
+    {
+        return mOps != NULL;
+    }
+
+    void operator()()
+    {
+        mOps->mInvoke(mStorage);
+    }
+
+    template<typename F>
+    static constexpr bool IsInline()
+    {
+        return sizeof(F) <= UT_TASK_FUNCTION_INLINE_SIZE &&
+            alignof(F) <= alignof(std::max_align_t) &&
+            std::is_nothrow_move_constructible<F>::value;
+    }
+
+private:
+    struct Ops
+    {
+        void (*mInvoke)(void*);
+        void (*mMove)(void* dst, void* src);
+        void (*mDestroy)(void*);
+    };
+
+    template<typename F>
+    struct InlineOps
+    {
+        static void Invoke(void* p)
+        {
+            (*static_cast<F*>(p))();
+        }
+
+        static void Move(void* dst, void* src)
+        {
+            new (dst) F(std::move(*static_cast<F*>(src)));
+            static_cast<F*>(src)->~F();
+        }
+
+        static void Destroy(void* p)
+        {
+            static_cast<F*>(p)->~F();
+        }
+
+        static const Ops* Get()
+        {
+            static const Ops ops = { &Invoke, &Move, &Destroy };
+            return &ops;
+        }
+    };
+
+    template<typename F>
+    struct HeapOps
+    {
+        static void Invoke(void* p)
+        {
+            (**static_cast<F**>(p))();
+        }
+
+        static void Move(void* dst, void* src)
+        {
+            *static_cast<F**>(dst) = *static_cast<F**>(src);
+        }
+
+        static void Destroy(void* p)
+        {
+            delete *static_cast<F**>(p);
+        }
+
+        static const Ops* Get()
+        {
+            static const Ops ops = { &Invoke, &Move, &Destroy };
+            return &ops;
+        }
+    };
+
+    template<typename F, typename T>
+    typename std::enable_if<IsInline<F>()>::type Construct(T&& f)
+    {
+        new (mStorage) F(std::forward<T>(f));
+        mOps = InlineOps<F>::Get();
+    }
+
+    template<typename F, typename T>
+    typename std::enable_if<!IsInline<F>()>::type Construct(T&& f)
+    {
+        *reinterpret_cast<F**>(mStorage) = new F(std::forward<T>(f));
+        mOps = HeapOps<F>::Get();
+    }
+
+    void MoveFrom(TaskFunction& other)
+    {
+        if (other.mOps != NULL)
+        {
+            other.mOps->mMove(mStorage, other.mStorage);
+            mOps = other.mOps;
+            other.mOps = NULL;
+        }
+    }
+
+private:
+    alignas(std::max_align_t) unsigned char mStorage[UT_TASK_FUNCTION_INLINE_SIZE];
+    const Ops* mOps;
+};
+
+/*
+ * bind func and args into a TaskFunction without std::bind/std::function.
+ * the result of func is discarded.
+ */
+__UT_THREAD_DECL_TMPL_FUNC_ARG__
+TaskFunction MakeTaskFunction(__UT_THREAD_TMPL_FUNC_ARG__)
+{
+    return TaskFunction([f = std::forward<Func>(func),
+        t = std::make_tuple(std::forward<Args>(args)...)]() mutable
+        {
+            std::apply(f, t);
+        });
+}
+
+}
+}
+
+#endif//__UT_TASK_FUNCTION_HPP__
@@ -2,6 +2,7 @@
 #define __UT_THREAD_HPP__
 
 #include <unitree/common/thread/future.hpp>
+#include <unitree/common/thread/thread_registry.hpp>
 
 namespace unitree
 {
@@ -50,6 +51,16 @@ protected:
         CreateThreadNative();
     }
 
+    /*
+     * Run, and the thread is listed in ThreadRegistry under mName until it
+     * exits.
+     */
+    __UT_THREAD_DECL_TMPL_FUNC_ARG__
+    void RunRegistered(__UT_THREAD_TMPL_FUNC_ARG__)
+    {
+        Run(MakeThreadRegistryFunc(mName, std::bind(__UT_THREAD_BIND_FUNC_ARG__)));
+    }
+
     void CreateThreadNative();
 
 protected:
@@ -64,13 +75,14 @@ typedef std::shared_ptr<Thread> ThreadPtr;
 __UT_THREAD_DECL_TMPL_FUNC_ARG__
 static inline ThreadPtr CreateThread(__UT_THREAD_TMPL_FUNC_ARG__)
 {
-    return ThreadPtr(new Thread(__UT_THREAD_BIND_FUNC_ARG__));
+    return ThreadPtr(new Thread(MakeThreadRegistryFunc("", std::bind(__UT_THREAD_BIND_FUNC_ARG__))));
 }
 
 __UT_THREAD_DECL_TMPL_FUNC_ARG__
 static inline ThreadPtr CreateThreadEx(const std::string& name, int32_t cpuId, __UT_THREAD_TMPL_FUNC_ARG__)
 {
-    return ThreadPtr(new Thread(name, cpuId, __UT_THREAD_BIND_FUNC_ARG__));
+    return ThreadPtr(new Thread(name, cpuId,
+        MakeThreadRegistryFunc(name, std::bind(__UT_THREAD_BIND_FUNC_ARG__))));
 }
 
 }
@@ -4,7 +4,9 @@
 #include <unitree/common/log/log.hpp>
 #include <unitree/common/thread/thread.hpp>
 #include <unitree/common/thread/thread_task.hpp>
+#include <unitree/common/thread/typed_future.hpp>
 #include <unitree/common/block_queue.hpp>
+#include <unitree/common/time/time_tool.hpp>
 
 namespace unitree
 {
@@ -64,6 +66,45 @@ public:
         return FuturePtr();
     }
 
+    /*
+     * typed variant of AddTaskFuture. the returned future is invalid if the
+     * task is not queued, and faulted if the task is dropped unrun.
+     */
+    __UT_THREAD_DECL_TMPL_FUNC_ARG__
+    TypedFuture<typename TaskResult<Func, Args...>::Type> AddTaskTypedFuture(__UT_THREAD_TMPL_FUNC_ARG__)
+    {
+        TypedPromise<typename TaskResult<Func, Args...>::Type> promise;
+
+        if (AddTask(MakePromiseTask(promise, __UT_THREAD_BIND_FUNC_ARG__)))
+        {
+            return promise.GetFuture();
+        }
+
+        return TypedFuture<typename TaskResult<Func, Args...>::Type>();
+    }
+
+    /*
+     * list the workers in ThreadRegistry under name. they are started inside
+     * the library, so each registers itself from one queued task, which it
+     * holds until every worker has taken one, so none takes two. return
+     * false if not all workers got to it within microsec.
+     */
+    bool RegisterThreads(const std::string& name, uint64_t microsec = QUEUE_GET_TIMEOUT_MICROSEC)
+    {
+        std::shared_ptr<ThreadArrival> arrival(new ThreadArrival(mThreadList.size(),
+            GetCurrentMonotonicTimeMicrosecond() + microsec));
+
+        for (size_t i=0; i<arrival->mNumber; i++)
+        {
+            if (!AddTask(&ThreadArrival::Arrive, arrival, name))
+            {
+                return false;
+            }
+        }
+
+        return arrival->Wait();
+    }
+
     int32_t DoTask();
     uint64_t GetTaskSize();
 
@@ -73,6 +114,57 @@ public:
     bool IsTaskOverdue(uint64_t enqueueTime);
 
 private:
+    class ThreadArrival
+    {
+    public:
+        ThreadArrival(size_t number, uint64_t deadline) :
+            mNumber(number), mCount(0), mDeadline(deadline)
+        {}
+
+        int32_t Arrive(const std::string& name)
+        {
+            ThreadRegistry::Instance()->RegisterCurrent(name);
+
+            LockGuard<MutexCond> guard(mMutexCond);
+            mCount++;
+            mMutexCond.NotifyAll();
+            WaitAll();
+
+            return 0;
+        }
+
+        bool Wait()
+        {
+            LockGuard<MutexCond> guard(mMutexCond);
+            return WaitAll();
+        }
+
+    private:
+        bool WaitAll()
+        {
+            while (mCount < mNumber)
+            {
+                uint64_t now = GetCurrentMonotonicTimeMicrosecond();
+                if (now >= mDeadline)
+                {
+                    return false;
+                }
+
+                mMutexCond.Wait(mDeadline - now);
+            }
+
+            return true;
+        }
+
+    public:
+        size_t mNumber;
+
+    private:
+        size_t mCount;
+        uint64_t mDeadline;
+        MutexCond mMutexCond;
+    };
+
     bool AddTaskInner(ThreadTaskPtr taskptr);
 
     void InitCreateThread();
@@ -0,0 +1,352 @@
+#ifndef __UT_THREAD_REGISTRY_HPP__
+#define __UT_THREAD_REGISTRY_HPP__
+
+#include <unitree/common/decl.hpp>
+#include <unitree/common/lock/lock.hpp>
+#include <unitree/common/time/time_tool.hpp>
+#include <sys/syscall.h>
+#include <dirent.h>
+
+namespace unitree
+{
+namespace common
+{
+/*
+ * cpu usage of one thread at snapshot time.
+ */
+class ThreadCpuStat
+{
+public:
+    ThreadCpuStat() :
+        mTid(0), mRegistered(false), mUserNanosec(0), mSystemNanosec(0),
+        mVoluntarySwitch(0), mInvoluntarySwitch(0), mLastCpu(-1)
+    {}
+
+public:
+    int32_t mTid;
+    /*
+     * kernel thread name(comm), at most 15 chars.
+     */
+    std::string mName;
+    /*
+     * true for threads started through common::Thread, whose full name is
+     * in mRegisteredName.
+     */
+    bool mRegistered;
+    std::string mRegisteredName;
+
+    uint64_t mUserNanosec;
+    uint64_t mSystemNanosec;
+    uint64_t mVoluntarySwitch;
+    uint64_t mInvoluntarySwitch;
+    /*
+     * cpu the thread last ran on.
+     */
+    int32_t mLastCpu;
+};
+
+/*
+ * @brief: ThreadRegistry
+ * process-wide registry of threads started through CreateThread/Ex,
+ * CreateRecurrentThread/Ex, the deadline and realtime threads and
+ * ThreadPool::RegisterThreads, and snapshots of per-thread cpu time,
+ * context switches and last cpu read from /proc/self/task. threads created
+ * elsewhere(dds receive threads, threads the prebuilt library starts)
+ * appear in snapshots by their kernel name.
+ */
+class ThreadRegistry
+{
+public:
+    static ThreadRegistry* Instance()
+    {
+        static ThreadRegistry inst;
+        return &inst;
+    }
+
+    /*
+     * register the calling thread until the scope ends.
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(const std::string& name) :
+            mTid(GetTid())
+        {
+            ThreadRegistry::Instance()->Register(mTid, name);
+        }
+
+        ~Scope()
+        {
+            ThreadRegistry::Instance()->Unregister(mTid);
+        }
+
+    private:
+        int32_t mTid;
+    };
+
+    static int32_t GetTid()
+    {
+        return (int32_t)syscall(SYS_gettid);
+    }
+
+    /*
+     * register the calling thread until it exits. calling it again renames
+     * the thread.
+     */
+    void RegisterCurrent(const std::string& name)
+    {
+        CurrentThread& current = GetCurrentThread();
+        if (current.mTid == 0)
+        {
+            current.mTid = GetTid();
+        }
+
+        Register(current.mTid, name);
+    }
+
+    void Register(int32_t tid, const std::string& name)
+    {
+        LockGuard<Mutex> guard(mMutex);
+        mThreadMap[tid] = name;
+    }
+
+    void Unregister(int32_t tid)
+    {
+        LockGuard<Mutex> guard(mMutex);
+        mThreadMap.erase(tid);
+    }
+
+    size_t GetRegisteredSize()
+    {
+        LockGuard<Mutex> guard(mMutex);
+        return mThreadMap.size();
+    }
+
+    /*
+     * sample every thread of the process, or only registered ones.
+     */
+    void Snapshot(std::vector<ThreadCpuStat>& list, bool registeredOnly = false)
+    {
+        std::map<int32_t,std::string> threadMap;
+        {
+            LockGuard<Mutex> guard(mMutex);
+            threadMap = mThreadMap;
+        }
+
+        DIR* dir = opendir("/proc/self/task");
+        if (dir == NULL)
+        {
+            return;
+        }
+
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != NULL)
+        {
+            if (entry->d_name[0] < '0' || entry->d_name[0] > '9')
+            {
+                continue;
+            }
+
+            ThreadCpuStat stat;
+            stat.mTid = atoi(entry->d_name);
+
+            std::map<int32_t,std::string>::iterator iter = threadMap.find(stat.mTid);
+            if (iter != threadMap.end())
+            {
+                stat.mRegistered = true;
+                stat.mRegisteredName = iter->second;
+            }
+            else if (registeredOnly)
+            {
+                continue;
+            }
+
+            /*
+             * the thread may exit between readdir and read.
+             */
+            if (Sample(stat))
+            {
+                list.push_back(stat);
+            }
+        }
+
+        closedir(dir);
+    }
+
+    /*
+     * sample one thread by tid.
+     */
+    static bool Sample(ThreadCpuStat& stat)
+    {
+        std::string path = "/proc/self/task/" + std::to_string(stat.mTid);
+        return ReadStat(path + "/stat", stat) && ReadStatus(path + "/status", stat);
+    }
+
+private:
+    ThreadRegistry()
+    {}
+
+    /*
+     * unregisters the thread from its thread_local destructor.
+     */
+    class CurrentThread
+    {
+    public:
+        CurrentThread() :
+            mTid(0)
+        {}
+
+        ~CurrentThread()
+        {
+            if (mTid != 0)
+            {
+                ThreadRegistry::Instance()->Unregister(mTid);
+            }
+        }
+
+        int32_t mTid;
+    };
+
+    static CurrentThread& GetCurrentThread()
+    {
+        static thread_local CurrentThread current;
+        return current;
+    }
+
+    static bool ReadFile(const std::string& fileName, char* buf, size_t size)
+    {
+        FILE* fp = fopen(fileName.c_str(), "r");
+        if (fp == NULL)
+        {
+            return false;
+        }
+
+        size_t len = fread(buf, 1, size - 1, fp);
+        buf[len] = 0;
+        fclose(fp);
+
+        return len > 0;
+    }
+
+    static bool ReadStat(const std::string& fileName, ThreadCpuStat& stat)
+    {
+        char buf[1024];
+        if (!ReadFile(fileName, buf, sizeof(buf)))
+        {
+            return false;
+        }
+
+        /*
+         * pid (comm) state ... comm may contain spaces and parentheses.
+         */
+        char* begin = strchr(buf, '(');
+        char* end = strrchr(buf, ')');
+        if (begin == NULL || end == NULL || end < begin)
+        {
+            return false;
+        }
+
+        stat.mName.assign(begin + 1, end - begin - 1);
+
+        /*
+         * fields after comm start at 3(state). utime 14, stime 15,
+         * processor 39.
+         */
+        uint64_t utime = 0, stime = 0;
+        int32_t field = 3;
+        char* save = NULL;
+
+        for (char* tok = strtok_r(end + 2, " ", &save); tok != NULL;
+            tok = strtok_r(NULL, " ", &save), field++)
+        {
+            if (field == 14)
+            {
+                utime = strtoull(tok, NULL, 10);
+            }
+            else if (field == 15)
+            {
+                stime = strtoull(tok, NULL, 10);
+            }
+            else if (field == 39)
+            {
+                stat.mLastCpu = atoi(tok);
+                break;
+            }
+        }
+
+        static const uint64_t tickNanosec = UT_NUMER_NANO / sysconf(_SC_CLK_TCK);
+        stat.mUserNanosec = utime * tickNanosec;
+        stat.mSystemNanosec = stime * tickNanosec;
+
+        return true;
+    }
+
+    static bool ReadStatus(const std::string& fileName, ThreadCpuStat& stat)
+    {
+        char buf[4096];
+        if (!ReadFile(fileName, buf, sizeof(buf)))
+        {
+            return false;
+        }
+
+        const char* p = strstr(buf, "voluntary_ctxt_switches:");
+        if (p != NULL && p > buf && *(p - 1) == '\n')
+        {
+            stat.mVoluntarySwitch = strtoull(p + 24, NULL, 10);
+        }
+
+        p = strstr(buf, "nonvoluntary_ctxt_switches:");
+        if (p != NULL)
+        {
+            stat.mInvoluntarySwitch = strtoull(p + 27, NULL, 10);
+        }
+
+        return true;
+    }
+
+private:
+    Mutex mMutex;
+    std::map<int32_t,std::string> mThreadMap;
+};
+
+/*
+ * @brief: ThreadRegistryFunc
+ * calls func and registers the calling thread under name on the first
+ * call, so a thread is registered from its own entry without changing
+ * Thread::Run, which the prebuilt library instantiates too.
+ */
+template<typename F>
+class ThreadRegistryFunc
+{
+public:
+    ThreadRegistryFunc(const std::string& name, F func) :
+        mRegistered(false), mName(name), mFunc(std::move(func))
+    {}
+
+    auto operator()() -> decltype(std::declval<F&>()())
+    {
+        if (UT_UNLIKELY(!mRegistered))
+        {
+            ThreadRegistry::Instance()->RegisterCurrent(mName);
+            mRegistered = true;
+        }
+
+        return mFunc();
+    }
+
+private:
+    bool mRegistered;
+    std::string mName;
+    F mFunc;
+};
+
+template<typename F>
+inline ThreadRegistryFunc<typename std::decay<F>::type> MakeThreadRegistryFunc(const std::string& name, F&& func)
+{
+    return ThreadRegistryFunc<typename std::decay<F>::type>(name, std::forward<F>(func));
+}
+
+}
+}
+
+#endif//__UT_THREAD_REGISTRY_HPP__
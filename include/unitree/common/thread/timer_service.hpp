@@ -0,0 +1,692 @@
+#ifndef __UT_TIMER_SERVICE_HPP__
+#define __UT_TIMER_SERVICE_HPP__
+
+#include <unitree/common/thread/realtime_thread.hpp>
+
+/*
+ * default wheel tick. timers fire on tick boundaries.
+ */
+#define UT_TIMER_TICK_MICROSEC          1000
+
+namespace unitree
+{
+namespace common
+{
+enum
+{
+    /*
+     * callbacks run on a normal priority thread.
+     */
+    UT_TIMER_GROUP_NORMAL = 0,
+    /*
+     * callbacks run on a thread with the service realtime profile.
+     */
+    UT_TIMER_GROUP_REALTIME = 1,
+    UT_TIMER_GROUP_NUMBER = 2
+};
+
+/*
+ * @brief: TimerWheel
+ * hierarchical timing wheel of LEVEL_NUMBER levels with SLOT_NUMBER slots
+ * each. insert and cancel are O(1), a timer is cascaded at most once per
+ * level. not thread safe, TimerGroup serializes access.
+ */
+class TimerWheel
+{
+public:
+    enum
+    {
+        SLOT_BITS = 6,
+        SLOT_NUMBER = 1 << SLOT_BITS,
+        SLOT_MASK = SLOT_NUMBER - 1,
+        LEVEL_NUMBER = 4
+    };
+
+    class Node
+    {
+    public:
+        Node() :
+            mId(0), mExpireTick(0), mIntervalTick(0), mCancelled(false),
+            mSlot(NULL), mPrev(NULL), mNext(NULL)
+        {}
+
+    public:
+        uint64_t mId;
+        uint64_t mExpireTick;
+        /*
+         * 0 for one-shot timers.
+         */
+        uint64_t mIntervalTick;
+        bool mCancelled;
+        std::function<void()> mFunc;
+
+        /*
+         * head of the slot list the node is linked in.
+         */
+        Node** mSlot;
+        Node* mPrev;
+        Node* mNext;
+    };
+
+    TimerWheel() :
+        mCurrentTick(0)
+    {
+        for (int32_t level=0; level<LEVEL_NUMBER; level++)
+        {
+            for (int32_t slot=0; slot<SLOT_NUMBER; slot++)
+            {
+                mSlots[level][slot] = NULL;
+            }
+        }
+    }
+
+    uint64_t GetCurrentTick() const
+    {
+        return mCurrentTick;
+    }
+
+    /*
+     * only valid while the wheel is empty.
+     */
+    void SetCurrentTick(uint64_t tick)
+    {
+        mCurrentTick = tick;
+    }
+
+    /*
+     * a node expiring at or before the current tick fires on the next tick.
+     */
+    void Insert(Node* node)
+    {
+        if (node->mExpireTick <= mCurrentTick)
+        {
+            node->mExpireTick = mCurrentTick + 1;
+        }
+
+        Place(node);
+    }
+
+    void Remove(Node* node)
+    {
+        if (node->mSlot == NULL)
+        {
+            return;
+        }
+
+        if (node->mPrev != NULL)
+        {
+            node->mPrev->mNext = node->mNext;
+        }
+        else
+        {
+            *node->mSlot = node->mNext;
+        }
+
+        if (node->mNext != NULL)
+        {
+            node->mNext->mPrev = node->mPrev;
+        }
+
+        Unlink(node);
+    }
+
+    /*
+     * earliest tick which may expire a node or cascade a level.
+     */
+    uint64_t GetNextTick() const
+    {
+        uint64_t tick = mCurrentTick + 1;
+        while ((tick & SLOT_MASK) != 0 && mSlots[0][tick & SLOT_MASK] == NULL)
+        {
+            tick++;
+        }
+
+        return tick;
+    }
+
+    /*
+     * advance one tick and append the expired nodes to expired.
+     */
+    void Advance(std::vector<Node*>& expired)
+    {
+        mCurrentTick++;
+
+        int32_t level = 1;
+        while (level < LEVEL_NUMBER &&
+            (mCurrentTick & ((1ULL << (SLOT_BITS * level)) - 1)) == 0)
+        {
+            level++;
+        }
+
+        /*
+         * cascade from the highest level whose boundary was crossed. a node
+         * expiring on this very tick lands in the level 0 slot taken below.
+         */
+        for (level=level-1; level>0; level--)
+        {
+            Node*& head = mSlots[level][(mCurrentTick >> (SLOT_BITS * level)) & SLOT_MASK];
+            Node* node = head;
+            head = NULL;
+
+            while (node != NULL)
+            {
+                Node* next = node->mNext;
+                Unlink(node);
+                Place(node);
+                node = next;
+            }
+        }
+
+        Node*& head = mSlots[0][mCurrentTick & SLOT_MASK];
+        Node* node = head;
+        head = NULL;
+
+        while (node != NULL)
+        {
+            Node* next = node->mNext;
+            Unlink(node);
+            expired.push_back(node);
+            node = next;
+        }
+    }
+
+private:
+    /*
+     * link a node expiring at or after the current tick.
+     */
+    void Place(Node* node)
+    {
+        uint64_t expire = node->mExpireTick;
+        uint64_t delta = expire - mCurrentTick;
+
+        int32_t level = 0;
+        while (level < LEVEL_NUMBER - 1 && delta >= (1ULL << (SLOT_BITS * (level + 1))))
+        {
+            level++;
+        }
+
+        /*
+         * beyond the wheel range: park in the top level slot cascaded last,
+         * the node is placed again from there.
+         */
+        if (delta >= (1ULL << (SLOT_BITS * LEVEL_NUMBER)))
+        {
+            expire = mCurrentTick + (1ULL << (SLOT_BITS * LEVEL_NUMBER)) - 1;
+        }
+
+        Link(mSlots[level][(expire >> (SLOT_BITS * level)) & SLOT_MASK], node);
+    }
+
+    static void Link(Node*& head, Node* node)
+    {
+        node->mSlot = &head;
+        node->mPrev = NULL;
+        node->mNext = head;
+        if (head != NULL)
+        {
+            head->mPrev = node;
+        }
+        head = node;
+    }
+
+    static void Unlink(Node* node)
+    {
+        node->mSlot = NULL;
+        node->mPrev = NULL;
+        node->mNext = NULL;
+    }
+
+private:
+    uint64_t mCurrentTick;
+    Node* mSlots[LEVEL_NUMBER][SLOT_NUMBER];
+};
+
+/*
+ * @brief: TimerGroup
+ * one wheel and the thread which runs its callbacks. the thread is created
+ * with the first timer and sleeps on a condition while the group is empty.
+ */
+class TimerGroup
+{
+public:
+    TimerGroup(const std::string& name, uint64_t tickMicrosec, bool realtime,
+        const RealtimeProfile& profile) :
+        mName(name), mTickNanosec(tickMicrosec * UT_NUMER_MILLI), mRealtime(realtime),
+        mProfile(profile), mQuit(false), mStartNanosec(0), mThreadId(0)
+    {}
+
+    ~TimerGroup()
+    {
+        Quit();
+
+        std::map<uint64_t,TimerWheel::Node*>::iterator iter;
+        for (iter=mNodeMap.begin(); iter!=mNodeMap.end(); ++iter)
+        {
+            delete iter->second;
+        }
+    }
+
+    void Add(uint64_t id, uint64_t delayMicrosec, uint64_t intervalMicrosec,
+        std::function<void()>&& func)
+    {
+        TimerWheel::Node* node = new TimerWheel::Node();
+        node->mId = id;
+        node->mIntervalTick = ToTick(intervalMicrosec);
+        node->mFunc = std::move(func);
+
+        if (intervalMicrosec > 0 && node->mIntervalTick == 0)
+        {
+            node->mIntervalTick = 1;
+        }
+
+        LockGuard<MutexCond> guard(mMutexCond);
+
+        if (mThreadPtr == NULL)
+        {
+            StartThread();
+        }
+
+        if (mNodeMap.empty())
+        {
+            mWheel.SetCurrentTick(GetElapsedTick());
+        }
+
+        node->mExpireTick = mWheel.GetCurrentTick() + ToTick(delayMicrosec);
+        mWheel.Insert(node);
+        mNodeMap[id] = node;
+
+        /*
+         * Cancel callers may wait on the same condition.
+         */
+        mMutexCond.NotifyAll();
+    }
+
+    /*
+     * a running callback is waited for, unless Cancel is called from the
+     * group thread itself, i.e. by a callback.
+     */
+    bool Cancel(uint64_t id)
+    {
+        LockGuard<MutexCond> guard(mMutexCond);
+
+        std::map<uint64_t,TimerWheel::Node*>::iterator iter = mNodeMap.find(id);
+        if (iter == mNodeMap.end())
+        {
+            return false;
+        }
+
+        TimerWheel::Node* node = iter->second;
+        mNodeMap.erase(iter);
+
+        if (node->mCancelled)
+        {
+            return false;
+        }
+
+        /*
+         * a node taken out for running is freed by the thread afterwards.
+         */
+        if (IsRunning(node))
+        {
+            node->mCancelled = true;
+
+            if (!pthread_equal(pthread_self(), mThreadId))
+            {
+                while (IsRunning(id))
+                {
+                    mMutexCond.Wait();
+                }
+            }
+        }
+        else
+        {
+            mWheel.Remove(node);
+            delete node;
+        }
+
+        return true;
+    }
+
+    size_t Size()
+    {
+        LockGuard<MutexCond> guard(mMutexCond);
+        return mNodeMap.size();
+    }
+
+    bool GetGrant(RealtimeGrant& grant, int64_t microsec)
+    {
+        RealtimeThreadPtr threadPtr;
+        {
+            LockGuard<MutexCond> guard(mMutexCond);
+            threadPtr = std::dynamic_pointer_cast<RealtimeThread>(mThreadPtr);
+        }
+
+        return threadPtr != NULL && threadPtr->GetGrant(grant, microsec);
+    }
+
+    void Quit()
+    {
+        ThreadPtr threadPtr;
+        {
+            LockGuard<MutexCond> guard(mMutexCond);
+            mQuit = true;
+            mMutexCond.NotifyAll();
+            threadPtr = mThreadPtr;
+        }
+
+        if (threadPtr != NULL)
+        {
+            threadPtr->Wait();
+        }
+    }
+
+private:
+    void StartThread()
+    {
+        mStartNanosec = GetCurrentMonotonicTimeNanosecond();
+
+        if (mRealtime)
+        {
+            mThreadPtr = CreateRealtimeThreadEx(mName, mProfile, &TimerGroup::ThreadFunc, this);
+        }
+        else
+        {
+            mThreadPtr = CreateThreadEx(mName, UT_CPU_ID_NONE, &TimerGroup::ThreadFunc, this);
+        }
+    }
+
+    int32_t ThreadFunc()
+    {
+        std::vector<TimerWheel::Node*> expired;
+        uint64_t wake;
+
+        {
+            LockGuard<MutexCond> guard(mMutexCond);
+            mThreadId = pthread_self();
+        }
+
+        while (true)
+        {
+            {
+                LockGuard<MutexCond> guard(mMutexCond);
+
+                while (!mQuit && mNodeMap.empty())
+                {
+                    mMutexCond.Wait();
+                }
+
+                if (mQuit)
+                {
+                    break;
+                }
+
+                /*
+                 * far events are waited for on the condition so that an
+                 * earlier timer added meanwhile wakes the thread. the last
+                 * tick is slept on the monotonic clock for precision.
+                 */
+                wake = mStartNanosec + mWheel.GetNextTick() * mTickNanosec;
+
+                uint64_t now = GetCurrentMonotonicTimeNanosecond();
+                if (wake > now + 2 * mTickNanosec)
+                {
+                    mMutexCond.Wait((wake - now - mTickNanosec) / UT_NUMER_MILLI);
+                    continue;
+                }
+            }
+
+            SleepUntil(wake);
+
+            {
+                LockGuard<MutexCond> guard(mMutexCond);
+
+                uint64_t now = GetElapsedTick();
+                while (mWheel.GetCurrentTick() < now)
+                {
+                    mWheel.Advance(expired);
+                }
+
+                mRunning.assign(expired.begin(), expired.end());
+            }
+
+            Run(expired);
+            expired.clear();
+        }
+
+        return 0;
+    }
+
+    void Run(std::vector<TimerWheel::Node*>& expired)
+    {
+        for (size_t i=0; i<expired.size(); i++)
+        {
+            TimerWheel::Node* node = expired[i];
+
+            {
+                LockGuard<MutexCond> guard(mMutexCond);
+                if (node->mCancelled)
+                {
+                    mRunning[i] = NULL;
+                    mMutexCond.NotifyAll();
+                    delete node;
+                    continue;
+                }
+            }
+
+            try
+            {
+                node->mFunc();
+            }
+            catch (...)
+            {}
+
+            LockGuard<MutexCond> guard(mMutexCond);
+
+            mRunning[i] = NULL;
+            if (node->mCancelled)
+            {
+                mMutexCond.NotifyAll();
+            }
+
+            if (node->mCancelled)
+            {
+                delete node;
+            }
+            else if (node->mIntervalTick > 0)
+            {
+                /*
+                 * fixed rate, missed periods are skipped.
+                 */
+                uint64_t current = mWheel.GetCurrentTick();
+                node->mExpireTick += node->mIntervalTick;
+                if (node->mExpireTick <= current)
+                {
+                    node->mExpireTick += ((current - node->mExpireTick) / node->mIntervalTick + 1) *
+                        node->mIntervalTick;
+                }
+
+                mWheel.Insert(node);
+            }
+            else
+            {
+                mNodeMap.erase(node->mId);
+                delete node;
+            }
+        }
+
+        LockGuard<MutexCond> guard(mMutexCond);
+        mRunning.clear();
+    }
+
+    bool IsRunning(TimerWheel::Node* node) const
+    {
+        for (size_t i=0; i<mRunning.size(); i++)
+        {
+            if (mRunning[i] == node)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /*
+     * by id, a freed node address may be reused by a new timer.
+     */
+    bool IsRunning(uint64_t id) const
+    {
+        for (size_t i=0; i<mRunning.size(); i++)
+        {
+            if (mRunning[i] != NULL && mRunning[i]->mId == id)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    uint64_t ToTick(uint64_t microsec) const
+    {
+        return (microsec * UT_NUMER_MILLI + mTickNanosec - 1) / mTickNanosec;
+    }
+
+    uint64_t GetElapsedTick() const
+    {
+        return (GetCurrentMonotonicTimeNanosecond() - mStartNanosec) / mTickNanosec;
+    }
+
+    static void SleepUntil(uint64_t nanosec)
+    {
+        struct timespec ts;
+        ts.tv_sec = nanosec / UT_NUMER_NANO;
+        ts.tv_nsec = nanosec % UT_NUMER_NANO;
+
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+        {}
+    }
+
+private:
+    std::string mName;
+    uint64_t mTickNanosec;
+    bool mRealtime;
+    RealtimeProfile mProfile;
+
+    bool mQuit;
+    uint64_t mStartNanosec;
+    TimerWheel mWheel;
+    std::map<uint64_t,TimerWheel::Node*> mNodeMap;
+    std::vector<TimerWheel::Node*> mRunning;
+    pthread_t mThreadId;
+    ThreadPtr mThreadPtr;
+    MutexCond mMutexCond;
+};
+
+/*
+ * @brief: TimerService
+ * runs many one-shot and recurrent callbacks from one timer wheel thread
+ * per execution group, instead of one RecurrentThread per job. callbacks of
+ * a group run one after another on its thread and should be short.
+ */
+class TimerService
+{
+public:
+    static TimerService* Instance()
+    {
+        static TimerService inst;
+        return &inst;
+    }
+
+    explicit TimerService(uint64_t tickMicrosec = UT_TIMER_TICK_MICROSEC,
+        const RealtimeProfile& realtimeProfile = RealtimeProfile()) :
+        mNextId(1)
+    {
+        UT_THROW_IF(tickMicrosec == 0, CommonException, "timer service tick is 0");
+
+        mGroups[UT_TIMER_GROUP_NORMAL].reset(new TimerGroup("timer", tickMicrosec, false,
+            realtimeProfile));
+        mGroups[UT_TIMER_GROUP_REALTIME].reset(new TimerGroup("rttimer", tickMicrosec, true,
+            realtimeProfile));
+    }
+
+    ~TimerService()
+    {
+        Quit();
+    }
+
+    /*
+     * intervalMicrosec 0 makes a one-shot timer. return the timer id.
+     */
+    __UT_THREAD_DECL_TMPL_FUNC_ARG__
+    uint64_t AddTimer(int32_t group, uint64_t delayMicrosec, uint64_t intervalMicrosec,
+        __UT_THREAD_TMPL_FUNC_ARG__)
+    {
+        UT_THROW_IF(group < 0 || group >= UT_TIMER_GROUP_NUMBER, CommonException,
+            "timer group is invalid");
+
+        uint64_t id = mNextId.fetch_add(1, std::memory_order_relaxed) * UT_TIMER_GROUP_NUMBER + group;
+        mGroups[group]->Add(id, delayMicrosec, intervalMicrosec,
+            std::bind(__UT_THREAD_BIND_FUNC_ARG__));
+
+        return id;
+    }
+
+    __UT_THREAD_DECL_TMPL_FUNC_ARG__
+    uint64_t AddOnce(uint64_t delayMicrosec, __UT_THREAD_TMPL_FUNC_ARG__)
+    {
+        return AddTimer(UT_TIMER_GROUP_NORMAL, delayMicrosec, 0, __UT_THREAD_BIND_FUNC_ARG__);
+    }
+
+    __UT_THREAD_DECL_TMPL_FUNC_ARG__
+    uint64_t AddRecurrent(uint64_t intervalMicrosec, __UT_THREAD_TMPL_FUNC_ARG__)
+    {
+        return AddTimer(UT_TIMER_GROUP_NORMAL, intervalMicrosec, intervalMicrosec,
+            __UT_THREAD_BIND_FUNC_ARG__);
+    }
+
+    /*
+     * return false if the timer has fired(one-shot) or was cancelled.
+     * a callback already running is not interrupted, Cancel returns once it
+     * has finished, so the callback may then release what it uses. from a
+     * callback of the same group Cancel returns at once, the group runs one
+     * callback at a time.
+     */
+    bool Cancel(uint64_t id)
+    {
+        return mGroups[id % UT_TIMER_GROUP_NUMBER]->Cancel(id);
+    }
+
+    size_t Size(int32_t group)
+    {
+        return mGroups[group]->Size();
+    }
+
+    /*
+     * grant of the realtime group thread, which exists once a realtime
+     * timer has been added.
+     */
+    bool GetRealtimeGrant(RealtimeGrant& grant, int64_t microsec = 0)
+    {
+        return mGroups[UT_TIMER_GROUP_REALTIME]->GetGrant(grant, microsec);
+    }
+
+    void Quit()
+    {
+        for (int32_t i=0; i<UT_TIMER_GROUP_NUMBER; i++)
+        {
+            mGroups[i]->Quit();
+        }
+    }
+
+private:
+    std::atomic<uint64_t> mNextId;
+    std::unique_ptr<TimerGroup> mGroups[UT_TIMER_GROUP_NUMBER];
+};
+
+typedef std::shared_ptr<TimerService> TimerServicePtr;
+
+}
+}
+
+#endif//__UT_TIMER_SERVICE_HPP__
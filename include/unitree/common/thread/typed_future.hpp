@@ -0,0 +1,655 @@
+#ifndef __UT_TYPED_FUTURE_HPP__
+#define __UT_TYPED_FUTURE_HPP__
+
+#include <unitree/common/thread/future.hpp>
+#include <unitree/common/thread/task_function.hpp>
+
+namespace unitree
+{
+namespace common
+{
+template<typename T>
+class TypedFuture;
+
+template<typename T>
+class TypedPromise;
+
+/*
+ * @brief: FutureValue
+ * in-place storage of a typed future value. void futures carry no value.
+ */
+template<typename T>
+class FutureValue
+{
+public:
+    typedef const T& ConstRef;
+
+    FutureValue() :
+        mSet(false)
+    {}
+
+    ~FutureValue()
+    {
+        if (mSet)
+        {
+            Get().~T();
+        }
+    }
+
+    template<typename V>
+    void Set(V&& value)
+    {
+        new (&mStorage) T(std::forward<V>(value));
+        mSet = true;
+    }
+
+    T& Get()
+    {
+        return *reinterpret_cast<T*>(&mStorage);
+    }
+
+    template<typename F>
+    auto Apply(F& f) -> decltype(f(std::declval<const T&>()))
+    {
+        return f(static_cast<const T&>(Get()));
+    }
+
+private:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type mStorage;
+    bool mSet;
+};
+
+template<>
+class FutureValue<void>
+{
+public:
+    typedef void ConstRef;
+
+    void Set()
+    {}
+
+    void Get()
+    {}
+
+    template<typename F>
+    auto Apply(F& f) -> decltype(f())
+    {
+        return f();
+    }
+};
+
+/*
+ * @brief: FutureState
+ * state shared by a TypedPromise and its futures. value, fault and the
+ * continuation list all live in this one object.
+ */
+template<typename T>
+class FutureState
+{
+public:
+    FutureState() :
+        mState(Future::DEFER), mFaultCode(UT_OK)
+    {}
+
+    int32_t GetState() const
+    {
+        return mState.load(std::memory_order_acquire);
+    }
+
+    template<typename... V>
+    bool Ready(V&&... value)
+    {
+        std::vector<TaskFunction> callbacks;
+
+        {
+            LockGuard<MutexCond> guard(mMutexCond);
+            if (mState.load(std::memory_order_relaxed) != Future::DEFER)
+            {
+                return false;
+            }
+
+            mValue.Set(std::forward<V>(value)...);
+            mState.store(Future::READY, std::memory_order_release);
+            mMutexCond.NotifyAll();
+
+            callbacks.swap(mCallbacks);
+        }
+
+        Run(callbacks);
+
+        return true;
+    }
+
+    bool Fault(int32_t code, const std::string& message)
+    {
+        std::vector<TaskFunction> callbacks;
+
+        {
+            LockGuard<MutexCond> guard(mMutexCond);
+            if (mState.load(std::memory_order_relaxed) != Future::DEFER)
+            {
+                return false;
+            }
+
+            mFaultCode = code;
+            mFaultMessage = message;
+            mState.store(Future::FAULT, std::memory_order_release);
+            mMutexCond.NotifyAll();
+
+            callbacks.swap(mCallbacks);
+        }
+
+        Run(callbacks);
+
+        return true;
+    }
+
+    /*
+     * set the state from the result of f(), or fault it with the exception
+     * f() throws.
+     */
+    template<typename F>
+    void Invoke(F& f)
+    {
+        try
+        {
+            InvokeInner(f, std::is_void<T>());
+        }
+        catch (const Exception& e)
+        {
+            Fault(e.GetCode(), e.GetMessage());
+        }
+        catch (const std::exception& e)
+        {
+            Fault(UT_ERR_FUTURE_FAULT, e.what());
+        }
+        catch (...)
+        {
+            Fault(UT_ERR_FUTURE_FAULT, UT_DESC_ERR(UT_ERR_FUTURE_FAULT));
+        }
+    }
+
+    /*
+     * microsec <= 0 waits until the state is set.
+     */
+    bool Wait(int64_t microsec)
+    {
+        if (GetState() != Future::DEFER)
+        {
+            return true;
+        }
+
+        LockGuard<MutexCond> guard(mMutexCond);
+
+        if (microsec <= 0)
+        {
+            while (mState.load(std::memory_order_relaxed) == Future::DEFER)
+            {
+                mMutexCond.Wait();
+            }
+
+            return true;
+        }
+
+        uint64_t deadline = GetCurrentMonotonicTimeMicrosecond() + microsec;
+        while (mState.load(std::memory_order_relaxed) == Future::DEFER)
+        {
+            uint64_t now = GetCurrentMonotonicTimeMicrosecond();
+            if (now >= deadline)
+            {
+                return false;
+            }
+
+            mMutexCond.Wait(deadline - now);
+        }
+
+        return true;
+    }
+
+    /*
+     * callback runs on the thread which sets the state, or right here if the
+     * state is already set.
+     */
+    void AddCallback(TaskFunction&& callback)
+    {
+        {
+            LockGuard<MutexCond> guard(mMutexCond);
+            if (mState.load(std::memory_order_relaxed) == Future::DEFER)
+            {
+                mCallbacks.push_back(std::move(callback));
+                return;
+            }
+        }
+
+        callback();
+    }
+
+    FutureValue<T>& GetValue()
+    {
+        return mValue;
+    }
+
+    int32_t GetFaultCode() const
+    {
+        return mFaultCode;
+    }
+
+    const std::string& GetFaultMessage() const
+    {
+        return mFaultMessage;
+    }
+
+private:
+    template<typename F>
+    void InvokeInner(F& f, std::true_type)
+    {
+        f();
+        Ready();
+    }
+
+    template<typename F>
+    void InvokeInner(F& f, std::false_type)
+    {
+        Ready(f());
+    }
+
+    static void Run(std::vector<TaskFunction>& callbacks)
+    {
+        for (size_t i=0; i<callbacks.size(); i++)
+        {
+            callbacks[i]();
+        }
+    }
+
+private:
+    std::atomic<int32_t> mState;
+    FutureValue<T> mValue;
+    int32_t mFaultCode;
+    std::string mFaultMessage;
+    std::vector<TaskFunction> mCallbacks;
+    MutexCond mMutexCond;
+};
+
+/*
+ * @brief: TypedFuture
+ * future of a T value without Any boxing or virtual calls.
+ * Then/OnReady continuations run inline on the completing thread, or on an
+ * executor, which is any object with bool AddTask(Func&&, Args&&...) such
+ * as ThreadPool or WorkStealingThreadPool. a continuation only holds its
+ * source state weakly, the state runs it while a promise or future still
+ * owns the state, so a future which is never set is not kept alive by its
+ * own continuations.
+ */
+template<typename T>
+class TypedFuture
+{
+public:
+    typedef T ValueType;
+    typedef std::shared_ptr<FutureState<T>> StatePtr;
+
+    TypedFuture()
+    {}
+
+    explicit TypedFuture(const StatePtr& statePtr) :
+        mStatePtr(statePtr)
+    {}
+
+    bool IsValid() const
+    {
+        return mStatePtr != NULL;
+    }
+
+    int32_t GetState() const
+    {
+        return CheckState()->GetState();
+    }
+
+    bool IsDeferred() const
+    {
+        return GetState() == Future::DEFER;
+    }
+
+    bool IsReady() const
+    {
+        return GetState() == Future::READY;
+    }
+
+    bool IsFault() const
+    {
+        return GetState() == Future::FAULT;
+    }
+
+    bool Wait(int64_t microsec = 0) const
+    {
+        return CheckState()->Wait(microsec);
+    }
+
+    /*
+     * throw TimeoutException if not set within microsec, and
+     * FutureFaultException with the fault message if faulted.
+     */
+    typename FutureValue<T>::ConstRef GetValue(int64_t microsec = 0) const
+    {
+        const StatePtr& statePtr = CheckState();
+
+        if (!statePtr->Wait(microsec))
+        {
+            UT_THROW(TimeoutException, "wait future value timeout");
+        }
+
+        if (statePtr->GetState() == Future::FAULT)
+        {
+            UT_THROW(FutureFaultException, statePtr->GetFaultMessage());
+        }
+
+        return statePtr->GetValue().Get();
+    }
+
+    int32_t GetFaultCode() const
+    {
+        return CheckState()->GetFaultCode();
+    }
+
+    const std::string& GetFaultMessage() const
+    {
+        return CheckState()->GetFaultMessage();
+    }
+
+    /*
+     * f(const T&) or f() for void futures. a fault is passed on to the
+     * returned future without calling f.
+     */
+    template<typename F>
+    TypedFuture<typename std::decay<decltype(std::declval<FutureValue<T>&>().Apply(
+        std::declval<typename std::decay<F>::type&>()))>::type> Then(F&& f) const
+    {
+        typedef typename std::decay<decltype(std::declval<FutureValue<T>&>().Apply(
+            std::declval<typename std::decay<F>::type&>()))>::type R;
+
+        std::weak_ptr<FutureState<T>> sourceWeak = CheckState();
+        std::shared_ptr<FutureState<R>> resultPtr = std::make_shared<FutureState<R>>();
+
+        mStatePtr->AddCallback(TaskFunction([sourceWeak, resultPtr, f = std::forward<F>(f)]() mutable
+        {
+            Continue(*sourceWeak.lock(), *resultPtr, f);
+        }));
+
+        return TypedFuture<R>(resultPtr);
+    }
+
+    template<typename Executor, typename F>
+    TypedFuture<typename std::decay<decltype(std::declval<FutureValue<T>&>().Apply(
+        std::declval<typename std::decay<F>::type&>()))>::type> Then(Executor& executor, F&& f) const
+    {
+        typedef typename std::decay<decltype(std::declval<FutureValue<T>&>().Apply(
+            std::declval<typename std::decay<F>::type&>()))>::type R;
+
+        std::weak_ptr<FutureState<T>> sourceWeak = CheckState();
+        std::shared_ptr<FutureState<R>> resultPtr = std::make_shared<FutureState<R>>();
+        Executor* executorPtr = &executor;
+
+        mStatePtr->AddCallback(TaskFunction([executorPtr, sourceWeak, resultPtr, f = std::forward<F>(f)]() mutable
+        {
+            StatePtr sourcePtr = sourceWeak.lock();
+            bool added = executorPtr->AddTask([sourcePtr, resultPtr, f]() mutable -> int32_t
+            {
+                Continue(*sourcePtr, *resultPtr, f);
+                return 0;
+            });
+
+            if (!added)
+            {
+                resultPtr->Fault(UT_ERR_FUTURE, "executor rejected continuation");
+            }
+        }));
+
+        return TypedFuture<R>(resultPtr);
+    }
+
+    /*
+     * f(const TypedFuture<T>&) once the future is ready or faulted.
+     */
+    template<typename F>
+    void OnReady(F&& f) const
+    {
+        std::weak_ptr<FutureState<T>> selfWeak = CheckState();
+
+        mStatePtr->AddCallback(TaskFunction([selfWeak, f = std::forward<F>(f)]() mutable
+        {
+            f(TypedFuture<T>(selfWeak.lock()));
+        }));
+    }
+
+    /*
+     * f runs as a task on executor. like Then, the returned future is
+     * faulted if the executor rejects the task or f throws, and ready once
+     * f returned.
+     */
+    template<typename Executor, typename F>
+    TypedFuture<void> OnReady(Executor& executor, F&& f) const
+    {
+        std::weak_ptr<FutureState<T>> selfWeak = CheckState();
+        std::shared_ptr<FutureState<void>> resultPtr = std::make_shared<FutureState<void>>();
+        Executor* executorPtr = &executor;
+
+        mStatePtr->AddCallback(TaskFunction([executorPtr, selfWeak, resultPtr, f = std::forward<F>(f)]() mutable
+        {
+            TypedFuture<T> self(selfWeak.lock());
+            bool added = executorPtr->AddTask([self, resultPtr, f]() mutable -> int32_t
+            {
+                auto call = [&self, &f]()
+                {
+                    f(self);
+                };
+
+                resultPtr->Invoke(call);
+                return 0;
+            });
+
+            if (!added)
+            {
+                resultPtr->Fault(UT_ERR_FUTURE, "executor rejected continuation");
+            }
+        }));
+
+        return TypedFuture<void>(resultPtr);
+    }
+
+private:
+    template<typename R, typename F>
+    static void Continue(FutureState<T>& source, FutureState<R>& result, F& f)
+    {
+        if (source.GetState() == Future::FAULT)
+        {
+            result.Fault(source.GetFaultCode(), source.GetFaultMessage());
+            return;
+        }
+
+        auto call = [&source, &f]() -> R
+        {
+            return source.GetValue().Apply(f);
+        };
+
+        result.Invoke(call);
+    }
+
+    const StatePtr& CheckState() const
+    {
+        if (mStatePtr == NULL)
+        {
+            UT_THROW(FutureException, "typed future has no state");
+        }
+
+        return mStatePtr;
+    }
+
+private:
+    StatePtr mStatePtr;
+};
+
+/*
+ * @brief: TypedPromise
+ * producer side of a TypedFuture. copies share one state, and the first
+ * SetValue/SetFault wins. like a shared_ptr, a const promise can still be set.
+ */
+template<typename T>
+class TypedPromise
+{
+public:
+    TypedPromise() :
+        mStatePtr(std::make_shared<FutureState<T>>())
+    {}
+
+    TypedFuture<T> GetFuture() const
+    {
+        return TypedFuture<T>(mStatePtr);
+    }
+
+    template<typename... V>
+    bool SetValue(V&&... value) const
+    {
+        return mStatePtr->Ready(std::forward<V>(value)...);
+    }
+
+    bool SetFault(const std::string& message) const
+    {
+        return mStatePtr->Fault(UT_ERR_FUTURE_FAULT, message);
+    }
+
+    bool SetFault(int32_t code, const std::string& message) const
+    {
+        return mStatePtr->Fault(code, message);
+    }
+
+    /*
+     * set the value from the result of f(), or the fault from what it throws.
+     */
+    template<typename F>
+    void SetResultOf(F&& f) const
+    {
+        mStatePtr->Invoke(f);
+    }
+
+private:
+    std::shared_ptr<FutureState<T>> mStatePtr;
+};
+
+/*
+ * result type of a task bound from func and args.
+ */
+__UT_THREAD_DECL_TMPL_FUNC_ARG__
+struct TaskResult
+{
+    typedef typename std::decay<decltype(std::bind(std::declval<Func>(),
+        std::declval<Args>()...)())>::type Type;
+};
+
+/*
+ * @brief: PromiseTask
+ * bound task which sets a promise from its result when run. if every copy
+ * is dropped without running, e.g. by a quitting pool, the promise is
+ * faulted instead of leaving the future deferred forever.
+ */
+template<typename R, typename Bound>
+class PromiseTask
+{
+public:
+    PromiseTask(const TypedPromise<R>& promise, Bound&& bound) :
+        mPromise(promise), mBound(std::move(bound)),
+        mGuard(NULL, [promise](void*)
+        {
+            promise.SetFault(UT_ERR_FUTURE, "task dropped before execution");
+        })
+    {}
+
+    int32_t operator()()
+    {
+        mPromise.SetResultOf(mBound);
+        return 0;
+    }
+
+private:
+    TypedPromise<R> mPromise;
+    Bound mBound;
+    std::shared_ptr<void> mGuard;
+};
+
+__UT_THREAD_DECL_TMPL_FUNC_ARG__
+PromiseTask<typename TaskResult<Func, Args...>::Type,
+    decltype(std::bind(std::declval<Func>(), std::declval<Args>()...))>
+MakePromiseTask(const TypedPromise<typename TaskResult<Func, Args...>::Type>& promise,
+    __UT_THREAD_TMPL_FUNC_ARG__)
+{
+    return PromiseTask<typename TaskResult<Func, Args...>::Type,
+        decltype(std::bind(std::declval<Func>(), std::declval<Args>()...))>(
+        promise, std::bind(__UT_THREAD_BIND_FUNC_ARG__));
+}
+
+/*
+ * ready once every future in the list is ready or faulted.
+ */
+template<typename T>
+TypedFuture<std::vector<TypedFuture<T>>> WhenAll(const std::vector<TypedFuture<T>>& futures)
+{
+    typedef std::vector<TypedFuture<T>> ListType;
+
+    TypedPromise<ListType> promise;
+    if (futures.empty())
+    {
+        promise.SetValue(ListType());
+        return promise.GetFuture();
+    }
+
+    /*
+     * each callback puts its own future into the list once it is set. the
+     * list never holds a pending future, so a future which is never set
+     * does not keep itself alive through its own callback.
+     */
+    std::shared_ptr<ListType> listPtr = std::make_shared<ListType>(futures.size());
+    std::shared_ptr<std::atomic<size_t>> remainPtr =
+        std::make_shared<std::atomic<size_t>>(futures.size());
+
+    for (size_t i=0; i<futures.size(); i++)
+    {
+        futures[i].OnReady([promise, listPtr, remainPtr, i](const TypedFuture<T>& future) mutable
+        {
+            (*listPtr)[i] = future;
+
+            if (remainPtr->fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                promise.SetValue(std::move(*listPtr));
+            }
+        });
+    }
+
+    return promise.GetFuture();
+}
+
+/*
+ * ready with the index of the first future which is ready or faulted.
+ */
+template<typename T>
+TypedFuture<size_t> WhenAny(const std::vector<TypedFuture<T>>& futures)
+{
+    TypedPromise<size_t> promise;
+    if (futures.empty())
+    {
+        promise.SetFault(UT_ERR_FUTURE, "when any of empty future list");
+        return promise.GetFuture();
+    }
+
+    for (size_t i=0; i<futures.size(); i++)
+    {
+        futures[i].OnReady([promise, i](const TypedFuture<T>&) mutable
+        {
+            promise.SetValue(i);
+        });
+    }
+
+    return promise.GetFuture();
+}
+
+}
+}
+
+#endif//__UT_TYPED_FUTURE_HPP__
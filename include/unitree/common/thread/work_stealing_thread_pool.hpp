@@ -0,0 +1,713 @@
+#ifndef __UT_WORK_STEALING_THREAD_POOL_HPP__
+#define __UT_WORK_STEALING_THREAD_POOL_HPP__
+
+#include <unitree/common/os.hpp>
+#include <unitree/common/thread/thread.hpp>
+#include <unitree/common/thread/task_function.hpp>
+#include <unitree/common/thread/typed_future.hpp>
+
+namespace unitree
+{
+namespace common
+{
+/*
+ * @brief: TaskNodePool
+ * recycles the TaskFunction slots used by WorkStealingThreadPool. slots are
+ * addressed by 32-bit index so the free list head can carry an ABA tag in
+ * one 64-bit word. memory grows by chunks and is only released on destroy.
+ */
+class TaskNodePool
+{
+public:
+    enum
+    {
+        CHUNK_SHIFT = 8,
+        CHUNK_SIZE = 1 << CHUNK_SHIFT,
+        MAX_CHUNK_NUMBER = 4096
+    };
+
+    static const uint32_t INDEX_NONE = 0xFFFFFFFF;
+
+    TaskNodePool() :
+        mHead(Pack(0, INDEX_NONE)), mChunkNumber(0)
+    {
+        for (uint32_t i=0; i<MAX_CHUNK_NUMBER; i++)
+        {
+            mChunks[i].store(NULL, std::memory_order_relaxed);
+        }
+    }
+
+    ~TaskNodePool()
+    {
+        uint32_t number = mChunkNumber.load(std::memory_order_acquire);
+        for (uint32_t i=0; i<number; i++)
+        {
+            delete [] mChunks[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    TaskFunction& Get(uint32_t index)
+    {
+        return GetNode(index).mFunc;
+    }
+
+    /*
+     * return INDEX_NONE when MAX_CHUNK_NUMBER * CHUNK_SIZE slots are in use.
+     */
+    uint32_t Alloc()
+    {
+        while (true)
+        {
+            uint64_t head = mHead.load(std::memory_order_acquire);
+            uint32_t index = GetIndex(head);
+
+            if (index == INDEX_NONE)
+            {
+                if (!Grow())
+                {
+                    return INDEX_NONE;
+                }
+                continue;
+            }
+
+            uint32_t next = GetNode(index).mNext.load(std::memory_order_relaxed);
+            if (mHead.compare_exchange_weak(head, Pack(GetTag(head) + 1, next),
+                std::memory_order_acq_rel, std::memory_order_relaxed))
+            {
+                return index;
+            }
+        }
+    }
+
+    void Free(uint32_t index)
+    {
+        Push(index, index);
+    }
+
+private:
+    class Node
+    {
+    public:
+        Node() :
+            mNext(INDEX_NONE)
+        {}
+
+    public:
+        TaskFunction mFunc;
+        std::atomic<uint32_t> mNext;
+    };
+
+    static uint64_t Pack(uint32_t tag, uint32_t index)
+    {
+        return ((uint64_t)tag << 32) | index;
+    }
+
+    static uint32_t GetTag(uint64_t head)
+    {
+        return (uint32_t)(head >> 32);
+    }
+
+    static uint32_t GetIndex(uint64_t head)
+    {
+        return (uint32_t)head;
+    }
+
+    Node& GetNode(uint32_t index)
+    {
+        Node* chunk = mChunks[index >> CHUNK_SHIFT].load(std::memory_order_acquire);
+        return chunk[index & (CHUNK_SIZE - 1)];
+    }
+
+    /*
+     * push the chain first..last, already linked through mNext.
+     */
+    void Push(uint32_t first, uint32_t last)
+    {
+        Node& node = GetNode(last);
+        uint64_t head = mHead.load(std::memory_order_relaxed);
+
+        do
+        {
+            node.mNext.store(GetIndex(head), std::memory_order_relaxed);
+        }
+        while (!mHead.compare_exchange_weak(head, Pack(GetTag(head) + 1, first),
+            std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    bool Grow()
+    {
+        LockGuard<Mutex> guard(mGrowLock);
+
+        if (GetIndex(mHead.load(std::memory_order_acquire)) != INDEX_NONE)
+        {
+            return true;
+        }
+
+        uint32_t number = mChunkNumber.load(std::memory_order_relaxed);
+        if (number >= MAX_CHUNK_NUMBER)
+        {
+            return false;
+        }
+
+        Node* chunk = new Node[CHUNK_SIZE];
+        uint32_t base = number << CHUNK_SHIFT;
+
+        for (uint32_t i=0; i<CHUNK_SIZE-1; i++)
+        {
+            chunk[i].mNext.store(base + i + 1, std::memory_order_relaxed);
+        }
+
+        mChunks[number].store(chunk, std::memory_order_release);
+        mChunkNumber.store(number + 1, std::memory_order_release);
+
+        Push(base, base + CHUNK_SIZE - 1);
+
+        return true;
+    }
+
+private:
+    std::atomic<uint64_t> mHead;
+    std::atomic<uint32_t> mChunkNumber;
+    std::atomic<Node*> mChunks[MAX_CHUNK_NUMBER];
+    Mutex mGrowLock;
+};
+
+/*
+ * @brief: WorkStealingDeque
+ * fixed capacity Chase-Lev deque of task indices. the owner pushes and pops
+ * at the bottom, other workers steal from the top.
+ */
+class WorkStealingDeque
+{
+public:
+    explicit WorkStealingDeque(uint32_t capacity) :
+        mTop(0), mBottom(0)
+    {
+        mCapacity = 1;
+        while (mCapacity < capacity)
+        {
+            mCapacity <<= 1;
+        }
+
+        mMask = mCapacity - 1;
+        mBuffer = new std::atomic<uint32_t>[mCapacity];
+    }
+
+    ~WorkStealingDeque()
+    {
+        delete [] mBuffer;
+    }
+
+    bool Push(uint32_t index)
+    {
+        int64_t b = mBottom.load(std::memory_order_relaxed);
+        int64_t t = mTop.load(std::memory_order_acquire);
+
+        if (b - t >= (int64_t)mCapacity)
+        {
+            return false;
+        }
+
+        mBuffer[b & mMask].store(index, std::memory_order_relaxed);
+        mBottom.store(b + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    bool Pop(uint32_t& index)
+    {
+        int64_t b = mBottom.load(std::memory_order_relaxed) - 1;
+        mBottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = mTop.load(std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            mBottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        index = mBuffer[b & mMask].load(std::memory_order_relaxed);
+        if (t == b)
+        {
+            bool won = mTop.compare_exchange_strong(t, t + 1,
+                std::memory_order_seq_cst, std::memory_order_relaxed);
+            mBottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+
+        return true;
+    }
+
+    bool Steal(uint32_t& index)
+    {
+        int64_t t = mTop.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = mBottom.load(std::memory_order_acquire);
+
+        if (t >= b)
+        {
+            return false;
+        }
+
+        index = mBuffer[t & mMask].load(std::memory_order_relaxed);
+        return mTop.compare_exchange_strong(t, t + 1,
+            std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    uint64_t Size() const
+    {
+        int64_t n = mBottom.load(std::memory_order_relaxed) - mTop.load(std::memory_order_relaxed);
+        return n > 0 ? n : 0;
+    }
+
+private:
+    alignas(64) std::atomic<int64_t> mTop;
+    alignas(64) std::atomic<int64_t> mBottom;
+    uint32_t mCapacity;
+    uint32_t mMask;
+    std::atomic<uint32_t>* mBuffer;
+};
+
+/*
+ * @brief: InjectionQueue
+ * bounded multi-producer/multi-consumer queue of task indices used for
+ * tasks submitted from outside the pool.
+ */
+class InjectionQueue
+{
+public:
+    explicit InjectionQueue(uint32_t capacity) :
+        mEnqueuePos(0), mDequeuePos(0)
+    {
+        uint32_t size = 2;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+
+        mMask = size - 1;
+        mCells = new Cell[size];
+
+        for (uint32_t i=0; i<size; i++)
+        {
+            mCells[i].mSequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~InjectionQueue()
+    {
+        delete [] mCells;
+    }
+
+    bool Put(uint32_t index)
+    {
+        uint64_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+
+        while (true)
+        {
+            cell = &mCells[pos & mMask];
+            int64_t dif = (int64_t)cell->mSequence.load(std::memory_order_acquire) - (int64_t)pos;
+
+            if (dif == 0)
+            {
+                if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (dif < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = mEnqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->mIndex = index;
+        cell->mSequence.store(pos + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    bool Get(uint32_t& index)
+    {
+        uint64_t pos = mDequeuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+
+        while (true)
+        {
+            cell = &mCells[pos & mMask];
+            int64_t dif = (int64_t)cell->mSequence.load(std::memory_order_acquire) - (int64_t)(pos + 1);
+
+            if (dif == 0)
+            {
+                if (mDequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (dif < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = mDequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        index = cell->mIndex;
+        cell->mSequence.store(pos + mMask + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    uint64_t Size() const
+    {
+        int64_t n = mEnqueuePos.load(std::memory_order_relaxed) - mDequeuePos.load(std::memory_order_relaxed);
+        return n > 0 ? n : 0;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<uint64_t> mSequence;
+        uint32_t mIndex;
+    };
+
+    uint64_t mMask;
+    Cell* mCells;
+    alignas(64) std::atomic<uint64_t> mEnqueuePos;
+    alignas(64) std::atomic<uint64_t> mDequeuePos;
+};
+
+/*
+ * @brief: WorkStealingThreadPool
+ * each worker owns a deque which tasks submitted from inside the pool go to,
+ * tasks submitted from other threads go through a shared injection queue,
+ * and idle workers steal from the others. task slots are recycled, so
+ * AddTask does not allocate for callables that fit in a TaskFunction.
+ */
+class WorkStealingThreadPool
+{
+public:
+    enum
+    {
+        /*
+         * 0 means one worker per processor.
+         */
+        DEFAULT_THREAD_NUMBER = 0,
+        MAX_THREAD_NUMBER = 1000,
+        /*
+         * default per-worker deque and injection queue capacity.
+         */
+        DEFAULT_QUEUE_SIZE = 4096,
+        /*
+         * rounds of spinning over all queues before a worker parks.
+         */
+        SPIN_ROUND = 64,
+        /*
+         * parked worker wakes up at least once per interval.
+         */
+        PARK_TIMEOUT_MICROSEC = 100000
+    };
+
+    explicit WorkStealingThreadPool(uint32_t threadNumber = DEFAULT_THREAD_NUMBER,
+        uint32_t queueMaxSize = DEFAULT_QUEUE_SIZE, const std::string& name = "wspool") :
+        mQuit(false), mSleeperNumber(0), mInjection(queueMaxSize)
+    {
+        if (threadNumber == 0)
+        {
+            threadNumber = OsHelper::Instance()->GetProcessorNumber();
+        }
+
+        UT_THROW_IF(threadNumber == 0 || threadNumber > MAX_THREAD_NUMBER, CommonException,
+            "work stealing thread pool thread number is invalid");
+
+        mThreadNumber = threadNumber;
+        for (uint32_t i=0; i<mThreadNumber; i++)
+        {
+            mDeques.emplace_back(new WorkStealingDeque(queueMaxSize));
+        }
+
+        for (uint32_t i=0; i<mThreadNumber; i++)
+        {
+            mThreadList.push_back(CreateThreadEx(name, UT_CPU_ID_NONE,
+                &WorkStealingThreadPool::WorkerFunc, this, i));
+        }
+    }
+
+    /*
+     * waits for the workers even if Quit(false) was called before, they
+     * use the members destroyed here.
+     */
+    ~WorkStealingThreadPool()
+    {
+        NotifyQuit();
+        WaitThreadExit();
+    }
+
+    __UT_THREAD_DECL_TMPL_FUNC_ARG__
+    bool AddTask(__UT_THREAD_TMPL_FUNC_ARG__)
+    {
+        if (mQuit)
+        {
+            return false;
+        }
+
+        uint32_t index = mNodePool.Alloc();
+        if (index == TaskNodePool::INDEX_NONE)
+        {
+            return false;
+        }
+
+        mNodePool.Get(index) = MakeTaskFunction(__UT_THREAD_BIND_FUNC_ARG__);
+
+        return Submit(index);
+    }
+
+    bool AddTask(TaskFunction&& task)
+    {
+        if (mQuit)
+        {
+            return false;
+        }
+
+        uint32_t index = mNodePool.Alloc();
+        if (index == TaskNodePool::INDEX_NONE)
+        {
+            return false;
+        }
+
+        mNodePool.Get(index) = std::move(task);
+
+        return Submit(index);
+    }
+
+    /*
+     * the returned future is invalid if the task is not queued, and faulted
+     * if the task is dropped unrun.
+     */
+    __UT_THREAD_DECL_TMPL_FUNC_ARG__
+    TypedFuture<typename TaskResult<Func, Args...>::Type> AddTaskFuture(__UT_THREAD_TMPL_FUNC_ARG__)
+    {
+        TypedPromise<typename TaskResult<Func, Args...>::Type> promise;
+
+        if (AddTask(MakePromiseTask(promise, __UT_THREAD_BIND_FUNC_ARG__)))
+        {
+            return promise.GetFuture();
+        }
+
+        return TypedFuture<typename TaskResult<Func, Args...>::Type>();
+    }
+
+    uint32_t GetThreadNumber() const
+    {
+        return mThreadNumber;
+    }
+
+    uint64_t GetTaskSize()
+    {
+        uint64_t size = mInjection.Size();
+        for (uint32_t i=0; i<mThreadNumber; i++)
+        {
+            size += mDeques[i]->Size();
+        }
+
+        return size;
+    }
+
+    bool IsQuit()
+    {
+        return mQuit;
+    }
+
+    /*
+     * tasks still queued when the workers exit are dropped.
+     */
+    void Quit(bool waitThreadExit = true)
+    {
+        NotifyQuit();
+
+        if (waitThreadExit)
+        {
+            WaitThreadExit();
+        }
+    }
+
+private:
+    void NotifyQuit()
+    {
+        if (mQuit.exchange(true))
+        {
+            return;
+        }
+
+        LockGuard<MutexCond> guard(mMutexCond);
+        mMutexCond.NotifyAll();
+    }
+
+    /*
+     * may be called any number of times, waiting for an exited worker
+     * returns at once.
+     */
+    void WaitThreadExit()
+    {
+        for (size_t i=0; i<mThreadList.size(); i++)
+        {
+            mThreadList[i]->Wait();
+        }
+    }
+
+    struct WorkerContext
+    {
+        WorkStealingThreadPool* mPool;
+        uint32_t mIndex;
+    };
+
+    static WorkerContext& GetWorkerContext()
+    {
+        static thread_local WorkerContext context = { NULL, 0 };
+        return context;
+    }
+
+    bool Submit(uint32_t index)
+    {
+        WorkerContext& context = GetWorkerContext();
+
+        bool ok = (context.mPool == this && mDeques[context.mIndex]->Push(index)) ||
+            mInjection.Put(index);
+
+        if (!ok)
+        {
+            mNodePool.Get(index).Reset();
+            mNodePool.Free(index);
+            return false;
+        }
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (mSleeperNumber.load(std::memory_order_relaxed) > 0)
+        {
+            LockGuard<MutexCond> guard(mMutexCond);
+            mMutexCond.Notify();
+        }
+
+        return true;
+    }
+
+    bool FindTask(uint32_t self, uint32_t& seed, uint32_t& index)
+    {
+        if (mDeques[self]->Pop(index) || mInjection.Get(index))
+        {
+            return true;
+        }
+
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+
+        uint32_t start = seed % mThreadNumber;
+        for (uint32_t i=0; i<mThreadNumber; i++)
+        {
+            uint32_t victim = (start + i) % mThreadNumber;
+            if (victim != self && mDeques[victim]->Steal(index))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void Execute(uint32_t index)
+    {
+        TaskFunction& func = mNodePool.Get(index);
+
+        try
+        {
+            func();
+        }
+        catch (...)
+        {}
+
+        func.Reset();
+        mNodePool.Free(index);
+    }
+
+    int32_t WorkerFunc(uint32_t self)
+    {
+        WorkerContext& context = GetWorkerContext();
+        context.mPool = this;
+        context.mIndex = self;
+
+        uint32_t seed = (self + 1) * 2654435761U;
+        uint32_t idle = 0;
+
+        while (!mQuit)
+        {
+            uint32_t index;
+            if (FindTask(self, seed, index))
+            {
+                Execute(index);
+                idle = 0;
+                continue;
+            }
+
+            if (++idle < SPIN_ROUND)
+            {
+                UT_CPU_RELAX();
+                continue;
+            }
+
+            Park();
+            idle = 0;
+        }
+
+        context.mPool = NULL;
+
+        return 0;
+    }
+
+    void Park()
+    {
+        LockGuard<MutexCond> guard(mMutexCond);
+
+        mSleeperNumber.fetch_add(1, std::memory_order_seq_cst);
+
+        bool hasTask = mInjection.Size() > 0;
+        for (uint32_t i=0; !hasTask && i<mThreadNumber; i++)
+        {
+            hasTask = mDeques[i]->Size() > 0;
+        }
+
+        if (!hasTask && !mQuit)
+        {
+            mMutexCond.Wait(PARK_TIMEOUT_MICROSEC);
+        }
+
+        mSleeperNumber.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<bool> mQuit;
+    std::atomic<uint32_t> mSleeperNumber;
+    uint32_t mThreadNumber;
+
+    TaskNodePool mNodePool;
+    InjectionQueue mInjection;
+    std::vector<std::unique_ptr<WorkStealingDeque>> mDeques;
+    std::vector<ThreadPtr> mThreadList;
+
+    MutexCond mMutexCond;
+};
+
+typedef std::shared_ptr<WorkStealingThreadPool> WorkStealingThreadPoolPtr;
+
+}
+}
+
+#endif//__UT_WORK_STEALING_THREAD_POOL_HPP__
@@ -1,7 +1,7 @@
 #ifndef __UT_ROBOT_B2_MOTION_SWITCHER_API_HPP__
 #define __UT_ROBOT_B2_MOTION_SWITCHER_API_HPP__
 
-#include <unitree/common/json/jsonize.hpp>
+#include <unitree/common/json/json_reflect.hpp>
 
 namespace unitree
 {
@@ -76,17 +76,8 @@ public:
     ~JsonizeSilent()
     {}
 
-    /*override*/
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["silent"], silent);
-    }
-
-    /*override*/
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(silent, json["silent"]);
-    }
+    JN_REFLECT(JsonizeSilent,
+        JN_FIELD("silent", silent))
 
 public:
     bool silent;
@@ -1,7 +1,7 @@
 #ifndef __UT_ROBOT_B2_ROBOT_STATE_API_HPP__
 #define __UT_ROBOT_B2_ROBOT_STATE_API_HPP__
 
-#include <unitree/common/json/jsonize.hpp>
+#include <unitree/common/json/json_reflect.hpp>
 
 namespace unitree
 {
@@ -40,17 +40,9 @@ public:
     ~ServiceSwitchParameter()
     {}
 
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["name"], name);
-        common::FromJson(json["switch"], swit);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(name, json["name"]);
-        common::ToJson(swit, json["switch"]);
-    }
+    JN_REFLECT(ServiceSwitchParameter,
+        JN_FIELD("name", name),
+        JN_FIELD("switch", swit))
 
 public:
     std::string name;
@@ -69,17 +61,9 @@ public:
     ~ServiceSwitchData()
     {}
 
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["name"], name);
-        common::FromJson(json["status"], status);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(name, json["name"]);
-        common::ToJson(status, json["status"]);
-    }
+    JN_REFLECT(ServiceSwitchData,
+        JN_FIELD("name", name),
+        JN_FIELD("status", status))
 
 public:
     std::string name;
@@ -98,17 +82,9 @@ public:
     ~SetReportFreqParameter()
     {}
 
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["interval"], interval);
-        common::FromJson(json["duration"], duration);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(interval, json["interval"]);
-        common::ToJson(duration, json["duration"]);
-    }
+    JN_REFLECT(SetReportFreqParameter,
+        JN_FIELD("interval", interval),
+        JN_FIELD("duration", duration))
 
 public:
     int32_t interval;
@@ -127,19 +103,10 @@ public:
     ~ServiceStateData()
     {}
 
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["name"], name);
-        common::FromJson(json["status"], status);
-        common::FromJson(json["protect"], protect);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(name, json["name"]);
-        common::ToJson(status, json["status"]);
-        common::ToJson(protect, json["protect"]);
-    }
+    JN_REFLECT(ServiceStateData,
+        JN_FIELD("name", name),
+        JN_FIELD("status", status),
+        JN_FIELD("protect", protect))
 
 public:
     std::string name;
@@ -159,15 +126,8 @@ public:
     ~LowPowerSwitchParameter()
     {}
 
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["switch"], swit);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(swit, json["switch"]);
-    }
+    JN_REFLECT(LowPowerSwitchParameter,
+        JN_FIELD("switch", swit))
 
 public:
     int32_t swit;
@@ -185,15 +145,8 @@ public:
     ~LowPowerStatusData()
     {}
 
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["status"], status);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(status, json["status"]);
-    }
+    JN_REFLECT(LowPowerStatusData,
+        JN_FIELD("status", status))
 
 public:
     int32_t status;
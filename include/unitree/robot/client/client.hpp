@@ -43,6 +43,73 @@ protected:
 
     int32_t Call(int32_t apiId, const std::string& parameter, const std::vector<uint8_t>& binary);
 
+    /*
+     * @brief
+     * Calls returning the received response without copying its payload.
+     */
+    int32_t Call(int32_t apiId, const std::string& parameter, ResponsePtr& responsePtr)
+    {
+        int32_t priority = 0;
+        int64_t leaseId = 0;
+
+        int32_t ret = CheckApi(apiId, priority, leaseId);
+        if (ret != UT_ROBOT_OK)
+        {
+            return ret;
+        }
+
+        return ClientBase::Call(apiId, parameter, responsePtr, priority, leaseId);
+    }
+
+    int32_t Call(int32_t apiId, const std::vector<uint8_t>& parameter, ResponsePtr& responsePtr)
+    {
+        int32_t priority = 0;
+        int64_t leaseId = 0;
+
+        int32_t ret = CheckApi(apiId, priority, leaseId);
+        if (ret != UT_ROBOT_OK)
+        {
+            return ret;
+        }
+
+        return ClientBase::Call(apiId, parameter, responsePtr, priority, leaseId);
+    }
+
+    /*
+     * @brief
+     * Binary call which moves the response binary into data. The only copy
+     * left is the one made when the DDS sample is taken.
+     */
+    int32_t TakeCall(int32_t apiId, const std::vector<uint8_t>& parameter, std::vector<uint8_t>& data)
+    {
+        ResponsePtr responsePtr;
+
+        int32_t ret = Call(apiId, parameter, responsePtr);
+        if (ret == UT_ROBOT_OK)
+        {
+            data = std::move(responsePtr->binary());
+        }
+
+        return ret;
+    }
+
+    template<typename Executor>
+    common::TypedFuture<ResponsePtr> CallFuture(Executor& executor, int32_t apiId, const std::string& parameter)
+    {
+        int32_t priority = 0;
+        int64_t leaseId = 0;
+
+        int32_t ret = CheckApi(apiId, priority, leaseId);
+        if (ret != UT_ROBOT_OK)
+        {
+            common::TypedPromise<ResponsePtr> promise;
+            promise.SetFault(ret, "check api error");
+            return promise.GetFuture();
+        }
+
+        return ClientBase::CallFuture(executor, apiId, parameter, priority, leaseId);
+    }
+
     void RegistApi(int32_t apiId, int32_t priority = 0);
     int32_t CheckApi(int32_t apiId, int32_t& priority, int64_t& leaseId);
 
@@ -2,6 +2,7 @@
 #define __UT_ROBOT_SDK_CLIENT_BASE_HPP__
 
 #include <unitree/robot/client/client_stub.hpp>
+#include <unitree/common/thread/typed_future.hpp>
 
 namespace unitree
 {
@@ -39,8 +40,114 @@ protected:
 
     int32_t Call(int32_t apiId, const std::string& parameter, std::string& data, int32_t priority, int64_t leaseId, int64_t timeout);
 
+    /*
+     * @brief
+     * Call which hands out the received response itself instead of copying
+     * its data/binary field. The caller owns responsePtr and may move the
+     * payload out of it.
+     */
+    int32_t Call(int32_t apiId, const std::string& parameter, ResponsePtr& responsePtr, int32_t priority, int64_t leaseId)
+    {
+        Request request;
+        request.parameter(parameter);
+
+        return CallResponse(request, apiId, responsePtr, priority, leaseId);
+    }
+
+    int32_t Call(int32_t apiId, const std::vector<uint8_t>& parameter, ResponsePtr& responsePtr, int32_t priority, int64_t leaseId)
+    {
+        Request request;
+        request.binary(parameter);
+
+        return CallResponse(request, apiId, responsePtr, priority, leaseId);
+    }
+
+    /*
+     * @brief
+     * Asynchronous call. The request is sent here and the response is waited
+     * for by a task on executor, so the calling thread is not blocked. The
+     * future is faulted with the client error code on send failure, timeout
+     * or api mismatch, and with the response status code when the server
+     * reports an error, as the synchronous Call returns it.
+     */
+    template<typename Executor>
+    common::TypedFuture<ResponsePtr> CallFuture(Executor& executor, int32_t apiId, const std::string& parameter, int32_t priority, int64_t leaseId)
+    {
+        Request request;
+        request.parameter(parameter);
+
+        SetHeader(request.header(), apiId, leaseId, priority, false);
+
+        common::TypedPromise<ResponsePtr> promise;
+
+        RequestFuturePtr futurePtr = mClientStubPtr->SendRequest(request, mTimeout);
+        if (futurePtr == NULL)
+        {
+            promise.SetFault(UT_ROBOT_ERR_CLIENT_SEND, UT_DESC_ERR(UT_ROBOT_ERR_CLIENT_SEND));
+            return promise.GetFuture();
+        }
+
+        int64_t timeout = mTimeout;
+        bool added = executor.AddTask([promise, futurePtr, apiId, timeout]() mutable -> int32_t
+        {
+            const ResponsePtr& responsePtr = futurePtr->GetResponse(timeout);
+            if (responsePtr == NULL)
+            {
+                promise.SetFault(UT_ROBOT_ERR_CLIENT_API_TIMEOUT, UT_DESC_ERR(UT_ROBOT_ERR_CLIENT_API_TIMEOUT));
+            }
+            else if (responsePtr->header().identity().api_id() != apiId)
+            {
+                promise.SetFault(UT_ROBOT_ERR_CLIENT_API_NOT_MATCH, UT_DESC_ERR(UT_ROBOT_ERR_CLIENT_API_NOT_MATCH));
+            }
+            else if (responsePtr->header().status().code() != UT_ROBOT_OK)
+            {
+                int32_t code = responsePtr->header().status().code();
+                promise.SetFault(code, "server response status error:" + std::to_string(code));
+            }
+            else
+            {
+                promise.SetValue(responsePtr);
+            }
+
+            return 0;
+        });
+
+        if (!added)
+        {
+            promise.SetFault(UT_ROBOT_ERR_CLIENT_SEND, "executor rejected response wait");
+        }
+
+        return promise.GetFuture();
+    }
+
     void SetHeader(RequestHeader& header, int32_t apiId, int64_t leaseId, int32_t priority, bool noReply);
 
+private:
+    int32_t CallResponse(Request& request, int32_t apiId, ResponsePtr& responsePtr, int32_t priority, int64_t leaseId)
+    {
+        SetHeader(request.header(), apiId, leaseId, priority, false);
+
+        RequestFuturePtr futurePtr = mClientStubPtr->SendRequest(request, mTimeout);
+        if (futurePtr == NULL)
+        {
+            return UT_ROBOT_ERR_CLIENT_SEND;
+        }
+
+        responsePtr = futurePtr->GetResponse(mTimeout);
+        if (responsePtr == NULL)
+        {
+            return UT_ROBOT_ERR_CLIENT_API_TIMEOUT;
+        }
+
+        if (responsePtr->header().identity().api_id() != apiId)
+        {
+            responsePtr.reset();
+            return UT_ROBOT_ERR_CLIENT_API_NOT_MATCH;
+        }
+
+        return responsePtr->header().status().code();
+    }
+
 private:
     int64_t mTimeout;
     ClientStubPtr mClientStubPtr;
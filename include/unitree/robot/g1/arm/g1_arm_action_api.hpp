@@ -1,6 +1,6 @@
 #pragma once
 
-#include <unitree/common/json/jsonize.hpp>
+#include <unitree/common/json/json_reflect.hpp>
 #include <variant>
 
 namespace unitree {
@@ -21,13 +21,8 @@ class JsonizeArmActionCommand : public common::Jsonize {
   JsonizeArmActionCommand() {}
   ~JsonizeArmActionCommand() {}
 
-  void fromJson(common::JsonMap &json) {
-    common::FromJson(json["data"], action_id);
-  }
-
-  void toJson(common::JsonMap &json) const {
-    common::ToJson(action_id, json["data"]);
-  }
+  JN_REFLECT(JsonizeArmActionCommand,
+      JN_FIELD("data", action_id))
 
   int32_t action_id;
 };
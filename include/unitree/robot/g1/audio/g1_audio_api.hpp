@@ -1,7 +1,7 @@
 #ifndef __UT_ROBOT_G1_AUDIO_API_HPP__
 #define __UT_ROBOT_G1_AUDIO_API_HPP__
 
-#include <unitree/common/json/jsonize.hpp>
+#include <unitree/common/json/json_reflect.hpp>
 // #include <variant>
 
 namespace unitree {
@@ -27,13 +27,10 @@ class TtsMakerParameter : public common::Jsonize {
   TtsMakerParameter() {}
   ~TtsMakerParameter() {}
 
-  void fromJson(common::JsonMap &json) {}
-
-  void toJson(common::JsonMap &json) const {
-    common::ToJson(index, json["index"]);
-    common::ToJson(speaker_id, json["speaker_id"]);
-    common::ToJson(text, json["text"]);
-  }
+  JN_REFLECT(TtsMakerParameter,
+      JN_FIELD("index", index),
+      JN_FIELD("speaker_id", speaker_id),
+      JN_FIELD("text", text))
 
   int32_t index = 0;
   uint16_t speaker_id = 0;
@@ -45,12 +42,9 @@ class PlayStreamParameter : public common::Jsonize {
   PlayStreamParameter() {}
   ~PlayStreamParameter() {}
 
-  void fromJson(common::JsonMap &json) {}
-
-  void toJson(common::JsonMap &json) const {
-    common::ToJson(app_name, json["app_name"]);
-    common::ToJson(stream_id, json["stream_id"]);
-  }
+  JN_REFLECT(PlayStreamParameter,
+      JN_FIELD("app_name", app_name),
+      JN_FIELD("stream_id", stream_id))
 
   std::string app_name;
   std::string stream_id;
@@ -61,11 +55,8 @@ class PlayStopParameter : public common::Jsonize {
   PlayStopParameter() {}
   ~PlayStopParameter() {}
 
-  void fromJson(common::JsonMap &json) {}
-
-  void toJson(common::JsonMap &json) const {
-    common::ToJson(app_name, json["app_name"]);
-  }
+  JN_REFLECT(PlayStopParameter,
+      JN_FIELD("app_name", app_name))
 
   std::string app_name;
 };
@@ -75,13 +66,10 @@ class LedControlParameter : public common::Jsonize {
   LedControlParameter() {}
   ~LedControlParameter() {}
 
-  void fromJson(common::JsonMap &json) {}
-
-  void toJson(common::JsonMap &json) const {
-    common::ToJson(R, json["R"]);
-    common::ToJson(G, json["G"]);
-    common::ToJson(B, json["B"]);
-  }
+  JN_REFLECT(LedControlParameter,
+      JN_FIELD("R", R),
+      JN_FIELD("G", G),
+      JN_FIELD("B", B))
 
   uint8_t R;
   uint8_t G;
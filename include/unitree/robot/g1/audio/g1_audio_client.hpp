@@ -35,7 +35,7 @@ class AudioClient : public Client {
     json.index = tts_index++;
     json.text = text;
     json.speaker_id = speaker_id;
-    parameter = common::ToJsonString(json);
+    common::StreamToJsonString(json, parameter);
 
     return Call(ROBOT_API_ID_AUDIO_TTS, parameter, data);
   }
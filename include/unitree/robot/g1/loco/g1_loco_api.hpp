@@ -1,7 +1,7 @@
 #ifndef __UT_ROBOT_G1_LOCO_API_HPP__
 #define __UT_ROBOT_G1_LOCO_API_HPP__
 
-#include <unitree/common/json/jsonize.hpp>
+#include <unitree/common/json/json_reflect.hpp>
 #include <variant>
 
 namespace unitree {
@@ -37,11 +37,8 @@ public:
   JsonizeDataVecFloat() {}
   ~JsonizeDataVecFloat() {}
 
-  void fromJson(common::JsonMap &json) { common::FromJson(json["data"], data); }
-
-  void toJson(common::JsonMap &json) const {
-    common::ToJson(data, json["data"]);
-  }
+  JN_REFLECT(JsonizeDataVecFloat,
+      JN_FIELD("data", data))
 
   std::vector<float> data;
 };
@@ -51,15 +48,9 @@ public:
   JsonizeVelocityCommand() {}
   ~JsonizeVelocityCommand() {}
 
-  void fromJson(common::JsonMap &json) {
-    common::FromJson(json["velocity"], velocity);
-    common::FromJson(json["duration"], duration);
-  }
-
-  void toJson(common::JsonMap &json) const {
-    common::ToJson(velocity, json["velocity"]);
-    common::ToJson(duration, json["duration"]);
-  }
+  JN_REFLECT(JsonizeVelocityCommand,
+      JN_FIELD("velocity", velocity),
+      JN_FIELD("duration", duration))
 
   std::vector<float> velocity;
   float duration;
@@ -1,7 +1,7 @@
 #ifndef __UT_ROBOT_GO2_CONFIG_API_HPP__
 #define __UT_ROBOT_GO2_CONFIG_API_HPP__
 
-#include <unitree/common/json/jsonize.hpp>
+#include <unitree/common/json/json_reflect.hpp>
 
 namespace unitree
 {
@@ -39,21 +39,11 @@ public:
     ~JsonizeConfigMeta()
     {}
 
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["name"], name);
-        common::FromJson(json["lastModified"], lastModified);
-        common::FromJson(json["size"], size);
-        common::FromJson(json["epoch"], epoch);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(name, json["name"]);
-        common::ToJson(lastModified, json["lastModified"]);
-        common::ToJson(size, json["size"]);
-        common::ToJson(epoch, json["epoch"]);
-    }
+    JN_REFLECT(JsonizeConfigMeta,
+        JN_FIELD("name", name),
+        JN_FIELD("lastModified", lastModified),
+        JN_FIELD("size", size),
+        JN_FIELD("epoch", epoch))
 
 public:
     std::string name;
@@ -71,17 +61,9 @@ public:
     ~ConfigSetParameter()
     {}
 
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["name"], name);
-        common::FromJson(json["content"], content);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(name, json["name"]);
-        common::ToJson(content, json["content"]);
-    }
+    JN_REFLECT(ConfigSetParameter,
+        JN_FIELD("name", name),
+        JN_FIELD("content", content))
 
 public:
     std::string name;
@@ -97,15 +79,8 @@ public:
     ~ConfigGetParameter()
     {}
 
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["name"], name);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(name, json["name"]);
-    }
+    JN_REFLECT(ConfigGetParameter,
+        JN_FIELD("name", name))
 
 public:
     std::string name;
@@ -120,15 +95,8 @@ public:
     ~ConfigGetData()
     {}
 
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["content"], content);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(content, json["content"]);
-    }
+    JN_REFLECT(ConfigGetData,
+        JN_FIELD("content", content))
 
 public:
     std::string content;
@@ -143,15 +111,8 @@ public:
     ~ConfigDelParameter()
     {}
 
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["name"], name);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(name, json["name"]);
-    }
+    JN_REFLECT(ConfigDelParameter,
+        JN_FIELD("name", name))
 
 public:
     std::string name;
@@ -166,15 +127,8 @@ public:
     ~ConfigMetaParameter()
     {}
 
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["name"], name);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(name, json["name"]);
-    }
+    JN_REFLECT(ConfigMetaParameter,
+        JN_FIELD("name", name))
 
 public:
     std::string name;
@@ -189,15 +143,8 @@ public:
     ~ConfigMetaData()
     {}
 
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["meta"], meta);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(meta, json["meta"]);
-    }
+    JN_REFLECT(ConfigMetaData,
+        JN_FIELD("meta", meta))
 
 public:
     JsonizeConfigMeta meta;
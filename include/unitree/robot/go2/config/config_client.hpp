@@ -2,7 +2,10 @@
 #define __UT_ROBOT_GO2_CONFIG_CLIENT_HPP__
 
 #include <unitree/robot/client/client.hpp>
+#include <unitree/robot/go2/config/config_api.hpp>
 #include <unitree/robot/channel/channel_subscriber.hpp>
+#include <unitree/robot/serialize/serialize.hpp>
+#include <unitree/common/string_tool.hpp>
 #include <unitree/idl/go2/ConfigChangeStatus_.hpp>
 
 namespace unitree
@@ -45,6 +48,95 @@ public:
 
     int32_t Set(const std::string& name, const std::string& content);
     int32_t Get(const std::string& name, std::string& content);
+
+    /*
+     * @brief TakeContent
+     * @note: same as Get, but parses the response data in place and moves
+     *        the content out instead of copying it twice.
+     */
+    int32_t TakeContent(const std::string& name, std::string& content)
+    {
+        ConfigGetParameter getParameter;
+        getParameter.name = name;
+
+        std::string parameter = common::ToJsonString(getParameter);
+
+        ResponsePtr responsePtr;
+        int32_t ret = Call(CONFIG_API_ID_GET, parameter, responsePtr);
+        if (ret != UT_ROBOT_OK)
+        {
+            return ret;
+        }
+
+        try
+        {
+            ConfigGetData getData;
+            common::FromJsonString(responsePtr->data(), getData);
+            content = std::move(getData.content);
+        }
+        catch (const common::Exception& e)
+        {
+            return UT_ROBOT_ERR_CLIENT_API_DATA;
+        }
+
+        return UT_ROBOT_OK;
+    }
+
+    /*
+     * @brief SetObject
+     * @note: store a Jsonize type as config content, json by default so
+     *        Get and other readers see it unchanged. cbor content is base64
+     *        encoded, since it travels inside a json string.
+     */
+    template<typename T>
+    int32_t SetObject(const std::string& name, const T& value,
+        int32_t format = UT_SERIALIZE_FORMAT_JSON)
+    {
+        std::string content;
+        if (!Serialize(value, content, format))
+        {
+            return UT_ROBOT_ERR_CLIENT_API_DATA;
+        }
+
+        if (format == UT_SERIALIZE_FORMAT_CBOR)
+        {
+            content = common::Base64Encode(content);
+        }
+
+        return Set(name, content);
+    }
+
+    /*
+     * @brief GetObject
+     * @note: read content stored by SetObject in either format, or plain
+     *        json written by Set.
+     */
+    template<typename T>
+    int32_t GetObject(const std::string& name, T& value)
+    {
+        std::string content;
+        int32_t ret = TakeContent(name, content);
+        if (ret != UT_ROBOT_OK)
+        {
+            return ret;
+        }
+
+        bool ok;
+        size_t pos = content.find_first_not_of(" \t\r\n");
+        if (pos != std::string::npos && (content[pos] == '{' || content[pos] == '['))
+        {
+            ok = Deserialize(content, value, UT_SERIALIZE_FORMAT_JSON);
+        }
+        else
+        {
+            std::string binary;
+            ok = common::Base64Decode(content, binary) &&
+                Deserialize(binary, value, UT_SERIALIZE_FORMAT_CBOR);
+        }
+
+        return ok ? UT_ROBOT_OK : UT_ROBOT_ERR_CLIENT_API_DATA;
+    }
+
     int32_t Del(const std::string& name);
     int32_t Meta(const std::string& name, ConfigMeta& meta);
     int32_t Meta(const std::string& name, std::string& meta);
@@ -1,7 +1,7 @@
 #ifndef __UT_ROBOT_GO2_OBSTACLES_AVOID_API_HPP__
 #define __UT_ROBOT_GO2_OBSTACLES_AVOID_API_HPP__
 
-#include <unitree/common/json/jsonize.hpp>
+#include <unitree/common/json/json_reflect.hpp>
 
 namespace unitree
 {
@@ -20,15 +20,8 @@ const int32_t ROBOT_API_ID_OBSTACLES_AVOID_USE_REMOTE_COMMAND_FROM_API = 1004;
 class ObstaclesAvoidSwitchSetParameter : public common::Jsonize
 {
 public:
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["enable"], mEnable);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(mEnable, json["enable"]);
-    }
+    JN_REFLECT(ObstaclesAvoidSwitchSetParameter,
+        JN_FIELD("enable", mEnable))
 
     bool mEnable = true;
 };
@@ -36,15 +29,8 @@ public:
 class ObstaclesAvoidSwitchGetData : public common::Jsonize
 {
 public:
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["enable"], mEnable);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(mEnable, json["enable"]);
-    }
+    JN_REFLECT(ObstaclesAvoidSwitchGetData,
+        JN_FIELD("enable", mEnable))
 
     bool mEnable = true;
 };
@@ -52,21 +38,11 @@ public:
 class ObstaclesAvoidMoveParameter : public common::Jsonize
 {
 public:
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["x"], mX);
-        common::FromJson(json["y"], mY);
-        common::FromJson(json["yaw"], mYaw);
-        common::FromJson(json["mode"], mMode);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(mX, json["x"]);
-        common::ToJson(mY, json["y"]);
-        common::ToJson(mYaw, json["yaw"]);
-        common::ToJson(mMode, json["mode"]);
-    }
+    JN_REFLECT(ObstaclesAvoidMoveParameter,
+        JN_FIELD("x", mX),
+        JN_FIELD("y", mY),
+        JN_FIELD("yaw", mYaw),
+        JN_FIELD("mode", mMode))
 
     float mX = 0.0;
     float mY = 0.0;
@@ -84,15 +60,8 @@ public:
 class ObstaclesAvoidRemoteCommandSource : public common::Jsonize
 {
 public:
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["is_remote_commands_from_api"], mIsRemoteCommandsFromApi);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(mIsRemoteCommandsFromApi, json["is_remote_commands_from_api"]);
-    }
+    JN_REFLECT(ObstaclesAvoidRemoteCommandSource,
+        JN_FIELD("is_remote_commands_from_api", mIsRemoteCommandsFromApi))
 
     bool mIsRemoteCommandsFromApi = true;
 };
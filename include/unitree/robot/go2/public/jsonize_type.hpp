@@ -1,7 +1,7 @@
 #ifndef __UT_ROBOT_GO2_SDK_JSON_DATA_TYPE_HPP__
 #define __UT_ROBOT_GO2_SDK_JSON_DATA_TYPE_HPP__
 
-#include <unitree/common/json/jsonize.hpp>
+#include <unitree/common/json/json_reflect.hpp>
 
 namespace unitree
 {
@@ -21,15 +21,8 @@ public:
     ~JsonizeFlagBool()
     {}
 
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["flag"], flag);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(flag, json["flag"]);
-    }
+    JN_REFLECT(JsonizeFlagBool,
+        JN_FIELD("flag", flag))
 
 public:
     bool flag;
@@ -47,15 +40,8 @@ public:
     ~JsonizeDataBool()
     {}
 
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["data"], data);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(data, json["data"]);
-    }
+    JN_REFLECT(JsonizeDataBool,
+        JN_FIELD("data", data))
 
 public:
     bool data;
@@ -73,15 +59,8 @@ public:
     ~JsonizeDataInt()
     {}
 
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["data"], data);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(data, json["data"]);
-    }
+    JN_REFLECT(JsonizeDataInt,
+        JN_FIELD("data", data))
 
 public:
     int data;
@@ -99,15 +78,8 @@ public:
     ~JsonizeDataFloat()
     {}
 
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["data"], data);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(data, json["data"]);
-    }
+    JN_REFLECT(JsonizeDataFloat,
+        JN_FIELD("data", data))
 
 public:
     float data;
@@ -125,15 +97,8 @@ public:
     ~JsonizeDataDouble()
     {}
 
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["data"], data);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(data, json["data"]);
-    }
+    JN_REFLECT(JsonizeDataDouble,
+        JN_FIELD("data", data))
 
 public:
     double data;
@@ -151,15 +116,8 @@ public:
     ~JsonizeDataString()
     {}
 
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["data"], data);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(data, json["data"]);
-    }
+    JN_REFLECT(JsonizeDataString,
+        JN_FIELD("data", data))
 
 public:
     std::string data;
@@ -177,19 +135,10 @@ public:
     ~JsonizeVec3()
     {}
 
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["x"], x);
-        common::FromJson(json["y"], y);
-        common::FromJson(json["z"], z);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(x, json["x"]);
-        common::ToJson(y, json["y"]);
-        common::ToJson(z, json["z"]);
-    }
+    JN_REFLECT(JsonizeVec3,
+        JN_FIELD("x", x),
+        JN_FIELD("y", y),
+        JN_FIELD("z", z))
 
 public:
     float x;
@@ -209,21 +158,11 @@ public:
     ~JsonizeQuat()
     {}
 
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["x"], x);
-        common::FromJson(json["y"], y);
-        common::FromJson(json["z"], z);
-        common::FromJson(json["w"], w);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(x, json["x"]);
-        common::ToJson(y, json["y"]);
-        common::ToJson(z, json["z"]);
-        common::ToJson(w, json["w"]);
-    }
+    JN_REFLECT(JsonizeQuat,
+        JN_FIELD("x", x),
+        JN_FIELD("y", y),
+        JN_FIELD("z", z),
+        JN_FIELD("w", w))
 
 public:
     float x;
@@ -246,27 +185,14 @@ public:
     {}
 
 public:
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["t_from_start"], timeFromStart);
-        common::FromJson(json["x"], x);
-        common::FromJson(json["y"], y);
-        common::FromJson(json["yaw"], yaw);
-        common::FromJson(json["vx"], vx);
-        common::FromJson(json["vy"], vy);
-        common::FromJson(json["vyaw"], vyaw);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(timeFromStart, json["t_from_start"]);
-        common::ToJson(x, json["x"]);
-        common::ToJson(y, json["y"]);
-        common::ToJson(yaw, json["yaw"]);
-        common::ToJson(vx, json["vx"]);
-        common::ToJson(vy, json["vy"]);
-        common::ToJson(vyaw, json["vyaw"]);
-  }
+    JN_REFLECT(JsonizePathPoint,
+        JN_FIELD("t_from_start", timeFromStart),
+        JN_FIELD("x", x),
+        JN_FIELD("y", y),
+        JN_FIELD("yaw", yaw),
+        JN_FIELD("vx", vx),
+        JN_FIELD("vy", vy),
+        JN_FIELD("vyaw", vyaw))
 
 public:
     float timeFromStart;
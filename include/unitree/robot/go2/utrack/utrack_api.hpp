@@ -1,7 +1,7 @@
 #ifndef __UT_ROBOT_GO2_UTRACK_API_HPP__
 #define __UT_ROBOT_GO2_UTRACK_API_HPP__
 
-#include <unitree/common/json/jsonize.hpp>
+#include <unitree/common/json/json_reflect.hpp>
 
 namespace unitree
 {
@@ -19,15 +19,8 @@ const int32_t ROBOT_API_ID_UTRACK_IS_TRACKING = 1003;
 class UtrackSwitchSetParameter : public common::Jsonize
 {
 public:
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["enable"], mEnable);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(mEnable, json["enable"]);
-    }
+    JN_REFLECT(UtrackSwitchSetParameter,
+        JN_FIELD("enable", mEnable))
 
     int32_t mEnable = true;
 };
@@ -35,15 +28,8 @@ public:
 class UtrackSwitchGetData : public common::Jsonize
 {
 public:
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["enable"], mEnable);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(mEnable, json["enable"]);
-    }
+    JN_REFLECT(UtrackSwitchGetData,
+        JN_FIELD("enable", mEnable))
 
     int32_t mEnable = true;
 };
@@ -2,6 +2,7 @@
 #define __UT_ROBOT_GO2_VIDEO_CLIENT_HPP__
 
 #include <unitree/robot/client/client.hpp>
+#include <unitree/robot/go2/video/video_api.hpp>
 
 namespace unitree
 {
@@ -26,6 +27,18 @@ public:
      */
     int32_t GetImageSample(std::vector<uint8_t>&);
 
+    /*
+     * @brief TakeImageSample
+     * @api: 1001
+     * @note: same as GetImageSample, but the jpeg buffer is moved out of the
+     *        received response instead of being copied.
+     */
+    int32_t TakeImageSample(std::vector<uint8_t>& image)
+    {
+        static const std::vector<uint8_t> parameter;
+        return TakeCall(ROBOT_VIDEO_API_ID_GETIMAGESAMPLE, parameter, image);
+    }
+
 };
 }
 }
@@ -1,7 +1,7 @@
 #ifndef __UT_ROBOT_H1_LOCO_API_HPP__
 #define __UT_ROBOT_H1_LOCO_API_HPP__
 
-#include <unitree/common/json/jsonize.hpp>
+#include <unitree/common/json/json_reflect.hpp>
 #include <variant>
 
 namespace unitree {
@@ -41,9 +41,8 @@ class JsonizeDataVecFloat : public common::Jsonize {
   JsonizeDataVecFloat() {}
   ~JsonizeDataVecFloat() {}
 
-  void fromJson(common::JsonMap& json) { common::FromJson(json["data"], data); }
-
-  void toJson(common::JsonMap& json) const { common::ToJson(data, json["data"]); }
+  JN_REFLECT(JsonizeDataVecFloat,
+      JN_FIELD("data", data))
 
   std::vector<float> data;
 };
@@ -53,15 +52,9 @@ class JsonizeVelocityCommand : public common::Jsonize {
   JsonizeVelocityCommand() {}
   ~JsonizeVelocityCommand() {}
 
-  void fromJson(common::JsonMap& json) {
-    common::FromJson(json["velocity"], velocity);
-    common::FromJson(json["duration"], duration);
-  }
-
-  void toJson(common::JsonMap& json) const {
-    common::ToJson(velocity, json["velocity"]);
-    common::ToJson(duration, json["duration"]);
-  }
+  JN_REFLECT(JsonizeVelocityCommand,
+      JN_FIELD("velocity", velocity),
+      JN_FIELD("duration", duration))
 
   std::vector<float> velocity;
   float duration;
@@ -72,19 +65,11 @@ class JsonizeTargetPos : public common::Jsonize {
   JsonizeTargetPos() {}
   ~JsonizeTargetPos() {}
 
-  void fromJson(common::JsonMap& json) {
-    common::FromJson(json["x"], x);
-    common::FromJson(json["y"], y);
-    common::FromJson(json["yaw"], yaw);
-    common::FromJson(json["relative"], relative);
-  }
-
-  void toJson(common::JsonMap& json) const {
-    common::ToJson(x, json["x"]);
-    common::ToJson(y, json["y"]);
-    common::ToJson(yaw, json["yaw"]);
-    common::ToJson(relative, json["relative"]);
-  }
+  JN_REFLECT(JsonizeTargetPos,
+      JN_FIELD("x", x),
+      JN_FIELD("y", y),
+      JN_FIELD("yaw", yaw),
+      JN_FIELD("relative", relative))
 
   float x, y, yaw;
   bool relative;
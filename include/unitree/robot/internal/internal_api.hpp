@@ -2,7 +2,7 @@
 #define __UT_ROBOT_SDK_INERNAL_API_HPP__
 
 #include <unitree/common/decl.hpp>
-#include <unitree/common/json/jsonize.hpp>
+#include <unitree/common/json/json_reflect.hpp>
 
 namespace unitree
 {
@@ -72,15 +72,8 @@ public:
     ~ApplyLeaseParameter()
     {}
 
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["name"], name);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(name, json["name"]);
-    }
+    JN_REFLECT(ApplyLeaseParameter,
+        JN_FIELD("name", name))
 
 public:
     std::string name;
@@ -99,17 +92,9 @@ public:
     ~ApplyLeaseData()
     {}
 
-    void fromJson(common::JsonMap& json)
-    {
-        common::FromJson(json["id"], id);
-        common::FromJson(json["term"], term);
-    }
-
-    void toJson(common::JsonMap& json) const
-    {
-        common::ToJson(id, json["id"]);
-        common::ToJson(term, json["term"]);
-    }
+    JN_REFLECT(ApplyLeaseData,
+        JN_FIELD("id", id),
+        JN_FIELD("term", term))
 
 public:
     int64_t id;
@@ -0,0 +1,345 @@
+#ifndef __UT_ROBOT_SDK_JOINT_MATH_HPP__
+#define __UT_ROBOT_SDK_JOINT_MATH_HPP__
+
+#include <unitree/common/decl.hpp>
+#include <array>
+
+#if defined(__SSE__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace unitree
+{
+namespace robot
+{
+/*
+ * float kernels over joint arrays: lerp, clamp to limits, rate limit,
+ * low pass, pd torque and cubic segments. every kernel is written once against an ops
+ * class and instantiated for the widest vector the build targets (avx
+ * when compiled with -mavx, else sse or neon) and for JointScalarOps,
+ * the scalar reference. a vector pass leaves its tail to the next
+ * narrower ops class, so any joint count works. out may be the same
+ * array as an input.
+ */
+class JointScalarOps
+{
+public:
+    typedef float Type;
+    static constexpr size_t WIDTH = 1;
+
+    static Type Load(const float* p) { return *p; }
+    static void Store(float* p, Type v) { *p = v; }
+    static Type Set(float v) { return v; }
+    static Type Add(Type a, Type b) { return a + b; }
+    static Type Sub(Type a, Type b) { return a - b; }
+    static Type Mul(Type a, Type b) { return a * b; }
+
+    /*
+     * same operand order and nan behaviour as maxps/minps.
+     */
+    static Type Max(Type a, Type b) { return a > b ? a : b; }
+    static Type Min(Type a, Type b) { return a < b ? a : b; }
+};
+
+#if defined(__SSE__)
+class JointSseOps
+{
+public:
+    typedef __m128 Type;
+    typedef JointScalarOps Narrow;
+    static constexpr size_t WIDTH = 4;
+
+    static Type Load(const float* p) { return _mm_loadu_ps(p); }
+    static void Store(float* p, Type v) { _mm_storeu_ps(p, v); }
+    static Type Set(float v) { return _mm_set1_ps(v); }
+    static Type Add(Type a, Type b) { return _mm_add_ps(a, b); }
+    static Type Sub(Type a, Type b) { return _mm_sub_ps(a, b); }
+    static Type Mul(Type a, Type b) { return _mm_mul_ps(a, b); }
+    static Type Max(Type a, Type b) { return _mm_max_ps(a, b); }
+    static Type Min(Type a, Type b) { return _mm_min_ps(a, b); }
+};
+
+#if defined(__AVX__)
+class JointAvxOps
+{
+public:
+    typedef __m256 Type;
+    typedef JointSseOps Narrow;
+    static constexpr size_t WIDTH = 8;
+
+    static Type Load(const float* p) { return _mm256_loadu_ps(p); }
+    static void Store(float* p, Type v) { _mm256_storeu_ps(p, v); }
+    static Type Set(float v) { return _mm256_set1_ps(v); }
+    static Type Add(Type a, Type b) { return _mm256_add_ps(a, b); }
+    static Type Sub(Type a, Type b) { return _mm256_sub_ps(a, b); }
+    static Type Mul(Type a, Type b) { return _mm256_mul_ps(a, b); }
+    static Type Max(Type a, Type b) { return _mm256_max_ps(a, b); }
+    static Type Min(Type a, Type b) { return _mm256_min_ps(a, b); }
+};
+
+typedef JointAvxOps JointVectorOps;
+#else
+typedef JointSseOps JointVectorOps;
+#endif
+#elif defined(__ARM_NEON)
+class JointNeonOps
+{
+public:
+    typedef float32x4_t Type;
+    typedef JointScalarOps Narrow;
+    static constexpr size_t WIDTH = 4;
+
+    static Type Load(const float* p) { return vld1q_f32(p); }
+    static void Store(float* p, Type v) { vst1q_f32(p, v); }
+    static Type Set(float v) { return vdupq_n_f32(v); }
+    static Type Add(Type a, Type b) { return vaddq_f32(a, b); }
+    static Type Sub(Type a, Type b) { return vsubq_f32(a, b); }
+    static Type Mul(Type a, Type b) { return vmulq_f32(a, b); }
+    static Type Max(Type a, Type b) { return vmaxq_f32(a, b); }
+    static Type Min(Type a, Type b) { return vminq_f32(a, b); }
+};
+
+typedef JointNeonOps JointVectorOps;
+#else
+typedef JointScalarOps JointVectorOps;
+#endif
+
+/*
+ * out = from + (to - from) * ratio, ratio clamped to [0, 1].
+ */
+template<typename OPS>
+inline void JointLerpT(float* out, const float* from, const float* to, float ratio, size_t n)
+{
+    ratio = JointScalarOps::Min(JointScalarOps::Max(ratio, 0.0f), 1.0f);
+    const typename OPS::Type r = OPS::Set(ratio);
+
+    size_t i = 0;
+    for (; i + OPS::WIDTH <= n; i += OPS::WIDTH)
+    {
+        typename OPS::Type f = OPS::Load(from + i);
+        OPS::Store(out + i, OPS::Add(f, OPS::Mul(OPS::Sub(OPS::Load(to + i), f), r)));
+    }
+
+    if constexpr (OPS::WIDTH > 1)
+    {
+        JointLerpT<typename OPS::Narrow>(out + i, from + i, to + i, ratio, n - i);
+    }
+}
+
+/*
+ * out = min(max(value, low), high).
+ */
+template<typename OPS>
+inline void JointClampT(float* out, const float* value, const float* low, const float* high, size_t n)
+{
+    size_t i = 0;
+    for (; i + OPS::WIDTH <= n; i += OPS::WIDTH)
+    {
+        OPS::Store(out + i, OPS::Min(OPS::Max(OPS::Load(value + i), OPS::Load(low + i)), OPS::Load(high + i)));
+    }
+
+    if constexpr (OPS::WIDTH > 1)
+    {
+        JointClampT<typename OPS::Narrow>(out + i, value + i, low + i, high + i, n - i);
+    }
+}
+
+/*
+ * out = prev + (target - prev) limited to [-step, step].
+ */
+template<typename OPS>
+inline void JointRateLimitT(float* out, const float* prev, const float* target, const float* step, size_t n)
+{
+    size_t i = 0;
+    for (; i + OPS::WIDTH <= n; i += OPS::WIDTH)
+    {
+        typename OPS::Type p = OPS::Load(prev + i);
+        typename OPS::Type s = OPS::Load(step + i);
+        typename OPS::Type d = OPS::Sub(OPS::Load(target + i), p);
+
+        d = OPS::Min(OPS::Max(d, OPS::Sub(OPS::Set(0.0f), s)), s);
+        OPS::Store(out + i, OPS::Add(p, d));
+    }
+
+    if constexpr (OPS::WIDTH > 1)
+    {
+        JointRateLimitT<typename OPS::Narrow>(out + i, prev + i, target + i, step + i, n - i);
+    }
+}
+
+/*
+ * first order low pass in place: state += (input - state) * alpha.
+ */
+template<typename OPS>
+inline void JointLowPassT(float* state, const float* input, float alpha, size_t n)
+{
+    const typename OPS::Type a = OPS::Set(alpha);
+
+    size_t i = 0;
+    for (; i + OPS::WIDTH <= n; i += OPS::WIDTH)
+    {
+        typename OPS::Type s = OPS::Load(state + i);
+        OPS::Store(state + i, OPS::Add(s, OPS::Mul(OPS::Sub(OPS::Load(input + i), s), a)));
+    }
+
+    if constexpr (OPS::WIDTH > 1)
+    {
+        JointLowPassT<typename OPS::Narrow>(state + i, input + i, alpha, n - i);
+    }
+}
+
+/*
+ * torque the motor pd loop will apply:
+ * tau = kp * (q_des - q) + kd * (dq_des - dq) + tau_ff.
+ */
+template<typename OPS>
+inline void JointPdTorqueT(float* tau, const float* kp, const float* kd, const float* qDes, const float* q,
+    const float* dqDes, const float* dq, const float* tauFf, size_t n)
+{
+    size_t i = 0;
+    for (; i + OPS::WIDTH <= n; i += OPS::WIDTH)
+    {
+        typename OPS::Type p = OPS::Mul(OPS::Load(kp + i), OPS::Sub(OPS::Load(qDes + i), OPS::Load(q + i)));
+        typename OPS::Type d = OPS::Mul(OPS::Load(kd + i), OPS::Sub(OPS::Load(dqDes + i), OPS::Load(dq + i)));
+        OPS::Store(tau + i, OPS::Add(OPS::Add(p, d), OPS::Load(tauFf + i)));
+    }
+
+    if constexpr (OPS::WIDTH > 1)
+    {
+        JointPdTorqueT<typename OPS::Narrow>(tau + i, kp + i, kd + i, qDes + i, q + i, dqDes + i, dq + i,
+            tauFf + i, n - i);
+    }
+}
+
+/*
+ * cubic segment in power form. c holds the rows c0, c1, c2, c3, stride
+ * floats apart: out = c0 + u * (c1 + u * (c2 + u * c3)).
+ */
+template<typename OPS>
+inline void JointCubicT(float* out, const float* c, size_t stride, size_t n, float u)
+{
+    const typename OPS::Type x = OPS::Set(u);
+
+    size_t i = 0;
+    for (; i + OPS::WIDTH <= n; i += OPS::WIDTH)
+    {
+        typename OPS::Type v = OPS::Load(c + 3 * stride + i);
+        v = OPS::Add(OPS::Load(c + 2 * stride + i), OPS::Mul(v, x));
+        v = OPS::Add(OPS::Load(c + stride + i), OPS::Mul(v, x));
+        OPS::Store(out + i, OPS::Add(OPS::Load(c + i), OPS::Mul(v, x)));
+    }
+
+    if constexpr (OPS::WIDTH > 1)
+    {
+        JointCubicT<typename OPS::Narrow>(out + i, c + i, stride, n - i, u);
+    }
+}
+
+/*
+ * derivative of the same segment times scale:
+ * out = (c1 + 2u * c2 + 3u^2 * c3) * scale.
+ */
+template<typename OPS>
+inline void JointCubicSlopeT(float* out, const float* c, size_t stride, size_t n, float u, float scale)
+{
+    const typename OPS::Type x2 = OPS::Set(2.0f * u);
+    const typename OPS::Type x3 = OPS::Set(3.0f * u * u);
+    const typename OPS::Type k = OPS::Set(scale);
+
+    size_t i = 0;
+    for (; i + OPS::WIDTH <= n; i += OPS::WIDTH)
+    {
+        typename OPS::Type v = OPS::Add(OPS::Mul(OPS::Load(c + 2 * stride + i), x2),
+            OPS::Mul(OPS::Load(c + 3 * stride + i), x3));
+        OPS::Store(out + i, OPS::Mul(OPS::Add(OPS::Load(c + stride + i), v), k));
+    }
+
+    if constexpr (OPS::WIDTH > 1)
+    {
+        JointCubicSlopeT<typename OPS::Narrow>(out + i, c + i, stride, n - i, u, scale);
+    }
+}
+
+/*
+ * vector versions.
+ */
+inline void JointLerp(float* out, const float* from, const float* to, float ratio, size_t n)
+{
+    JointLerpT<JointVectorOps>(out, from, to, ratio, n);
+}
+
+inline void JointClamp(float* out, const float* value, const float* low, const float* high, size_t n)
+{
+    JointClampT<JointVectorOps>(out, value, low, high, n);
+}
+
+inline void JointRateLimit(float* out, const float* prev, const float* target, const float* step, size_t n)
+{
+    JointRateLimitT<JointVectorOps>(out, prev, target, step, n);
+}
+
+inline void JointLowPass(float* state, const float* input, float alpha, size_t n)
+{
+    JointLowPassT<JointVectorOps>(state, input, alpha, n);
+}
+
+inline void JointPdTorque(float* tau, const float* kp, const float* kd, const float* qDes, const float* q,
+    const float* dqDes, const float* dq, const float* tauFf, size_t n)
+{
+    JointPdTorqueT<JointVectorOps>(tau, kp, kd, qDes, q, dqDes, dq, tauFf, n);
+}
+
+inline void JointCubic(float* out, const float* c, size_t n, float u)
+{
+    JointCubicT<JointVectorOps>(out, c, n, n, u);
+}
+
+inline void JointCubicSlope(float* out, const float* c, size_t n, float u, float scale)
+{
+    JointCubicSlopeT<JointVectorOps>(out, c, n, n, u, scale);
+}
+
+/*
+ * fixed size joint arrays. n is a constant here, so the vector loop and
+ * the tail unroll.
+ */
+template<size_t N>
+inline void JointLerp(std::array<float,N>& out, const std::array<float,N>& from, const std::array<float,N>& to,
+    float ratio)
+{
+    JointLerp(out.data(), from.data(), to.data(), ratio, N);
+}
+
+template<size_t N>
+inline void JointClamp(std::array<float,N>& value, const std::array<float,N>& low, const std::array<float,N>& high)
+{
+    JointClamp(value.data(), value.data(), low.data(), high.data(), N);
+}
+
+template<size_t N>
+inline void JointRateLimit(std::array<float,N>& out, const std::array<float,N>& prev,
+    const std::array<float,N>& target, const std::array<float,N>& step)
+{
+    JointRateLimit(out.data(), prev.data(), target.data(), step.data(), N);
+}
+
+template<size_t N>
+inline void JointLowPass(std::array<float,N>& state, const std::array<float,N>& input, float alpha)
+{
+    JointLowPass(state.data(), input.data(), alpha, N);
+}
+
+template<size_t N>
+inline void JointPdTorque(std::array<float,N>& tau, const std::array<float,N>& kp, const std::array<float,N>& kd,
+    const std::array<float,N>& qDes, const std::array<float,N>& q, const std::array<float,N>& dqDes,
+    const std::array<float,N>& dq, const std::array<float,N>& tauFf)
+{
+    JointPdTorque(tau.data(), kp.data(), kd.data(), qDes.data(), q.data(), dqDes.data(), dq.data(), tauFf.data(), N);
+}
+
+}
+}
+
+#endif//__UT_ROBOT_SDK_JOINT_MATH_HPP__
@@ -0,0 +1,183 @@
+#ifndef __UT_ROBOT_SDK_LOW_CMD_BUILDER_HPP__
+#define __UT_ROBOT_SDK_LOW_CMD_BUILDER_HPP__
+
+#include <unitree/common/crc32.hpp>
+#include <unitree/idl/go2/LowCmd_.hpp>
+#include <unitree/idl/hg/LowCmd_.hpp>
+
+namespace unitree
+{
+namespace robot
+{
+/*
+ * @brief
+ * @class: LowCmdBuilder
+ * keeps one LowCmd_ across cycles and tracks which motor slots changed.
+ * the crc is the last word of LowCmd_ and covers every word before it.
+ * when incremental, Build updates the crc from the xor delta of the
+ * changed slots instead of checksumming the whole message. that only pays
+ * off against the table back end, a pclmul or crc32 instruction pass over
+ * the whole message is faster than the update.
+ */
+template<typename LOW_CMD>
+class LowCmdBuilder
+{
+public:
+    typedef typename std::remove_reference<decltype(std::declval<LOW_CMD&>().motor_cmd())>::type MotorArray;
+    typedef typename MotorArray::value_type MotorCmd;
+
+    static constexpr size_t MOTOR_NUM = std::tuple_size<MotorArray>::value;
+    static constexpr uint32_t WORD_NUM = (sizeof(LOW_CMD) >> 2) - 1;
+    static constexpr uint32_t SLOT_WORD_NUM = sizeof(MotorCmd) >> 2;
+
+    static_assert(MOTOR_NUM <= 64, "dirty mask holds 64 motors");
+    static_assert(sizeof(MotorCmd) % 4 == 0, "motor slot must be whole words");
+    static_assert(std::is_trivially_copyable<LOW_CMD>::value, "crc reads the message as words");
+
+    explicit LowCmdBuilder(bool incremental = common::GetCrc32Word() == common::Crc32WordTable) :
+        mMessage(), mDirty(0), mAllDirty(true), mIncremental(incremental)
+    {
+        mMotorOffset = (uint32_t)(((const char*)&mMessage.motor_cmd()[0] - (const char*)&mMessage) >> 2);
+
+        /*
+         * slot i is followed by WORD_NUM - end words. x^(32 * n) mod P grows
+         * one word per step, walking from the last slot back.
+         */
+        uint32_t shift = 1;
+        uint32_t end = WORD_NUM;
+        for (size_t i=MOTOR_NUM; i>0; i--)
+        {
+            uint32_t slotEnd = mMotorOffset + (uint32_t)i * SLOT_WORD_NUM;
+            for (; end > slotEnd; end--)
+            {
+                shift = common::Crc32MulMod(shift, UT_CRC32_POLY);
+            }
+
+            mShift[i-1] = shift;
+        }
+    }
+
+    /*
+     * store cmd in slot index. an unchanged command leaves the slot clean.
+     */
+    void SetMotor(size_t index, const MotorCmd& cmd)
+    {
+        MotorCmd& slot = mMessage.motor_cmd()[index];
+        if (slot != cmd)
+        {
+            slot = cmd;
+            mDirty |= (uint64_t)1 << index;
+        }
+    }
+
+    /*
+     * slot index for in place edits, marked dirty.
+     */
+    MotorCmd& Motor(size_t index)
+    {
+        mDirty |= (uint64_t)1 << index;
+        return mMessage.motor_cmd()[index];
+    }
+
+    /*
+     * the whole message, for fields outside motor_cmd. the next Build
+     * checksums the whole message.
+     */
+    LOW_CMD& Mutable()
+    {
+        mAllDirty = true;
+        return mMessage;
+    }
+
+    const LOW_CMD& Get() const
+    {
+        return mMessage;
+    }
+
+    uint64_t GetDirty() const
+    {
+        return mDirty;
+    }
+
+    bool IsIncremental() const
+    {
+        return mIncremental;
+    }
+
+    /*
+     * bring the crc up to date and return the message ready to write.
+     */
+    const LOW_CMD& Build()
+    {
+        /*
+         * past half of the slots a full pass over the message is cheaper.
+         */
+        if (!mIncremental || mAllDirty || (size_t)__builtin_popcountll(mDirty) * 2 > MOTOR_NUM)
+        {
+            mMessage.crc() = common::Crc32Word(Words(mMessage), WORD_NUM);
+            if (mIncremental)
+            {
+                mChecked = mMessage;
+            }
+            mAllDirty = false;
+            mDirty = 0;
+
+            return mMessage;
+        }
+
+        uint32_t crc = mMessage.crc();
+
+        while (mDirty != 0)
+        {
+            size_t index = __builtin_ctzll(mDirty);
+            mDirty &= mDirty - 1;
+
+            uint32_t offset = mMotorOffset + (uint32_t)index * SLOT_WORD_NUM;
+            const uint32_t* current = Words(mMessage) + offset;
+            uint32_t* checked = Words(mChecked) + offset;
+
+            uint32_t delta[SLOT_WORD_NUM];
+            uint32_t changed = 0;
+            for (uint32_t i=0; i<SLOT_WORD_NUM; i++)
+            {
+                delta[i] = current[i] ^ checked[i];
+                checked[i] = current[i];
+                changed |= delta[i];
+            }
+
+            if (changed != 0)
+            {
+                crc ^= common::Crc32MulMod(common::Crc32Word(delta, SLOT_WORD_NUM, 0), mShift[index]);
+            }
+        }
+
+        mMessage.crc() = crc;
+
+        return mMessage;
+    }
+
+private:
+    static uint32_t* Words(LOW_CMD& message)
+    {
+        return (uint32_t*)&message;
+    }
+
+private:
+    LOW_CMD mMessage;
+    LOW_CMD mChecked;
+
+    uint64_t mDirty;
+    bool mAllDirty;
+    bool mIncremental;
+
+    uint32_t mMotorOffset;
+    uint32_t mShift[MOTOR_NUM];
+};
+
+typedef LowCmdBuilder<unitree_go::msg::dds_::LowCmd_> GoLowCmdBuilder;
+typedef LowCmdBuilder<unitree_hg::msg::dds_::LowCmd_> HgLowCmdBuilder;
+
+}
+}
+
+#endif//__UT_ROBOT_SDK_LOW_CMD_BUILDER_HPP__
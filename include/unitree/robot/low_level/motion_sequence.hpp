@@ -0,0 +1,379 @@
+#ifndef __UT_ROBOT_SDK_MOTION_SEQUENCE_HPP__
+#define __UT_ROBOT_SDK_MOTION_SEQUENCE_HPP__
+
+#include <unitree/common/exception.hpp>
+#include <unitree/common/filesystem/filesystem.hpp>
+#include <vector>
+
+/*
+ * compiled motion sequence, the binary form of a behavior_lib .seq file.
+ * all fields little endian:
+ *
+ *   MotionSeqHeader
+ *   MotionSeqComponent[component number]
+ *   uint32_t slot[slot number]              motor slot of each joint column
+ *   padding to UT_MOTION_SEQ_ALIGN
+ *   float frame[frame number][frame width]  components side by side
+ *
+ * a reader rejects files of another version or byte order. frames are
+ * read in place, so only little endian hosts write or map the file.
+ */
+#define UT_MOTION_SEQ_MAGIC         "UTMS"
+#define UT_MOTION_SEQ_VERSION       1
+#define UT_MOTION_SEQ_ALIGN         64
+#define UT_MOTION_SEQ_NAME_SIZE     24
+#define UT_MOTION_SEQ_NO_SLOT       0xFFFFFFFF
+
+namespace unitree
+{
+namespace robot
+{
+class MotionSeqHeader
+{
+public:
+    char mMagic[4];
+    uint32_t mVersion;
+    float mFrameRate;
+    uint32_t mFrameNum;
+    uint32_t mComponentNum;
+    uint32_t mFrameWidth;
+    uint32_t mSlotNum;
+    uint32_t mReserve;
+    uint64_t mDataOffset;
+    uint64_t mDataSize;
+};
+
+/*
+ * mWidth floats at mOffset of every frame. joint valued components map
+ * column i to motor slot slot[mSlotOffset + i], others have
+ * UT_MOTION_SEQ_NO_SLOT.
+ */
+class MotionSeqComponent
+{
+public:
+    char mType[UT_MOTION_SEQ_NAME_SIZE];
+    char mContent[UT_MOTION_SEQ_NAME_SIZE];
+    uint32_t mOffset;
+    uint32_t mWidth;
+    uint32_t mPartNum;
+    uint32_t mSlotOffset;
+};
+
+static_assert(sizeof(MotionSeqHeader) == 48, "motion seq header layout");
+static_assert(sizeof(MotionSeqComponent) == 64, "motion seq component layout");
+
+static inline bool MotionSeqHostLittleEndian()
+{
+    return __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+}
+
+/*
+ * @brief
+ * @class: MotionSeqWriter
+ * collects components and frames, then writes the compiled file.
+ */
+class MotionSeqWriter
+{
+public:
+    MotionSeqWriter(float frameRate, uint32_t frameNum) :
+        mFrameRate(frameRate), mFrameNum(frameNum)
+    {
+        UT_THROW_IF(frameNum == 0, common::CommonException, "motion seq needs at least one frame");
+    }
+
+    /*
+     * slots is empty, or one motor slot per column. return the component
+     * index.
+     */
+    uint32_t AddComponent(const std::string& type, const std::string& content, uint32_t width,
+        uint32_t partNum, const std::vector<uint32_t>& slots = std::vector<uint32_t>())
+    {
+        UT_THROW_IF(type.size() >= UT_MOTION_SEQ_NAME_SIZE || content.size() >= UT_MOTION_SEQ_NAME_SIZE,
+            common::CommonException, "motion seq component name too long:" + type + "/" + content);
+        UT_THROW_IF(!slots.empty() && slots.size() != width, common::CommonException,
+            "motion seq slot number differs from component width:" + content);
+
+        MotionSeqComponent c;
+        memset(&c, 0, sizeof(c));
+        memcpy(c.mType, type.data(), type.size());
+        memcpy(c.mContent, content.data(), content.size());
+        c.mOffset = mComponents.empty() ? 0 : mComponents.back().mOffset + mComponents.back().mWidth;
+        c.mWidth = width;
+        c.mPartNum = partNum;
+        c.mSlotOffset = slots.empty() ? UT_MOTION_SEQ_NO_SLOT : (uint32_t)mSlots.size();
+
+        mSlots.insert(mSlots.end(), slots.begin(), slots.end());
+        mComponents.push_back(c);
+        mData.push_back(std::vector<float>((size_t)width * mFrameNum, 0.0f));
+
+        return (uint32_t)mComponents.size() - 1;
+    }
+
+    /*
+     * width floats of component at frame.
+     */
+    float* Get(uint32_t component, uint32_t frame)
+    {
+        return mData[component].data() + (size_t)frame * mComponents[component].mWidth;
+    }
+
+    void Save(const std::string& fileName) const
+    {
+        UT_THROW_IF(!MotionSeqHostLittleEndian(), common::FileException,
+            "motion seq is little endian, host is not. file:" + fileName);
+
+        MotionSeqHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.mMagic, UT_MOTION_SEQ_MAGIC, 4);
+        header.mVersion = UT_MOTION_SEQ_VERSION;
+        header.mFrameRate = mFrameRate;
+        header.mFrameNum = mFrameNum;
+        header.mComponentNum = (uint32_t)mComponents.size();
+        header.mFrameWidth = mComponents.empty() ? 0 : mComponents.back().mOffset + mComponents.back().mWidth;
+        header.mSlotNum = (uint32_t)mSlots.size();
+
+        std::string s((const char*)&header, sizeof(header));
+        s.append((const char*)mComponents.data(), mComponents.size() * sizeof(MotionSeqComponent));
+        s.append((const char*)mSlots.data(), mSlots.size() * sizeof(uint32_t));
+        s.resize((s.size() + UT_MOTION_SEQ_ALIGN - 1) & ~(size_t)(UT_MOTION_SEQ_ALIGN - 1), '\0');
+
+        header.mDataOffset = s.size();
+        header.mDataSize = (uint64_t)header.mFrameNum * header.mFrameWidth * sizeof(float);
+        memcpy(&s[0], &header, sizeof(header));
+
+        s.reserve(header.mDataOffset + header.mDataSize);
+        for (uint32_t i=0; i<mFrameNum; i++)
+        {
+            for (size_t k=0; k<mComponents.size(); k++)
+            {
+                const uint32_t width = mComponents[k].mWidth;
+                s.append((const char*)(mData[k].data() + (size_t)i * width), width * sizeof(float));
+            }
+        }
+
+        /*
+         * write aside and rename, a reader never maps a partial file.
+         */
+        std::string tmpName = fileName + ".tmp";
+        int32_t fd = open(tmpName.c_str(), common::UT_OPEN_FLAG_C | common::UT_OPEN_FLAG_W |
+            common::UT_OPEN_FLAG_T, common::UT_OPEN_MODE_RW);
+        UT_THROW_IF(fd < 0, common::FileException, "open motion seq failed. file:" + tmpName +
+            ", error:" + strerror(errno));
+
+        size_t written = 0;
+        while (written < s.size())
+        {
+            ssize_t n = write(fd, s.data() + written, s.size() - written);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            else if (n <= 0)
+            {
+                int32_t error = errno;
+                close(fd);
+                unlink(tmpName.c_str());
+                UT_THROW(common::FileException, "write motion seq failed. file:" + tmpName +
+                    ", error:" + strerror(error));
+            }
+
+            written += n;
+        }
+
+        close(fd);
+
+        if (rename(tmpName.c_str(), fileName.c_str()) != 0)
+        {
+            int32_t error = errno;
+            unlink(tmpName.c_str());
+            UT_THROW(common::FileException, "rename motion seq failed. file:" + fileName +
+                ", error:" + strerror(error));
+        }
+    }
+
+private:
+    float mFrameRate;
+    uint32_t mFrameNum;
+    std::vector<MotionSeqComponent> mComponents;
+    std::vector<uint32_t> mSlots;
+    std::vector<std::vector<float>> mData;
+};
+
+/*
+ * @brief
+ * @class: MotionSeqFile
+ * maps a compiled motion sequence read only. frames are read in place,
+ * nothing is copied or parsed after the header checks.
+ */
+class MotionSeqFile
+{
+public:
+    explicit MotionSeqFile(const std::string& fileName) :
+        mFileName(fileName), mData(NULL), mSize(0)
+    {
+        int32_t fd = open(fileName.c_str(), common::UT_OPEN_FLAG_R);
+        UT_THROW_IF(fd < 0, common::FileException, "open motion seq failed. file:" + fileName +
+            ", error:" + strerror(errno));
+
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+        {
+            int32_t error = errno;
+            close(fd);
+            UT_THROW(common::FileException, "stat motion seq failed. file:" + fileName +
+                ", error:" + strerror(error));
+        }
+
+        mSize = (size_t)st.st_size;
+        if (!MotionSeqHostLittleEndian())
+        {
+            close(fd);
+            UT_THROW(common::FileException, "motion seq is little endian, host is not. file:" + fileName);
+        }
+        else if (mSize < sizeof(MotionSeqHeader))
+        {
+            close(fd);
+            UT_THROW(common::FileException, "motion seq too short. file:" + fileName);
+        }
+
+        void* data = mmap(NULL, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        int32_t error = errno;
+        close(fd);
+
+        UT_THROW_IF(data == MAP_FAILED, common::FileException, "map motion seq failed. file:" +
+            fileName + ", error:" + strerror(error));
+
+        mData = (const char*)data;
+        madvise(data, mSize, MADV_WILLNEED);
+
+        Check();
+    }
+
+    ~MotionSeqFile()
+    {
+        if (mData != NULL)
+        {
+            munmap((void*)mData, mSize);
+        }
+    }
+
+    MotionSeqFile(const MotionSeqFile&) = delete;
+    MotionSeqFile& operator=(const MotionSeqFile&) = delete;
+
+    const MotionSeqHeader& GetHeader() const
+    {
+        return *(const MotionSeqHeader*)mData;
+    }
+
+    float GetFrameRate() const
+    {
+        return GetHeader().mFrameRate;
+    }
+
+    uint32_t GetFrameNum() const
+    {
+        return GetHeader().mFrameNum;
+    }
+
+    uint32_t GetFrameWidth() const
+    {
+        return GetHeader().mFrameWidth;
+    }
+
+    uint32_t GetComponentNum() const
+    {
+        return GetHeader().mComponentNum;
+    }
+
+    const MotionSeqComponent& GetComponent(uint32_t index) const
+    {
+        return ((const MotionSeqComponent*)(mData + sizeof(MotionSeqHeader)))[index];
+    }
+
+    /*
+     * index of the first component with this content, or -1.
+     */
+    int32_t FindComponent(const std::string& content) const
+    {
+        for (uint32_t i=0; i<GetComponentNum(); i++)
+        {
+            const MotionSeqComponent& c = GetComponent(i);
+            if (strncmp(c.mContent, content.c_str(), UT_MOTION_SEQ_NAME_SIZE) == 0)
+            {
+                return (int32_t)i;
+            }
+        }
+
+        return -1;
+    }
+
+    /*
+     * motor slots of a joint valued component, GetComponent(index).mWidth
+     * entries, or NULL.
+     */
+    const uint32_t* GetSlots(uint32_t index) const
+    {
+        const MotionSeqComponent& c = GetComponent(index);
+        if (c.mSlotOffset == UT_MOTION_SEQ_NO_SLOT)
+        {
+            return NULL;
+        }
+
+        return (const uint32_t*)(mData + sizeof(MotionSeqHeader) +
+            GetComponentNum() * sizeof(MotionSeqComponent)) + c.mSlotOffset;
+    }
+
+    const float* GetFrame(uint32_t frame) const
+    {
+        return (const float*)(mData + GetHeader().mDataOffset) + (size_t)frame * GetFrameWidth();
+    }
+
+    const float* Get(uint32_t frame, uint32_t component) const
+    {
+        return GetFrame(frame) + GetComponent(component).mOffset;
+    }
+
+private:
+    void Check() const
+    {
+        const MotionSeqHeader& h = GetHeader();
+
+        UT_THROW_IF(memcmp(h.mMagic, UT_MOTION_SEQ_MAGIC, 4) != 0, common::FileException,
+            "not a motion seq file. file:" + mFileName);
+        UT_THROW_IF(h.mVersion == __builtin_bswap32(UT_MOTION_SEQ_VERSION), common::FileException,
+            "motion seq byte order differs from the host. file:" + mFileName);
+        UT_THROW_IF(h.mVersion != UT_MOTION_SEQ_VERSION, common::FileException,
+            "unsupported motion seq version. file:" + mFileName + ", version:" + std::to_string(h.mVersion));
+
+        uint64_t tableEnd = sizeof(MotionSeqHeader) + (uint64_t)h.mComponentNum * sizeof(MotionSeqComponent) +
+            (uint64_t)h.mSlotNum * sizeof(uint32_t);
+
+        UT_THROW_IF(h.mFrameNum == 0, common::FileException, "motion seq has no frames. file:" + mFileName);
+
+        UT_THROW_IF(h.mDataOffset < tableEnd || h.mDataOffset % UT_MOTION_SEQ_ALIGN != 0 ||
+            h.mDataSize != (uint64_t)h.mFrameNum * h.mFrameWidth * sizeof(float) ||
+            h.mDataOffset + h.mDataSize > mSize, common::FileException,
+            "corrupt motion seq layout. file:" + mFileName);
+
+        for (uint32_t i=0; i<h.mComponentNum; i++)
+        {
+            const MotionSeqComponent& c = GetComponent(i);
+
+            UT_THROW_IF((uint64_t)c.mOffset + c.mWidth > h.mFrameWidth ||
+                (c.mSlotOffset != UT_MOTION_SEQ_NO_SLOT && (uint64_t)c.mSlotOffset + c.mWidth > h.mSlotNum),
+                common::FileException, "corrupt motion seq component. file:" + mFileName);
+        }
+    }
+
+private:
+    std::string mFileName;
+    const char* mData;
+    size_t mSize;
+};
+
+typedef std::shared_ptr<MotionSeqFile> MotionSeqFilePtr;
+
+}
+}
+
+#endif//__UT_ROBOT_SDK_MOTION_SEQUENCE_HPP__
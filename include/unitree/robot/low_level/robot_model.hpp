@@ -0,0 +1,381 @@
+#ifndef __UT_ROBOT_SDK_ROBOT_MODEL_HPP__
+#define __UT_ROBOT_SDK_ROBOT_MODEL_HPP__
+
+#include <unitree/robot/low_level/joint_math.hpp>
+#include <unitree/robot/low_level/low_cmd_builder.hpp>
+#include <unitree/robot/low_level/state_view.hpp>
+#include <unitree/idl/go2/LowState_.hpp>
+#include <unitree/idl/hg/LowState_.hpp>
+
+/*
+ * gearbox class of a joint motor.
+ */
+#define UT_GEARBOX_S    0
+#define UT_GEARBOX_M    1
+#define UT_GEARBOX_L    2
+
+namespace unitree
+{
+namespace robot
+{
+/*
+ * @brief
+ * robot model descriptors. every model is a class of constants:
+ *
+ *   LowCmd, LowState   message types
+ *   DOF                number of driven joints
+ *   SLOT_NUM           motor slots in LowCmd_/LowState_
+ *   SLOT[DOF]          motor slot of each joint
+ *   GEARBOX[DOF]       UT_GEARBOX_S/M/L of each joint
+ *   MODE[DOF]          motor mode written to the command
+ *   KP[DOF], KD[DOF]   default gains
+ *
+ * joint arrays below are indexed by joint, not by slot. the primitives
+ * take the model as a template argument, so the joint count and the
+ * tables are compile time constants.
+ */
+
+/*
+ * go2, 12 leg joints in slots 0..11 of 20.
+ */
+class Go2Model
+{
+public:
+    typedef unitree_go::msg::dds_::LowCmd_ LowCmd;
+    typedef unitree_go::msg::dds_::LowState_ LowState;
+
+    static constexpr size_t DOF = 12;
+    static constexpr size_t SLOT_NUM = 20;
+
+    static constexpr std::array<uint32_t,DOF> SLOT = {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+
+    static constexpr std::array<uint8_t,DOF> GEARBOX = {
+        UT_GEARBOX_M, UT_GEARBOX_M, UT_GEARBOX_L,
+        UT_GEARBOX_M, UT_GEARBOX_M, UT_GEARBOX_L,
+        UT_GEARBOX_M, UT_GEARBOX_M, UT_GEARBOX_L,
+        UT_GEARBOX_M, UT_GEARBOX_M, UT_GEARBOX_L };
+
+    static constexpr std::array<uint8_t,DOF> MODE = {
+        0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01 };
+
+    static constexpr std::array<float,DOF> KP = {
+        60, 60, 60, 60, 60, 60, 60, 60, 60, 60, 60, 60 };
+
+    static constexpr std::array<float,DOF> KD = {
+        5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5 };
+};
+
+/*
+ * b2, same joint layout as go2 with stiffer default gains.
+ */
+class B2Model : public Go2Model
+{
+public:
+    static constexpr std::array<float,DOF> KP = {
+        1000, 1000, 1000, 1000, 1000, 1000, 1000, 1000, 1000, 1000, 1000, 1000 };
+
+    static constexpr std::array<float,DOF> KD = {
+        10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10 };
+};
+
+/*
+ * h1, 19 joints in the 20 go2 motor slots, slot 9 is not used. ankles
+ * and arms are the weak motors, in servo mode, the rest in mode 0x0A.
+ */
+class H1Model
+{
+public:
+    typedef unitree_go::msg::dds_::LowCmd_ LowCmd;
+    typedef unitree_go::msg::dds_::LowState_ LowState;
+
+    static constexpr size_t DOF = 19;
+    static constexpr size_t SLOT_NUM = 20;
+
+    static constexpr std::array<uint32_t,DOF> SLOT = {
+        0, 1, 2, 3, 4, 5, 6, 7, 8,
+        10, 11,
+        12, 13, 14, 15, 16, 17, 18, 19 };
+
+    static constexpr std::array<uint8_t,DOF> GEARBOX = {
+        UT_GEARBOX_L, UT_GEARBOX_L, UT_GEARBOX_L, UT_GEARBOX_L, UT_GEARBOX_L, UT_GEARBOX_L,
+        UT_GEARBOX_L, UT_GEARBOX_L, UT_GEARBOX_L,
+        UT_GEARBOX_S, UT_GEARBOX_S,
+        UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S,
+        UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S };
+
+    static constexpr std::array<uint8_t,DOF> MODE = {
+        0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A,
+        0x01, 0x01,
+        0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01 };
+
+    static constexpr std::array<float,DOF> KP = {
+        200, 200, 200, 200, 200, 200, 200, 200, 200,
+        60, 60,
+        60, 60, 60, 60, 60, 60, 60, 60 };
+
+    static constexpr std::array<float,DOF> KD = {
+        5, 5, 5, 5, 5, 5, 5, 5, 5,
+        1.5f, 1.5f,
+        1.5f, 1.5f, 1.5f, 1.5f, 1.5f, 1.5f, 1.5f, 1.5f };
+};
+
+/*
+ * h1-2, 27 joints in slots 0..26 of the 35 hg motor slots: legs, waist
+ * yaw, then 7 joints per arm.
+ */
+class H1_2Model
+{
+public:
+    typedef unitree_hg::msg::dds_::LowCmd_ LowCmd;
+    typedef unitree_hg::msg::dds_::LowState_ LowState;
+
+    static constexpr size_t DOF = 27;
+    static constexpr size_t SLOT_NUM = 35;
+
+    static constexpr std::array<uint32_t,DOF> SLOT = {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+        12,
+        13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26 };
+
+    static constexpr std::array<uint8_t,DOF> GEARBOX = {
+        UT_GEARBOX_M, UT_GEARBOX_M, UT_GEARBOX_M, UT_GEARBOX_L, UT_GEARBOX_S, UT_GEARBOX_S,
+        UT_GEARBOX_M, UT_GEARBOX_M, UT_GEARBOX_M, UT_GEARBOX_L, UT_GEARBOX_S, UT_GEARBOX_S,
+        UT_GEARBOX_M,
+        UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S,
+        UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S };
+
+    static constexpr std::array<uint8_t,DOF> MODE = {
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+
+    static constexpr std::array<float,DOF> KP = {
+        100, 100, 100, 200, 80, 80,
+        100, 100, 100, 200, 80, 80,
+        100,
+        80, 80, 80, 80, 80, 80, 80,
+        80, 80, 80, 80, 80, 80, 80 };
+
+    static constexpr std::array<float,DOF> KD = {
+        3, 3, 3, 5, 2, 2,
+        3, 3, 3, 5, 2, 2,
+        3,
+        2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2 };
+};
+
+/*
+ * g1 29 dof: legs in slots 0..11, waist yaw/roll/pitch in 12..14, then
+ * 7 joints per arm in 15..28.
+ */
+class G1_29Model
+{
+public:
+    typedef unitree_hg::msg::dds_::LowCmd_ LowCmd;
+    typedef unitree_hg::msg::dds_::LowState_ LowState;
+
+    static constexpr size_t DOF = 29;
+    static constexpr size_t SLOT_NUM = 35;
+
+    static constexpr std::array<uint32_t,DOF> SLOT = {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+        12, 13, 14,
+        15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28 };
+
+    static constexpr std::array<uint8_t,DOF> GEARBOX = {
+        UT_GEARBOX_M, UT_GEARBOX_M, UT_GEARBOX_M, UT_GEARBOX_L, UT_GEARBOX_S, UT_GEARBOX_S,
+        UT_GEARBOX_M, UT_GEARBOX_M, UT_GEARBOX_M, UT_GEARBOX_L, UT_GEARBOX_S, UT_GEARBOX_S,
+        UT_GEARBOX_M, UT_GEARBOX_S, UT_GEARBOX_S,
+        UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S,
+        UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S };
+
+    static constexpr std::array<uint8_t,DOF> MODE = {
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+
+    static constexpr std::array<float,DOF> KP = {
+        60, 60, 60, 100, 40, 40,
+        60, 60, 60, 100, 40, 40,
+        60, 40, 40,
+        40, 40, 40, 40, 40, 40, 40,
+        40, 40, 40, 40, 40, 40, 40 };
+
+    static constexpr std::array<float,DOF> KD = {
+        1, 1, 1, 2, 1, 1,
+        1, 1, 1, 2, 1, 1,
+        1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1 };
+};
+
+/*
+ * g1 23 dof: the 29 dof slot layout without waist roll/pitch (13, 14)
+ * and wrist pitch/yaw (20, 21, 27, 28).
+ */
+class G1_23Model
+{
+public:
+    typedef unitree_hg::msg::dds_::LowCmd_ LowCmd;
+    typedef unitree_hg::msg::dds_::LowState_ LowState;
+
+    static constexpr size_t DOF = 23;
+    static constexpr size_t SLOT_NUM = 35;
+
+    static constexpr std::array<uint32_t,DOF> SLOT = {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+        12,
+        15, 16, 17, 18, 19,
+        22, 23, 24, 25, 26 };
+
+    static constexpr std::array<uint8_t,DOF> GEARBOX = {
+        UT_GEARBOX_M, UT_GEARBOX_M, UT_GEARBOX_M, UT_GEARBOX_L, UT_GEARBOX_S, UT_GEARBOX_S,
+        UT_GEARBOX_M, UT_GEARBOX_M, UT_GEARBOX_M, UT_GEARBOX_L, UT_GEARBOX_S, UT_GEARBOX_S,
+        UT_GEARBOX_M,
+        UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S,
+        UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S };
+
+    static constexpr std::array<uint8_t,DOF> MODE = {
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+
+    static constexpr std::array<float,DOF> KP = {
+        60, 60, 60, 100, 40, 40,
+        60, 60, 60, 100, 40, 40,
+        60,
+        40, 40, 40, 40, 40,
+        40, 40, 40, 40, 40 };
+
+    static constexpr std::array<float,DOF> KD = {
+        1, 1, 1, 2, 1, 1,
+        1, 1, 1, 2, 1, 1,
+        1,
+        1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1 };
+};
+
+/*
+ * one float per joint of MODEL.
+ */
+template<typename MODEL>
+using JointArray = std::array<float,MODEL::DOF>;
+
+/*
+ * slots in range, strictly increasing, and SLOT_NUM matching the messages.
+ */
+template<typename MODEL>
+constexpr bool IsValidRobotModel()
+{
+    typedef typename LowCmdBuilder<typename MODEL::LowCmd>::MotorArray MotorArray;
+
+    if (std::tuple_size<MotorArray>::value != MODEL::SLOT_NUM || MODEL::DOF == 0)
+    {
+        return false;
+    }
+
+    for (size_t i=0; i<MODEL::DOF; i++)
+    {
+        if (MODEL::SLOT[i] >= MODEL::SLOT_NUM || (i > 0 && MODEL::SLOT[i] <= MODEL::SLOT[i-1]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * a StateView over the joints of MODEL.
+ */
+template<typename MODEL, uint32_t FIELDS = UT_STATE_FIELD_DEFAULT>
+class ModelStateView : public StateView<typename std::remove_reference<decltype(
+    std::declval<typename MODEL::LowState&>().motor_state())>::type::value_type, MODEL::DOF, FIELDS>
+{
+public:
+    static_assert(IsValidRobotModel<MODEL>(), "invalid robot model");
+
+    ModelStateView() :
+        ModelStateView::StateView(MODEL::SLOT)
+    {}
+};
+
+/*
+ * default gains of MODEL, scaled.
+ */
+template<typename MODEL>
+inline void FillGains(JointArray<MODEL>& kp, JointArray<MODEL>& kd, float scale = 1.0f)
+{
+    for (size_t i=0; i<MODEL::DOF; i++)
+    {
+        kp[i] = MODEL::KP[i] * scale;
+        kd[i] = MODEL::KD[i] * scale;
+    }
+}
+
+template<typename MODEL>
+inline void Clamp(JointArray<MODEL>& value, const JointArray<MODEL>& low, const JointArray<MODEL>& high)
+{
+    JointClamp(value, low, high);
+}
+
+/*
+ * out = from + (to - from) * ratio, ratio clamped to [0, 1].
+ */
+template<typename MODEL>
+inline void Interpolate(const JointArray<MODEL>& from, const JointArray<MODEL>& to, float ratio,
+    JointArray<MODEL>& out)
+{
+    JointLerp(out, from, to, ratio);
+}
+
+/*
+ * write the joint commands to their motor slots with the model mode.
+ * slots outside the model are left as they are.
+ */
+template<typename MODEL>
+inline void PackCommand(LowCmdBuilder<typename MODEL::LowCmd>& builder,
+    const JointArray<MODEL>& q, const JointArray<MODEL>& dq, const JointArray<MODEL>& kp,
+    const JointArray<MODEL>& kd, const JointArray<MODEL>& tau)
+{
+    static_assert(IsValidRobotModel<MODEL>(), "invalid robot model");
+
+    for (size_t i=0; i<MODEL::DOF; i++)
+    {
+        typename LowCmdBuilder<typename MODEL::LowCmd>::MotorCmd cmd = builder.Get().motor_cmd()[MODEL::SLOT[i]];
+        cmd.mode() = MODEL::MODE[i];
+        cmd.q() = q[i];
+        cmd.dq() = dq[i];
+        cmd.kp() = kp[i];
+        cmd.kd() = kd[i];
+        cmd.tau() = tau[i];
+        builder.SetMotor(MODEL::SLOT[i], cmd);
+    }
+}
+
+/*
+ * same on a plain message, followed by a full crc.
+ */
+template<typename MODEL>
+inline void PackCommand(typename MODEL::LowCmd& message,
+    const JointArray<MODEL>& q, const JointArray<MODEL>& dq, const JointArray<MODEL>& kp,
+    const JointArray<MODEL>& kd, const JointArray<MODEL>& tau)
+{
+    static_assert(IsValidRobotModel<MODEL>(), "invalid robot model");
+
+    for (size_t i=0; i<MODEL::DOF; i++)
+    {
+        auto& cmd = message.motor_cmd()[MODEL::SLOT[i]];
+        cmd.mode() = MODEL::MODE[i];
+        cmd.q() = q[i];
+        cmd.dq() = dq[i];
+        cmd.kp() = kp[i];
+        cmd.kd() = kd[i];
+        cmd.tau() = tau[i];
+    }
+
+    message.crc() = common::Crc32Word((const uint32_t*)&message, (sizeof(message) >> 2) - 1);
+}
+
+}
+}
+
+#endif//__UT_ROBOT_SDK_ROBOT_MODEL_HPP__
@@ -0,0 +1,336 @@
+#ifndef __UT_ROBOT_SDK_STATE_VIEW_HPP__
+#define __UT_ROBOT_SDK_STATE_VIEW_HPP__
+
+#include <unitree/common/decl.hpp>
+#include <unitree/idl/go2/MotorState_.hpp>
+#include <unitree/idl/hg/MotorState_.hpp>
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/*
+ * MotorState_ fields a StateView extracts, or-ed into its FIELDS.
+ */
+#define UT_STATE_FIELD_Q        0x01
+#define UT_STATE_FIELD_DQ       0x02
+#define UT_STATE_FIELD_DDQ      0x04
+#define UT_STATE_FIELD_TAU_EST  0x08
+
+#define UT_STATE_FIELD_DEFAULT  (UT_STATE_FIELD_Q | UT_STATE_FIELD_DQ | UT_STATE_FIELD_TAU_EST)
+
+namespace unitree
+{
+namespace robot
+{
+/*
+ * byte offset of q in MOTOR_STATE when q, dq, ddq and tau_est are four
+ * consecutive floats, or -1. the generated members are private, so the
+ * layout is mirrored by a plain struct and checked against the class
+ * size.
+ */
+template<typename MOTOR_STATE>
+class MotorStateLayout
+{
+public:
+    static constexpr ptrdiff_t CORE_OFFSET = -1;
+};
+
+template<>
+class MotorStateLayout<unitree_go::msg::dds_::MotorState_>
+{
+private:
+    struct Mirror
+    {
+        uint8_t mode;
+        float q;
+        float dq;
+        float ddq;
+        float tau_est;
+        float q_raw;
+        float dq_raw;
+        float ddq_raw;
+        uint8_t temperature;
+        uint32_t lost;
+        std::array<uint32_t,2> reserve;
+    };
+
+    static_assert(std::is_standard_layout<unitree_go::msg::dds_::MotorState_>::value &&
+        sizeof(Mirror) == sizeof(unitree_go::msg::dds_::MotorState_), "go2 MotorState_ layout changed");
+
+public:
+    static constexpr ptrdiff_t CORE_OFFSET = offsetof(Mirror, q);
+
+    static_assert(offsetof(Mirror, dq) == CORE_OFFSET + 4 && offsetof(Mirror, ddq) == CORE_OFFSET + 8 &&
+        offsetof(Mirror, tau_est) == CORE_OFFSET + 12, "go2 MotorState_ core fields not consecutive");
+};
+
+template<>
+class MotorStateLayout<unitree_hg::msg::dds_::MotorState_>
+{
+private:
+    struct Mirror
+    {
+        uint8_t mode;
+        float q;
+        float dq;
+        float ddq;
+        float tau_est;
+        std::array<int16_t,2> temperature;
+        float vol;
+        std::array<uint32_t,2> sensor;
+        uint32_t motorstate;
+        std::array<uint32_t,4> reserve;
+    };
+
+    static_assert(std::is_standard_layout<unitree_hg::msg::dds_::MotorState_>::value &&
+        sizeof(Mirror) == sizeof(unitree_hg::msg::dds_::MotorState_), "hg MotorState_ layout changed");
+
+public:
+    static constexpr ptrdiff_t CORE_OFFSET = offsetof(Mirror, q);
+
+    static_assert(offsetof(Mirror, dq) == CORE_OFFSET + 4 && offsetof(Mirror, ddq) == CORE_OFFSET + 8 &&
+        offsetof(Mirror, tau_est) == CORE_OFFSET + 12, "hg MotorState_ core fields not consecutive");
+};
+
+/*
+ * @brief
+ * @class: StateView
+ * copies the selected fields of N motor states into one contiguous,
+ * aligned float array per field. q, dq, ddq and tau_est sit next to
+ * each other in the go2 and hg MotorState_, so four joints are read with
+ * four vector loads and turned into four field vectors by a 4x4
+ * transpose. layouts without that run, see MotorStateLayout, use the
+ * scalar path.
+ */
+template<typename MOTOR_STATE, size_t N, uint32_t FIELDS = UT_STATE_FIELD_DEFAULT>
+class StateView
+{
+public:
+    static constexpr size_t SIZE = N;
+    static constexpr size_t FIELD_NUM = __builtin_popcount(FIELDS);
+
+    /*
+     * arrays are padded to whole vectors.
+     */
+    static constexpr size_t CAPACITY = (N + 3) & ~(size_t)3;
+
+    static constexpr ptrdiff_t CORE_OFFSET = MotorStateLayout<MOTOR_STATE>::CORE_OFFSET;
+
+    static_assert(N > 0, "state view needs at least one joint");
+    static_assert(FIELDS != 0 && (FIELDS & ~0x0F) == 0, "unknown state field");
+
+    /*
+     * joints 0..N-1.
+     */
+    StateView() :
+        mMaxJoint(N - 1)
+    {
+        for (size_t i=0; i<N; i++)
+        {
+            mJoints[i] = (uint32_t)i;
+        }
+
+        memset(mData, 0, sizeof(mData));
+    }
+
+    explicit StateView(const std::array<uint32_t,N>& joints) :
+        mJoints(joints), mMaxJoint(0)
+    {
+        for (size_t i=0; i<N; i++)
+        {
+            mMaxJoint = std::max(mMaxJoint, mJoints[i]);
+        }
+
+        memset(mData, 0, sizeof(mData));
+    }
+
+    /*
+     * motors is the motor_state array of LowState_, or the motor_state
+     * vector of HandState_. return false if it has fewer motors than the
+     * joint set needs.
+     */
+    template<typename MOTOR_ARRAY>
+    bool Extract(const MOTOR_ARRAY& motors)
+    {
+        if (motors.size() <= mMaxJoint)
+        {
+            return false;
+        }
+
+        Extract(motors.data());
+        return true;
+    }
+
+    void Extract(const MOTOR_STATE* motors)
+    {
+        size_t i = 0;
+
+        if constexpr (CORE_OFFSET >= 0)
+        {
+            for (; i + 4 <= N; i += 4)
+            {
+                Transpose4(motors, i);
+            }
+        }
+
+        for (; i < N; i++)
+        {
+            const MOTOR_STATE& m = motors[mJoints[i]];
+
+            if constexpr ((FIELDS & UT_STATE_FIELD_Q) != 0)
+            {
+                mData[Position<UT_STATE_FIELD_Q>()][i] = m.q();
+            }
+            if constexpr ((FIELDS & UT_STATE_FIELD_DQ) != 0)
+            {
+                mData[Position<UT_STATE_FIELD_DQ>()][i] = m.dq();
+            }
+            if constexpr ((FIELDS & UT_STATE_FIELD_DDQ) != 0)
+            {
+                mData[Position<UT_STATE_FIELD_DDQ>()][i] = m.ddq();
+            }
+            if constexpr ((FIELDS & UT_STATE_FIELD_TAU_EST) != 0)
+            {
+                mData[Position<UT_STATE_FIELD_TAU_EST>()][i] = m.tau_est();
+            }
+        }
+    }
+
+    template<uint32_t FIELD>
+    const float* Get() const
+    {
+        static_assert((FIELDS & FIELD) != 0 && (FIELD & (FIELD - 1)) == 0, "field not in view");
+        return mData[Position<FIELD>()];
+    }
+
+    const float* Q() const
+    {
+        return Get<UT_STATE_FIELD_Q>();
+    }
+
+    const float* Dq() const
+    {
+        return Get<UT_STATE_FIELD_DQ>();
+    }
+
+    const float* Ddq() const
+    {
+        return Get<UT_STATE_FIELD_DDQ>();
+    }
+
+    const float* TauEst() const
+    {
+        return Get<UT_STATE_FIELD_TAU_EST>();
+    }
+
+    const std::array<uint32_t,N>& GetJoints() const
+    {
+        return mJoints;
+    }
+
+private:
+    template<uint32_t FIELD>
+    static constexpr size_t Position()
+    {
+        return __builtin_popcount(FIELDS & (FIELD - 1));
+    }
+
+    const float* Core(const MOTOR_STATE* motors, size_t i) const
+    {
+        return (const float*)((const char*)(motors + mJoints[i]) + CORE_OFFSET);
+    }
+
+    /*
+     * joints i..i+3 from rows (q, dq, ddq, tau_est) to one vector per field.
+     */
+    void Transpose4(const MOTOR_STATE* motors, size_t i)
+    {
+#if defined(__SSE2__)
+        __m128 r0 = _mm_loadu_ps(Core(motors, i));
+        __m128 r1 = _mm_loadu_ps(Core(motors, i + 1));
+        __m128 r2 = _mm_loadu_ps(Core(motors, i + 2));
+        __m128 r3 = _mm_loadu_ps(Core(motors, i + 3));
+
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+        Store<UT_STATE_FIELD_Q>(r0, i);
+        Store<UT_STATE_FIELD_DQ>(r1, i);
+        Store<UT_STATE_FIELD_DDQ>(r2, i);
+        Store<UT_STATE_FIELD_TAU_EST>(r3, i);
+#elif defined(__ARM_NEON)
+        float32x4x2_t t01 = vtrnq_f32(vld1q_f32(Core(motors, i)), vld1q_f32(Core(motors, i + 1)));
+        float32x4x2_t t23 = vtrnq_f32(vld1q_f32(Core(motors, i + 2)), vld1q_f32(Core(motors, i + 3)));
+
+        Store<UT_STATE_FIELD_Q>(vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0])), i);
+        Store<UT_STATE_FIELD_DQ>(vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1])), i);
+        Store<UT_STATE_FIELD_DDQ>(vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0])), i);
+        Store<UT_STATE_FIELD_TAU_EST>(vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1])), i);
+#else
+        for (size_t k=i; k<i+4; k++)
+        {
+            const float* core = Core(motors, k);
+
+            Store<UT_STATE_FIELD_Q>(core[0], k);
+            Store<UT_STATE_FIELD_DQ>(core[1], k);
+            Store<UT_STATE_FIELD_DDQ>(core[2], k);
+            Store<UT_STATE_FIELD_TAU_EST>(core[3], k);
+        }
+#endif
+    }
+
+    template<uint32_t FIELD>
+    void Store(float v, size_t i)
+    {
+        if constexpr ((FIELDS & FIELD) != 0)
+        {
+            mData[Position<FIELD>()][i] = v;
+        }
+    }
+
+#if defined(__SSE2__)
+    template<uint32_t FIELD>
+    void Store(__m128 v, size_t i)
+    {
+        if constexpr ((FIELDS & FIELD) != 0)
+        {
+            _mm_store_ps(&mData[Position<FIELD>()][i], v);
+        }
+    }
+#elif defined(__ARM_NEON)
+    template<uint32_t FIELD>
+    void Store(float32x4_t v, size_t i)
+    {
+        if constexpr ((FIELDS & FIELD) != 0)
+        {
+            vst1q_f32(&mData[Position<FIELD>()][i], v);
+        }
+    }
+#endif
+
+private:
+    alignas(64) float mData[FIELD_NUM][CAPACITY];
+    std::array<uint32_t,N> mJoints;
+    uint32_t mMaxJoint;
+};
+
+/*
+ * go2/b2/h1 LowState_ use the go2 MotorState_, g1/h1-2 LowState_ and
+ * HandState_ the hg one.
+ */
+template<size_t N, uint32_t FIELDS = UT_STATE_FIELD_DEFAULT>
+using GoStateView = StateView<unitree_go::msg::dds_::MotorState_, N, FIELDS>;
+
+template<size_t N, uint32_t FIELDS = UT_STATE_FIELD_DEFAULT>
+using HgStateView = StateView<unitree_hg::msg::dds_::MotorState_, N, FIELDS>;
+
+}
+}
+
+#endif//__UT_ROBOT_SDK_STATE_VIEW_HPP__
@@ -0,0 +1,348 @@
+#ifndef __UT_ROBOT_SDK_TRAJECTORY_HPP__
+#define __UT_ROBOT_SDK_TRAJECTORY_HPP__
+
+#include <unitree/robot/low_level/joint_math.hpp>
+#include <unitree/robot/low_level/motion_sequence.hpp>
+#include <algorithm>
+#include <cmath>
+
+/*
+ * joint curve through the frames.
+ * hermite: catmull-rom tangents, passes through every frame, c1.
+ * bspline: uniform cubic b-spline with the frames as control points, c2,
+ *          smooths the frames instead of passing through them.
+ */
+#define UT_TRAJECTORY_HERMITE   0
+#define UT_TRAJECTORY_BSPLINE   1
+
+/*
+ * XYZQWQXQYQZ, the SE3Format of MultiSE3Seq parts.
+ */
+#define UT_TRAJECTORY_POSE_SIZE 7
+
+namespace unitree
+{
+namespace robot
+{
+/*
+ * segment and local parameter of time t on frames uniformly spaced at
+ * rate. t is clamped to the sequence, so one multiply finds the segment
+ * for any t, monotonic or not.
+ */
+static inline uint32_t TrajectorySegment(double t, float rate, uint32_t segmentNum, float& u)
+{
+    double x = t * rate;
+    if (!(x > 0.0))
+    {
+        u = 0.0f;
+        return 0;
+    }
+    else if (x >= (double)segmentNum)
+    {
+        u = 1.0f;
+        return segmentNum - 1;
+    }
+
+    uint32_t k = (uint32_t)x;
+    u = (float)(x - k);
+
+    return k;
+}
+
+/*
+ * @brief
+ * @class: JointTrajectory
+ * continuous time curve over the columns of a value component. every
+ * segment keeps its four power form coefficient rows, so an evaluation is
+ * one segment lookup and a vector horner step over all joints.
+ */
+class JointTrajectory
+{
+public:
+    JointTrajectory(const MotionSeqFile& file, uint32_t component, int32_t mode = UT_TRAJECTORY_HERMITE)
+    {
+        const MotionSeqComponent& c = file.GetComponent(component);
+        Init(file.GetFrame(0) + c.mOffset, file.GetFrameWidth(), file.GetFrameNum(), c.mWidth,
+            file.GetFrameRate(), mode);
+    }
+
+    /*
+     * frameNum frames of width floats, stride floats apart.
+     */
+    JointTrajectory(const float* frames, uint32_t stride, uint32_t frameNum, uint32_t width, float frameRate,
+        int32_t mode = UT_TRAJECTORY_HERMITE)
+    {
+        Init(frames, stride, frameNum, width, frameRate, mode);
+    }
+
+    uint32_t GetWidth() const
+    {
+        return mWidth;
+    }
+
+    double GetDuration() const
+    {
+        return (double)mSegmentNum / mRate;
+    }
+
+    /*
+     * position, and velocity per second when dq is not NULL, at t seconds
+     * from the first frame. outside the sequence the end frame holds and
+     * the velocity is zero.
+     */
+    void Evaluate(double t, float* q, float* dq = NULL) const
+    {
+        float u;
+        uint32_t k = TrajectorySegment(t, mRate, mSegmentNum, u);
+        const float* c = mCoeff.data() + (size_t)k * 4 * mWidth;
+
+        JointCubic(q, c, mWidth, u);
+
+        if (dq != NULL)
+        {
+            double x = t * mRate;
+            if (x >= 0.0 && x <= (double)mSegmentNum)
+            {
+                JointCubicSlope(dq, c, mWidth, u, mRate);
+            }
+            else
+            {
+                std::fill(dq, dq + mWidth, 0.0f);
+            }
+        }
+    }
+
+private:
+    void Init(const float* frames, uint32_t stride, uint32_t frameNum, uint32_t width, float frameRate,
+        int32_t mode)
+    {
+        UT_THROW_IF(frameNum == 0 || !(frameRate > 0.0f), common::CommonException,
+            "trajectory needs frames and a positive frame rate");
+        UT_THROW_IF(mode != UT_TRAJECTORY_HERMITE && mode != UT_TRAJECTORY_BSPLINE, common::CommonException,
+            "unknown trajectory mode:" + std::to_string(mode));
+
+        mWidth = width;
+        mRate = frameRate;
+        mSegmentNum = frameNum > 1 ? frameNum - 1 : 1;
+        mCoeff.resize((size_t)mSegmentNum * 4 * width);
+
+        /*
+         * frames outside the sequence repeat the end frames.
+         */
+        auto p = [frames, stride, frameNum](int64_t i, uint32_t j)
+        {
+            i = std::min(std::max(i, (int64_t)0), (int64_t)frameNum - 1);
+            return frames[(size_t)i * stride + j];
+        };
+
+        for (uint32_t k=0; k<mSegmentNum; k++)
+        {
+            float* c = mCoeff.data() + (size_t)k * 4 * width;
+
+            for (uint32_t j=0; j<width; j++)
+            {
+                float p0 = p((int64_t)k - 1, j);
+                float p1 = p(k, j);
+                float p2 = p(k + 1, j);
+                float p3 = p(k + 2, j);
+
+                if (mode == UT_TRAJECTORY_HERMITE)
+                {
+                    float m1 = (p2 - p0) * 0.5f;
+                    float m2 = (p3 - p1) * 0.5f;
+
+                    c[j] = p1;
+                    c[width + j] = m1;
+                    c[2 * width + j] = 3.0f * (p2 - p1) - 2.0f * m1 - m2;
+                    c[3 * width + j] = 2.0f * (p1 - p2) + m1 + m2;
+                }
+                else
+                {
+                    c[j] = (p0 + 4.0f * p1 + p2) / 6.0f;
+                    c[width + j] = (p2 - p0) * 0.5f;
+                    c[2 * width + j] = (p0 - 2.0f * p1 + p2) * 0.5f;
+                    c[3 * width + j] = (p3 - p0 + 3.0f * (p1 - p2)) / 6.0f;
+                }
+            }
+        }
+    }
+
+private:
+    uint32_t mWidth;
+    uint32_t mSegmentNum;
+    float mRate;
+    std::vector<float> mCoeff;
+};
+
+/*
+ * @brief
+ * @class: PoseTrajectory
+ * continuous time link poses of a MultiSE3Seq component: position is
+ * interpolated linearly, orientation by slerp along the shorter arc.
+ * quaternions are normalized and the arc of every segment is computed
+ * once.
+ */
+class PoseTrajectory
+{
+public:
+    PoseTrajectory(const MotionSeqFile& file, uint32_t component)
+    {
+        const MotionSeqComponent& c = file.GetComponent(component);
+        UT_THROW_IF(c.mWidth % UT_TRAJECTORY_POSE_SIZE != 0, common::CommonException,
+            "pose component width is not a multiple of 7");
+
+        Init(file.GetFrame(0) + c.mOffset, file.GetFrameWidth(), file.GetFrameNum(),
+            c.mWidth / UT_TRAJECTORY_POSE_SIZE, file.GetFrameRate());
+    }
+
+    PoseTrajectory(const float* frames, uint32_t stride, uint32_t frameNum, uint32_t partNum, float frameRate)
+    {
+        Init(frames, stride, frameNum, partNum, frameRate);
+    }
+
+    uint32_t GetPartNum() const
+    {
+        return mPartNum;
+    }
+
+    double GetDuration() const
+    {
+        return (double)mSegmentNum / mRate;
+    }
+
+    /*
+     * pose is partNum XYZQWQXQYQZ groups.
+     */
+    void Evaluate(double t, float* pose) const
+    {
+        float u;
+        uint32_t k = TrajectorySegment(t, mRate, mSegmentNum, u);
+        const Segment* s = mSegments.data() + (size_t)k * mPartNum;
+
+        for (uint32_t i=0; i<mPartNum; i++, s++, pose+=UT_TRAJECTORY_POSE_SIZE)
+        {
+            for (uint32_t j=0; j<3; j++)
+            {
+                pose[j] = s->mPosition[j] + s->mDelta[j] * u;
+            }
+
+            float w0, w1;
+            if (s->mInvSin != 0.0f)
+            {
+                w0 = std::sin((1.0f - u) * s->mAngle) * s->mInvSin;
+                w1 = std::sin(u * s->mAngle) * s->mInvSin;
+            }
+            else
+            {
+                w0 = 1.0f - u;
+                w1 = u;
+            }
+
+            float norm = 0.0f;
+            for (uint32_t j=0; j<4; j++)
+            {
+                pose[3 + j] = w0 * s->mFrom[j] + w1 * s->mTo[j];
+                norm += pose[3 + j] * pose[3 + j];
+            }
+
+            /*
+             * exact slerp stays unit length, the nlerp fallback does not.
+             */
+            norm = 1.0f / std::sqrt(norm);
+            for (uint32_t j=0; j<4; j++)
+            {
+                pose[3 + j] *= norm;
+            }
+        }
+    }
+
+private:
+    class Segment
+    {
+    public:
+        float mPosition[3];
+        float mDelta[3];
+        float mFrom[4];
+        float mTo[4];
+        float mAngle;
+        float mInvSin;
+    };
+
+    static void Normalize(const float* q, float* out)
+    {
+        float norm = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+        UT_THROW_IF(!(norm > 0.0f), common::CommonException, "pose quaternion is zero or nan");
+
+        for (uint32_t j=0; j<4; j++)
+        {
+            out[j] = q[j] / norm;
+        }
+    }
+
+    void Init(const float* frames, uint32_t stride, uint32_t frameNum, uint32_t partNum, float frameRate)
+    {
+        UT_THROW_IF(frameNum == 0 || !(frameRate > 0.0f), common::CommonException,
+            "trajectory needs frames and a positive frame rate");
+
+        mPartNum = partNum;
+        mRate = frameRate;
+        mSegmentNum = frameNum > 1 ? frameNum - 1 : 1;
+        mSegments.resize((size_t)mSegmentNum * partNum);
+
+        for (uint32_t k=0; k<mSegmentNum; k++)
+        {
+            const float* f0 = frames + (size_t)k * stride;
+            const float* f1 = frames + (size_t)std::min(k + 1, frameNum - 1) * stride;
+
+            for (uint32_t i=0; i<partNum; i++)
+            {
+                Segment& s = mSegments[(size_t)k * partNum + i];
+                const float* a = f0 + i * UT_TRAJECTORY_POSE_SIZE;
+                const float* b = f1 + i * UT_TRAJECTORY_POSE_SIZE;
+
+                for (uint32_t j=0; j<3; j++)
+                {
+                    s.mPosition[j] = a[j];
+                    s.mDelta[j] = b[j] - a[j];
+                }
+
+                Normalize(a + 3, s.mFrom);
+                Normalize(b + 3, s.mTo);
+
+                float dot = 0.0f;
+                for (uint32_t j=0; j<4; j++)
+                {
+                    dot += s.mFrom[j] * s.mTo[j];
+                }
+
+                if (dot < 0.0f)
+                {
+                    dot = -dot;
+                    for (uint32_t j=0; j<4; j++)
+                    {
+                        s.mTo[j] = -s.mTo[j];
+                    }
+                }
+
+                /*
+                 * nearly equal rotations use nlerp, sin(angle) would lose
+                 * all precision.
+                 */
+                s.mAngle = std::acos(std::min(dot, 1.0f));
+                float sinAngle = std::sin(s.mAngle);
+                s.mInvSin = sinAngle > 1e-4f ? 1.0f / sinAngle : 0.0f;
+            }
+        }
+    }
+
+private:
+    uint32_t mPartNum;
+    uint32_t mSegmentNum;
+    float mRate;
+    std::vector<Segment> mSegments;
+};
+
+}
+}
+
+#endif//__UT_ROBOT_SDK_TRAJECTORY_HPP__
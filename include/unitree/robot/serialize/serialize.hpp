@@ -1,18 +1,34 @@
 #ifndef __UT_ROBOT_SDK_SERIALIZE_HPP__
 #define __UT_ROBOT_SDK_SERIALIZE_HPP__
 
-#include <unitree/common/json/jsonize.hpp>
+#include <unitree/common/json/json_cbor.hpp>
+
+/*
+ * serialize format, chosen per call site. cbor is binary and not valid
+ * inside a json string without encoding.
+ */
+#define UT_SERIALIZE_FORMAT_JSON    0
+#define UT_SERIALIZE_FORMAT_CBOR    1
 
 namespace unitree
 {
 namespace robot
 {
+
 template<typename T>
-inline bool Serialize(const T& instance, std::string& serialziedData)
+inline bool Serialize(const T& instance, std::string& serialziedData,
+    int32_t format = UT_SERIALIZE_FORMAT_JSON)
 {
     try
     {
-        serialziedData = common::ToJsonString(instance);
+        if (format == UT_SERIALIZE_FORMAT_CBOR)
+        {
+            common::ToCborString(instance, serialziedData);
+        }
+        else
+        {
+            common::StreamToJsonString(instance, serialziedData);
+        }
     }
     catch(const common::Exception& e)
     {
@@ -23,11 +39,19 @@ inline bool Serialize(const T& instance, std::string& serialziedData)
 }
 
 template<typename T>
-inline bool Deserialize(const std::string& serialziedData, T& instance)
+inline bool Deserialize(const std::string& serialziedData, T& instance,
+    int32_t format = UT_SERIALIZE_FORMAT_JSON)
 {
     try
     {
-        instance = common::FromJsonString<T>(serialziedData);
+        if (format == UT_SERIALIZE_FORMAT_CBOR)
+        {
+            common::FromCborString(serialziedData, instance);
+        }
+        else
+        {
+            common::StreamFromJsonString(serialziedData, instance);
+        }
     }
     catch(const common::Exception& e)
     {
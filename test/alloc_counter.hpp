@@ -0,0 +1,161 @@
+#ifndef __UT_TEST_ALLOC_COUNTER_HPP__
+#define __UT_TEST_ALLOC_COUNTER_HPP__
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+/*
+ * replaces the global operator new/delete of the executable, so include it
+ * from one translation unit only. allocations are counted per process and
+ * per thread, and separately when at least AllocCounter::SetLargeSize
+ * bytes.
+ */
+namespace unitree
+{
+namespace test
+{
+class AllocCounter
+{
+public:
+    static void Count(size_t size)
+    {
+        mCount.fetch_add(1, std::memory_order_relaxed);
+        mThreadCount++;
+
+        if (size >= mLargeSize.load(std::memory_order_relaxed))
+        {
+            mLargeCount.fetch_add(1, std::memory_order_relaxed);
+            mThreadLargeCount++;
+        }
+    }
+
+    static void SetLargeSize(size_t size)
+    {
+        mLargeSize.store(size, std::memory_order_relaxed);
+    }
+
+    static uint64_t GetCount()
+    {
+        return mCount.load(std::memory_order_relaxed);
+    }
+
+    static uint64_t GetLargeCount()
+    {
+        return mLargeCount.load(std::memory_order_relaxed);
+    }
+
+    static uint64_t GetThreadCount()
+    {
+        return mThreadCount;
+    }
+
+    static uint64_t GetThreadLargeCount()
+    {
+        return mThreadLargeCount;
+    }
+
+private:
+    static inline std::atomic<uint64_t> mCount{0};
+    static inline std::atomic<uint64_t> mLargeCount{0};
+    static inline std::atomic<size_t> mLargeSize{SIZE_MAX};
+    static inline thread_local uint64_t mThreadCount = 0;
+    static inline thread_local uint64_t mThreadLargeCount = 0;
+};
+
+}
+}
+
+void* operator new(size_t size)
+{
+    unitree::test::AllocCounter::Count(size);
+
+    void* p = malloc(size == 0 ? 1 : size);
+    if (p == NULL)
+    {
+        throw std::bad_alloc();
+    }
+
+    return p;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, std::align_val_t align)
+{
+    unitree::test::AllocCounter::Count(size);
+
+    size_t a = (size_t)align;
+    void* p = aligned_alloc(a, (size + a - 1) / a * a);
+    if (p == NULL)
+    {
+        throw std::bad_alloc();
+    }
+
+    return p;
+}
+
+void* operator new[](size_t size, std::align_val_t align)
+{
+    return operator new(size, align);
+}
+
+/*
+ * these are the replacements of the operator new above, so free is the
+ * matching release. gcc only sees the malloc and the free once both are
+ * inlined into a new/delete pair, and warns about that pair.
+ */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept
+{
+    free(p);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif//__UT_TEST_ALLOC_COUNTER_HPP__
@@ -0,0 +1,117 @@
+#include <unitree/common/json/json.hpp>
+
+#include "test_util.hpp"
+
+/*
+ * cost of constructing, copying and moving common::Any, and of the
+ * AnyCast, AnyNumberCast and number type checks the json layer calls for
+ * every value.
+ */
+#define BENCH_CALL_NUM  2000000
+
+using namespace unitree::common;
+using unitree::test::DoNotOptimize;
+using unitree::test::MeasureNs;
+using unitree::test::PrintNs;
+
+int main()
+{
+    const std::string text(64, 'x');
+    const Any anyInt(int32_t(42));
+    const Any anyDouble(3.5);
+    const Any anyUint16(uint16_t(7));
+    const Any anyString(text);
+
+    JsonMap map;
+    for (int32_t i=0; i<8; i++)
+    {
+        map["key_" + std::to_string(i)] = Any(i);
+    }
+    const Any anyMap(map);
+
+    PrintNs("construct int", MeasureNs(BENCH_CALL_NUM, [&](uint64_t i)
+    {
+        Any a((int32_t)i);
+        DoNotOptimize(a);
+    }));
+    PrintNs("construct string (copy)", MeasureNs(BENCH_CALL_NUM, [&](uint64_t)
+    {
+        Any a(text);
+        DoNotOptimize(a);
+    }));
+    PrintNs("construct string (move)", MeasureNs(BENCH_CALL_NUM, [&](uint64_t)
+    {
+        std::string s(text);
+        Any a(std::move(s));
+        DoNotOptimize(a);
+    }));
+    PrintNs("  string alone", MeasureNs(BENCH_CALL_NUM, [&](uint64_t)
+    {
+        std::string s(text);
+        DoNotOptimize(s);
+    }));
+
+    PrintNs("copy int", MeasureNs(BENCH_CALL_NUM, [&](uint64_t)
+    {
+        Any a(anyInt);
+        DoNotOptimize(a);
+    }));
+    PrintNs("copy string", MeasureNs(BENCH_CALL_NUM, [&](uint64_t)
+    {
+        Any a(anyString);
+        DoNotOptimize(a);
+    }));
+    PrintNs("copy map of 8", MeasureNs(BENCH_CALL_NUM / 10, [&](uint64_t)
+    {
+        Any a(anyMap);
+        DoNotOptimize(a);
+    }));
+
+    Any moving(text);
+    PrintNs("move string", MeasureNs(BENCH_CALL_NUM, [&](uint64_t)
+    {
+        Any a(std::move(moving));
+        moving = std::move(a);
+        DoNotOptimize(moving);
+    }));
+    PrintNs("vector<Any> grow to 64 strings", MeasureNs(BENCH_CALL_NUM / 100, [&](uint64_t)
+    {
+        JsonArray array;
+        for (int32_t i=0; i<64; i++)
+        {
+            array.push_back(anyString);
+        }
+        DoNotOptimize(array);
+    }));
+
+    PrintNs("AnyCast<int32_t>", MeasureNs(BENCH_CALL_NUM, [&](uint64_t)
+    {
+        DoNotOptimize(AnyCast<int32_t>(anyInt));
+    }));
+    PrintNs("AnyCast<std::string>", MeasureNs(BENCH_CALL_NUM, [&](uint64_t)
+    {
+        DoNotOptimize(AnyCast<std::string>(anyString));
+    }));
+    PrintNs("AnyNumberCast<int32_t>(int32_t)", MeasureNs(BENCH_CALL_NUM, [&](uint64_t)
+    {
+        DoNotOptimize(AnyNumberCast<int32_t>(anyInt));
+    }));
+    PrintNs("AnyNumberCast<int32_t>(double)", MeasureNs(BENCH_CALL_NUM, [&](uint64_t)
+    {
+        DoNotOptimize(AnyNumberCast<int32_t>(anyDouble));
+    }));
+    PrintNs("AnyNumberCast<double>(uint16_t)", MeasureNs(BENCH_CALL_NUM, [&](uint64_t)
+    {
+        DoNotOptimize(AnyNumberCast<double>(anyUint16));
+    }));
+    PrintNs("IsNumber(string)", MeasureNs(BENCH_CALL_NUM, [&](uint64_t)
+    {
+        DoNotOptimize(IsNumber(anyString));
+    }));
+    PrintNs("IsInteger(uint16_t)", MeasureNs(BENCH_CALL_NUM, [&](uint64_t)
+    {
+        DoNotOptimize(IsInteger(anyUint16));
+    }));
+
+    return 0;
+}
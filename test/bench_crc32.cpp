@@ -0,0 +1,107 @@
+#include <unitree/common/crc32.hpp>
+#include <unitree/idl/go2/LowCmd_.hpp>
+#include <unitree/idl/hg/LowCmd_.hpp>
+#include <vector>
+
+#include "test_util.hpp"
+
+/*
+ * throughput of the Crc32Word back ends against the bitwise crc32_core of
+ * the low level examples, on the go and hg LowCmd_ sizes and on larger
+ * buffers.
+ */
+#define BENCH_BYTE_NUM  (64 * 1024 * 1024)
+
+using namespace unitree::common;
+using unitree::test::DoNotOptimize;
+using unitree::test::MeasureNs;
+
+static uint32_t Crc32Core(const uint32_t* ptr, uint32_t len)
+{
+    uint32_t crc = UT_CRC32_INIT;
+    for (uint32_t i=0; i<len; i++)
+    {
+        uint32_t xbit = 1u << 31;
+        uint32_t data = ptr[i];
+        for (uint32_t bits=0; bits<32; bits++)
+        {
+            if (crc & 0x80000000)
+            {
+                crc <<= 1;
+                crc ^= UT_CRC32_POLY;
+            }
+            else
+            {
+                crc <<= 1;
+            }
+
+            if (data & xbit)
+            {
+                crc ^= UT_CRC32_POLY;
+            }
+            xbit >>= 1;
+        }
+    }
+
+    return crc;
+}
+
+static void Run(const char* name, Crc32WordFunc func, const std::vector<uint32_t>& buffer, uint32_t len)
+{
+    /*
+     * about the same number of bytes for every size, less for the bitwise
+     * loop.
+     */
+    uint64_t count = BENCH_BYTE_NUM / ((uint64_t)len * 4);
+    if (func == NULL)
+    {
+        count = count / 32 + 1;
+    }
+
+    uint32_t crc = 0;
+    double ns = MeasureNs(count, [&](uint64_t)
+    {
+        crc ^= func ? func(buffer.data(), len, UT_CRC32_INIT) : Crc32Core(buffer.data(), len);
+        DoNotOptimize(crc);
+    });
+
+    printf("  %-10s %10.1f ns %10.1f MB/s\n", name, ns, len * 4 * 1e3 / ns);
+}
+
+int main()
+{
+    std::vector<uint32_t> buffer(64 * 1024);
+    for (size_t i=0; i<buffer.size(); i++)
+    {
+        buffer[i] = (uint32_t)(i * 2654435761u);
+    }
+
+    const uint32_t lengths[] =
+    {
+        (sizeof(unitree_go::msg::dds_::LowCmd_) >> 2) - 1,
+        (sizeof(unitree_hg::msg::dds_::LowCmd_) >> 2) - 1,
+        1024,
+        64 * 1024
+    };
+
+    for (uint32_t len : lengths)
+    {
+        printf("%u words\n", len);
+        Run("core", NULL, buffer, len);
+        Run("table", Crc32WordTable, buffer, len);
+#if defined(__x86_64__) || defined(__i386__)
+        if (__builtin_cpu_supports("pclmul"))
+        {
+            Run("pclmul", Crc32WordClmul, buffer, len);
+        }
+#elif defined(__aarch64__)
+        if (getauxval(AT_HWCAP) & HWCAP_CRC32)
+        {
+            Run("arm crc32", Crc32WordArm, buffer, len);
+        }
+#endif
+        Run("dispatch", Crc32Word, buffer, len);
+    }
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include <unitree/robot/serialize/serialize.hpp>
+#include <unitree/robot/go2/public/jsonize_type.hpp>
+#include <unitree/robot/b2/robot_state/robot_state_api.hpp>
+#include <unitree/robot/g1/audio/g1_audio_api.hpp>
+
+#include "test_util.hpp"
+
+/*
+ * encoded size and encode/decode time of rpc parameter structs through
+ * robot::Serialize/Deserialize, json against cbor. the round trip is
+ * checked by test_json_cbor.
+ */
+#define BENCH_CALL_NUM  20000
+
+using namespace unitree::common;
+using namespace unitree::robot;
+using unitree::test::DoNotOptimize;
+using unitree::test::MeasureNs;
+
+static std::vector<go2::JsonizePathPoint> MakePath()
+{
+    std::vector<go2::JsonizePathPoint> path(30);
+    for (size_t i=0; i<path.size(); i++)
+    {
+        path[i].timeFromStart = 0.1f * i;
+        path[i].x = 0.05f * i;
+        path[i].y = -0.01f * i;
+        path[i].yaw = 0.002f * i;
+        path[i].vx = 0.5f;
+        path[i].vy = 0.0f;
+        path[i].vyaw = 0.02f;
+    }
+
+    return path;
+}
+
+static std::vector<b2::ServiceStateData> MakeServiceState()
+{
+    std::vector<b2::ServiceStateData> states(20);
+    for (size_t i=0; i<states.size(); i++)
+    {
+        states[i].name = "service_" + std::to_string(i);
+        states[i].status = (int32_t)(i % 2);
+        states[i].protect = (int32_t)(i % 3 == 0);
+    }
+
+    return states;
+}
+
+static b2::ServiceSwitchParameter MakeSwitch()
+{
+    b2::ServiceSwitchParameter p;
+    p.name = "obstacle_avoidance";
+    p.swit = 1;
+
+    return p;
+}
+
+static g1::TtsMakerParameter MakeTts()
+{
+    g1::TtsMakerParameter tts;
+    tts.index = 7;
+    tts.speaker_id = 1;
+    tts.text = "hello, the battery is at 80 percent and the robot is ready";
+
+    return tts;
+}
+
+template<typename T>
+static void RunFormat(const char* name, const T& value, int32_t format)
+{
+    std::string data;
+    Serialize(value, data, format);
+
+    std::string out;
+    double encode = MeasureNs(BENCH_CALL_NUM, [&](uint64_t)
+    {
+        Serialize(value, out, format);
+        DoNotOptimize(out);
+    });
+    double decode = MeasureNs(BENCH_CALL_NUM, [&](uint64_t)
+    {
+        T t;
+        Deserialize(data, t, format);
+        DoNotOptimize(t);
+    });
+
+    printf("  %-6s %8zu %12.0f %12.0f\n", name, data.size(), encode, decode);
+}
+
+template<typename T>
+static void Run(const char* name, const T& value)
+{
+    printf("%s\n", name);
+    printf("  %-6s %8s %12s %12s\n", "format", "bytes", "encode ns", "decode ns");
+    RunFormat("json", value, UT_SERIALIZE_FORMAT_JSON);
+    RunFormat("cbor", value, UT_SERIALIZE_FORMAT_CBOR);
+}
+
+int main()
+{
+    Run("go2 path, 30 JsonizePathPoint", MakePath());
+    Run("b2 service state, 20 ServiceStateData", MakeServiceState());
+    Run("b2 ServiceSwitchParameter", MakeSwitch());
+    Run("g1 TtsMakerParameter", MakeTts());
+
+    return 0;
+}
@@ -0,0 +1,139 @@
+#include <unitree/robot/serialize/serialize.hpp>
+#include <unitree/common/json/json_value.hpp>
+#include <unitree/robot/go2/public/jsonize_type.hpp>
+#include <unitree/robot/b2/robot_state/robot_state_api.hpp>
+#include <unitree/robot/g1/audio/g1_audio_api.hpp>
+
+#include "test_util.hpp"
+
+/*
+ * parse and serialize throughput of rpc payloads through the Any based
+ * FromJsonString/ToJsonString, the JsonDocument DOM bridged to Any, the
+ * DOM alone without binding to a struct, and the streaming
+ * robot::Serialize/Deserialize the clients use.
+ */
+#define BENCH_CALL_NUM  20000
+
+using namespace unitree::common;
+using namespace unitree::robot;
+using unitree::test::DoNotOptimize;
+using unitree::test::MeasureNs;
+
+static std::vector<go2::JsonizePathPoint> MakePath()
+{
+    std::vector<go2::JsonizePathPoint> path(30);
+    for (size_t i=0; i<path.size(); i++)
+    {
+        path[i].timeFromStart = 0.1f * i;
+        path[i].x = 0.05f * i;
+        path[i].y = -0.01f * i;
+        path[i].yaw = 0.002f * i;
+        path[i].vx = 0.5f;
+        path[i].vy = 0.0f;
+        path[i].vyaw = 0.02f;
+    }
+
+    return path;
+}
+
+static std::vector<b2::ServiceStateData> MakeServiceState()
+{
+    std::vector<b2::ServiceStateData> states(20);
+    for (size_t i=0; i<states.size(); i++)
+    {
+        states[i].name = "service_" + std::to_string(i);
+        states[i].status = (int32_t)(i % 2);
+        states[i].protect = (int32_t)(i % 3 == 0);
+    }
+
+    return states;
+}
+
+static g1::TtsMakerParameter MakeTts()
+{
+    g1::TtsMakerParameter tts;
+    tts.index = 7;
+    tts.speaker_id = 1;
+    tts.text = "hello, the battery is at 80 percent and the robot is ready";
+
+    return tts;
+}
+
+template<typename T>
+static void Run(const char* name, const T& value)
+{
+    std::string json;
+    Serialize(value, json);
+
+    std::string out;
+    JsonDocument doc;
+    Any a;
+
+    printf("%s, %zu bytes\n", name, json.size());
+    printf("  %-28s %10s %10s\n", "path", "parse ns", "write ns");
+
+    double parse = MeasureNs(BENCH_CALL_NUM, [&](uint64_t)
+    {
+        T t;
+        FromJsonString(json, t);
+        DoNotOptimize(t);
+    });
+    double write = MeasureNs(BENCH_CALL_NUM, [&](uint64_t)
+    {
+        out = ToJsonString(value);
+        DoNotOptimize(out);
+    });
+    printf("  %-28s %10.0f %10.0f\n", "Any FromJsonString", parse, write);
+
+    parse = MeasureNs(BENCH_CALL_NUM, [&](uint64_t)
+    {
+        T t;
+        doc.Parse(json);
+        doc.ToAny(a);
+        FromJson(a, t);
+        DoNotOptimize(t);
+    });
+    write = MeasureNs(BENCH_CALL_NUM, [&](uint64_t)
+    {
+        Any v;
+        ToJson(value, v);
+        doc.FromAny(v);
+        doc.Write(out);
+        DoNotOptimize(out);
+    });
+    printf("  %-28s %10.0f %10.0f\n", "JsonDocument + Any", parse, write);
+
+    parse = MeasureNs(BENCH_CALL_NUM, [&](uint64_t)
+    {
+        doc.Parse(json);
+        DoNotOptimize(doc.GetRoot());
+    });
+    write = MeasureNs(BENCH_CALL_NUM, [&](uint64_t)
+    {
+        doc.Write(out);
+        DoNotOptimize(out);
+    });
+    printf("  %-28s %10.0f %10.0f\n", "JsonDocument only", parse, write);
+
+    parse = MeasureNs(BENCH_CALL_NUM, [&](uint64_t)
+    {
+        T t;
+        Deserialize(json, t);
+        DoNotOptimize(t);
+    });
+    write = MeasureNs(BENCH_CALL_NUM, [&](uint64_t)
+    {
+        Serialize(value, out);
+        DoNotOptimize(out);
+    });
+    printf("  %-28s %10.0f %10.0f\n", "stream Serialize", parse, write);
+}
+
+int main()
+{
+    Run("go2 path, 30 JsonizePathPoint", MakePath());
+    Run("b2 service state, 20 ServiceStateData", MakeServiceState());
+    Run("g1 TtsMakerParameter", MakeTts());
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+#include <unitree/common/latest_value.hpp>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+#include "alloc_counter.hpp"
+#include "test_util.hpp"
+
+/*
+ * one way handoff latency of a low level sized state from a writer to a
+ * reader thread. the writer stamps the time and waits for the reader to
+ * see it before the next Set, so each sample is one handoff. DataBuffer is
+ * the shared_mutex + make_shared buffer the examples used before.
+ */
+#define BENCH_HANDOFF_NUM   100000
+#define BENCH_JOINT_NUM     35
+
+using namespace unitree::common;
+using unitree::test::AllocCounter;
+
+class State
+{
+public:
+    uint64_t mSeq;
+    int64_t mStamp;
+    float mQ[BENCH_JOINT_NUM];
+    float mDq[BENCH_JOINT_NUM];
+    float mTau[BENCH_JOINT_NUM];
+};
+
+template<typename T>
+class DataBuffer
+{
+public:
+    void Set(const T& value)
+    {
+        std::unique_lock<std::shared_mutex> lock(mMutex);
+        mData = std::make_shared<T>(value);
+    }
+
+    bool Get(T& value)
+    {
+        std::shared_ptr<const T> data;
+        {
+            std::shared_lock<std::shared_mutex> lock(mMutex);
+            data = mData;
+        }
+
+        if (!data)
+        {
+            return false;
+        }
+
+        value = *data;
+        return true;
+    }
+
+private:
+    std::shared_ptr<T> mData;
+    std::shared_mutex mMutex;
+};
+
+static int64_t NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+template<typename V>
+static void Run(const char* name, uint64_t count)
+{
+    V value;
+    std::atomic<uint64_t> seen(0);
+    std::vector<int64_t> latency(count);
+    uint64_t writerAlloc = 0, readerAlloc = 0;
+
+    std::thread reader([&]()
+    {
+        uint64_t alloc = AllocCounter::GetThreadCount();
+        State s;
+        s.mSeq = 0;
+
+        for (uint64_t seq=1; seq<=count; seq++)
+        {
+            while (!value.Get(s) || s.mSeq != seq)
+            {}
+
+            latency[seq - 1] = NowNs() - s.mStamp;
+            seen.store(seq, std::memory_order_release);
+        }
+
+        readerAlloc = AllocCounter::GetThreadCount() - alloc;
+    });
+
+    uint64_t alloc = AllocCounter::GetThreadCount();
+    State s = {};
+    for (uint64_t seq=1; seq<=count; seq++)
+    {
+        s.mSeq = seq;
+        s.mStamp = NowNs();
+        value.Set(s);
+
+        while (seen.load(std::memory_order_acquire) != seq)
+        {}
+    }
+    writerAlloc = AllocCounter::GetThreadCount() - alloc;
+
+    reader.join();
+
+    std::sort(latency.begin(), latency.end());
+    double sum = 0;
+    for (int64_t ns : latency)
+    {
+        sum += ns;
+    }
+
+    printf("%-20s %10.1f %10ld %10ld %10.2f %10.2f\n", name, sum / count,
+        (long)latency[count / 2], (long)latency[count * 99 / 100],
+        (double)writerAlloc / count, (double)readerAlloc / count);
+}
+
+int main()
+{
+    /*
+     * on a single cpu every handoff waits for a scheduler tick, the
+     * latency is meaningless there and only the allocations count.
+     */
+    uint64_t count = BENCH_HANDOFF_NUM;
+    if (std::thread::hardware_concurrency() < 2)
+    {
+        count = 100;
+        printf("single cpu, latency is the scheduler tick\n");
+    }
+
+    printf("%lu handoffs of %zu bytes, ns\n", (unsigned long)count, sizeof(State));
+    printf("%-20s %10s %10s %10s %10s %10s\n", "buffer", "mean", "p50", "p99", "alloc/set", "alloc/get");
+
+    Run<LatestValue<State>>("LatestValue", count);
+    Run<SeqLockLatestValue<State>>("SeqLockLatestValue", count);
+    Run<DataBuffer<State>>("DataBuffer", count);
+
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include <unitree/common/log/log_binary.hpp>
+#include <algorithm>
+
+#include "test_util.hpp"
+
+/*
+ * caller side cost of a BLOG call with an int, a double and a short string,
+ * in batches that fit the ring. the rings are flushed between batches,
+ * outside the timed part, so no record is dropped. a disabled call is
+ * measured for reference.
+ */
+#define BENCH_BATCH_SIZE    2000
+#define BENCH_BATCH_NUM     500
+
+using namespace unitree::common;
+using unitree::test::MeasureNs;
+using unitree::test::PrintNs;
+
+int main()
+{
+    LogBinaryStorePtr storePtr(new LogBinaryStore(LogStorePtr(), "", 100 * UT_NUMER_MILLI));
+    LogBinaryLoggerPtr loggerPtr(new LogBinaryLogger(UT_LOG_INFO, storePtr));
+    std::string topic("rt/lowstate");
+
+    /*
+     * the first call of the thread creates its ring.
+     */
+    BLOG_INFO(loggerPtr, "warmup");
+    storePtr->Flush();
+
+    std::vector<double> batches;
+    for (int32_t b=0; b<BENCH_BATCH_NUM; b++)
+    {
+        batches.push_back(MeasureNs(BENCH_BATCH_SIZE, [&](uint64_t i)
+        {
+            BLOG_INFO(loggerPtr, "topic:{} seq:{} dt:{}", topic, i, 0.002);
+        }));
+
+        storePtr->Flush();
+    }
+
+    std::sort(batches.begin(), batches.end());
+
+    double sum = 0;
+    for (double ns : batches)
+    {
+        sum += ns;
+    }
+
+    printf("%d calls per batch, %d batches, dropped:%lu\n", BENCH_BATCH_SIZE, BENCH_BATCH_NUM,
+        (unsigned long)storePtr->GetDropped());
+    PrintNs("BLOG_INFO mean", sum / batches.size());
+    PrintNs("BLOG_INFO batch p50", batches[batches.size() / 2]);
+    PrintNs("BLOG_INFO batch p99", batches[batches.size() * 99 / 100]);
+
+    PrintNs("BLOG_DEBUG disabled", MeasureNs(BENCH_BATCH_SIZE * BENCH_BATCH_NUM, [&](uint64_t i)
+    {
+        BLOG_DEBUG(loggerPtr, "topic:{} seq:{} dt:{}", topic, i, 0.002);
+    }));
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <unitree/common/log/log.hpp>
+
+#include "test_util.hpp"
+
+/*
+ * cost of log calls filtered out by the logger level, next to a bare
+ * branch on a runtime flag. the argument is an expensive call, counted to
+ * show it is never evaluated.
+ */
+#define BENCH_CALL_NUM  100000000
+
+using namespace unitree::common;
+using unitree::test::MeasureNs;
+using unitree::test::PrintNs;
+
+class NullStore : public LogStore
+{
+public:
+    void Append(const std::string&)
+    {}
+};
+
+static uint64_t gEvaluated = 0;
+
+static __attribute__((noinline)) std::string Expensive(uint64_t i)
+{
+    gEvaluated++;
+    return std::to_string(i);
+}
+
+int main()
+{
+    /*
+     * read through volatile every call, so the level check is not hoisted
+     * out of the loop.
+     */
+    Logger* volatile loggerHolder = new Logger(UT_LOG_INFO, LogStorePtr(new NullStore()));
+    volatile bool flag = false;
+
+    PrintNs("branch on a runtime flag", MeasureNs(BENCH_CALL_NUM, [&](uint64_t i)
+    {
+        if (flag)
+        {
+            unitree::test::DoNotOptimize(Expensive(i));
+        }
+    }));
+
+    PrintNs("LOG_DEBUG disabled", MeasureNs(BENCH_CALL_NUM, [&](uint64_t i)
+    {
+        Logger* logger = loggerHolder;
+        LOG_DEBUG(logger, "seq:", i, " value:", Expensive(i));
+    }));
+
+    PrintNs("FMT_DEBUG disabled", MeasureNs(BENCH_CALL_NUM, [&](uint64_t i)
+    {
+        Logger* logger = loggerHolder;
+        FMT_DEBUG(logger, ("seq", i)("value", Expensive(i)));
+    }));
+
+    PrintNs("UT_LOG_IS_ENABLED disabled", MeasureNs(BENCH_CALL_NUM, [&](uint64_t i)
+    {
+        Logger* logger = loggerHolder;
+        if (UT_LOG_IS_ENABLED(logger, UT_LOG_DEBUG))
+        {
+            unitree::test::DoNotOptimize(Expensive(i));
+        }
+    }));
+
+    printf("arguments evaluated: %lu\n", (unsigned long)gEvaluated);
+
+    delete loggerHolder;
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include <unitree/common/thread/thread_pool.hpp>
+#include <unitree/common/thread/work_stealing_thread_pool.hpp>
+
+#include "alloc_counter.hpp"
+#include "test_util.hpp"
+
+/*
+ * short task throughput of ThreadPool and WorkStealingThreadPool, with the
+ * tasks submitted from a thread outside the pool and spawned by tasks
+ * running inside it.
+ */
+#define BENCH_TASK_NUM      200000
+#define BENCH_QUEUE_SIZE    65536
+
+using namespace unitree::common;
+using unitree::test::AllocCounter;
+
+static std::atomic<uint64_t> gDone(0);
+
+/*
+ * tasks return int32_t, ThreadPool tasks must yield an Any.
+ */
+static int32_t ShortTask(uint64_t seed)
+{
+    for (int32_t i=0; i<32; i++)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+    }
+
+    unitree::test::DoNotOptimize(seed);
+    gDone.fetch_add(1, std::memory_order_relaxed);
+
+    return 0;
+}
+
+static std::atomic<uint64_t> gInline(0);
+
+/*
+ * from outside the pool wait for room. a worker can not wait, every worker
+ * may be submitting with the queues full and none left to drain them, so
+ * it runs the task itself.
+ */
+template<typename POOL>
+static int32_t Submit(POOL* pool, uint64_t begin, uint64_t end, bool worker)
+{
+    for (uint64_t i=begin; i<end; i++)
+    {
+        while (!pool->AddTask(&ShortTask, i))
+        {
+            if (worker)
+            {
+                ShortTask(i);
+                gInline.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+
+            UT_CPU_RELAX();
+        }
+    }
+
+    return 0;
+}
+
+static void WaitDone()
+{
+    while (gDone.load(std::memory_order_relaxed) < BENCH_TASK_NUM)
+    {
+        UT_CPU_RELAX();
+    }
+}
+
+class Result
+{
+public:
+    double mExternalNs;
+    double mExternalAlloc;
+    double mSpawnNs;
+    double mSpawnInline;
+};
+
+template<typename POOL>
+static Result Run(uint32_t threadNumber)
+{
+    POOL pool(threadNumber, BENCH_QUEUE_SIZE);
+    Result r;
+
+    gDone = 0;
+    uint64_t alloc = AllocCounter::GetThreadCount();
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    Submit(&pool, 0, BENCH_TASK_NUM, false);
+    r.mExternalAlloc = (double)(AllocCounter::GetThreadCount() - alloc) / BENCH_TASK_NUM;
+    WaitDone();
+    r.mExternalNs = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - begin).count() / BENCH_TASK_NUM;
+
+    /*
+     * one seed task per worker, each seed submits its share from inside.
+     */
+    gDone = 0;
+    gInline = 0;
+    begin = std::chrono::steady_clock::now();
+    uint64_t share = BENCH_TASK_NUM / threadNumber;
+    for (uint32_t i=0; i<threadNumber; i++)
+    {
+        uint64_t end = (i + 1 == threadNumber) ? BENCH_TASK_NUM : (i + 1) * share;
+        while (!pool.AddTask(&Submit<POOL>, &pool, i * share, end, true))
+        {
+            UT_CPU_RELAX();
+        }
+    }
+    WaitDone();
+    r.mSpawnNs = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - begin).count() / BENCH_TASK_NUM;
+    r.mSpawnInline = (double)gInline.load() / BENCH_TASK_NUM;
+
+    pool.Quit(true);
+
+    return r;
+}
+
+int main()
+{
+    std::vector<uint32_t> threadNumbers = { 1, 2, 4, 8 };
+    uint32_t processor = OsHelper::Instance()->GetProcessorNumber();
+    if (std::find(threadNumbers.begin(), threadNumbers.end(), processor) == threadNumbers.end())
+    {
+        threadNumbers.push_back(processor);
+    }
+
+    printf("%d tasks, %u processors, ns per task\n", BENCH_TASK_NUM, processor);
+    printf("threads  pool         external  alloc/task     spawn  spawn inline\n");
+
+    for (uint32_t n : threadNumbers)
+    {
+        Result a = Run<ThreadPool>(n);
+        printf("%7u  ThreadPool   %8.1f  %10.2f  %8.1f  %11.1f%%\n", n, a.mExternalNs, a.mExternalAlloc,
+            a.mSpawnNs, a.mSpawnInline * 100);
+
+        Result b = Run<WorkStealingThreadPool>(n);
+        printf("%7u  WorkStealing %8.1f  %10.2f  %8.1f  %11.1f%%\n", n, b.mExternalNs, b.mExternalAlloc,
+            b.mSpawnNs, b.mSpawnInline * 100);
+    }
+
+    return 0;
+}
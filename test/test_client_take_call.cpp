@@ -0,0 +1,140 @@
+#include <unitree/robot/client/client.hpp>
+#include <unitree/robot/server/server.hpp>
+#include <unitree/robot/channel/channel_factory.hpp>
+
+#include "alloc_counter.hpp"
+#include "test_util.hpp"
+
+/*
+ * counts the allocations of a binary call returning a camera sized blob,
+ * through the copying Call and through TakeCall.
+ */
+#define TEST_SERVICE_NAME   "test_take_call"
+#define TEST_API_VERSION    "1.0.0.0"
+#define TEST_API_ID_BLOB    1001
+#define TEST_BLOB_SIZE      (200 * 1024)
+#define TEST_CALL_NUM       20
+
+using namespace unitree::common;
+using namespace unitree::robot;
+using unitree::test::AllocCounter;
+
+class BlobServer : public Server
+{
+public:
+    BlobServer() : Server(TEST_SERVICE_NAME), mBlob(TEST_BLOB_SIZE, 0x5a)
+    {}
+
+    void Init()
+    {
+        SetApiVersion(TEST_API_VERSION);
+        UT_ROBOT_SERVER_REG_API_BINARY_HANDLER_NO_LEASE(TEST_API_ID_BLOB, &BlobServer::GetBlob);
+    }
+
+    int32_t GetBlob(const std::vector<uint8_t>&, std::vector<uint8_t>& data)
+    {
+        data = mBlob;
+        return 0;
+    }
+
+private:
+    std::vector<uint8_t> mBlob;
+};
+
+class BlobClient : public Client
+{
+public:
+    BlobClient() : Client(TEST_SERVICE_NAME, false)
+    {}
+
+    void Init()
+    {
+        SetApiVersion(TEST_API_VERSION);
+        UT_ROBOT_CLIENT_REG_API_NO_PROI(TEST_API_ID_BLOB);
+    }
+
+    int32_t Get(std::vector<uint8_t>& data)
+    {
+        static const std::vector<uint8_t> parameter;
+        return Call(TEST_API_ID_BLOB, parameter, data);
+    }
+
+    int32_t Take(std::vector<uint8_t>& data)
+    {
+        static const std::vector<uint8_t> parameter;
+        return TakeCall(TEST_API_ID_BLOB, parameter, data);
+    }
+};
+
+class CallCount
+{
+public:
+    double mThread;
+    double mThreadLarge;
+    double mLarge;
+};
+
+template<typename F>
+CallCount CountCalls(F&& call)
+{
+    std::vector<uint8_t> data;
+
+    uint64_t thread = AllocCounter::GetThreadCount();
+    uint64_t threadLarge = AllocCounter::GetThreadLargeCount();
+    uint64_t large = AllocCounter::GetLargeCount();
+
+    for (int32_t i=0; i<TEST_CALL_NUM; i++)
+    {
+        UT_TEST_CHECK(call(data) == 0);
+        UT_TEST_CHECK(data.size() == TEST_BLOB_SIZE);
+    }
+
+    CallCount c;
+    c.mThread = (double)(AllocCounter::GetThreadCount() - thread) / TEST_CALL_NUM;
+    c.mThreadLarge = (double)(AllocCounter::GetThreadLargeCount() - threadLarge) / TEST_CALL_NUM;
+    c.mLarge = (double)(AllocCounter::GetLargeCount() - large) / TEST_CALL_NUM;
+
+    return c;
+}
+
+int main()
+{
+    ChannelFactory::Instance()->Init(0);
+
+    BlobServer server;
+    server.Init();
+    server.Start(false);
+
+    BlobClient client;
+    client.SetTimeout(1.0f);
+    client.Init();
+
+    /*
+     * wait for discovery.
+     */
+    std::vector<uint8_t> data;
+    int32_t ret = -1;
+    for (int32_t i=0; i<10 && ret != 0; i++)
+    {
+        ret = client.Get(data);
+    }
+    UT_TEST_CHECK(ret == 0);
+
+    AllocCounter::SetLargeSize(TEST_BLOB_SIZE);
+
+    CallCount get = CountCalls([&client](std::vector<uint8_t>& d) { return client.Get(d); });
+    CallCount take = CountCalls([&client](std::vector<uint8_t>& d) { return client.Take(d); });
+
+    printf("per call             thread  thread>=blob  process>=blob\n");
+    printf("Call (copy)      %10.1f %13.1f %14.1f\n", get.mThread, get.mThreadLarge, get.mLarge);
+    printf("TakeCall (move)  %10.1f %13.1f %14.1f\n", take.mThread, take.mThreadLarge, take.mLarge);
+
+    /*
+     * the blob is copied once when the sample is taken, which happens on
+     * the dds thread. TakeCall must not copy it again on the caller.
+     */
+    UT_TEST_CHECK(take.mThreadLarge == 0.0);
+    UT_TEST_CHECK(take.mLarge + 1.0 <= get.mLarge);
+
+    return unitree::test::TestResult();
+}
@@ -0,0 +1,200 @@
+#include <unitree/common/crc32.hpp>
+#include <unitree/idl/go2/LowCmd_.hpp>
+#include <unitree/idl/hg/LowCmd_.hpp>
+#include <random>
+#include <vector>
+
+#include "test_util.hpp"
+
+/*
+ * every Crc32Word back end against the bitwise crc32_core of the low level
+ * examples: fixed and random lengths, unaligned starts, crcs continued
+ * over split messages, and the Crc32MulMod update of changed words.
+ */
+#define TEST_RANDOM_NUM     2000
+#define TEST_MAX_WORD_NUM   1100
+
+using namespace unitree::common;
+
+/*
+ * crc32_core of the examples, with the crc of preceding words.
+ */
+static uint32_t Crc32Core(const uint32_t* ptr, uint32_t len, uint32_t crc = UT_CRC32_INIT)
+{
+    for (uint32_t i=0; i<len; i++)
+    {
+        uint32_t xbit = 1u << 31;
+        uint32_t data = ptr[i];
+        for (uint32_t bits=0; bits<32; bits++)
+        {
+            if (crc & 0x80000000)
+            {
+                crc <<= 1;
+                crc ^= UT_CRC32_POLY;
+            }
+            else
+            {
+                crc <<= 1;
+            }
+
+            if (data & xbit)
+            {
+                crc ^= UT_CRC32_POLY;
+            }
+            xbit >>= 1;
+        }
+    }
+
+    return crc;
+}
+
+class Backend
+{
+public:
+    const char* mName;
+    Crc32WordFunc mFunc;
+};
+
+static std::vector<Backend> GetBackends()
+{
+    std::vector<Backend> backends;
+    backends.push_back({"table", Crc32WordTable});
+
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("pclmul"))
+    {
+        backends.push_back({"pclmul", Crc32WordClmul});
+    }
+#elif defined(__aarch64__)
+    if (getauxval(AT_HWCAP) & HWCAP_CRC32)
+    {
+        backends.push_back({"arm crc32", Crc32WordArm});
+    }
+#endif
+
+    backends.push_back({"dispatch", Crc32Word});
+
+    return backends;
+}
+
+int main()
+{
+    std::vector<Backend> backends = GetBackends();
+    for (const Backend& b : backends)
+    {
+        printf("back end: %s\n", b.mName);
+    }
+
+    std::mt19937 rng(20261018);
+    std::vector<uint32_t> buffer(TEST_MAX_WORD_NUM + 8);
+    for (uint32_t& w : buffer)
+    {
+        w = rng();
+    }
+
+    /*
+     * every length around the 16 word pclmul threshold and its 4 block
+     * steps, and the message sizes of go and hg LowCmd_.
+     */
+    std::vector<uint32_t> lengths;
+    for (uint32_t len=0; len<=80; len++)
+    {
+        lengths.push_back(len);
+    }
+    lengths.push_back((sizeof(unitree_go::msg::dds_::LowCmd_) >> 2) - 1);
+    lengths.push_back((sizeof(unitree_hg::msg::dds_::LowCmd_) >> 2) - 1);
+
+    for (uint32_t len : lengths)
+    {
+        uint32_t expect = Crc32Core(buffer.data(), len);
+        for (const Backend& b : backends)
+        {
+            uint32_t crc = b.mFunc(buffer.data(), len, UT_CRC32_INIT);
+            if (crc != expect)
+            {
+                printf("%s len:%u crc:%08x expect:%08x\n", b.mName, len, crc, expect);
+            }
+            UT_TEST_CHECK(crc == expect);
+        }
+    }
+
+    int32_t mismatch = 0;
+    std::uniform_int_distribution<uint32_t> lengthDist(0, TEST_MAX_WORD_NUM);
+    std::uniform_int_distribution<uint32_t> offsetDist(0, 7);
+
+    for (int32_t n=0; n<TEST_RANDOM_NUM; n++)
+    {
+        /*
+         * word offsets leave the start off 16 byte alignment.
+         */
+        uint32_t len = lengthDist(rng);
+        const uint32_t* ptr = buffer.data() + offsetDist(rng);
+        uint32_t init = (n % 2) ? rng() : UT_CRC32_INIT;
+
+        uint32_t expect = Crc32Core(ptr, len, init);
+        uint32_t split = len ? rng() % (len + 1) : 0;
+
+        for (const Backend& b : backends)
+        {
+            if (b.mFunc(ptr, len, init) != expect)
+            {
+                mismatch++;
+            }
+
+            /*
+             * the crc of the head carried into the tail.
+             */
+            if (b.mFunc(ptr + split, len - split, b.mFunc(ptr, split, init)) != expect)
+            {
+                mismatch++;
+            }
+
+            /*
+             * head and tail through different back ends.
+             */
+            if (b.mFunc(ptr + split, len - split, Crc32WordTable(ptr, split, init)) != expect)
+            {
+                mismatch++;
+            }
+        }
+    }
+    printf("random lengths: %d, mismatches: %d\n", TEST_RANDOM_NUM, mismatch);
+    UT_TEST_CHECK(mismatch == 0);
+
+    /*
+     * changing words of a message changes its crc by the crc of the xor
+     * delta with init 0, times x^(32 * words after the change).
+     */
+    mismatch = 0;
+    std::vector<uint32_t> message(buffer.begin(), buffer.begin() + 256);
+    for (int32_t n=0; n<TEST_RANDOM_NUM; n++)
+    {
+        uint32_t crc = Crc32Core(message.data(), (uint32_t)message.size());
+
+        uint32_t begin = rng() % 250;
+        uint32_t count = 1 + rng() % 6;
+        uint32_t delta[6];
+        for (uint32_t i=0; i<count; i++)
+        {
+            delta[i] = rng();
+            message[begin + i] ^= delta[i];
+        }
+
+        uint32_t shift = 1;
+        for (uint32_t i=begin+count; i<message.size(); i++)
+        {
+            shift = Crc32MulMod(shift, UT_CRC32_POLY);
+        }
+
+        crc ^= Crc32MulMod(Crc32Core(delta, count, 0), shift);
+        if (crc != Crc32Core(message.data(), (uint32_t)message.size()))
+        {
+            mismatch++;
+        }
+    }
+    printf("word updates: %d, mismatches: %d\n", TEST_RANDOM_NUM, mismatch);
+    UT_TEST_CHECK(mismatch == 0);
+
+    return unitree::test::TestResult();
+}
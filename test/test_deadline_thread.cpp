@@ -0,0 +1,169 @@
+#include <unitree/common/thread/deadline_thread.hpp>
+
+#include "test_util.hpp"
+
+/*
+ * one run overruns by a known number of periods, the skip, catch-up and
+ * bounded catch-up policies must miss and drop exactly the periods they
+ * document. the overrun lands mid period, so wake up latency below half a
+ * period does not change the counts.
+ */
+#define TEST_PERIOD_US      10000
+#define TEST_OVERRUN_CALL   5
+#define TEST_CALL_NUM       12
+
+using namespace unitree::common;
+
+class Step
+{
+public:
+    explicit Step(uint64_t overrunUs) :
+        mCalls(0), mOverrunUs(overrunUs)
+    {}
+
+    void Run()
+    {
+        if (++mCalls == TEST_OVERRUN_CALL)
+        {
+            usleep(mOverrunUs);
+        }
+    }
+
+    std::atomic<uint32_t> mCalls;
+    uint64_t mOverrunUs;
+};
+
+static DeadlineStatistics RunPolicy(const DeadlinePolicy& policy, uint64_t overrunUs)
+{
+    Step step(overrunUs);
+    DeadlineThreadPtr thread = CreateDeadlineThreadEx("test_deadline", UT_CPU_ID_NONE, TEST_PERIOD_US,
+        policy, &Step::Run, &step);
+
+    while (step.mCalls < TEST_CALL_NUM)
+    {
+        usleep(1000);
+    }
+    thread->Wait();
+
+    DeadlineStatistics stat;
+    thread->GetStatistics(stat);
+    UT_TEST_CHECK(stat.mPeriods == step.mCalls);
+
+    return stat;
+}
+
+static uint64_t BucketSum(const DeadlineHistogram& hist)
+{
+    uint64_t sum = 0;
+    for (int32_t i=0; i<UT_DEADLINE_HISTOGRAM_BUCKETS; i++)
+    {
+        sum += hist.mBuckets[i];
+    }
+
+    return sum;
+}
+
+static void TestHistogram()
+{
+    UT_TEST_CHECK(DeadlineHistogram::GetBucket(0) == 0);
+    UT_TEST_CHECK(DeadlineHistogram::GetBucket(999) == 0);
+    UT_TEST_CHECK(DeadlineHistogram::GetBucket(1000) == 1);
+    UT_TEST_CHECK(DeadlineHistogram::GetBucket(1999) == 1);
+    UT_TEST_CHECK(DeadlineHistogram::GetBucket(2000) == 2);
+    UT_TEST_CHECK(DeadlineHistogram::GetBucket(35000000) == 16);
+    UT_TEST_CHECK(DeadlineHistogram::GetBucket(UINT64_MAX) == UT_DEADLINE_HISTOGRAM_BUCKETS - 1);
+
+    UT_TEST_CHECK(DeadlineHistogram::GetBucketBound(0) == 1000);
+    UT_TEST_CHECK(DeadlineHistogram::GetBucketBound(1) == 2000);
+    UT_TEST_CHECK(DeadlineHistogram::GetBucketBound(UT_DEADLINE_HISTOGRAM_BUCKETS - 1) == UINT64_MAX);
+
+    /*
+     * 90 samples under 1us, 9 in [2, 4)us and one of 50us.
+     */
+    DeadlineHistogram hist;
+    hist.mCount = 100;
+    hist.mBuckets[0] = 90;
+    hist.mBuckets[2] = 9;
+    hist.mBuckets[6] = 1;
+    hist.mMax = 50000;
+    hist.mSum = 90 * 500 + 9 * 3000 + 50000;
+
+    UT_TEST_CHECK(hist.GetMean() == hist.mSum / 100);
+    UT_TEST_CHECK(hist.GetPercentile(0.5) == 1000);
+    UT_TEST_CHECK(hist.GetPercentile(0.99) == 4000);
+    UT_TEST_CHECK(hist.GetPercentile(1.0) == 50000);
+    UT_TEST_CHECK(DeadlineHistogram().GetPercentile(0.99) == 0);
+}
+
+int main()
+{
+    TestHistogram();
+
+    /*
+     * skip: 5.5 periods late, the following deadline and the 4 after it
+     * are dropped.
+     */
+    DeadlineStatistics skip = RunPolicy(DeadlinePolicy(UT_DEADLINE_OVERRUN_SKIP),
+        TEST_PERIOD_US * 11 / 2);
+    printf("skip: periods %lu missed %lu skipped %lu\n", (unsigned long)skip.mPeriods,
+        (unsigned long)skip.mMissed, (unsigned long)skip.mSkipped);
+    UT_TEST_CHECK(skip.mMissed == 1);
+    UT_TEST_CHECK(skip.mSkipped == 5);
+
+    /*
+     * the overrun run lands in bucket [32, 64)ms, every run is counted
+     * once.
+     */
+    UT_TEST_CHECK(skip.mExecution.mMax >= (uint64_t)TEST_PERIOD_US * 11 / 2 * UT_NUMER_MILLI);
+    UT_TEST_CHECK(skip.mExecution.mBuckets[DeadlineHistogram::GetBucket(skip.mExecution.mMax)] >= 1);
+    UT_TEST_CHECK(skip.mExecution.mCount == skip.mPeriods);
+    UT_TEST_CHECK(BucketSum(skip.mExecution) == skip.mPeriods);
+    UT_TEST_CHECK(BucketSum(skip.mJitter) == skip.mPeriods);
+
+    /*
+     * unbounded catch-up: 3.5 periods late, the next two runs start late
+     * and also miss, the third is back on time. nothing is skipped.
+     */
+    DeadlineStatistics catchup = RunPolicy(DeadlinePolicy(UT_DEADLINE_OVERRUN_CATCHUP),
+        TEST_PERIOD_US * 7 / 2);
+    printf("catch-up: periods %lu missed %lu skipped %lu\n", (unsigned long)catchup.mPeriods,
+        (unsigned long)catchup.mMissed, (unsigned long)catchup.mSkipped);
+    UT_TEST_CHECK(catchup.mMissed == 3);
+    UT_TEST_CHECK(catchup.mSkipped == 0);
+    UT_TEST_CHECK(catchup.mJitter.mMax >= (uint64_t)TEST_PERIOD_US * 2 * UT_NUMER_MILLI);
+
+    /*
+     * at most one catch-up run, then the 2 periods still behind are
+     * skipped.
+     */
+    DeadlineStatistics bounded = RunPolicy(DeadlinePolicy(UT_DEADLINE_OVERRUN_CATCHUP, 0, 1),
+        TEST_PERIOD_US * 7 / 2);
+    printf("bounded catch-up: periods %lu missed %lu skipped %lu\n", (unsigned long)bounded.mPeriods,
+        (unsigned long)bounded.mMissed, (unsigned long)bounded.mSkipped);
+    UT_TEST_CHECK(bounded.mMissed == 2);
+    UT_TEST_CHECK(bounded.mSkipped == 2);
+
+    /*
+     * the thread clears its statistics at the next period.
+     */
+    Step step(0);
+    DeadlineThreadPtr thread = CreateDeadlineThread(TEST_PERIOD_US, DeadlinePolicy(), &Step::Run, &step);
+    while (step.mCalls < 5)
+    {
+        usleep(1000);
+    }
+    thread->ResetStatistics();
+    uint32_t calls = step.mCalls;
+    while (step.mCalls < calls + 3)
+    {
+        usleep(1000);
+    }
+    thread->Wait();
+
+    DeadlineStatistics reset;
+    thread->GetStatistics(reset);
+    UT_TEST_CHECK(reset.mPeriods > 0 && reset.mPeriods < step.mCalls);
+    UT_TEST_CHECK(reset.mExecution.mCount == reset.mPeriods);
+
+    return unitree::test::TestResult();
+}
@@ -0,0 +1,242 @@
+#include <unitree/robot/low_level/joint_math.hpp>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+#include "test_util.hpp"
+
+/*
+ * every joint_math kernel through each vector ops class the build has,
+ * against JointScalarOps, for all joint counts up to TEST_MAX_JOINT_NUM so
+ * every vector body and tail split is hit. in place calls and the fixed
+ * size overloads are checked too.
+ */
+#define TEST_MAX_JOINT_NUM  70
+#define TEST_ROUND_NUM      20
+
+using namespace unitree::robot;
+
+/*
+ * scalar code may be contracted to fused multiply-add where the target
+ * has it, the vector intrinsics never are. clamp and rate limit do not
+ * multiply and are compared exactly everywhere.
+ */
+#if defined(__FP_FAST_FMAF)
+#define TEST_MUL_TOLERANCE  1e-5f
+#else
+#define TEST_MUL_TOLERANCE  0.0f
+#endif
+
+static bool Same(const float* a, const float* b, size_t n, float tolerance)
+{
+    if (tolerance == 0.0f)
+    {
+        return n == 0 || memcmp(a, b, n * sizeof(float)) == 0;
+    }
+
+    for (size_t i=0; i<n; i++)
+    {
+        if (std::fabs(a[i] - b[i]) > tolerance * std::max(1.0f, std::fabs(b[i])))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+class Input
+{
+public:
+    Input(std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> value(-3.0f, 3.0f);
+        std::uniform_real_distribution<float> positive(0.0f, 50.0f);
+
+        for (size_t i=0; i<TEST_MAX_JOINT_NUM; i++)
+        {
+            mA[i] = value(rng);
+            mB[i] = value(rng);
+            mC[i] = value(rng);
+            mD[i] = value(rng);
+            mLow[i] = -std::fabs(value(rng));
+            mHigh[i] = std::fabs(value(rng));
+            mStep[i] = std::fabs(value(rng)) * 0.1f;
+            mKp[i] = positive(rng);
+            mKd[i] = positive(rng) * 0.1f;
+        }
+
+        for (size_t i=0; i<4 * TEST_MAX_JOINT_NUM; i++)
+        {
+            mCoeff[i] = value(rng);
+        }
+
+        /*
+         * nan commands, clamp and rate limit must treat them the same.
+         */
+        mNan = mA;
+        for (size_t i=0; i<TEST_MAX_JOINT_NUM; i+=7)
+        {
+            mNan[i] = NAN;
+        }
+    }
+
+    std::array<float,TEST_MAX_JOINT_NUM> mA, mB, mC, mD, mLow, mHigh, mStep, mKp, mKd, mNan;
+    std::array<float,4 * TEST_MAX_JOINT_NUM> mCoeff;
+};
+
+template<typename OPS>
+static int32_t Compare(const Input& in, size_t n, float ratio, float u)
+{
+    typedef std::array<float,TEST_MAX_JOINT_NUM> Array;
+
+    int32_t failed = 0;
+    Array v, s;
+
+    auto check = [&failed](const char* name, const Array& v, const Array& s, size_t n, float tolerance)
+    {
+        if (!Same(v.data(), s.data(), n, tolerance))
+        {
+            printf("%s differs, n:%zu\n", name, n);
+            failed++;
+        }
+    };
+
+    JointLerpT<OPS>(v.data(), in.mA.data(), in.mB.data(), ratio, n);
+    JointLerpT<JointScalarOps>(s.data(), in.mA.data(), in.mB.data(), ratio, n);
+    check("lerp", v, s, n, TEST_MUL_TOLERANCE);
+
+    JointClampT<OPS>(v.data(), in.mNan.data(), in.mLow.data(), in.mHigh.data(), n);
+    JointClampT<JointScalarOps>(s.data(), in.mNan.data(), in.mLow.data(), in.mHigh.data(), n);
+    check("clamp", v, s, n, 0.0f);
+
+    JointRateLimitT<OPS>(v.data(), in.mA.data(), in.mNan.data(), in.mStep.data(), n);
+    JointRateLimitT<JointScalarOps>(s.data(), in.mA.data(), in.mNan.data(), in.mStep.data(), n);
+    check("rate limit", v, s, n, 0.0f);
+
+    v = in.mA;
+    s = in.mA;
+    JointLowPassT<OPS>(v.data(), in.mB.data(), ratio, n);
+    JointLowPassT<JointScalarOps>(s.data(), in.mB.data(), ratio, n);
+    check("low pass", v, s, n, TEST_MUL_TOLERANCE);
+
+    JointPdTorqueT<OPS>(v.data(), in.mKp.data(), in.mKd.data(), in.mA.data(), in.mB.data(), in.mC.data(),
+        in.mD.data(), in.mLow.data(), n);
+    JointPdTorqueT<JointScalarOps>(s.data(), in.mKp.data(), in.mKd.data(), in.mA.data(), in.mB.data(),
+        in.mC.data(), in.mD.data(), in.mLow.data(), n);
+    check("pd torque", v, s, n, TEST_MUL_TOLERANCE);
+
+    /*
+     * rows n apart as the trajectory stores them, and a wider stride.
+     */
+    const size_t strides[] = {n, TEST_MAX_JOINT_NUM};
+    for (size_t stride : strides)
+    {
+        JointCubicT<OPS>(v.data(), in.mCoeff.data(), stride, n, u);
+        JointCubicT<JointScalarOps>(s.data(), in.mCoeff.data(), stride, n, u);
+        check("cubic", v, s, n, TEST_MUL_TOLERANCE);
+
+        JointCubicSlopeT<OPS>(v.data(), in.mCoeff.data(), stride, n, u, 30.0f);
+        JointCubicSlopeT<JointScalarOps>(s.data(), in.mCoeff.data(), stride, n, u, 30.0f);
+        check("cubic slope", v, s, n, TEST_MUL_TOLERANCE);
+    }
+
+    /*
+     * out aliasing an input.
+     */
+    v = in.mA;
+    JointLerpT<OPS>(v.data(), v.data(), in.mB.data(), ratio, n);
+    JointLerpT<JointScalarOps>(s.data(), in.mA.data(), in.mB.data(), ratio, n);
+    check("lerp in place", v, s, n, TEST_MUL_TOLERANCE);
+
+    v = in.mNan;
+    JointClampT<OPS>(v.data(), v.data(), in.mLow.data(), in.mHigh.data(), n);
+    JointClampT<JointScalarOps>(s.data(), in.mNan.data(), in.mLow.data(), in.mHigh.data(), n);
+    check("clamp in place", v, s, n, 0.0f);
+
+    return failed;
+}
+
+template<typename OPS>
+static void Run(const char* name, std::mt19937& rng)
+{
+    const float ratios[] = {-0.5f, 0.0f, 0.3f, 1.0f, 1.7f};
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    int32_t failed = 0;
+    for (int32_t round=0; round<TEST_ROUND_NUM; round++)
+    {
+        Input in(rng);
+        for (size_t n=0; n<=TEST_MAX_JOINT_NUM; n++)
+        {
+            failed += Compare<OPS>(in, n, ratios[(round + n) % 5], unit(rng));
+        }
+    }
+
+    printf("%s (width %zu): %d differences\n", name, OPS::WIDTH, failed);
+    UT_TEST_CHECK(failed == 0);
+}
+
+/*
+ * the fixed size overloads, on the g1 joint count.
+ */
+static void RunArray(std::mt19937& rng)
+{
+    const size_t N = 29;
+    std::uniform_real_distribution<float> value(-3.0f, 3.0f);
+
+    std::array<float,N> a, b, c, d, low, high, step, v, s;
+    for (size_t i=0; i<N; i++)
+    {
+        a[i] = value(rng);
+        b[i] = value(rng);
+        c[i] = value(rng);
+        d[i] = value(rng);
+        low[i] = -1.0f;
+        high[i] = 1.0f;
+        step[i] = 0.05f;
+    }
+
+    JointLerp(v, a, b, 0.25f);
+    JointLerpT<JointScalarOps>(s.data(), a.data(), b.data(), 0.25f, N);
+    UT_TEST_CHECK(Same(v.data(), s.data(), N, TEST_MUL_TOLERANCE));
+
+    v = a;
+    JointClamp(v, low, high);
+    JointClampT<JointScalarOps>(s.data(), a.data(), low.data(), high.data(), N);
+    UT_TEST_CHECK(Same(v.data(), s.data(), N, 0.0f));
+
+    JointRateLimit(v, a, b, step);
+    JointRateLimitT<JointScalarOps>(s.data(), a.data(), b.data(), step.data(), N);
+    UT_TEST_CHECK(Same(v.data(), s.data(), N, 0.0f));
+
+    v = a;
+    s = a;
+    JointLowPass(v, b, 0.1f);
+    JointLowPassT<JointScalarOps>(s.data(), b.data(), 0.1f, N);
+    UT_TEST_CHECK(Same(v.data(), s.data(), N, TEST_MUL_TOLERANCE));
+
+    JointPdTorque(v, high, step, a, b, c, d, low);
+    JointPdTorqueT<JointScalarOps>(s.data(), high.data(), step.data(), a.data(), b.data(), c.data(), d.data(),
+        low.data(), N);
+    UT_TEST_CHECK(Same(v.data(), s.data(), N, TEST_MUL_TOLERANCE));
+}
+
+int main()
+{
+    std::mt19937 rng(20261018);
+
+#if defined(__SSE__)
+    Run<JointSseOps>("sse", rng);
+#if defined(__AVX__)
+    Run<JointAvxOps>("avx", rng);
+#endif
+#elif defined(__ARM_NEON)
+    Run<JointNeonOps>("neon", rng);
+#endif
+    Run<JointVectorOps>("vector", rng);
+
+    RunArray(rng);
+
+    return unitree::test::TestResult();
+}
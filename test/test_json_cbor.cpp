@@ -0,0 +1,312 @@
+#include <unitree/robot/serialize/serialize.hpp>
+#include <unitree/robot/go2/public/jsonize_type.hpp>
+#include <unitree/robot/b2/robot_state/robot_state_api.hpp>
+#include <unitree/robot/g1/audio/g1_audio_api.hpp>
+#include <cfloat>
+
+#include "test_util.hpp"
+
+/*
+ * robot::Serialize/Deserialize round trip the rpc parameter structs in
+ * both formats. CborWriter produces the rfc 8949 appendix A encodings,
+ * CborReader decodes half floats, and rejects truncated, malformed and
+ * over-deep input.
+ */
+using namespace unitree::common;
+using namespace unitree::robot;
+
+static std::string Hex(const char* hex)
+{
+    std::string s;
+    for (size_t i=0; hex[i] != 0 && hex[i+1] != 0; i+=2)
+    {
+        s += (char)strtol(std::string(hex + i, 2).c_str(), NULL, 16);
+    }
+
+    return s;
+}
+
+template<typename T>
+static bool Encodes(const T& value, const char* hex)
+{
+    std::string s = ToCborString(value);
+    if (s != Hex(hex))
+    {
+        printf("encoding differs from %s\n", hex);
+        return false;
+    }
+
+    return true;
+}
+
+template<typename T>
+static bool Rejected(const std::string& s)
+{
+    try
+    {
+        T t;
+        FromCborString(s, t);
+    }
+    catch (const JsonException&)
+    {
+        return true;
+    }
+
+    return false;
+}
+
+template<typename T>
+static T Decode(const char* hex)
+{
+    T t;
+    FromCborString(Hex(hex), t);
+    return t;
+}
+
+/*
+ * decode and encode again gives the same bytes, and the decoded value
+ * equals the original.
+ */
+template<typename T>
+static bool RoundTrip(const T& value, int32_t format)
+{
+    std::string data, again;
+    T decoded;
+
+    return Serialize(value, data, format) && Deserialize(data, decoded, format) &&
+        Serialize(decoded, again, format) && again == data && decoded == value;
+}
+
+static void TestRoundTrip()
+{
+    std::vector<go2::JsonizePathPoint> path(30);
+    for (size_t i=0; i<path.size(); i++)
+    {
+        path[i].timeFromStart = 0.1f * i;
+        path[i].x = 0.05f * i;
+        path[i].y = -0.01f * i;
+        path[i].yaw = 0.002f * i;
+        path[i].vx = 0.5f;
+        path[i].vy = 0.0f;
+        path[i].vyaw = 0.02f;
+    }
+
+    std::vector<b2::ServiceStateData> states(20);
+    for (size_t i=0; i<states.size(); i++)
+    {
+        states[i].name = "service_" + std::to_string(i);
+        states[i].status = (int32_t)(i % 2);
+        states[i].protect = (int32_t)(i % 3 == 0);
+    }
+
+    b2::ServiceSwitchParameter sw;
+    sw.name = "obstacle_avoidance";
+    sw.swit = 1;
+
+    g1::TtsMakerParameter tts;
+    tts.index = 7;
+    tts.speaker_id = 65535;
+    tts.text = "hello \xe4\xbd\xa0\xe5\xa5\xbd \"quoted\"";
+
+    go2::JsonizeDataDouble d;
+    d.data = 0.1;
+
+    int32_t formats[] = {UT_SERIALIZE_FORMAT_JSON, UT_SERIALIZE_FORMAT_CBOR};
+    for (size_t i=0; i<2; i++)
+    {
+        UT_TEST_CHECK(RoundTrip(path, formats[i]));
+        UT_TEST_CHECK(RoundTrip(states, formats[i]));
+        UT_TEST_CHECK(RoundTrip(sw, formats[i]));
+        UT_TEST_CHECK(RoundTrip(tts, formats[i]));
+        UT_TEST_CHECK(RoundTrip(d, formats[i]));
+    }
+
+    /*
+     * the Any tree keeps its number types.
+     */
+    Any a;
+    FromCborString(Hex("a5" "616920" "61751bffffffffffffffff" "6164fb3fb999999999999a" "616ef6"
+        "616182f5626263"), a);
+
+    const JsonMap& m = AnyCast<JsonMap>(a);
+    UT_TEST_CHECK(m.at("i").GetTypeInfo() == typeid(int32_t) && AnyCast<int32_t>(m.at("i")) == -1);
+    UT_TEST_CHECK(m.at("u").GetTypeInfo() == typeid(uint64_t) && AnyCast<uint64_t>(m.at("u")) == UINT64_MAX);
+    UT_TEST_CHECK(m.at("d").GetTypeInfo() == typeid(double) && AnyCast<double>(m.at("d")) == 0.1);
+    UT_TEST_CHECK(m.at("n").Empty());
+
+    const JsonArray& arr = AnyCast<JsonArray>(m.at("a"));
+    UT_TEST_CHECK(arr.size() == 2 && AnyCast<bool>(arr[0]) && AnyCast<std::string>(arr[1]) == "bc");
+    UT_TEST_CHECK(Encodes(a, "a5" "616182f5626263" "6164fb3fb999999999999a" "616920" "616ef6"
+        "61751bffffffffffffffff"));
+}
+
+static void TestEncoding()
+{
+    UT_TEST_CHECK(Encodes((uint32_t)0, "00"));
+    UT_TEST_CHECK(Encodes((uint32_t)23, "17"));
+    UT_TEST_CHECK(Encodes((uint32_t)24, "1818"));
+    UT_TEST_CHECK(Encodes((int32_t)1000, "1903e8"));
+    UT_TEST_CHECK(Encodes((uint32_t)1000000, "1a000f4240"));
+    UT_TEST_CHECK(Encodes(UINT64_MAX, "1bffffffffffffffff"));
+    UT_TEST_CHECK(Encodes((int32_t)-1, "20"));
+    UT_TEST_CHECK(Encodes((int32_t)-1000, "3903e7"));
+    UT_TEST_CHECK(Encodes(INT64_MIN, "3b7fffffffffffffff"));
+    UT_TEST_CHECK(Encodes(true, "f5"));
+    UT_TEST_CHECK(Encodes(false, "f4"));
+    UT_TEST_CHECK(Encodes(std::string(""), "60"));
+    UT_TEST_CHECK(Encodes(std::string("\xc3\xbc"), "62c3bc"));
+    UT_TEST_CHECK(Encodes(std::vector<int32_t>(), "80"));
+    UT_TEST_CHECK(Encodes(std::vector<int32_t>{1, 2, 3}, "83010203"));
+    UT_TEST_CHECK(Encodes(std::map<std::string,int32_t>{{"b", 2}, {"a", 1}}, "a2616101616202"));
+
+    /*
+     * doubles a float holds exactly take 4 bytes, the float range is
+     * checked before the conversion.
+     */
+    UT_TEST_CHECK(Encodes(1.5, "fa3fc00000"));
+    UT_TEST_CHECK(Encodes(-4.0f, "fac0800000"));
+    UT_TEST_CHECK(Encodes(0.1, "fb3fb999999999999a"));
+    UT_TEST_CHECK(Encodes((double)FLT_MAX, "fa7f7fffff"));
+    UT_TEST_CHECK(Encodes(1.0e300, "fb7e37e43c8800759c"));
+    UT_TEST_CHECK(Encodes(-1.0e39, "fbc8078287f49c4a1d"));
+    UT_TEST_CHECK(Encodes(DBL_MAX, "fb7fefffffffffffff"));
+    UT_TEST_CHECK(Encodes((double)INFINITY, "fa7f800000"));
+    UT_TEST_CHECK(Encodes(-(double)INFINITY, "faff800000"));
+    UT_TEST_CHECK(Encodes(5e-324, "fb0000000000000001"));
+    UT_TEST_CHECK(Encodes((double)NAN, "fb7ff8000000000000"));
+
+    /*
+     * a reflected class is a map keyed in JsonMap order.
+     */
+    b2::ServiceStateData state;
+    state.name = "a";
+    state.status = 1;
+    state.protect = 0;
+    UT_TEST_CHECK(Encodes(state, "a3" "646e616d656161" "6770726f7465637400" "6673746174757301"));
+}
+
+static void TestHalf()
+{
+    UT_TEST_CHECK(Decode<double>("f90000") == 0.0);
+    UT_TEST_CHECK(std::signbit(Decode<double>("f98000")) && Decode<double>("f98000") == 0.0);
+    UT_TEST_CHECK(Decode<double>("f93c00") == 1.0);
+    UT_TEST_CHECK(Decode<double>("f93e00") == 1.5);
+    UT_TEST_CHECK(Decode<double>("f97bff") == 65504.0);
+    UT_TEST_CHECK(Decode<double>("f90001") == 5.960464477539063e-8);
+    UT_TEST_CHECK(Decode<double>("f90400") == 6.103515625e-5);
+    UT_TEST_CHECK(Decode<double>("f9c400") == -4.0);
+    UT_TEST_CHECK(Decode<double>("f97c00") == INFINITY);
+    UT_TEST_CHECK(Decode<double>("f9fc00") == -INFINITY);
+    UT_TEST_CHECK(std::isnan(Decode<double>("f97e00")));
+
+    UT_TEST_CHECK(Decode<float>("f93555") == 0.333251953125f);
+    UT_TEST_CHECK(Decode<int32_t>("f9c900") == -10);
+
+    /*
+     * tags are skipped, undefined reads as null.
+     */
+    UT_TEST_CHECK(Decode<double>("c1f93c00") == 1.0);
+    UT_TEST_CHECK(Decode<int32_t>("d8201903e8") == 1000);
+
+    int32_t kept = 5;
+    FromCborString(Hex("f7"), kept);
+    UT_TEST_CHECK(kept == 5);
+}
+
+static void TestMalformed()
+{
+    /*
+     * every proper prefix of an encoding is rejected.
+     */
+    g1::TtsMakerParameter tts;
+    tts.index = 100000;
+    tts.speaker_id = 300;
+    tts.text = "truncated text";
+
+    std::string data = ToCborString(tts);
+    size_t accepted = 0;
+    for (size_t len=0; len<data.size(); len++)
+    {
+        if (!Rejected<g1::TtsMakerParameter>(data.substr(0, len)) || !Rejected<Any>(data.substr(0, len)))
+        {
+            accepted++;
+        }
+    }
+    UT_TEST_CHECK(accepted == 0);
+
+    const char* invalid[] =
+    {
+        "9f01ff",                   /* indefinite array */
+        "7f6161ff",                 /* indefinite string */
+        "1c",                       /* reserved length */
+        "a10102",                   /* integer key */
+        "9a7fffffff",               /* count larger than the input */
+        "bb00000001000000000000",   /* map count larger than the input */
+        "7b7fffffffffffffff",       /* string longer than the input */
+        "f820",                     /* unsupported simple value */
+        "e0",                       /* unassigned simple value */
+        "0000",                     /* trailing byte */
+        "c1"                        /* tag without item */
+    };
+
+    for (size_t i=0; i<sizeof(invalid)/sizeof(invalid[0]); i++)
+    {
+        if (!Rejected<Any>(Hex(invalid[i])))
+        {
+            printf("accepted: %s\n", invalid[i]);
+            UT_TEST_CHECK(false);
+        }
+    }
+
+    UT_TEST_CHECK(Rejected<g1::TtsMakerParameter>(Hex("a1")));
+    UT_TEST_CHECK(Rejected<g1::TtsMakerParameter>(Hex("a1010102")));
+    UT_TEST_CHECK(Rejected<g1::TtsMakerParameter>(Hex("a165696e6465786161")));
+    UT_TEST_CHECK(Rejected<g1::TtsMakerParameter>(Hex("a164746578740a")));
+    UT_TEST_CHECK(Rejected<g1::TtsMakerParameter>(Hex("80")));
+    UT_TEST_CHECK(Rejected<std::vector<int32_t>>(Hex("a0")));
+    UT_TEST_CHECK(Rejected<bool>(Hex("01")));
+
+    /*
+     * unknown keys are skipped whatever they hold.
+     */
+    g1::TtsMakerParameter skipped;
+    FromCborString(Hex("a3617882a161796162fb3ff0000000000000" "6474657874626869" "657a7a7a7a7ac1f97c00"), skipped);
+    UT_TEST_CHECK(skipped.text == "hi");
+}
+
+/*
+ * depth arrays, the innermost one empty.
+ */
+static std::string Nested(int32_t depth)
+{
+    return std::string(depth - 1, (char)0x81) + Hex("80");
+}
+
+static void TestDepth()
+{
+    /*
+     * the same container limit as json, for the Any tree and for skipped
+     * values.
+     */
+    Any a;
+    FromCborString(Nested(UT_JSON_MAX_DEPTH), a);
+    UT_TEST_CHECK(Rejected<Any>(Nested(UT_JSON_MAX_DEPTH + 1)));
+
+    std::string member = Hex("a1617a") + Nested(UT_JSON_MAX_DEPTH);
+    g1::TtsMakerParameter tts;
+    FromCborString(member, tts);
+
+    member = Hex("a1617a") + Nested(UT_JSON_MAX_DEPTH + 1);
+    UT_TEST_CHECK(Rejected<g1::TtsMakerParameter>(member));
+}
+
+int main()
+{
+    TestRoundTrip();
+    TestEncoding();
+    TestHalf();
+    TestMalformed();
+    TestDepth();
+
+    return unitree::test::TestResult();
+}
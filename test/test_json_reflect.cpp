@@ -0,0 +1,935 @@
+#include <unitree/common/json/json_reflect.hpp>
+#include <unitree/robot/go2/public/jsonize_type.hpp>
+#include <unitree/robot/go2/robot_state/robot_state_api.hpp>
+#include <unitree/robot/go2/config/config_api.hpp>
+#include <unitree/robot/go2/obstacles_avoid/obstacles_avoid_api.hpp>
+#include <unitree/robot/go2/utrack/utrack_api.hpp>
+#include <unitree/robot/b2/config/config_api.hpp>
+#include <unitree/robot/b2/motion_switcher/motion_switcher_api.hpp>
+#include <unitree/robot/b2/robot_state/robot_state_api.hpp>
+#include <unitree/robot/g1/arm/g1_arm_action_api.hpp>
+#include <unitree/robot/g1/audio/g1_audio_api.hpp>
+#include <unitree/robot/g1/loco/g1_loco_api.hpp>
+#include <unitree/robot/h1/loco/h1_loco_api.hpp>
+#include <unitree/robot/internal/internal_api.hpp>
+
+#include "../example/state_machine/cfg.hpp"
+#include "test_util.hpp"
+
+/*
+ * every class migrated to JN_REFLECT must produce what its hand-written
+ * toJson produced and read what its hand-written fromJson read. the
+ * replaced bodies are kept below as Legacy functions. reflected classes
+ * also skip unknown keys, keep members missing from the input, and
+ * compare field by field.
+ */
+#define TEST_STRING             "s\"\\\n\xc3\xa9"
+
+using namespace unitree::common;
+
+namespace go2 = unitree::robot::go2;
+namespace b2 = unitree::robot::b2;
+namespace g1 = unitree::robot::g1;
+namespace h1 = unitree::robot::h1;
+namespace robot = unitree::robot;
+
+/*
+ * the hand-written members replaced by JN_REFLECT.
+ */
+static void LegacyToJson(const b2::JsonizeConfigMeta& t, JsonMap& json)
+{
+    ToJson(t.name, json["name"]);
+    ToJson(t.lastModified, json["lastModified"]);
+    ToJson(t.size, json["size"]);
+    ToJson(t.epoch, json["epoch"]);
+}
+
+static void LegacyFromJson(JsonMap& json, b2::JsonizeConfigMeta& t)
+{
+    FromJson(json["name"], t.name);
+    FromJson(json["lastModified"], t.lastModified);
+    FromJson(json["size"], t.size);
+    FromJson(json["epoch"], t.epoch);
+}
+
+static void LegacyToJson(const b2::ConfigSetParameter& t, JsonMap& json)
+{
+    ToJson(t.name, json["name"]);
+    ToJson(t.content, json["content"]);
+}
+
+static void LegacyFromJson(JsonMap& json, b2::ConfigSetParameter& t)
+{
+    FromJson(json["name"], t.name);
+    FromJson(json["content"], t.content);
+}
+
+static void LegacyToJson(const b2::ConfigGetParameter& t, JsonMap& json)
+{
+    ToJson(t.name, json["name"]);
+}
+
+static void LegacyFromJson(JsonMap& json, b2::ConfigGetParameter& t)
+{
+    FromJson(json["name"], t.name);
+}
+
+static void LegacyToJson(const b2::ConfigGetData& t, JsonMap& json)
+{
+    ToJson(t.content, json["content"]);
+}
+
+static void LegacyFromJson(JsonMap& json, b2::ConfigGetData& t)
+{
+    FromJson(json["content"], t.content);
+}
+
+static void LegacyToJson(const b2::ConfigDelParameter& t, JsonMap& json)
+{
+    ToJson(t.name, json["name"]);
+}
+
+static void LegacyFromJson(JsonMap& json, b2::ConfigDelParameter& t)
+{
+    FromJson(json["name"], t.name);
+}
+
+static void LegacyToJson(const b2::ConfigMetaParameter& t, JsonMap& json)
+{
+    ToJson(t.name, json["name"]);
+}
+
+static void LegacyFromJson(JsonMap& json, b2::ConfigMetaParameter& t)
+{
+    FromJson(json["name"], t.name);
+}
+
+static void LegacyToJson(const b2::ConfigMetaData& t, JsonMap& json)
+{
+    ToJson(t.meta, json["meta"]);
+}
+
+static void LegacyFromJson(JsonMap& json, b2::ConfigMetaData& t)
+{
+    FromJson(json["meta"], t.meta);
+}
+
+static void LegacyToJson(const b2::JsonizeSilent& t, JsonMap& json)
+{
+    ToJson(t.silent, json["silent"]);
+}
+
+static void LegacyFromJson(JsonMap& json, b2::JsonizeSilent& t)
+{
+    FromJson(json["silent"], t.silent);
+}
+
+static void LegacyToJson(const b2::ServiceSwitchParameter& t, JsonMap& json)
+{
+    ToJson(t.name, json["name"]);
+    ToJson(t.swit, json["switch"]);
+}
+
+static void LegacyFromJson(JsonMap& json, b2::ServiceSwitchParameter& t)
+{
+    FromJson(json["name"], t.name);
+    FromJson(json["switch"], t.swit);
+}
+
+static void LegacyToJson(const b2::ServiceSwitchData& t, JsonMap& json)
+{
+    ToJson(t.name, json["name"]);
+    ToJson(t.status, json["status"]);
+}
+
+static void LegacyFromJson(JsonMap& json, b2::ServiceSwitchData& t)
+{
+    FromJson(json["name"], t.name);
+    FromJson(json["status"], t.status);
+}
+
+static void LegacyToJson(const b2::SetReportFreqParameter& t, JsonMap& json)
+{
+    ToJson(t.interval, json["interval"]);
+    ToJson(t.duration, json["duration"]);
+}
+
+static void LegacyFromJson(JsonMap& json, b2::SetReportFreqParameter& t)
+{
+    FromJson(json["interval"], t.interval);
+    FromJson(json["duration"], t.duration);
+}
+
+static void LegacyToJson(const b2::ServiceStateData& t, JsonMap& json)
+{
+    ToJson(t.name, json["name"]);
+    ToJson(t.status, json["status"]);
+    ToJson(t.protect, json["protect"]);
+}
+
+static void LegacyFromJson(JsonMap& json, b2::ServiceStateData& t)
+{
+    FromJson(json["name"], t.name);
+    FromJson(json["status"], t.status);
+    FromJson(json["protect"], t.protect);
+}
+
+static void LegacyToJson(const b2::LowPowerSwitchParameter& t, JsonMap& json)
+{
+    ToJson(t.swit, json["switch"]);
+}
+
+static void LegacyFromJson(JsonMap& json, b2::LowPowerSwitchParameter& t)
+{
+    FromJson(json["switch"], t.swit);
+}
+
+static void LegacyToJson(const b2::LowPowerStatusData& t, JsonMap& json)
+{
+    ToJson(t.status, json["status"]);
+}
+
+static void LegacyFromJson(JsonMap& json, b2::LowPowerStatusData& t)
+{
+    FromJson(json["status"], t.status);
+}
+
+static void LegacyToJson(const g1::JsonizeArmActionCommand& t, JsonMap& json)
+{
+    ToJson(t.action_id, json["data"]);
+}
+
+static void LegacyFromJson(JsonMap& json, g1::JsonizeArmActionCommand& t)
+{
+    FromJson(json["data"], t.action_id);
+}
+
+static void LegacyToJson(const g1::TtsMakerParameter& t, JsonMap& json)
+{
+    ToJson(t.index, json["index"]);
+    ToJson(t.speaker_id, json["speaker_id"]);
+    ToJson(t.text, json["text"]);
+}
+
+static void LegacyFromJson(JsonMap& json, g1::TtsMakerParameter& t)
+{
+    /*
+     * the replaced fromJson was empty.
+     */
+    (void)json;
+    (void)t;
+}
+
+static void LegacyToJson(const g1::PlayStreamParameter& t, JsonMap& json)
+{
+    ToJson(t.app_name, json["app_name"]);
+    ToJson(t.stream_id, json["stream_id"]);
+}
+
+static void LegacyFromJson(JsonMap& json, g1::PlayStreamParameter& t)
+{
+    /*
+     * the replaced fromJson was empty.
+     */
+    (void)json;
+    (void)t;
+}
+
+static void LegacyToJson(const g1::PlayStopParameter& t, JsonMap& json)
+{
+    ToJson(t.app_name, json["app_name"]);
+}
+
+static void LegacyFromJson(JsonMap& json, g1::PlayStopParameter& t)
+{
+    /*
+     * the replaced fromJson was empty.
+     */
+    (void)json;
+    (void)t;
+}
+
+static void LegacyToJson(const g1::LedControlParameter& t, JsonMap& json)
+{
+    ToJson(t.R, json["R"]);
+    ToJson(t.G, json["G"]);
+    ToJson(t.B, json["B"]);
+}
+
+static void LegacyFromJson(JsonMap& json, g1::LedControlParameter& t)
+{
+    /*
+     * the replaced fromJson was empty.
+     */
+    (void)json;
+    (void)t;
+}
+
+static void LegacyToJson(const g1::JsonizeDataVecFloat& t, JsonMap& json)
+{
+    ToJson(t.data, json["data"]);
+}
+
+static void LegacyFromJson(JsonMap& json, g1::JsonizeDataVecFloat& t)
+{
+    FromJson(json["data"], t.data);
+}
+
+static void LegacyToJson(const g1::JsonizeVelocityCommand& t, JsonMap& json)
+{
+    ToJson(t.velocity, json["velocity"]);
+    ToJson(t.duration, json["duration"]);
+}
+
+static void LegacyFromJson(JsonMap& json, g1::JsonizeVelocityCommand& t)
+{
+    FromJson(json["velocity"], t.velocity);
+    FromJson(json["duration"], t.duration);
+}
+
+static void LegacyToJson(const go2::JsonizeConfigMeta& t, JsonMap& json)
+{
+    ToJson(t.name, json["name"]);
+    ToJson(t.lastModified, json["lastModified"]);
+    ToJson(t.size, json["size"]);
+    ToJson(t.epoch, json["epoch"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::JsonizeConfigMeta& t)
+{
+    FromJson(json["name"], t.name);
+    FromJson(json["lastModified"], t.lastModified);
+    FromJson(json["size"], t.size);
+    FromJson(json["epoch"], t.epoch);
+}
+
+static void LegacyToJson(const go2::ConfigSetParameter& t, JsonMap& json)
+{
+    ToJson(t.name, json["name"]);
+    ToJson(t.content, json["content"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::ConfigSetParameter& t)
+{
+    FromJson(json["name"], t.name);
+    FromJson(json["content"], t.content);
+}
+
+static void LegacyToJson(const go2::ConfigGetParameter& t, JsonMap& json)
+{
+    ToJson(t.name, json["name"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::ConfigGetParameter& t)
+{
+    FromJson(json["name"], t.name);
+}
+
+static void LegacyToJson(const go2::ConfigGetData& t, JsonMap& json)
+{
+    ToJson(t.content, json["content"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::ConfigGetData& t)
+{
+    FromJson(json["content"], t.content);
+}
+
+static void LegacyToJson(const go2::ConfigDelParameter& t, JsonMap& json)
+{
+    ToJson(t.name, json["name"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::ConfigDelParameter& t)
+{
+    FromJson(json["name"], t.name);
+}
+
+static void LegacyToJson(const go2::ConfigMetaParameter& t, JsonMap& json)
+{
+    ToJson(t.name, json["name"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::ConfigMetaParameter& t)
+{
+    FromJson(json["name"], t.name);
+}
+
+static void LegacyToJson(const go2::ConfigMetaData& t, JsonMap& json)
+{
+    ToJson(t.meta, json["meta"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::ConfigMetaData& t)
+{
+    FromJson(json["meta"], t.meta);
+}
+
+static void LegacyToJson(const go2::ObstaclesAvoidSwitchSetParameter& t, JsonMap& json)
+{
+    ToJson(t.mEnable, json["enable"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::ObstaclesAvoidSwitchSetParameter& t)
+{
+    FromJson(json["enable"], t.mEnable);
+}
+
+static void LegacyToJson(const go2::ObstaclesAvoidSwitchGetData& t, JsonMap& json)
+{
+    ToJson(t.mEnable, json["enable"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::ObstaclesAvoidSwitchGetData& t)
+{
+    FromJson(json["enable"], t.mEnable);
+}
+
+static void LegacyToJson(const go2::ObstaclesAvoidMoveParameter& t, JsonMap& json)
+{
+    ToJson(t.mX, json["x"]);
+    ToJson(t.mY, json["y"]);
+    ToJson(t.mYaw, json["yaw"]);
+    ToJson(t.mMode, json["mode"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::ObstaclesAvoidMoveParameter& t)
+{
+    FromJson(json["x"], t.mX);
+    FromJson(json["y"], t.mY);
+    FromJson(json["yaw"], t.mYaw);
+    FromJson(json["mode"], t.mMode);
+}
+
+static void LegacyToJson(const go2::ObstaclesAvoidRemoteCommandSource& t, JsonMap& json)
+{
+    ToJson(t.mIsRemoteCommandsFromApi, json["is_remote_commands_from_api"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::ObstaclesAvoidRemoteCommandSource& t)
+{
+    FromJson(json["is_remote_commands_from_api"], t.mIsRemoteCommandsFromApi);
+}
+
+static void LegacyToJson(const go2::JsonizeFlagBool& t, JsonMap& json)
+{
+    ToJson(t.flag, json["flag"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::JsonizeFlagBool& t)
+{
+    FromJson(json["flag"], t.flag);
+}
+
+static void LegacyToJson(const go2::JsonizeDataBool& t, JsonMap& json)
+{
+    ToJson(t.data, json["data"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::JsonizeDataBool& t)
+{
+    FromJson(json["data"], t.data);
+}
+
+static void LegacyToJson(const go2::JsonizeDataInt& t, JsonMap& json)
+{
+    ToJson(t.data, json["data"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::JsonizeDataInt& t)
+{
+    FromJson(json["data"], t.data);
+}
+
+static void LegacyToJson(const go2::JsonizeDataFloat& t, JsonMap& json)
+{
+    ToJson(t.data, json["data"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::JsonizeDataFloat& t)
+{
+    FromJson(json["data"], t.data);
+}
+
+static void LegacyToJson(const go2::JsonizeDataDouble& t, JsonMap& json)
+{
+    ToJson(t.data, json["data"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::JsonizeDataDouble& t)
+{
+    FromJson(json["data"], t.data);
+}
+
+static void LegacyToJson(const go2::JsonizeDataString& t, JsonMap& json)
+{
+    ToJson(t.data, json["data"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::JsonizeDataString& t)
+{
+    FromJson(json["data"], t.data);
+}
+
+static void LegacyToJson(const go2::JsonizeVec3& t, JsonMap& json)
+{
+    ToJson(t.x, json["x"]);
+    ToJson(t.y, json["y"]);
+    ToJson(t.z, json["z"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::JsonizeVec3& t)
+{
+    FromJson(json["x"], t.x);
+    FromJson(json["y"], t.y);
+    FromJson(json["z"], t.z);
+}
+
+static void LegacyToJson(const go2::JsonizeQuat& t, JsonMap& json)
+{
+    ToJson(t.x, json["x"]);
+    ToJson(t.y, json["y"]);
+    ToJson(t.z, json["z"]);
+    ToJson(t.w, json["w"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::JsonizeQuat& t)
+{
+    FromJson(json["x"], t.x);
+    FromJson(json["y"], t.y);
+    FromJson(json["z"], t.z);
+    FromJson(json["w"], t.w);
+}
+
+static void LegacyToJson(const go2::JsonizePathPoint& t, JsonMap& json)
+{
+    ToJson(t.timeFromStart, json["t_from_start"]);
+    ToJson(t.x, json["x"]);
+    ToJson(t.y, json["y"]);
+    ToJson(t.yaw, json["yaw"]);
+    ToJson(t.vx, json["vx"]);
+    ToJson(t.vy, json["vy"]);
+    ToJson(t.vyaw, json["vyaw"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::JsonizePathPoint& t)
+{
+    FromJson(json["t_from_start"], t.timeFromStart);
+    FromJson(json["x"], t.x);
+    FromJson(json["y"], t.y);
+    FromJson(json["yaw"], t.yaw);
+    FromJson(json["vx"], t.vx);
+    FromJson(json["vy"], t.vy);
+    FromJson(json["vyaw"], t.vyaw);
+}
+
+static void LegacyToJson(const go2::ServiceSwitchParameter& t, JsonMap& json)
+{
+    ToJson(t.name, json["name"]);
+    ToJson(t.swit, json["switch"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::ServiceSwitchParameter& t)
+{
+    FromJson(json["name"], t.name);
+    FromJson(json["switch"], t.swit);
+}
+
+static void LegacyToJson(const go2::ServiceSwitchData& t, JsonMap& json)
+{
+    ToJson(t.name, json["name"]);
+    ToJson(t.status, json["status"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::ServiceSwitchData& t)
+{
+    FromJson(json["name"], t.name);
+    FromJson(json["status"], t.status);
+}
+
+static void LegacyToJson(const go2::SetReportFreqParameter& t, JsonMap& json)
+{
+    ToJson(t.interval, json["interval"]);
+    ToJson(t.duration, json["duration"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::SetReportFreqParameter& t)
+{
+    FromJson(json["interval"], t.interval);
+    FromJson(json["duration"], t.duration);
+}
+
+static void LegacyToJson(const go2::ServiceStateData& t, JsonMap& json)
+{
+    ToJson(t.name, json["name"]);
+    ToJson(t.status, json["status"]);
+    ToJson(t.protect, json["protect"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::ServiceStateData& t)
+{
+    FromJson(json["name"], t.name);
+    FromJson(json["status"], t.status);
+    FromJson(json["protect"], t.protect);
+}
+
+static void LegacyToJson(const go2::UtrackSwitchSetParameter& t, JsonMap& json)
+{
+    ToJson(t.mEnable, json["enable"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::UtrackSwitchSetParameter& t)
+{
+    FromJson(json["enable"], t.mEnable);
+}
+
+static void LegacyToJson(const go2::UtrackSwitchGetData& t, JsonMap& json)
+{
+    ToJson(t.mEnable, json["enable"]);
+}
+
+static void LegacyFromJson(JsonMap& json, go2::UtrackSwitchGetData& t)
+{
+    FromJson(json["enable"], t.mEnable);
+}
+
+static void LegacyToJson(const h1::JsonizeDataVecFloat& t, JsonMap& json)
+{
+    ToJson(t.data, json["data"]);
+}
+
+static void LegacyFromJson(JsonMap& json, h1::JsonizeDataVecFloat& t)
+{
+    FromJson(json["data"], t.data);
+}
+
+static void LegacyToJson(const h1::JsonizeVelocityCommand& t, JsonMap& json)
+{
+    ToJson(t.velocity, json["velocity"]);
+    ToJson(t.duration, json["duration"]);
+}
+
+static void LegacyFromJson(JsonMap& json, h1::JsonizeVelocityCommand& t)
+{
+    FromJson(json["velocity"], t.velocity);
+    FromJson(json["duration"], t.duration);
+}
+
+static void LegacyToJson(const h1::JsonizeTargetPos& t, JsonMap& json)
+{
+    ToJson(t.x, json["x"]);
+    ToJson(t.y, json["y"]);
+    ToJson(t.yaw, json["yaw"]);
+    ToJson(t.relative, json["relative"]);
+}
+
+static void LegacyFromJson(JsonMap& json, h1::JsonizeTargetPos& t)
+{
+    FromJson(json["x"], t.x);
+    FromJson(json["y"], t.y);
+    FromJson(json["yaw"], t.yaw);
+    FromJson(json["relative"], t.relative);
+}
+
+static void LegacyToJson(const robot::ApplyLeaseParameter& t, JsonMap& json)
+{
+    ToJson(t.name, json["name"]);
+}
+
+static void LegacyFromJson(JsonMap& json, robot::ApplyLeaseParameter& t)
+{
+    FromJson(json["name"], t.name);
+}
+
+static void LegacyToJson(const robot::ApplyLeaseData& t, JsonMap& json)
+{
+    ToJson(t.id, json["id"]);
+    ToJson(t.term, json["term"]);
+}
+
+static void LegacyFromJson(JsonMap& json, robot::ApplyLeaseData& t)
+{
+    FromJson(json["id"], t.id);
+    FromJson(json["term"], t.term);
+}
+
+static void LegacyToJson(const ExampleCfg& t, JsonMap& json)
+{
+    ToJson(t.kp, json["kp"]);
+    ToJson(t.kd, json["kd"]);
+    ToJson(t.dt, json["dt"]);
+    ToAny<float>(t.init_pos, json["init_pos"]);
+}
+
+static void LegacyFromJson(JsonMap& json, ExampleCfg& t)
+{
+    FromJson(json["kp"], t.kp);
+    FromJson(json["kd"], t.kd);
+    FromJson(json["dt"], t.dt);
+    FromAny<float>(json["init_pos"], t.init_pos);
+}
+
+/*
+ * give every field a distinct value. floats are multiples of 1/4 so both
+ * writers print them the same.
+ */
+template<typename T>
+static void FillValue(T& value, int32_t& seed)
+{
+    seed++;
+
+    if constexpr (std::is_same<T,bool>::value)
+    {
+        value = (seed % 2 == 1);
+    }
+    else if constexpr (std::is_integral<T>::value)
+    {
+        value = std::is_signed<T>::value ? (T)(-seed) : (T)(100 + seed);
+    }
+    else if constexpr (std::is_floating_point<T>::value)
+    {
+        value = (T)(seed * 0.25 - 1.0);
+    }
+    else if constexpr (std::is_same<T,std::string>::value)
+    {
+        value = TEST_STRING + std::to_string(seed);
+    }
+    else if constexpr (std::is_base_of<Jsonize,T>::value)
+    {
+        ForEachJsonField(value, [&seed](const char*, size_t, auto& field)
+        {
+            FillValue(field, seed);
+        });
+    }
+    else
+    {
+        value.resize(2);
+        FillValue(value[0], seed);
+        FillValue(value[1], seed);
+    }
+}
+
+/*
+ * change a value so it no longer compares equal.
+ */
+template<typename T>
+static void ChangeValue(T& value)
+{
+    if constexpr (std::is_same<T,bool>::value)
+    {
+        value = !value;
+    }
+    else if constexpr (std::is_arithmetic<T>::value)
+    {
+        value = (T)(value + 1);
+    }
+    else if constexpr (std::is_same<T,std::string>::value)
+    {
+        value += "x";
+    }
+    else if constexpr (std::is_base_of<Jsonize,T>::value)
+    {
+        VisitJsonField(value, 0, [](auto& field)
+        {
+            ChangeValue(field);
+        },
+        std::make_index_sequence<JsonFieldTable<T>::SIZE>());
+    }
+    else
+    {
+        value.emplace_back();
+    }
+}
+
+static std::string MapString(const JsonMap& m)
+{
+    return WriteJsonString(Any(m));
+}
+
+template<typename T>
+static bool CheckLegacy(bool legacyReads)
+{
+    T t;
+    int32_t seed = 0;
+    FillValue(t, seed);
+
+    /*
+     * toJson and writeJson against the replaced toJson.
+     */
+    JsonMap legacy, reflected;
+    LegacyToJson(t, legacy);
+    t.toJson(reflected);
+
+    std::string text = MapString(legacy);
+    bool ok = true;
+
+    if (MapString(reflected) != text)
+    {
+        printf("toJson:    %s\nlegacy:    %s\n", MapString(reflected).c_str(), text.c_str());
+        ok = false;
+    }
+
+    if (StreamToJsonString(t) != text)
+    {
+        printf("writeJson: %s\nlegacy:    %s\n", StreamToJsonString(t).c_str(), text.c_str());
+        ok = false;
+    }
+
+    /*
+     * fromJson and readJson against the replaced fromJson.
+     */
+    T before;
+    int32_t other = 1000;
+    FillValue(before, other);
+
+    /*
+     * vectors are appended to, as FromAny does, so read into fresh objects.
+     */
+    T fromMap, fromStream, fromLegacy;
+    if (!legacyReads)
+    {
+        fromLegacy = before;
+    }
+
+    JsonMap m1 = legacy, m2 = legacy;
+    fromMap.fromJson(m1);
+    StreamFromJsonString(text, fromStream);
+    LegacyFromJson(m2, fromLegacy);
+
+    ok = ok && fromMap == t && fromStream == t;
+    ok = ok && fromLegacy == (legacyReads ? t : before);
+
+    return ok;
+}
+
+/*
+ * unknown keys are skipped, missing ones leave the member unchanged, and
+ * every field takes part in operator==.
+ */
+template<typename T>
+static bool CheckReflect()
+{
+    typedef JsonFieldTable<T> Table;
+
+    T t;
+    int32_t seed = 0;
+    FillValue(t, seed);
+
+    JsonMap m;
+    t.toJson(m);
+    m["zz_unknown"] = Any(std::string("x"));
+    m[""] = Any(JsonArray());
+
+    T fromMap;
+    fromMap.fromJson(m);
+
+    std::string text = StreamToJsonString(t);
+    text = "{\"\":[{\"a\":[1,\"\\u0041\"]},null]," + text.substr(1, text.size() - 2) + ",\"zz_unknown\":{\"b\":true}}";
+
+    T fromStream;
+    StreamFromJsonString(text, fromStream);
+
+    bool ok = (fromMap == t) && (fromStream == t);
+
+    T kept = t;
+    JsonMap empty;
+    kept.fromJson(empty);
+    StreamFromJsonString("{}", kept);
+    StreamFromJsonString("{\"zz_unknown\":1}", kept);
+    ok = ok && kept == t;
+
+    T copy = t;
+    ok = ok && EqualJsonFields(copy, t) && !(copy != t);
+
+    for (size_t i=0; i<Table::SIZE; i++)
+    {
+        T changed = t;
+        VisitJsonField(changed, i, [](auto& field)
+        {
+            ChangeValue(field);
+        },
+        std::make_index_sequence<Table::SIZE>());
+
+        ok = ok && changed != t && !EqualJsonFields(changed, t);
+    }
+
+    return ok;
+}
+
+template<typename T>
+static void Check(bool legacyReads = true)
+{
+    UT_TEST_CHECK(CheckLegacy<T>(legacyReads));
+    UT_TEST_CHECK(CheckReflect<T>());
+}
+
+int main()
+{
+    Check<go2::JsonizeFlagBool>();
+    Check<go2::JsonizeDataBool>();
+    Check<go2::JsonizeDataInt>();
+    Check<go2::JsonizeDataFloat>();
+    Check<go2::JsonizeDataDouble>();
+    Check<go2::JsonizeDataString>();
+    Check<go2::JsonizeVec3>();
+    Check<go2::JsonizeQuat>();
+    Check<go2::JsonizePathPoint>();
+    Check<go2::ServiceSwitchParameter>();
+    Check<go2::ServiceSwitchData>();
+    Check<go2::SetReportFreqParameter>();
+    Check<go2::ServiceStateData>();
+    Check<go2::JsonizeConfigMeta>();
+    Check<go2::ConfigSetParameter>();
+    Check<go2::ConfigGetParameter>();
+    Check<go2::ConfigGetData>();
+    Check<go2::ConfigDelParameter>();
+    Check<go2::ConfigMetaParameter>();
+    Check<go2::ConfigMetaData>();
+    Check<go2::ObstaclesAvoidSwitchSetParameter>();
+    Check<go2::ObstaclesAvoidSwitchGetData>();
+    Check<go2::ObstaclesAvoidMoveParameter>();
+    Check<go2::ObstaclesAvoidRemoteCommandSource>();
+    Check<go2::UtrackSwitchSetParameter>();
+    Check<go2::UtrackSwitchGetData>();
+
+    Check<b2::JsonizeConfigMeta>();
+    Check<b2::ConfigSetParameter>();
+    Check<b2::ConfigGetParameter>();
+    Check<b2::ConfigGetData>();
+    Check<b2::ConfigDelParameter>();
+    Check<b2::ConfigMetaParameter>();
+    Check<b2::ConfigMetaData>();
+    Check<b2::JsonizeSilent>();
+    Check<b2::ServiceSwitchParameter>();
+    Check<b2::ServiceSwitchData>();
+    Check<b2::SetReportFreqParameter>();
+    Check<b2::ServiceStateData>();
+    Check<b2::LowPowerSwitchParameter>();
+    Check<b2::LowPowerStatusData>();
+
+    Check<g1::JsonizeArmActionCommand>();
+    Check<g1::TtsMakerParameter>(false);
+    Check<g1::PlayStreamParameter>(false);
+    Check<g1::PlayStopParameter>(false);
+    Check<g1::LedControlParameter>(false);
+    Check<g1::JsonizeDataVecFloat>();
+    Check<g1::JsonizeVelocityCommand>();
+
+    Check<h1::JsonizeDataVecFloat>();
+    Check<h1::JsonizeVelocityCommand>();
+    Check<h1::JsonizeTargetPos>();
+
+    Check<robot::ApplyLeaseParameter>();
+    Check<robot::ApplyLeaseData>();
+
+    Check<ExampleCfg>();
+
+    /*
+     * input in declaration order takes the same path as sorted input.
+     */
+    go2::JsonizePathPoint point;
+    StreamFromJsonString("{\"t_from_start\":0.5,\"x\":1,\"y\":2,\"yaw\":3,\"vx\":4,\"vy\":5,\"vyaw\":6}", point);
+    UT_TEST_CHECK(point.timeFromStart == 0.5f && point.x == 1 && point.yaw == 3 && point.vyaw == 6);
+
+    return unitree::test::TestResult();
+}
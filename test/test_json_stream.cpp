@@ -0,0 +1,442 @@
+#include <unitree/common/json/json_stream.hpp>
+#include <unitree/robot/go2/public/jsonize_type.hpp>
+#include <unitree/robot/go2/robot_state/robot_state_api.hpp>
+#include <unitree/robot/go2/config/config_api.hpp>
+#include <unitree/robot/go2/obstacles_avoid/obstacles_avoid_api.hpp>
+#include <unitree/robot/b2/motion_switcher/motion_switcher_api.hpp>
+#include <unitree/robot/g1/audio/g1_audio_api.hpp>
+#include <unitree/robot/h1/loco/h1_loco_api.hpp>
+#include <unitree/robot/internal/internal_api.hpp>
+
+#include "test_util.hpp"
+
+/*
+ * JsonWriter and JsonReader round trip nested containers and strings,
+ * reject malformed and over-deep input, skip unknown keys, and write the
+ * robot api structs byte for byte as ToJsonString does. ToJsonString comes
+ * from the prebuilt library, so that check is only as strong as the
+ * library linked in.
+ */
+#define TEST_KEY_TEXT           "k\"\\/\b\f\n\r\t\x01 \xc3\xa9"
+#define TEST_KEY_JSON           "\"k\\\"\\\\/\\b\\f\\n\\r\\t\\u0001 \xc3\xa9\""
+
+using namespace unitree::common;
+
+/*
+ * a Jsonize type with hand-written stream members.
+ */
+class Sample : public Jsonize
+{
+public:
+    Sample() :
+        id(0), ratio(0.0)
+    {}
+
+    void toJson(JsonMap& m) const
+    {
+        JN_TO(m, "id", id);
+        JN_TO(m, "names", names);
+        JN_TO(m, "ratio", ratio);
+    }
+
+    void fromJson(JsonMap& m)
+    {
+        JN_FROM(m, "id", id);
+        JN_FROM(m, "names", names);
+        JN_FROM(m, "ratio", ratio);
+    }
+
+    void writeJson(JsonWriter& w) const
+    {
+        w.StartObject();
+        JN_WRITE(w, "id", id);
+        JN_WRITE(w, "names", names);
+        JN_WRITE(w, "ratio", ratio);
+        w.EndObject();
+    }
+
+    void readJson(JsonReader& r)
+    {
+        r.StartObject();
+        while (r.NextMember())
+        {
+            JN_READ(r, "id", id);
+            JN_READ(r, "names", names);
+            JN_READ(r, "ratio", ratio);
+            r.Skip();
+        }
+    }
+
+    bool operator==(const Sample& other) const
+    {
+        return id == other.id && names == other.names && ratio == other.ratio;
+    }
+
+public:
+    int64_t id;
+    std::vector<std::string> names;
+    double ratio;
+};
+
+template<typename T>
+static bool Rejected(const std::string& s)
+{
+    try
+    {
+        T t;
+        StreamFromJsonString(s, t);
+    }
+    catch (const JsonException&)
+    {
+        return true;
+    }
+
+    printf("accepted: %s\n", s.c_str());
+    return false;
+}
+
+/*
+ * write t, check the text, read it back into a fresh T and compare.
+ */
+template<typename T>
+static bool RoundTrip(const T& t, const std::string& expected)
+{
+    std::string s = StreamToJsonString(t);
+    if (s != expected)
+    {
+        printf("written: %s, expected %s\n", s.c_str(), expected.c_str());
+        return false;
+    }
+
+    T back;
+    StreamFromJsonString(s, back);
+
+    return back == t;
+}
+
+static void TestRoundTrip()
+{
+    std::map<std::string,std::vector<std::string>> m;
+    m["b"] = {"x", "", "y z"};
+    m["a"] = {};
+    m[TEST_KEY_TEXT] = {TEST_KEY_TEXT};
+    UT_TEST_CHECK(RoundTrip(m, "{\"a\":[],\"b\":[\"x\",\"\",\"y z\"]," TEST_KEY_JSON ":[" TEST_KEY_JSON "]}"));
+
+    std::vector<std::map<std::string,int32_t>> v(3);
+    v[0]["n"] = -1;
+    v[2]["m"] = INT32_MAX;
+    v[2]["l"] = INT32_MIN;
+    UT_TEST_CHECK(RoundTrip(v, "[{\"n\":-1},{},{\"l\":-2147483648,\"m\":2147483647}]"));
+
+    std::vector<std::vector<double>> d = {{0.1, -2.5, 1e300}, {}, {0.0}};
+    UT_TEST_CHECK(RoundTrip(d, "[[0.1,-2.5,1e+300],[],[0.0]]"));
+
+    std::list<int64_t> l = {INT64_MIN, 0, INT64_MAX};
+    UT_TEST_CHECK(RoundTrip(l, "[-9223372036854775808,0,9223372036854775807]"));
+
+    std::set<uint64_t> u = {UINT64_MAX, 1};
+    UT_TEST_CHECK(RoundTrip(u, "[1,18446744073709551615]"));
+
+    std::vector<float> f = {0.1f, 1.0f, -3.4028235e38f, 1e-45f};
+    UT_TEST_CHECK(RoundTrip(f, "[0.1,1.0,-3.40282347e+38,1.401298e-45]"));
+
+    Sample s;
+    s.id = -42;
+    s.names = {"a", "b\"c"};
+    s.ratio = 0.25;
+    UT_TEST_CHECK(RoundTrip(s, "{\"id\":-42,\"names\":[\"a\",\"b\\\"c\"],\"ratio\":0.25}"));
+
+    std::map<std::string,Sample> ms;
+    ms["x"] = s;
+    UT_TEST_CHECK(RoundTrip(ms, "{\"x\":{\"id\":-42,\"names\":[\"a\",\"b\\\"c\"],\"ratio\":0.25}}"));
+
+    /*
+     * non-finite numbers are written as null, null leaves a value as it was.
+     */
+    std::vector<double> nan = {NAN, INFINITY};
+    UT_TEST_CHECK(StreamToJsonString(nan) == "[null,null]");
+
+    Sample n;
+    n.id = 7;
+    StreamFromJsonString("{\"id\":null,\"names\":null,\"ratio\":null}", n);
+    UT_TEST_CHECK(n.id == 7 && n.names.empty() && n.ratio == 0.0);
+
+    /*
+     * JsonWriter appends, StreamToJsonString reuses the buffer.
+     */
+    std::string buf = "prefix";
+    JsonWriter w(buf);
+    w.StartArray();
+    w.Null();
+    w.Bool(true);
+    w.Int(-1);
+    w.Uint(2);
+    w.EndArray();
+    UT_TEST_CHECK(buf == "prefix[null,true,-1,2]");
+
+    StreamToJsonString(l, buf);
+    UT_TEST_CHECK(buf == "[-9223372036854775808,0,9223372036854775807]");
+}
+
+static void TestEscape()
+{
+    /*
+     * escapes in values and keys, with and without an escape-free prefix.
+     */
+    std::map<std::string,std::string> m;
+    StreamFromJsonString("{\"\\u0061b\":\"\\u00e9\\u20ac\\ud83d\\ude00\",\"c\\td\":\"x\\/y\\\\\",\"plain\":\"\xe4\xb8\xad\"}", m);
+
+    UT_TEST_CHECK(m.size() == 3);
+    UT_TEST_CHECK(m["ab"] == "\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80");
+    UT_TEST_CHECK(m["c\td"] == "x/y\\");
+    UT_TEST_CHECK(m["plain"] == "\xe4\xb8\xad");
+
+    /*
+     * utf-8 is written as is, control characters escaped.
+     */
+    std::string s = "\xf0\x9f\x98\x80\x1f\x7f";
+    UT_TEST_CHECK(StreamToJsonString(s) == "\"\xf0\x9f\x98\x80\\u001f\x7f\"");
+
+    UT_TEST_CHECK(Rejected<std::string>("\"\\ud83d\""));
+    UT_TEST_CHECK(Rejected<std::string>("\"\\ud83dx\""));
+    UT_TEST_CHECK(Rejected<std::string>("\"\\ud83d\\u0041\""));
+    UT_TEST_CHECK(Rejected<std::string>("\"\\ude00\""));
+    UT_TEST_CHECK(Rejected<std::string>("\"\\u00g0\""));
+    UT_TEST_CHECK(Rejected<std::string>("\"\\x\""));
+    UT_TEST_CHECK(Rejected<std::string>("\"a\tb\""));
+    UT_TEST_CHECK(Rejected<std::string>("\"ab\\"));
+}
+
+static void TestMalformed()
+{
+    /*
+     * every proper prefix of a document is rejected.
+     */
+    Sample s;
+    s.id = 123;
+    s.names = {"n\\u", "\xc3\xa9"};
+    s.ratio = -1.5e-7;
+
+    std::string text = StreamToJsonString(s);
+    size_t accepted = 0;
+    for (size_t len=0; len<text.size(); len++)
+    {
+        if (!Rejected<Sample>(text.substr(0, len)))
+        {
+            accepted++;
+        }
+    }
+    UT_TEST_CHECK(accepted == 0);
+
+    const char* invalid[] =
+    {
+        "", "tru", "nul", "nulL", "fals", "True", "{\"id\":+1}", "{\"id\":012}", "{\"id\":1.}",
+        "{\"id\":1.e5}", "{\"id\":1e}", "{\"id\":.5}", "{\"id\":-}", "{\"id\":0x1}", "{\"id\":NaN}",
+        "{\"id\":\"1\"}", "{\"names\":\"a\"}", "{\"names\":[1]}", "{\"names\":[\"a\",]}",
+        "{\"id\":1,}", "{,\"id\":1}", "{\"id\" 1}", "{id:1}", "{\"id\":1 \"ratio\":2}", "[]",
+        "{\"x\":tru}", "{\"x\":[1,]}", "{\"x\":{\"y\"}}", "{\"x\":\"\\q\"}",
+        "{} x", "{}{}", "{\"id\":1}]", "{\"id\":1} 1"
+    };
+
+    for (size_t i=0; i<sizeof(invalid)/sizeof(invalid[0]); i++)
+    {
+        UT_TEST_CHECK(Rejected<Sample>(invalid[i]));
+    }
+
+    /*
+     * space around the root value is fine.
+     */
+    Sample t;
+    StreamFromJsonString(" \r\n\t" + text + " \n", t);
+    UT_TEST_CHECK(t == s);
+}
+
+static bool SkipDepth(int32_t depth)
+{
+    std::string s = std::string(depth, '[') + std::string(depth, ']');
+    try
+    {
+        JsonReader r(s);
+        r.Skip();
+        r.Finish();
+    }
+    catch (const JsonException&)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+static void TestDepth()
+{
+    UT_TEST_CHECK(SkipDepth(UT_JSON_MAX_DEPTH));
+    UT_TEST_CHECK(!SkipDepth(UT_JSON_MAX_DEPTH + 1));
+
+    /*
+     * the limit also holds inside a skipped member.
+     */
+    std::string deep = "{\"x\":" + std::string(UT_JSON_MAX_DEPTH, '[') + std::string(UT_JSON_MAX_DEPTH, ']') + "}";
+    UT_TEST_CHECK(Rejected<Sample>(deep));
+
+    std::vector<std::vector<std::vector<int32_t>>> v;
+    StreamFromJsonString("[[[1],[]],[]]", v);
+    UT_TEST_CHECK(v.size() == 2 && v[0].size() == 2 && v[0][0].size() == 1 && v[0][0][0] == 1);
+}
+
+static void TestSkip()
+{
+    Sample s;
+    StreamFromJsonString("{\"before\":{\"a\":[1,{\"b\":\"\\u0041\\\"\"}],\"c\":null},"
+        "\"id\":5,\"mid\":[true,false,-1.5e3,\"s\\\\t\",[],{}],\"ratio\":2.0,"
+        "\"names\":[\"n\"],\"after\":\"\\ud83d\\ude00\"}", s);
+
+    UT_TEST_CHECK(s.id == 5);
+    UT_TEST_CHECK(s.ratio == 2.0);
+    UT_TEST_CHECK(s.names.size() == 1 && s.names[0] == "n");
+
+    /*
+     * Capture returns the text of a skipped value.
+     */
+    std::string text = "{\"a\": [1, {\"b\": 2}] , \"c\":3}";
+    JsonReader r(text);
+    r.StartObject();
+    UT_TEST_CHECK(r.NextMember() && r.IsKey("a"));
+
+    const char* begin = NULL;
+    size_t len = 0;
+    r.Capture(begin, len);
+    UT_TEST_CHECK(std::string(begin, len) == "[1, {\"b\": 2}]");
+
+    int32_t c = 0;
+    UT_TEST_CHECK(r.NextMember() && r.GetKey() == "c");
+    r.ReadNumber(c);
+    UT_TEST_CHECK(c == 3);
+    UT_TEST_CHECK(!r.NextMember());
+    r.Finish();
+}
+
+/*
+ * the stream path writes what ToJsonString writes and reads what
+ * FromJsonString reads.
+ */
+template<typename T>
+static bool SameAsAny(const T& t)
+{
+    std::string stream = StreamToJsonString(t);
+    std::string any = ToJsonString(t);
+    if (stream != any)
+    {
+        printf("stream: %s\nany:    %s\n", stream.c_str(), any.c_str());
+        return false;
+    }
+
+    T a, b;
+    FromJsonString(any, a);
+    StreamFromJsonString(stream, b);
+
+    return StreamToJsonString(a) == stream && StreamToJsonString(b) == stream;
+}
+
+static void TestSameAsAny()
+{
+    namespace go2 = unitree::robot::go2;
+    namespace b2 = unitree::robot::b2;
+    namespace g1 = unitree::robot::g1;
+    namespace h1 = unitree::robot::h1;
+    namespace internal = unitree::robot;
+
+    go2::ServiceStateData state;
+    state.name = "sport_mode";
+    state.status = 1;
+    state.protect = 0;
+    UT_TEST_CHECK(SameAsAny(state));
+
+    go2::ServiceSwitchParameter sw;
+    sw.name = "obstacles_avoid";
+    sw.swit = 1;
+    UT_TEST_CHECK(SameAsAny(sw));
+
+    go2::JsonizePathPoint point;
+    point.timeFromStart = 0.5f;
+    point.x = 1.25f;
+    point.y = -2.0f;
+    point.yaw = 0.125f;
+    point.vx = 0.0f;
+    point.vy = -0.75f;
+    point.vyaw = 3.0f;
+    UT_TEST_CHECK(SameAsAny(point));
+
+    go2::JsonizeDataString str;
+    str.data = TEST_KEY_TEXT;
+    UT_TEST_CHECK(SameAsAny(str));
+
+    go2::JsonizeDataBool flag;
+    flag.data = true;
+    UT_TEST_CHECK(SameAsAny(flag));
+
+    go2::JsonizeDataDouble dbl;
+    dbl.data = -0.5;
+    UT_TEST_CHECK(SameAsAny(dbl));
+
+    go2::ConfigMetaData meta;
+    meta.meta.name = "cfg";
+    meta.meta.lastModified = "2024-01-01 00:00:00";
+    meta.meta.size = 1024;
+    meta.meta.epoch = -1;
+    UT_TEST_CHECK(SameAsAny(meta));
+
+    go2::ObstaclesAvoidMoveParameter move;
+    move.mX = 0.5f;
+    move.mY = -0.25f;
+    move.mYaw = 1.0f;
+    move.mMode = 2;
+    UT_TEST_CHECK(SameAsAny(move));
+
+    b2::JsonizeModeName mode;
+    mode.name = "normal";
+    UT_TEST_CHECK(SameAsAny(mode));
+    mode.form = "0";
+    UT_TEST_CHECK(SameAsAny(mode));
+
+    g1::TtsMakerParameter tts;
+    tts.index = 3;
+    tts.speaker_id = 65535;
+    tts.text = "\xe4\xbd\xa0\xe5\xa5\xbd";
+    UT_TEST_CHECK(SameAsAny(tts));
+
+    g1::LedControlParameter led;
+    led.R = 255;
+    led.G = 0;
+    led.B = 128;
+    UT_TEST_CHECK(SameAsAny(led));
+
+    h1::JsonizeVelocityCommand vel;
+    vel.velocity = {0.5f, -0.25f, 0.0f};
+    vel.duration = 1.0f;
+    UT_TEST_CHECK(SameAsAny(vel));
+
+    h1::JsonizeTargetPos target;
+    target.x = 1.5f;
+    target.y = 0.0f;
+    target.yaw = -0.5f;
+    target.relative = false;
+    UT_TEST_CHECK(SameAsAny(target));
+
+    internal::ApplyLeaseData lease;
+    lease.id = INT64_MIN;
+    lease.term = INT64_MAX;
+    UT_TEST_CHECK(SameAsAny(lease));
+}
+
+int main()
+{
+    TestRoundTrip();
+    TestEscape();
+    TestMalformed();
+    TestDepth();
+    TestSkip();
+    TestSameAsAny();
+
+    return unitree::test::TestResult();
+}
@@ -0,0 +1,274 @@
+#include <unitree/common/json/json_value.hpp>
+
+#include "test_util.hpp"
+
+/*
+ * JsonDocument parses RFC 8259 json and writes it back compact with sorted
+ * keys, rejects what the grammar does not allow, keeps its values valid in
+ * the arena across blocks and reparses, and converts to and from the Any
+ * tree used by Jsonize without loss.
+ */
+#define TEST_LONG_STRING_NUM    1000
+#define TEST_REPARSE_NUM        100
+
+using namespace unitree::common;
+
+static std::string Rewrite(const std::string& s)
+{
+    JsonDocument doc;
+    doc.Parse(s);
+    return doc.ToString();
+}
+
+static bool Rejected(const std::string& s)
+{
+    try
+    {
+        JsonDocument doc;
+        doc.Parse(s);
+    }
+    catch (const JsonException&)
+    {
+        return true;
+    }
+
+    printf("accepted: %s\n", s.c_str());
+    return false;
+}
+
+/*
+ * s written compact and written again after a reparse.
+ */
+static bool RoundTrip(const std::string& s, const std::string& expected)
+{
+    std::string once = Rewrite(s);
+    if (once != expected || Rewrite(once) != expected)
+    {
+        printf("round trip: %s -> %s, expected %s\n", s.c_str(), once.c_str(), expected.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+static void TestRoundTrip()
+{
+    UT_TEST_CHECK(RoundTrip(" { \"b\" : 1 , \"a\" : [ true , false , null ] }\n",
+        "{\"a\":[true,false,null],\"b\":1}"));
+    UT_TEST_CHECK(RoundTrip("{\"k\":1,\"k\":2,\"a\":{}}", "{\"a\":{},\"k\":2}"));
+    UT_TEST_CHECK(RoundTrip("[[],{},[[1]],{\"x\":{\"y\":[]}}]", "[[],{},[[1]],{\"x\":{\"y\":[]}}]"));
+
+    /*
+     * integers keep their type, anything else is a double written with a
+     * fraction or exponent.
+     */
+    UT_TEST_CHECK(RoundTrip("[0,-0,9223372036854775807,-9223372036854775808,18446744073709551615]",
+        "[0,0,9223372036854775807,-9223372036854775808,18446744073709551615]"));
+    UT_TEST_CHECK(RoundTrip("[1.0,0.5,-0.0,1E2,1e+2,25e-1,0e0,-1.5e-3]",
+        "[1.0,0.5,-0.0,100.0,100.0,2.5,0.0,-0.0015]"));
+    UT_TEST_CHECK(RoundTrip("[0.1,1e300,18446744073709551616]",
+        "[0.1,1e+300,1.8446744073709552e+19]"));
+
+    /*
+     * escapes are decoded to utf-8 and only what must be escaped is
+     * escaped again.
+     */
+    UT_TEST_CHECK(RoundTrip("\"a\\\"b\\\\c\\/d\\b\\f\\n\\r\\t\\u0001\"",
+        "\"a\\\"b\\\\c/d\\b\\f\\n\\r\\t\\u0001\""));
+    UT_TEST_CHECK(RoundTrip("\"\\u00e9\\u20AC\\ud83d\\ude00\"", "\"\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80\""));
+    UT_TEST_CHECK(RoundTrip("\"\xc3\xa9\"", "\"\xc3\xa9\""));
+
+    /*
+     * small strings are inline, longer ones in the arena.
+     */
+    std::string small(UT_JSON_SMALL_STRING_SIZE, 's');
+    std::string large(UT_JSON_SMALL_STRING_SIZE + 1, 'l');
+    UT_TEST_CHECK(RoundTrip("[\"" + small + "\",\"" + large + "\"]", "[\"" + small + "\",\"" + large + "\"]"));
+
+    JsonDocument doc;
+    doc.Parse("{\"n\":-3,\"d\":2.5,\"s\":\"text\",\"a\":[1,2]}");
+
+    const JsonValue& root = doc.GetRoot();
+    UT_TEST_CHECK(root.IsObject() && root.Size() == 4);
+    UT_TEST_CHECK(root.Find("n") != NULL && root.Find("n")->GetInt64() == -3);
+    UT_TEST_CHECK(root.Find("d") != NULL && root.Find("d")->GetDouble() == 2.5);
+    UT_TEST_CHECK(root.Find("s") != NULL && root.Find("s")->GetString() == "text");
+    UT_TEST_CHECK(root.Find("a") != NULL && (*root.Find("a"))[1].GetUint64() == 2);
+    UT_TEST_CHECK(root.Find("missing") == NULL);
+    UT_TEST_CHECK(root.GetMember(0).mKey.GetString() == "a");
+}
+
+static void TestInvalid()
+{
+    const char* invalid[] =
+    {
+        "", " ", "012", "-012", "00", "-", "+1", ".5", "1.", "-1.", "1.e5", "1e", "1e+", "1E-",
+        "1.5.5", "1ee5", "0x10", "Infinity", "NaN", "-Infinity",
+        "tru", "nul", "falsey", "True",
+        "[1,]", "[,1]", "[1 2]", "[", "]", "{", "}", "{\"a\":1,}", "{\"a\" 1}", "{a:1}", "{\"a\":}",
+        "{1:2}", "[1]]", "[1] x", "{} {}", "1 2",
+        "\"abc", "\"\\x\"", "\"\\u12\"", "\"\\u12g4\"", "\"\t\"", "\"\n\"",
+        "\"\\udc00\"", "\"\\udfff\"", "\"\\ud800\"", "\"\\ud800x\"", "\"\\ud800\\u0041\"",
+        "\"\\ud800\\ud800\"", "\"\\ude00\\ud83d\""
+    };
+
+    for (size_t i=0; i<sizeof(invalid)/sizeof(invalid[0]); i++)
+    {
+        UT_TEST_CHECK(Rejected(invalid[i]));
+    }
+
+    /*
+     * the depth limit counts containers.
+     */
+    std::string ok = std::string(UT_JSON_MAX_DEPTH, '[') + std::string(UT_JSON_MAX_DEPTH, ']');
+    std::string deep = "[" + ok + "]";
+
+    UT_TEST_CHECK(Rewrite(ok) == ok);
+    UT_TEST_CHECK(Rejected(deep));
+
+    /*
+     * a failed parse leaves a document which parses again.
+     */
+    JsonDocument doc;
+    UT_TEST_CHECK(Rejected("{\"a\":[1,2"));
+    try
+    {
+        doc.Parse("{\"a\":[1,2");
+    }
+    catch (const JsonException&)
+    {}
+    doc.Parse("{\"a\":[1,2]}");
+    UT_TEST_CHECK(doc.ToString() == "{\"a\":[1,2]}");
+}
+
+static std::string LongString(int32_t i)
+{
+    return std::string(100, 'a' + i % 26) + std::to_string(i);
+}
+
+static void TestArena()
+{
+    {
+        JsonArena arena;
+        char* first = (char*)arena.Allocate(1);
+        char* second = (char*)arena.Allocate(3);
+        UT_TEST_CHECK(((uintptr_t)first & 7) == 0 && ((uintptr_t)second & 7) == 0);
+        UT_TEST_CHECK(second - first == 8);
+
+        char* big = (char*)arena.Allocate(UT_JSON_ARENA_BLOCK_SIZE * 3);
+        memset(big, 1, UT_JSON_ARENA_BLOCK_SIZE * 3);
+
+        /*
+         * Reset keeps the first block.
+         */
+        arena.Reset();
+        UT_TEST_CHECK(arena.Allocate(1) == first);
+    }
+
+    /*
+     * strings spread over many arena blocks stay valid while the document
+     * lives.
+     */
+    std::string s = "[";
+    for (int32_t i=0; i<TEST_LONG_STRING_NUM; i++)
+    {
+        s += (i > 0 ? ",\"" : "\"") + LongString(i) + "\"";
+    }
+    s += "]";
+
+    JsonDocument doc;
+    doc.Parse(s);
+
+    const JsonValue& root = doc.GetRoot();
+    bool intact = root.IsArray() && root.Size() == TEST_LONG_STRING_NUM;
+    for (int32_t i=0; intact && i<TEST_LONG_STRING_NUM; i++)
+    {
+        intact = (root[i].GetString() == LongString(i));
+    }
+    UT_TEST_CHECK(intact);
+    UT_TEST_CHECK(doc.ToString() == s);
+
+    /*
+     * reparsing reuses the arena.
+     */
+    bool reparsed = true;
+    for (int32_t i=0; i<TEST_REPARSE_NUM; i++)
+    {
+        std::string t = "{\"k\":\"" + LongString(i) + "\",\"n\":" + std::to_string(i) + "}";
+        doc.Parse(t);
+        reparsed = reparsed && doc.ToString() == t;
+    }
+    UT_TEST_CHECK(reparsed);
+
+    doc.Clear();
+    UT_TEST_CHECK(doc.GetRoot().IsNull() && doc.ToString() == "null");
+
+    /*
+     * FromAny copies strings into the arena, the Any tree may go away.
+     */
+    {
+        JsonArray arr;
+        arr.push_back(Any(LongString(1)));
+        arr.push_back(Any(std::string("short")));
+        doc.FromAny(Any(arr));
+    }
+    UT_TEST_CHECK(doc.ToString() == "[\"" + LongString(1) + "\",\"short\"]");
+}
+
+static void TestAny()
+{
+    Any a;
+    ParseJsonString("{\"i\":-7,\"big\":-9223372036854775808,\"u\":18446744073709551615,"
+        "\"d\":0.25,\"s\":\"x\",\"t\":true,\"z\":null,\"a\":[1,\"y\"],\"m\":{\"k\":2}}", a);
+
+    UT_TEST_CHECK(a.GetTypeInfo() == typeid(JsonMap));
+    const JsonMap& m = AnyCast<JsonMap>(a);
+    UT_TEST_CHECK(m.size() == 9);
+
+    UT_TEST_CHECK(m.at("i").GetTypeInfo() == typeid(int32_t) && AnyCast<int32_t>(m.at("i")) == -7);
+    UT_TEST_CHECK(m.at("big").GetTypeInfo() == typeid(int64_t) && AnyCast<int64_t>(m.at("big")) == INT64_MIN);
+    UT_TEST_CHECK(m.at("u").GetTypeInfo() == typeid(uint64_t) && AnyCast<uint64_t>(m.at("u")) == UINT64_MAX);
+    UT_TEST_CHECK(m.at("d").GetTypeInfo() == typeid(double) && AnyCast<double>(m.at("d")) == 0.25);
+    UT_TEST_CHECK(m.at("s").GetTypeInfo() == typeid(std::string) && AnyCast<std::string>(m.at("s")) == "x");
+    UT_TEST_CHECK(m.at("t").GetTypeInfo() == typeid(bool) && AnyCast<bool>(m.at("t")));
+    UT_TEST_CHECK(m.at("z").Empty());
+
+    const JsonArray& arr = AnyCast<JsonArray>(m.at("a"));
+    UT_TEST_CHECK(arr.size() == 2 && AnyCast<int32_t>(arr[0]) == 1 && AnyCast<std::string>(arr[1]) == "y");
+    UT_TEST_CHECK(AnyCast<int32_t>(AnyCast<JsonMap>(m.at("m")).at("k")) == 2);
+
+    UT_TEST_CHECK(WriteJsonString(a) == "{\"a\":[1,\"y\"],\"big\":-9223372036854775808,\"d\":0.25,"
+        "\"i\":-7,\"m\":{\"k\":2},\"s\":\"x\",\"t\":true,\"u\":18446744073709551615,\"z\":null}");
+
+    /*
+     * the other number types Jsonize puts into an Any.
+     */
+    JsonMap n;
+    n["f"] = Any(1.5f);
+    n["i8"] = Any((int8_t)-8);
+    n["u16"] = Any((uint16_t)65535);
+    n["u32"] = Any((uint32_t)4294967295u);
+    n["i64"] = Any((int64_t)-5);
+    UT_TEST_CHECK(WriteJsonString(Any(n)) == "{\"f\":1.5,\"i64\":-5,\"i8\":-8,\"u16\":65535,\"u32\":4294967295}");
+
+    bool thrown = false;
+    try
+    {
+        WriteJsonString(Any(std::vector<int32_t>()));
+    }
+    catch (const JsonException&)
+    {
+        thrown = true;
+    }
+    UT_TEST_CHECK(thrown);
+}
+
+int main()
+{
+    TestRoundTrip();
+    TestInvalid();
+    TestArena();
+    TestAny();
+
+    return unitree::test::TestResult();
+}
@@ -0,0 +1,165 @@
+#include <unitree/common/latest_value.hpp>
+#include <thread>
+
+#include "alloc_counter.hpp"
+#include "test_util.hpp"
+
+/*
+ * one writer hands a state of the size of a low level message to its
+ * readers. every field is derived from the sequence number, so a torn
+ * value is seen as a mismatch. nothing may be allocated after
+ * construction on either side.
+ */
+#define TEST_SET_NUM    200000
+#define TEST_JOINT_NUM  35
+
+using namespace unitree::common;
+using unitree::test::AllocCounter;
+
+class State
+{
+public:
+    uint64_t mSeq;
+    float mQ[TEST_JOINT_NUM];
+    float mDq[TEST_JOINT_NUM];
+    uint64_t mCheck;
+};
+
+static void Fill(State& s, uint64_t seq)
+{
+    s.mSeq = seq;
+    for (int32_t i=0; i<TEST_JOINT_NUM; i++)
+    {
+        s.mQ[i] = (float)(seq + i);
+        s.mDq[i] = (float)(seq * 2 + i);
+    }
+    s.mCheck = ~seq;
+}
+
+static bool Consistent(const State& s)
+{
+    for (int32_t i=0; i<TEST_JOINT_NUM; i++)
+    {
+        if (s.mQ[i] != (float)(s.mSeq + i) || s.mDq[i] != (float)(s.mSeq * 2 + i))
+        {
+            return false;
+        }
+    }
+
+    return s.mCheck == ~s.mSeq;
+}
+
+class ReaderResult
+{
+public:
+    ReaderResult() : mTorn(0), mBackward(0), mLast(0), mAlloc(0)
+    {}
+
+    uint64_t mTorn;
+    uint64_t mBackward;
+    uint64_t mLast;
+    uint64_t mAlloc;
+};
+
+/*
+ * get(State&) until the last value is seen.
+ */
+template<typename G>
+static void ReadAll(G&& get, ReaderResult& r)
+{
+    uint64_t alloc = AllocCounter::GetThreadCount();
+    State s;
+
+    while (r.mLast < TEST_SET_NUM)
+    {
+        if (!get(s))
+        {
+            continue;
+        }
+
+        if (!Consistent(s))
+        {
+            r.mTorn++;
+        }
+        if (s.mSeq < r.mLast)
+        {
+            r.mBackward++;
+        }
+
+        r.mLast = s.mSeq;
+    }
+
+    r.mAlloc = AllocCounter::GetThreadCount() - alloc;
+}
+
+template<typename V>
+static uint64_t WriteAll(V& value)
+{
+    uint64_t alloc = AllocCounter::GetThreadCount();
+    State s;
+
+    for (uint64_t seq=1; seq<=TEST_SET_NUM; seq++)
+    {
+        Fill(s, seq);
+        value.Set(s);
+    }
+
+    return AllocCounter::GetThreadCount() - alloc;
+}
+
+static void Check(const ReaderResult& r)
+{
+    UT_TEST_CHECK(r.mTorn == 0);
+    UT_TEST_CHECK(r.mBackward == 0);
+    UT_TEST_CHECK(r.mLast == TEST_SET_NUM);
+    UT_TEST_CHECK(r.mAlloc == 0);
+}
+
+int main()
+{
+    {
+        LatestValue<State> value;
+        State s;
+        UT_TEST_CHECK(value.Read() == NULL);
+        UT_TEST_CHECK(!value.Get(s));
+
+        ReaderResult r;
+        std::thread reader([&value, &r]()
+        {
+            ReadAll([&value](State& s) { return value.Get(s); }, r);
+        });
+
+        uint64_t writerAlloc = WriteAll(value);
+        reader.join();
+
+        Check(r);
+        UT_TEST_CHECK(writerAlloc == 0);
+        UT_TEST_CHECK(value.Read() != NULL && value.Read()->mSeq == TEST_SET_NUM);
+    }
+
+    {
+        SeqLockLatestValue<State> value;
+        State s;
+        UT_TEST_CHECK(!value.Get(s));
+
+        ReaderResult r[2];
+        std::thread reader0([&value, &r]()
+        {
+            ReadAll([&value](State& s) { return value.Get(s); }, r[0]);
+        });
+        std::thread reader1([&value, &r]()
+        {
+            ReadAll([&value](State& s) { return value.Get(s); }, r[1]);
+        });
+
+        uint64_t writerAlloc = WriteAll(value);
+        reader0.join();
+        reader1.join();
+
+        Check(r[0]);
+        Check(r[1]);
+        UT_TEST_CHECK(writerAlloc == 0);
+    }
+
+    return unitree::test::TestResult();
+}
@@ -0,0 +1,74 @@
+#include <unitree/common/log/log_binary.hpp>
+#include <thread>
+
+#include "test_util.hpp"
+
+/*
+ * records dropped by a full ring are counted once, also after the ring of
+ * an exited thread has been removed, and a logging thread drops nothing
+ * while the writer keeps up.
+ */
+#define TEST_RING_SIZE      4096
+#define TEST_RECORD_NUM     10000
+
+using namespace unitree::common;
+
+/*
+ * log count records from a new thread and return the drops of its ring.
+ */
+static uint64_t LogFromThread(LogBinaryLoggerPtr loggerPtr, int32_t count)
+{
+    uint64_t dropped = 0;
+
+    std::thread thread([loggerPtr, count, &dropped]()
+    {
+        for (int32_t i=0; i<count; i++)
+        {
+            BLOG_INFO(loggerPtr, "record:{} value:{}", i, 0.5 * i);
+        }
+
+        dropped = loggerPtr->GetStore()->GetThreadRing()->GetDropped();
+    });
+
+    thread.join();
+
+    return dropped;
+}
+
+int main()
+{
+    /*
+     * the writer thread may flush at any time, the counts hold either way.
+     */
+    LogBinaryStorePtr storePtr(new LogBinaryStore(LogStorePtr(), "", 100 * UT_NUMER_MILLI,
+        UT_CPU_ID_NONE, TEST_RING_SIZE));
+    LogBinaryLoggerPtr loggerPtr(new LogBinaryLogger(UT_LOG_INFO, storePtr));
+
+    uint64_t first = LogFromThread(loggerPtr, TEST_RECORD_NUM);
+    UT_TEST_CHECK(first > 0);
+
+    storePtr->Flush();
+    UT_TEST_CHECK(storePtr->GetDropped() == first);
+
+    storePtr->Flush();
+    UT_TEST_CHECK(storePtr->GetDropped() == first);
+
+    uint64_t second = LogFromThread(loggerPtr, TEST_RECORD_NUM);
+    storePtr->Flush();
+    storePtr->Flush();
+    UT_TEST_CHECK(storePtr->GetDropped() == first + second);
+
+    /*
+     * a live ring is counted while it is still registered.
+     */
+    for (int32_t i=0; i<TEST_RECORD_NUM; i++)
+    {
+        BLOG_INFO(loggerPtr, "record:{}", i);
+    }
+
+    uint64_t live = storePtr->GetThreadRing()->GetDropped();
+    storePtr->Flush();
+    UT_TEST_CHECK(storePtr->GetDropped() == first + second + live);
+
+    return unitree::test::TestResult();
+}
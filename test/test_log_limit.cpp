@@ -0,0 +1,110 @@
+#include <unitree/common/log/log.hpp>
+
+#include "test_util.hpp"
+
+/*
+ * every suppressed message is reported exactly once, by the next message
+ * which passes, by LogLimitFlush or by the flush timer.
+ */
+using namespace unitree::common;
+
+class CaptureStore : public LogStore
+{
+public:
+    void Append(const std::string& s)
+    {
+        LockGuard<Mutex> guard(mMutex);
+        mLines.push_back(s);
+    }
+
+    /*
+     * sum of the suppressed counts reported so far.
+     */
+    uint64_t GetReported()
+    {
+        LockGuard<Mutex> guard(mMutex);
+
+        uint64_t total = 0;
+        for (size_t i=0; i<mLines.size(); i++)
+        {
+            size_t pos = mLines[i].find("suppressed ");
+            if (pos != std::string::npos)
+            {
+                total += std::stoull(mLines[i].substr(pos + 11));
+            }
+        }
+
+        return total;
+    }
+
+    size_t GetLineNumber()
+    {
+        LockGuard<Mutex> guard(mMutex);
+        return mLines.size();
+    }
+
+private:
+    Mutex mMutex;
+    std::vector<std::string> mLines;
+};
+
+typedef std::shared_ptr<CaptureStore> CaptureStorePtr;
+
+int main()
+{
+    CaptureStorePtr storePtr(new CaptureStore());
+    Logger* logger = new Logger(UT_LOG_INFO, storePtr);
+
+    /*
+     * 1 passes, 99 are suppressed and only reported by the flush.
+     */
+    for (int32_t i=0; i<100; i++)
+    {
+        LOG_WARNING_RATE_LIMIT(logger, 1, "rate limited:", i);
+    }
+
+    UT_TEST_CHECK(storePtr->GetLineNumber() == 1);
+    UT_TEST_CHECK(storePtr->GetReported() == 0);
+
+    LogLimitFlush();
+    UT_TEST_CHECK(storePtr->GetReported() == 99);
+
+    LogLimitFlush();
+    UT_TEST_CHECK(storePtr->GetReported() == 99);
+
+    /*
+     * 0, 10 and 20 pass and report 9 each from the second on, 4 are left.
+     */
+    for (int32_t i=0; i<25; i++)
+    {
+        LOG_INFO_EVERY_N(logger, 10, "every n:", i);
+    }
+
+    UT_TEST_CHECK(storePtr->GetReported() == 99 + 18);
+
+    LogLimitFlush();
+    UT_TEST_CHECK(storePtr->GetReported() == 99 + 18 + 4);
+
+    /*
+     * without LogLimitFlush the timer reports the last count.
+     */
+    for (int32_t i=0; i<50; i++)
+    {
+        LOG_ERROR_RATE_LIMIT(logger, 1, "timer:", i);
+    }
+
+    for (int32_t i=0; i<30 && storePtr->GetReported() < 99 + 18 + 4 + 49; i++)
+    {
+        usleep(100000);
+    }
+
+    UT_TEST_CHECK(storePtr->GetReported() == 99 + 18 + 4 + 49);
+
+    /*
+     * the limited call sites keep the logger, stop the timer first.
+     */
+    TimerService::Instance()->Quit();
+    delete logger;
+
+    return unitree::test::TestResult();
+}
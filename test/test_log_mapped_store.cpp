@@ -0,0 +1,188 @@
+#include <unitree/common/log/log_mapped_store.hpp>
+#include <algorithm>
+#include <fstream>
+
+#include "test_util.hpp"
+
+/*
+ * writes 20M of numbered lines through 1M segments, prints the append
+ * throughput and latency across the rotations, and checks that a rotation
+ * is not slower than the worst other append by more than
+ * TEST_ROTATION_FACTOR, and that exactly the newest TEST_SEGMENT_NUM
+ * segments are kept, with consecutive indexes, holding the newest lines
+ * in order and nothing else. a second run through page sized segments
+ * outpaces the background thread, so rotations also prepare inline.
+ */
+#define TEST_SEGMENT_SIZE   (1024 * 1024)
+#define TEST_SEGMENT_NUM    4
+#define TEST_LINE_SIZE      100
+#define TEST_LINE_NUM       (20 * TEST_SEGMENT_SIZE / TEST_LINE_SIZE)
+#define TEST_SMALL_SIZE     4096
+#define TEST_ROTATION_FACTOR    2
+
+using namespace unitree::common;
+
+static std::string MakeLine(uint64_t seq)
+{
+    char buf[TEST_LINE_SIZE + 1];
+    int32_t len = snprintf(buf, sizeof(buf), "%012llu ", (unsigned long long)seq);
+    memset(buf + len, 'x', TEST_LINE_SIZE - len - 1);
+    buf[TEST_LINE_SIZE - 1] = '\n';
+
+    return std::string(buf, TEST_LINE_SIZE);
+}
+
+static std::vector<std::string> ListSegments(const std::string& directory)
+{
+    std::vector<std::string> names;
+
+    DIR* dir = opendir(directory.c_str());
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        std::string name = entry->d_name;
+        if (name.compare(0, 5, "test.") == 0)
+        {
+            names.push_back(directory + "/" + name);
+        }
+    }
+    closedir(dir);
+
+    std::sort(names.begin(), names.end());
+
+    return names;
+}
+
+/*
+ * test.<index>.LOG
+ */
+static uint64_t GetSegmentIndex(const std::string& name)
+{
+    return strtoull(name.c_str() + name.rfind("test.") + 5, NULL, 10);
+}
+
+/*
+ * write lineNum lines through segments of segmentSize bytes, then check
+ * what is left on disk.
+ */
+static void Run(const std::vector<std::string>& lines, uint64_t lineNum, int64_t segmentSize,
+    bool checkLatency)
+{
+    char directory[] = "/tmp/ut_log_mmap_XXXXXX";
+    UT_TEST_CHECK(mkdtemp(directory) != NULL);
+
+    std::vector<double> latency(lineNum);
+    std::chrono::steady_clock::time_point begin, end;
+    {
+        LogMappedFileStore store(directory, "test", segmentSize, TEST_SEGMENT_NUM);
+
+        begin = std::chrono::steady_clock::now();
+        for (uint64_t i=0; i<lineNum; i++)
+        {
+            std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now();
+            store.Append(lines[i]);
+            latency[i] = std::chrono::duration<double, std::nano>(
+                std::chrono::steady_clock::now() - t).count();
+        }
+        end = std::chrono::steady_clock::now();
+    }
+
+    double seconds = std::chrono::duration<double>(end - begin).count();
+    double sum = 0;
+    for (double ns : latency)
+    {
+        sum += ns;
+    }
+
+    std::vector<double> sorted(latency);
+    std::sort(sorted.begin(), sorted.end());
+
+    /*
+     * the appends which crossed a segment boundary.
+     */
+    double rotationMax = 0;
+    double otherMax = 0;
+    for (uint64_t i=0; i<lineNum; i++)
+    {
+        if ((i * TEST_LINE_SIZE) / segmentSize != ((i + 1) * TEST_LINE_SIZE - 1) / segmentSize)
+        {
+            rotationMax = std::max(rotationMax, latency[i]);
+        }
+        else
+        {
+            otherMax = std::max(otherMax, latency[i]);
+        }
+    }
+
+    printf("%llu lines, %llu segments of %lld bytes\n", (unsigned long long)lineNum,
+        (unsigned long long)(lineNum * TEST_LINE_SIZE / segmentSize), (long long)segmentSize);
+    printf("throughput %.1f MB/s\n", lineNum * TEST_LINE_SIZE / seconds / 1048576.0);
+    printf("append mean %.0f ns, p50 %.0f ns, p99 %.0f ns\n", sum / lineNum,
+        sorted[lineNum / 2], sorted[lineNum * 99 / 100]);
+    printf("max %.0f ns at a rotation, %.0f ns elsewhere\n", rotationMax, otherMax);
+
+    /*
+     * the next segment is prepared in the background, a rotation is a
+     * pointer switch.
+     */
+    if (checkLatency)
+    {
+        UT_TEST_CHECK(rotationMax <= TEST_ROTATION_FACTOR * otherMax);
+    }
+
+    /*
+     * the kept segments, oldest first, are a tail of the written stream.
+     */
+    std::vector<std::string> names = ListSegments(directory);
+    UT_TEST_CHECK(names.size() == TEST_SEGMENT_NUM);
+
+    /*
+     * the last index is that of the segment the last line went to.
+     */
+    uint64_t lastIndex = (lineNum * TEST_LINE_SIZE - 1) / segmentSize;
+
+    std::string content;
+    for (size_t i=0; i<names.size(); i++)
+    {
+        UT_TEST_CHECK(GetSegmentIndex(names[i]) == lastIndex + 1 - names.size() + i);
+
+        std::ifstream file(names[i].c_str(), std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        UT_TEST_CHECK(i + 1 == names.size() || (int64_t)data.size() == segmentSize);
+        content += data;
+        unlink(names[i].c_str());
+    }
+    rmdir(directory);
+
+    size_t pos = content.find('\n') + 1;
+    uint64_t seq = strtoull(content.c_str() + pos, NULL, 10);
+    uint64_t wrong = 0;
+
+    UT_TEST_CHECK((int64_t)content.size() > (TEST_SEGMENT_NUM - 1) * segmentSize);
+
+    for (; pos<content.size() && seq<lineNum; pos+=TEST_LINE_SIZE, seq++)
+    {
+        if (content.compare(pos, TEST_LINE_SIZE, lines[seq]) != 0)
+        {
+            wrong++;
+        }
+    }
+
+    UT_TEST_CHECK(wrong == 0);
+    UT_TEST_CHECK(seq == lineNum);
+}
+
+int main()
+{
+    std::vector<std::string> lines;
+    for (uint64_t i=0; i<TEST_LINE_NUM; i++)
+    {
+        lines.push_back(MakeLine(i));
+    }
+
+    Run(lines, TEST_LINE_NUM, TEST_SEGMENT_SIZE, true);
+    Run(lines, TEST_LINE_NUM / 4, TEST_SMALL_SIZE, false);
+
+    return unitree::test::TestResult();
+}
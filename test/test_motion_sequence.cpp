@@ -0,0 +1,127 @@
+#include <unitree/robot/low_level/motion_sequence.hpp>
+
+#include "test_util.hpp"
+
+/*
+ * a written motion sequence maps back with the same frames, and files
+ * with no frames, swapped byte order or a cut data block are rejected
+ * instead of being read.
+ */
+#define TEST_FRAME_NUM  5
+
+using namespace unitree::common;
+using namespace unitree::robot;
+
+static std::string Write(const std::string& fileName)
+{
+    MotionSeqWriter writer(50.0f, TEST_FRAME_NUM);
+    uint32_t joint = writer.AddComponent("MultiValueSeq", "joint", 3, 1, {15, 16, 17});
+    uint32_t pose = writer.AddComponent("MultiSE3Seq", "pose", 7, 1);
+
+    for (uint32_t i=0; i<TEST_FRAME_NUM; i++)
+    {
+        for (uint32_t j=0; j<3; j++)
+        {
+            writer.Get(joint, i)[j] = 0.1f * i + j;
+        }
+        for (uint32_t j=0; j<7; j++)
+        {
+            writer.Get(pose, i)[j] = -1.0f * i - j;
+        }
+    }
+
+    writer.Save(fileName);
+
+    std::string s;
+    int32_t fd = open(fileName.c_str(), O_RDONLY);
+    char buf[4096];
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0)
+    {
+        s.append(buf, n);
+    }
+    close(fd);
+
+    return s;
+}
+
+static void Rewrite(const std::string& fileName, const std::string& s)
+{
+    int32_t fd = open(fileName.c_str(), O_WRONLY | O_TRUNC);
+    UT_TEST_CHECK(write(fd, s.data(), s.size()) == (ssize_t)s.size());
+    close(fd);
+}
+
+static bool Rejected(const std::string& fileName)
+{
+    try
+    {
+        MotionSeqFile file(fileName);
+    }
+    catch (const FileException&)
+    {
+        return true;
+    }
+
+    return false;
+}
+
+int main()
+{
+    const std::string fileName = "/tmp/test_motion_sequence_" + std::to_string(getpid()) + ".useq";
+    const std::string s = Write(fileName);
+
+    {
+        MotionSeqFile file(fileName);
+        UT_TEST_CHECK(file.GetFrameNum() == TEST_FRAME_NUM);
+        UT_TEST_CHECK(file.GetFrameWidth() == 10);
+        UT_TEST_CHECK(file.GetFrameRate() == 50.0f);
+        UT_TEST_CHECK(file.FindComponent("pose") == 1);
+        UT_TEST_CHECK(file.GetSlots(0) != NULL && file.GetSlots(0)[2] == 17);
+        UT_TEST_CHECK(file.GetSlots(1) == NULL);
+        UT_TEST_CHECK(file.Get(4, 0)[2] == 0.1f * 4 + 2);
+        UT_TEST_CHECK(file.Get(3, 1)[6] == -3.0f - 6);
+    }
+
+    MotionSeqHeader header;
+    memcpy(&header, s.data(), sizeof(header));
+
+    /*
+     * no frames, with a matching empty data block.
+     */
+    MotionSeqHeader h = header;
+    h.mFrameNum = 0;
+    h.mDataSize = 0;
+    Rewrite(fileName, std::string((const char*)&h, sizeof(h)) + s.substr(sizeof(h)));
+    UT_TEST_CHECK(Rejected(fileName));
+
+    /*
+     * written on a host of the other byte order.
+     */
+    h = header;
+    h.mVersion = __builtin_bswap32(h.mVersion);
+    h.mFrameNum = __builtin_bswap32(h.mFrameNum);
+    Rewrite(fileName, std::string((const char*)&h, sizeof(h)) + s.substr(sizeof(h)));
+    UT_TEST_CHECK(Rejected(fileName));
+
+    Rewrite(fileName, s.substr(0, s.size() - 4));
+    UT_TEST_CHECK(Rejected(fileName));
+
+    Rewrite(fileName, s);
+    UT_TEST_CHECK(!Rejected(fileName));
+
+    bool thrown = false;
+    try
+    {
+        MotionSeqWriter writer(50.0f, 0);
+    }
+    catch (const CommonException&)
+    {
+        thrown = true;
+    }
+    UT_TEST_CHECK(thrown);
+
+    unlink(fileName.c_str());
+
+    return unitree::test::TestResult();
+}
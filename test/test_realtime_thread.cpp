@@ -0,0 +1,237 @@
+#include <unitree/common/thread/realtime_thread.hpp>
+#include <sys/resource.h>
+
+#include "test_util.hpp"
+
+/*
+ * run without privileges, root drops to nobody first with no realtime
+ * priority and no lockable memory. SCHED_FIFO and mlockall must then be
+ * reported as not granted with the errno of the first failure, items not
+ * requested as granted, and the thread function must still run with the
+ * cpu pinning applied.
+ */
+#define TEST_NOBODY_ID          65534
+#define TEST_GRANT_WAIT_US      1000000
+#define TEST_PERIOD_US          2000
+#define TEST_PERIOD_NUM         5
+#define TEST_HUGE_STACK_SIZE    (1ULL << 40)
+
+using namespace unitree::common;
+
+/*
+ * what the thread function saw of itself.
+ */
+class ThreadState
+{
+public:
+    ThreadState() :
+        mRan(false), mPolicy(-1), mCpu(-1), mCpuCount(0), mTicks(0)
+    {
+        CPU_ZERO(&mCpuSet);
+    }
+
+    void Capture()
+    {
+        struct sched_param param;
+        pthread_getschedparam(pthread_self(), &mPolicy, &param);
+        pthread_getaffinity_np(pthread_self(), sizeof(mCpuSet), &mCpuSet);
+        mCpu = sched_getcpu();
+        mCpuCount = CPU_COUNT(&mCpuSet);
+        mRan = true;
+    }
+
+    void Tick()
+    {
+        if (mTicks++ == 0)
+        {
+            Capture();
+        }
+    }
+
+    bool mRan;
+    int mPolicy;
+    int32_t mCpu;
+    int32_t mCpuCount;
+    cpu_set_t mCpuSet;
+    std::atomic<uint32_t> mTicks;
+};
+
+static bool DropPrivileges()
+{
+    struct rlimit limit;
+    limit.rlim_cur = 0;
+    limit.rlim_max = 0;
+
+    if (setrlimit(RLIMIT_RTPRIO, &limit) != 0 || setrlimit(RLIMIT_MEMLOCK, &limit) != 0)
+    {
+        return false;
+    }
+
+    if (geteuid() == 0)
+    {
+        if (setgid(TEST_NOBODY_ID) != 0 || setuid(TEST_NOBODY_ID) != 0)
+        {
+            return false;
+        }
+    }
+
+    return geteuid() != 0;
+}
+
+static RealtimeGrant RunOnce(const RealtimeProfile& profile, ThreadState& state)
+{
+    RealtimeThreadPtr thread = CreateRealtimeThreadEx("test_rt", profile, &ThreadState::Capture, &state);
+
+    RealtimeGrant grant;
+    UT_TEST_CHECK(thread->GetGrant(grant, TEST_GRANT_WAIT_US));
+    thread->Wait();
+
+    UT_TEST_CHECK(state.mRan);
+
+    return grant;
+}
+
+/*
+ * the last cpu the process may run on, pinning to it is always allowed.
+ */
+static int32_t GetTargetCpu(cpu_set_t& inherited)
+{
+    CPU_ZERO(&inherited);
+    sched_getaffinity(0, sizeof(inherited), &inherited);
+
+    for (int32_t cpu=CPU_SETSIZE-1; cpu>=0; cpu--)
+    {
+        if (CPU_ISSET(cpu, &inherited))
+        {
+            return cpu;
+        }
+    }
+
+    return 0;
+}
+
+int main()
+{
+    UT_TEST_CHECK(DropPrivileges());
+
+    cpu_set_t inherited;
+    int32_t cpu = GetTargetCpu(inherited);
+
+    {
+        /*
+         * the default profile: only the pinning is granted, mlockall is
+         * the first failure.
+         */
+        ThreadState state;
+        RealtimeGrant grant = RunOnce(RealtimeProfile(SCHED_FIFO, 80, cpu), state);
+
+        UT_TEST_CHECK(!grant.IsGranted());
+        UT_TEST_CHECK(grant.mCpuPinned);
+        UT_TEST_CHECK(!grant.mMemoryLocked);
+        UT_TEST_CHECK(grant.mHeapReserved);
+        UT_TEST_CHECK(grant.mStackPrefaulted);
+        UT_TEST_CHECK(!grant.mScheduled);
+        UT_TEST_CHECK(grant.mError == EPERM || grant.mError == ENOMEM);
+
+        UT_TEST_CHECK(state.mPolicy == SCHED_OTHER);
+        UT_TEST_CHECK(state.mCpuCount == 1 && CPU_ISSET(cpu, &state.mCpuSet));
+        UT_TEST_CHECK(state.mCpu == cpu);
+    }
+
+    {
+        /*
+         * without mlockall the scheduler is the only failure.
+         */
+        ThreadState state;
+        RealtimeGrant grant = RunOnce(RealtimeProfile(SCHED_FIFO, 80, UT_CPU_ID_NONE, false), state);
+
+        UT_TEST_CHECK(grant.mCpuPinned && grant.mMemoryLocked && grant.mHeapReserved);
+        UT_TEST_CHECK(grant.mStackPrefaulted);
+        UT_TEST_CHECK(!grant.mScheduled);
+        UT_TEST_CHECK(grant.mError == EPERM);
+        UT_TEST_CHECK(state.mPolicy == SCHED_OTHER);
+    }
+
+    {
+        /*
+         * a profile an unprivileged thread may have is fully granted and
+         * keeps the inherited affinity.
+         */
+        ThreadState state;
+        RealtimeGrant grant = RunOnce(RealtimeProfile(SCHED_OTHER, 0, UT_CPU_ID_NONE, false), state);
+
+        UT_TEST_CHECK(grant.IsGranted());
+        UT_TEST_CHECK(grant.mError == 0);
+        UT_TEST_CHECK(state.mPolicy == SCHED_OTHER);
+        UT_TEST_CHECK(CPU_EQUAL(&state.mCpuSet, &inherited));
+    }
+
+    {
+        /*
+         * a cpu outside the machine is not pinned, the thread still runs.
+         */
+        ThreadState state;
+        RealtimeGrant grant = RunOnce(RealtimeProfile(SCHED_OTHER, 0, CPU_SETSIZE - 1, false), state);
+
+        UT_TEST_CHECK(!grant.mCpuPinned);
+        UT_TEST_CHECK(grant.mScheduled);
+        UT_TEST_CHECK(grant.mError == EINVAL);
+        UT_TEST_CHECK(CPU_EQUAL(&state.mCpuSet, &inherited));
+    }
+
+    {
+        /*
+         * a prefault larger than the thread stack is refused.
+         */
+        ThreadState state;
+        RealtimeGrant grant = RunOnce(RealtimeProfile(SCHED_OTHER, 0, UT_CPU_ID_NONE, false,
+            TEST_HUGE_STACK_SIZE), state);
+
+        UT_TEST_CHECK(!grant.mStackPrefaulted);
+        UT_TEST_CHECK(grant.mError == ENOMEM);
+    }
+
+    {
+        /*
+         * the heap reserve needs RetainHeap first.
+         */
+        RealtimeProfile profile(SCHED_OTHER, 0, UT_CPU_ID_NONE, false,
+            UT_REALTIME_STACK_PREFAULT_SIZE, 1024 * 1024);
+
+        ThreadState before;
+        RealtimeGrant grant = RunOnce(profile, before);
+        UT_TEST_CHECK(!grant.mHeapReserved);
+        UT_TEST_CHECK(grant.mError == EPERM);
+
+        UT_TEST_CHECK(RealtimeHelper::RetainHeap());
+
+        ThreadState after;
+        grant = RunOnce(profile, after);
+        UT_TEST_CHECK(grant.IsGranted());
+    }
+
+    {
+        /*
+         * the recurrent thread falls back the same way and keeps its
+         * periods.
+         */
+        ThreadState state;
+        RealtimeRecurrentThreadPtr thread = CreateRealtimeRecurrentThread(TEST_PERIOD_US,
+            RealtimeProfile(SCHED_FIFO, 80, cpu), &ThreadState::Tick, &state);
+
+        RealtimeGrant grant;
+        UT_TEST_CHECK(thread->GetGrant(grant, TEST_GRANT_WAIT_US));
+
+        while (state.mTicks < TEST_PERIOD_NUM)
+        {
+            usleep(1000);
+        }
+        thread->Wait();
+
+        UT_TEST_CHECK(grant.mCpuPinned && !grant.mMemoryLocked && !grant.mScheduled);
+        UT_TEST_CHECK(state.mPolicy == SCHED_OTHER);
+        UT_TEST_CHECK(state.mCpuCount == 1 && CPU_ISSET(cpu, &state.mCpuSet));
+    }
+
+    return unitree::test::TestResult();
+}
@@ -0,0 +1,348 @@
+#include <unitree/common/ring_block_queue.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "test_util.hpp"
+
+/*
+ * RingBlockQueue, SpscBlockQueue and MpscBlockQueue keep fifo order through
+ * growth and index wrap-around, report full and empty, and hand every
+ * element from concurrent producers to the consumer exactly once and in
+ * per-producer order.
+ */
+#define TEST_WRAP_ROUND     1000
+#define TEST_THREAD_NUM     200000
+#define TEST_PRODUCER_NUM   4
+#define TEST_WAIT_US        1000
+
+using namespace unitree::common;
+
+/*
+ * Get with a timeout on an empty queue returns false, then Interrupt
+ * releases a consumer blocked without a timeout.
+ */
+template<typename Q>
+static void CheckEmpty(Q& queue)
+{
+    uint64_t v = 0;
+    UT_TEST_CHECK(queue.Empty());
+    UT_TEST_CHECK(queue.Size() == 0);
+    UT_TEST_CHECK(!queue.Get(v, TEST_WAIT_US));
+
+    std::vector<uint64_t> list;
+    UT_TEST_CHECK(queue.GetAll(list, TEST_WAIT_US) == 0);
+    UT_TEST_CHECK(list.empty());
+
+    std::atomic<bool> done(false);
+    bool got = true;
+    std::thread consumer([&queue, &done, &got]()
+    {
+        uint64_t t = 0;
+        got = queue.Get(t, 0);
+        done = true;
+    });
+
+    while (!done)
+    {
+        queue.Interrupt(true);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    consumer.join();
+
+    UT_TEST_CHECK(!got);
+}
+
+/*
+ * put count values, get them back one at a time or in one batch.
+ */
+template<typename Q>
+static bool PutRange(Q& queue, uint64_t begin, uint64_t count)
+{
+    for (uint64_t i=0; i<count; i++)
+    {
+        if (!queue.Put(begin + i))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<typename Q>
+static bool GetRange(Q& queue, uint64_t begin, uint64_t count, bool batch)
+{
+    if (batch)
+    {
+        std::vector<uint64_t> list;
+        if (queue.GetAll(list, TEST_WAIT_US) != count || list.size() != count)
+        {
+            return false;
+        }
+
+        for (uint64_t i=0; i<count; i++)
+        {
+            if (list[i] != begin + i)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    for (uint64_t i=0; i<count; i++)
+    {
+        uint64_t v = 0;
+        if (!queue.Get(v, TEST_WAIT_US) || v != begin + i)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * fill a queue of capacity elements, check it is full, then move the
+ * indexes around the ring many times with partial fills.
+ */
+template<typename Q>
+static void CheckFullAndWrap(Q& queue, uint64_t capacity)
+{
+    UT_TEST_CHECK(PutRange(queue, 0, capacity));
+    UT_TEST_CHECK(queue.Size() == capacity);
+    UT_TEST_CHECK(!queue.Put(capacity));
+    UT_TEST_CHECK(GetRange(queue, 0, capacity, false));
+    UT_TEST_CHECK(queue.Empty());
+
+    uint64_t next = 0;
+    bool ordered = true;
+    for (uint64_t round=0; round<TEST_WRAP_ROUND; round++)
+    {
+        uint64_t count = 1 + round % capacity;
+        ordered = ordered && PutRange(queue, next, count);
+        ordered = ordered && GetRange(queue, next, count, round % 2 == 1);
+        next += count;
+    }
+
+    UT_TEST_CHECK(ordered);
+    UT_TEST_CHECK(queue.Empty());
+
+    /*
+     * full again with head in the middle of the ring.
+     */
+    UT_TEST_CHECK(PutRange(queue, next, capacity));
+    UT_TEST_CHECK(!queue.Put(next + capacity));
+    UT_TEST_CHECK(GetRange(queue, next, capacity, true));
+}
+
+/*
+ * producers send (producer << 32 | seq) until TEST_THREAD_NUM values each,
+ * retrying while the queue is full. the consumer checks per-producer order.
+ */
+template<typename Q>
+static void CheckThreaded(Q& queue, int32_t producerNum, bool batch)
+{
+    std::vector<std::thread> producers;
+    for (int32_t p=0; p<producerNum; p++)
+    {
+        producers.emplace_back([&queue, p]()
+        {
+            for (uint64_t seq=0; seq<TEST_THREAD_NUM; seq++)
+            {
+                while (!queue.Put(((uint64_t)p << 32) | seq))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<uint64_t> next(producerNum, 0);
+    uint64_t total = (uint64_t)producerNum * TEST_THREAD_NUM;
+    uint64_t received = 0;
+    uint64_t outOfOrder = 0;
+    std::vector<uint64_t> list;
+
+    while (received < total)
+    {
+        list.clear();
+        if (batch)
+        {
+            queue.GetAll(list, TEST_WAIT_US);
+        }
+        else
+        {
+            uint64_t v = 0;
+            if (queue.Get(v, TEST_WAIT_US))
+            {
+                list.push_back(v);
+            }
+        }
+
+        for (size_t i=0; i<list.size(); i++)
+        {
+            uint64_t p = list[i] >> 32;
+            uint64_t seq = list[i] & 0xFFFFFFFFu;
+            if (p >= (uint64_t)producerNum || seq != next[p])
+            {
+                outOfOrder++;
+            }
+            else
+            {
+                next[p]++;
+            }
+        }
+
+        received += list.size();
+    }
+
+    for (size_t i=0; i<producers.size(); i++)
+    {
+        producers[i].join();
+    }
+
+    UT_TEST_CHECK(outOfOrder == 0);
+    UT_TEST_CHECK(received == total);
+    UT_TEST_CHECK(queue.Empty());
+}
+
+static void TestRingBlockQueue()
+{
+    {
+        RingBlockQueue<uint64_t> queue(100);
+        CheckEmpty(queue);
+        CheckFullAndWrap(queue, 100);
+    }
+
+    {
+        /*
+         * grow while the ring is wrapped, order is kept.
+         */
+        RingBlockQueue<uint64_t> queue(1000);
+        UT_TEST_CHECK(PutRange(queue, 0, RingBlockQueue<uint64_t>::INIT_CAPACITY));
+        UT_TEST_CHECK(GetRange(queue, 0, 10, false));
+        UT_TEST_CHECK(PutRange(queue, RingBlockQueue<uint64_t>::INIT_CAPACITY, 500));
+        UT_TEST_CHECK(queue.Size() == RingBlockQueue<uint64_t>::INIT_CAPACITY + 490);
+        UT_TEST_CHECK(GetRange(queue, 10, RingBlockQueue<uint64_t>::INIT_CAPACITY + 490, true));
+    }
+
+    {
+        /*
+         * replace evicts the front element and reports it, putfront
+         * jumps the queue.
+         */
+        RingBlockQueue<uint64_t> queue(4);
+        UT_TEST_CHECK(PutRange(queue, 0, 4));
+        UT_TEST_CHECK(!queue.Put(4, true));
+        UT_TEST_CHECK(queue.Size() == 4);
+        UT_TEST_CHECK(queue.Get(TEST_WAIT_US) == 1);
+
+        UT_TEST_CHECK(queue.Put(100, false, true));
+        UT_TEST_CHECK(!queue.Put(101, true, true));
+
+        std::vector<uint64_t> list;
+        UT_TEST_CHECK(queue.Drain(list, 2, TEST_WAIT_US) == 2);
+        UT_TEST_CHECK(list.size() == 2 && list[0] == 101 && list[1] == 2);
+        UT_TEST_CHECK(queue.GetAll(list, TEST_WAIT_US) == 2);
+        UT_TEST_CHECK(list.size() == 4 && list[2] == 3 && list[3] == 4);
+    }
+
+    {
+        RingBlockQueue<uint64_t> queue(64);
+        CheckThreaded(queue, 1, false);
+        CheckThreaded(queue, TEST_PRODUCER_NUM, true);
+    }
+}
+
+static void TestSpscBlockQueue()
+{
+    {
+        /*
+         * capacity rounds up to a power of two.
+         */
+        SpscBlockQueue<uint64_t> queue(5);
+        CheckEmpty(queue);
+        CheckFullAndWrap(queue, 8);
+    }
+
+    {
+        SpscBlockQueue<uint64_t> queue(1);
+        UT_TEST_CHECK(queue.Put(7));
+        UT_TEST_CHECK(!queue.Put(8));
+        UT_TEST_CHECK(queue.Get(TEST_WAIT_US) == 7);
+    }
+
+    {
+        SpscBlockQueue<uint64_t> queue(8);
+        std::vector<uint64_t> list;
+        UT_TEST_CHECK(PutRange(queue, 0, 6));
+        UT_TEST_CHECK(queue.Drain(list, 4, TEST_WAIT_US) == 4);
+        UT_TEST_CHECK(PutRange(queue, 6, 6));
+        UT_TEST_CHECK(queue.Drain(list, 100, TEST_WAIT_US) == 8);
+        UT_TEST_CHECK(list.size() == 12 && list[0] == 0 && list[11] == 11);
+    }
+
+    bool thrown = false;
+    try
+    {
+        SpscBlockQueue<uint64_t> queue(0);
+    }
+    catch (const CommonException&)
+    {
+        thrown = true;
+    }
+    UT_TEST_CHECK(thrown);
+
+    {
+        SpscBlockQueue<uint64_t> queue(64);
+        CheckThreaded(queue, 1, false);
+        CheckThreaded(queue, 1, true);
+    }
+}
+
+static void TestMpscBlockQueue()
+{
+    {
+        MpscBlockQueue<uint64_t> queue(6);
+        CheckEmpty(queue);
+        CheckFullAndWrap(queue, 8);
+    }
+
+    {
+        /*
+         * the smallest ring has two cells.
+         */
+        MpscBlockQueue<uint64_t> queue(1);
+        CheckFullAndWrap(queue, 2);
+    }
+
+    bool thrown = false;
+    try
+    {
+        MpscBlockQueue<uint64_t> queue(0);
+    }
+    catch (const CommonException&)
+    {
+        thrown = true;
+    }
+    UT_TEST_CHECK(thrown);
+
+    {
+        MpscBlockQueue<uint64_t> queue(64);
+        CheckThreaded(queue, 1, false);
+        CheckThreaded(queue, TEST_PRODUCER_NUM, false);
+        CheckThreaded(queue, TEST_PRODUCER_NUM, true);
+    }
+}
+
+int main()
+{
+    TestRingBlockQueue();
+    TestSpscBlockQueue();
+    TestMpscBlockQueue();
+
+    return unitree::test::TestResult();
+}
@@ -0,0 +1,261 @@
+#include <unitree/robot/low_level/robot_model.hpp>
+
+#include "test_util.hpp"
+
+/*
+ * every model passes IsValidRobotModel, the h1-2 and g1 29 dof gains are
+ * the tables the low level examples used before, and PackCommand gives
+ * the same message and crc through a LowCmdBuilder, incremental or not,
+ * as through the plain message.
+ */
+#define TEST_PACK_ROUND_NUM     5
+
+using namespace unitree::robot;
+
+/*
+ * GetMotorKp/GetMotorKd of the h1_27dof example, by gearbox.
+ */
+static float LegacyH1_2Kp(uint8_t gearbox)
+{
+    switch (gearbox)
+    {
+    case UT_GEARBOX_S:
+        return 80;
+    case UT_GEARBOX_M:
+        return 100;
+    case UT_GEARBOX_L:
+        return 200;
+    default:
+        return 0;
+    }
+}
+
+static float LegacyH1_2Kd(uint8_t gearbox)
+{
+    switch (gearbox)
+    {
+    case UT_GEARBOX_S:
+        return 2;
+    case UT_GEARBOX_M:
+        return 3;
+    case UT_GEARBOX_L:
+        return 5;
+    default:
+        return 0;
+    }
+}
+
+/*
+ * H1MotorType of the h1_27dof example.
+ */
+static const std::array<uint8_t,27> LEGACY_H1_2_GEARBOX = {{
+    UT_GEARBOX_M, UT_GEARBOX_M, UT_GEARBOX_M, UT_GEARBOX_L, UT_GEARBOX_S, UT_GEARBOX_S,
+    UT_GEARBOX_M, UT_GEARBOX_M, UT_GEARBOX_M, UT_GEARBOX_L, UT_GEARBOX_S, UT_GEARBOX_S,
+    UT_GEARBOX_M,
+    UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S,
+    UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S, UT_GEARBOX_S }};
+
+/*
+ * Kp/Kd of the g1_ankle_swing example.
+ */
+static const std::array<float,29> LEGACY_G1_29_KP = {{
+    60, 60, 60, 100, 40, 40,
+    60, 60, 60, 100, 40, 40,
+    60, 40, 40,
+    40, 40, 40, 40, 40, 40, 40,
+    40, 40, 40, 40, 40, 40, 40 }};
+
+static const std::array<float,29> LEGACY_G1_29_KD = {{
+    1, 1, 1, 2, 1, 1,
+    1, 1, 1, 2, 1, 1,
+    1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1 }};
+
+/*
+ * go2 with a slot used twice.
+ */
+class RepeatedSlotModel : public Go2Model
+{
+public:
+    static constexpr std::array<uint32_t,DOF> SLOT = {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 10 };
+};
+
+/*
+ * go2 joints with the hg messages.
+ */
+class WrongMessageModel : public Go2Model
+{
+public:
+    typedef unitree_hg::msg::dds_::LowCmd_ LowCmd;
+};
+
+static void TestValid()
+{
+    static_assert(IsValidRobotModel<Go2Model>(), "go2");
+    static_assert(IsValidRobotModel<B2Model>(), "b2");
+    static_assert(IsValidRobotModel<H1Model>(), "h1");
+    static_assert(IsValidRobotModel<H1_2Model>(), "h1-2");
+    static_assert(IsValidRobotModel<G1_23Model>(), "g1 23 dof");
+    static_assert(IsValidRobotModel<G1_29Model>(), "g1 29 dof");
+
+    UT_TEST_CHECK(IsValidRobotModel<Go2Model>());
+    UT_TEST_CHECK(IsValidRobotModel<B2Model>());
+    UT_TEST_CHECK(IsValidRobotModel<H1Model>());
+    UT_TEST_CHECK(IsValidRobotModel<H1_2Model>());
+    UT_TEST_CHECK(IsValidRobotModel<G1_23Model>());
+    UT_TEST_CHECK(IsValidRobotModel<G1_29Model>());
+
+    UT_TEST_CHECK(!IsValidRobotModel<RepeatedSlotModel>());
+    UT_TEST_CHECK(!IsValidRobotModel<WrongMessageModel>());
+}
+
+static void TestGains()
+{
+    UT_TEST_CHECK(H1_2Model::GEARBOX == LEGACY_H1_2_GEARBOX);
+    for (size_t i=0; i<H1_2Model::DOF; i++)
+    {
+        UT_TEST_CHECK(H1_2Model::KP[i] == LegacyH1_2Kp(LEGACY_H1_2_GEARBOX[i]));
+        UT_TEST_CHECK(H1_2Model::KD[i] == LegacyH1_2Kd(LEGACY_H1_2_GEARBOX[i]));
+    }
+
+    UT_TEST_CHECK(G1_29Model::KP == LEGACY_G1_29_KP);
+    UT_TEST_CHECK(G1_29Model::KD == LEGACY_G1_29_KD);
+
+    /*
+     * g1 23 dof drives a subset of the 29 dof motors with the same gains.
+     */
+    for (size_t i=0; i<G1_23Model::DOF; i++)
+    {
+        size_t j = 0;
+        while (G1_29Model::SLOT[j] != G1_23Model::SLOT[i])
+        {
+            j++;
+        }
+
+        UT_TEST_CHECK(G1_23Model::KP[i] == G1_29Model::KP[j] && G1_23Model::KD[i] == G1_29Model::KD[j]);
+        UT_TEST_CHECK(G1_23Model::GEARBOX[i] == G1_29Model::GEARBOX[j]);
+    }
+
+    JointArray<G1_29Model> kp, kd;
+    FillGains<G1_29Model>(kp, kd, 0.5f);
+    UT_TEST_CHECK(kp[3] == 50.0f && kd[3] == 1.0f);
+}
+
+/*
+ * distinct joint commands for round r.
+ */
+template<typename MODEL>
+static void MakeCommand(uint32_t r, JointArray<MODEL>& q, JointArray<MODEL>& dq, JointArray<MODEL>& kp,
+    JointArray<MODEL>& kd, JointArray<MODEL>& tau)
+{
+    FillGains<MODEL>(kp, kd);
+
+    for (size_t i=0; i<MODEL::DOF; i++)
+    {
+        q[i] = 0.01f * i + 0.1f * r;
+        dq[i] = -0.02f * i;
+        tau[i] = (r % 2 == 0) ? 0.0f : 0.5f * i;
+    }
+
+    /*
+     * later rounds change few joints, the incremental update runs.
+     */
+    if (r > 1)
+    {
+        q = JointArray<MODEL>();
+        q[r % MODEL::DOF] = 1.0f * r;
+    }
+}
+
+template<typename MODEL>
+static bool PackSame()
+{
+    typedef typename MODEL::LowCmd LowCmd;
+
+    LowCmdBuilder<LowCmd> incremental(true);
+    LowCmdBuilder<LowCmd> full(false);
+    LowCmd message;
+    bool same = true;
+
+    for (uint32_t r=0; r<TEST_PACK_ROUND_NUM; r++)
+    {
+        JointArray<MODEL> q, dq, kp, kd, tau;
+        MakeCommand<MODEL>(r, q, dq, kp, kd, tau);
+
+        PackCommand<MODEL>(incremental, q, dq, kp, kd, tau);
+        PackCommand<MODEL>(full, q, dq, kp, kd, tau);
+        PackCommand<MODEL>(message, q, dq, kp, kd, tau);
+
+        const LowCmd& a = incremental.Build();
+        const LowCmd& b = full.Build();
+
+        same = same && a.crc() == message.crc() && b.crc() == message.crc();
+        same = same && memcmp(&a, &message, sizeof(LowCmd)) == 0 && memcmp(&b, &message, sizeof(LowCmd)) == 0;
+    }
+
+    /*
+     * joints land in their slots with the model mode, other slots stay
+     * untouched.
+     */
+    for (size_t i=0, slot=0; slot<MODEL::SLOT_NUM; slot++)
+    {
+        const auto& cmd = message.motor_cmd()[slot];
+        if (i < MODEL::DOF && MODEL::SLOT[i] == slot)
+        {
+            same = same && cmd.mode() == MODEL::MODE[i] && cmd.kp() == MODEL::KP[i];
+            i++;
+        }
+        else
+        {
+            same = same && cmd.mode() == 0 && cmd.kp() == 0.0f;
+        }
+    }
+
+    return same;
+}
+
+template<typename MODEL>
+static bool ViewReadsSlots()
+{
+    typename MODEL::LowState state;
+    for (size_t slot=0; slot<MODEL::SLOT_NUM; slot++)
+    {
+        state.motor_state()[slot].q((float)slot);
+    }
+
+    ModelStateView<MODEL> view;
+    bool same = view.Extract(state.motor_state());
+    for (size_t i=0; i<MODEL::DOF; i++)
+    {
+        same = same && view.Q()[i] == (float)MODEL::SLOT[i];
+    }
+
+    return same;
+}
+
+static void TestPack()
+{
+    UT_TEST_CHECK(PackSame<Go2Model>());
+    UT_TEST_CHECK(PackSame<B2Model>());
+    UT_TEST_CHECK(PackSame<H1Model>());
+    UT_TEST_CHECK(PackSame<H1_2Model>());
+    UT_TEST_CHECK(PackSame<G1_23Model>());
+    UT_TEST_CHECK(PackSame<G1_29Model>());
+
+    UT_TEST_CHECK(ViewReadsSlots<Go2Model>());
+    UT_TEST_CHECK(ViewReadsSlots<H1Model>());
+    UT_TEST_CHECK(ViewReadsSlots<H1_2Model>());
+    UT_TEST_CHECK(ViewReadsSlots<G1_23Model>());
+    UT_TEST_CHECK(ViewReadsSlots<G1_29Model>());
+}
+
+int main()
+{
+    TestValid();
+    TestGains();
+    TestPack();
+
+    return unitree::test::TestResult();
+}
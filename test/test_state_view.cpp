@@ -0,0 +1,199 @@
+#include <unitree/robot/low_level/state_view.hpp>
+#include <unitree/idl/go2/LowState_.hpp>
+#include <unitree/idl/hg/LowState_.hpp>
+#include <unitree/idl/hg/HandState_.hpp>
+
+#include "test_util.hpp"
+
+/*
+ * every StateView field array equals the per-motor accessors, for the go2
+ * and hg MotorState_, the transposed groups of four and the scalar rest,
+ * field subsets, and joint sets out of order or repeated. a motor state
+ * without a known layout gives the same arrays through the scalar path.
+ */
+#define TEST_HAND_MOTOR_NUM     7
+
+using namespace unitree::robot;
+
+/*
+ * the hg accessors on members which are not consecutive.
+ */
+class SparseMotorState
+{
+public:
+    float q() const { return mQ; }
+    void q(float v) { mQ = v; }
+    float dq() const { return mDq; }
+    void dq(float v) { mDq = v; }
+    float ddq() const { return mDdq; }
+    void ddq(float v) { mDdq = v; }
+    float tau_est() const { return mTauEst; }
+    void tau_est(float v) { mTauEst = v; }
+
+private:
+    float mTauEst = 0.0f;
+    uint32_t mPad = 0;
+    float mQ = 0.0f;
+    float mDq = 0.0f;
+    uint16_t mMode = 0;
+    float mDdq = 0.0f;
+};
+
+/*
+ * distinct values per motor and field.
+ */
+template<typename MOTOR_ARRAY>
+static void Fill(MOTOR_ARRAY& motors)
+{
+    for (size_t i=0; i<motors.size(); i++)
+    {
+        motors[i].q(1.0f + i);
+        motors[i].dq(100.0f + i);
+        motors[i].ddq(-200.0f - i);
+        motors[i].tau_est(0.5f * i - 3.0f);
+    }
+}
+
+template<typename MOTOR_STATE, size_t N, uint32_t FIELDS, typename MOTOR_ARRAY>
+static bool Matches(const StateView<MOTOR_STATE,N,FIELDS>& view, const MOTOR_ARRAY& motors)
+{
+    const std::array<uint32_t,N>& joints = view.GetJoints();
+    bool same = true;
+
+    for (size_t i=0; i<N; i++)
+    {
+        const MOTOR_STATE& m = motors[joints[i]];
+
+        if constexpr ((FIELDS & UT_STATE_FIELD_Q) != 0)
+        {
+            same = same && view.Q()[i] == m.q();
+        }
+        if constexpr ((FIELDS & UT_STATE_FIELD_DQ) != 0)
+        {
+            same = same && view.Dq()[i] == m.dq();
+        }
+        if constexpr ((FIELDS & UT_STATE_FIELD_DDQ) != 0)
+        {
+            same = same && view.Ddq()[i] == m.ddq();
+        }
+        if constexpr ((FIELDS & UT_STATE_FIELD_TAU_EST) != 0)
+        {
+            same = same && view.TauEst()[i] == m.tau_est();
+        }
+    }
+
+    return same;
+}
+
+/*
+ * the mirrored layout is where the accessors point.
+ */
+template<typename MOTOR_STATE>
+static bool LayoutMatches()
+{
+    MOTOR_STATE m;
+    const char* base = (const char*)&m;
+
+    return MotorStateLayout<MOTOR_STATE>::CORE_OFFSET == (const char*)&m.q() - base &&
+        (const char*)&m.dq() - base == MotorStateLayout<MOTOR_STATE>::CORE_OFFSET + 4 &&
+        (const char*)&m.ddq() - base == MotorStateLayout<MOTOR_STATE>::CORE_OFFSET + 8 &&
+        (const char*)&m.tau_est() - base == MotorStateLayout<MOTOR_STATE>::CORE_OFFSET + 12;
+}
+
+static void TestGo()
+{
+    UT_TEST_CHECK(LayoutMatches<unitree_go::msg::dds_::MotorState_>());
+
+    unitree_go::msg::dds_::LowState_ state;
+    Fill(state.motor_state());
+
+    GoStateView<20> all;
+    UT_TEST_CHECK(all.Extract(state.motor_state()));
+    UT_TEST_CHECK(Matches(all, state.motor_state()));
+
+    GoStateView<12, UT_STATE_FIELD_Q | UT_STATE_FIELD_DQ | UT_STATE_FIELD_DDQ | UT_STATE_FIELD_TAU_EST> legs;
+    UT_TEST_CHECK(legs.Extract(state.motor_state()));
+    UT_TEST_CHECK(Matches(legs, state.motor_state()));
+
+    /*
+     * out of order and repeated, two groups of four and a scalar rest of
+     * three.
+     */
+    std::array<uint32_t,11> joints = {{19, 0, 5, 5, 11, 3, 7, 18, 2, 2, 13}};
+    GoStateView<11, UT_STATE_FIELD_DQ | UT_STATE_FIELD_TAU_EST> subset(joints);
+    UT_TEST_CHECK(subset.Extract(state.motor_state()));
+    UT_TEST_CHECK(Matches(subset, state.motor_state()));
+
+    GoStateView<3, UT_STATE_FIELD_DDQ> small(std::array<uint32_t,3>{{4, 1, 16}});
+    UT_TEST_CHECK(small.Extract(state.motor_state()));
+    UT_TEST_CHECK(Matches(small, state.motor_state()));
+}
+
+static void TestHg()
+{
+    UT_TEST_CHECK(LayoutMatches<unitree_hg::msg::dds_::MotorState_>());
+
+    unitree_hg::msg::dds_::LowState_ state;
+    Fill(state.motor_state());
+
+    HgStateView<35> all;
+    UT_TEST_CHECK(all.Extract(state.motor_state()));
+    UT_TEST_CHECK(Matches(all, state.motor_state()));
+
+    std::array<uint32_t,9> joints = {{34, 15, 22, 0, 29, 29, 8, 17, 1}};
+    HgStateView<9, UT_STATE_FIELD_Q | UT_STATE_FIELD_DDQ> subset(joints);
+    UT_TEST_CHECK(subset.Extract(state.motor_state()));
+    UT_TEST_CHECK(Matches(subset, state.motor_state()));
+}
+
+static void TestHand()
+{
+    unitree_hg::msg::dds_::HandState_ state;
+    state.motor_state().resize(TEST_HAND_MOTOR_NUM);
+    Fill(state.motor_state());
+
+    HgStateView<TEST_HAND_MOTOR_NUM> all;
+    UT_TEST_CHECK(all.Extract(state.motor_state()));
+    UT_TEST_CHECK(Matches(all, state.motor_state()));
+
+    std::array<uint32_t,5> joints = {{6, 2, 4, 0, 5}};
+    HgStateView<5, UT_STATE_FIELD_TAU_EST | UT_STATE_FIELD_Q> subset(joints);
+    UT_TEST_CHECK(subset.Extract(state.motor_state()));
+    UT_TEST_CHECK(Matches(subset, state.motor_state()));
+
+    /*
+     * a joint past the received motors is refused and the arrays kept.
+     */
+    state.motor_state().resize(TEST_HAND_MOTOR_NUM - 1);
+    UT_TEST_CHECK(!all.Extract(state.motor_state()));
+    UT_TEST_CHECK(all.Q()[TEST_HAND_MOTOR_NUM - 1] == 1.0f + TEST_HAND_MOTOR_NUM - 1);
+    UT_TEST_CHECK(!subset.Extract(state.motor_state()));
+}
+
+static void TestScalar()
+{
+    static_assert(MotorStateLayout<SparseMotorState>::CORE_OFFSET < 0, "sparse layout has no core run");
+
+    std::vector<SparseMotorState> motors(10);
+    Fill(motors);
+
+    StateView<SparseMotorState, 10, UT_STATE_FIELD_Q | UT_STATE_FIELD_DQ | UT_STATE_FIELD_DDQ |
+        UT_STATE_FIELD_TAU_EST> all;
+    UT_TEST_CHECK(all.Extract(motors));
+    UT_TEST_CHECK(Matches(all, motors));
+
+    std::array<uint32_t,6> joints = {{9, 3, 3, 0, 7, 1}};
+    StateView<SparseMotorState, 6> subset(joints);
+    UT_TEST_CHECK(subset.Extract(motors));
+    UT_TEST_CHECK(Matches(subset, motors));
+}
+
+int main()
+{
+    TestGo();
+    TestHg();
+    TestHand();
+    TestScalar();
+
+    return unitree::test::TestResult();
+}
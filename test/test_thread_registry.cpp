@@ -0,0 +1,242 @@
+#include <unitree/common/thread/thread_registry.hpp>
+#include <unitree/common/thread/recurrent_thread.hpp>
+#include <unitree/common/thread/realtime_thread.hpp>
+#include <unitree/common/thread/work_stealing_thread_pool.hpp>
+
+#include "test_util.hpp"
+
+/*
+ * threads started through the factories are listed under their full name
+ * while they run, once each, and leave the registry when they exit. a
+ * snapshot reports the cpu time a busy thread used and the context
+ * switches of a sleeping one.
+ */
+#define TEST_LONG_NAME          "test_registry_long_thread_name"
+#define TEST_BUSY_MS            200
+#define TEST_SLEEP_NUM          20
+#define TEST_PERIOD_US          1000
+#define TEST_PERIOD_NUM         20
+#define TEST_POOL_THREADS       3
+#define TEST_WAIT_MS            5000
+
+using namespace unitree::common;
+
+static bool FindRegistered(const std::string& name, ThreadCpuStat& found, size_t& count)
+{
+    std::vector<ThreadCpuStat> list;
+    ThreadRegistry::Instance()->Snapshot(list, true);
+
+    count = 0;
+    for (size_t i=0; i<list.size(); i++)
+    {
+        if (list[i].mRegisteredName == name)
+        {
+            found = list[i];
+            count++;
+        }
+    }
+
+    return count > 0;
+}
+
+/*
+ * wait until name is listed count times, or not at all for count 0.
+ */
+static bool WaitRegistered(const std::string& name, size_t count)
+{
+    for (int32_t ms=0; ms<TEST_WAIT_MS; ms++)
+    {
+        ThreadCpuStat stat;
+        size_t n = 0;
+        FindRegistered(name, stat, n);
+        if (n == count)
+        {
+            return true;
+        }
+
+        usleep(1000);
+    }
+
+    return false;
+}
+
+class Gate
+{
+public:
+    Gate() :
+        mOpen(false), mTicks(0)
+    {}
+
+    int32_t Hold()
+    {
+        while (!mOpen)
+        {
+            usleep(1000);
+        }
+
+        return 0;
+    }
+
+    int32_t Busy()
+    {
+        uint64_t begin = GetCurrentMonotonicTimeNanosecond();
+        while (GetCurrentMonotonicTimeNanosecond() - begin < TEST_BUSY_MS * UT_NUMER_MICRO)
+        {
+            unitree::test::DoNotOptimize(begin);
+        }
+
+        return Hold();
+    }
+
+    int32_t Sleep()
+    {
+        for (int32_t i=0; i<TEST_SLEEP_NUM; i++)
+        {
+            usleep(1000);
+        }
+
+        return Hold();
+    }
+
+    void Tick()
+    {
+        mTicks++;
+    }
+
+    std::atomic<bool> mOpen;
+    std::atomic<uint32_t> mTicks;
+};
+
+static void TestThread()
+{
+    size_t before = ThreadRegistry::Instance()->GetRegisteredSize();
+
+    Gate gate;
+    ThreadPtr busy = CreateThreadEx(TEST_LONG_NAME, UT_CPU_ID_NONE, &Gate::Busy, &gate);
+    ThreadPtr sleep = CreateThreadEx("test_sleep", UT_CPU_ID_NONE, &Gate::Sleep, &gate);
+
+    UT_TEST_CHECK(WaitRegistered(TEST_LONG_NAME, 1));
+    UT_TEST_CHECK(WaitRegistered("test_sleep", 1));
+    usleep((TEST_BUSY_MS + 50) * 1000);
+
+    ThreadCpuStat stat;
+    size_t count = 0;
+
+    UT_TEST_CHECK(FindRegistered(TEST_LONG_NAME, stat, count));
+    UT_TEST_CHECK(stat.mRegistered);
+    UT_TEST_CHECK(stat.mTid != ThreadRegistry::GetTid());
+    UT_TEST_CHECK(stat.mName.size() <= 15);
+    UT_TEST_CHECK(stat.mUserNanosec + stat.mSystemNanosec >= TEST_BUSY_MS / 2 * UT_NUMER_MICRO);
+    UT_TEST_CHECK(stat.mLastCpu >= 0 && stat.mLastCpu < CPU_SETSIZE);
+
+    UT_TEST_CHECK(FindRegistered("test_sleep", stat, count));
+    UT_TEST_CHECK(stat.mVoluntarySwitch >= TEST_SLEEP_NUM);
+    UT_TEST_CHECK(stat.mUserNanosec + stat.mSystemNanosec < TEST_BUSY_MS / 2 * UT_NUMER_MICRO);
+
+    /*
+     * Sample reads the same thread by tid.
+     */
+    ThreadCpuStat sample;
+    sample.mTid = stat.mTid;
+    UT_TEST_CHECK(ThreadRegistry::Sample(sample));
+    UT_TEST_CHECK(sample.mVoluntarySwitch >= stat.mVoluntarySwitch);
+
+    gate.mOpen = true;
+    busy->Wait();
+    sleep->Wait();
+
+    UT_TEST_CHECK(WaitRegistered(TEST_LONG_NAME, 0));
+    UT_TEST_CHECK(WaitRegistered("test_sleep", 0));
+    UT_TEST_CHECK(ThreadRegistry::Instance()->GetRegisteredSize() == before);
+}
+
+static void TestRecurrent()
+{
+    Gate gate;
+
+    {
+        ThreadPtr recurrent = CreateRecurrentThreadEx("test_recurrent", UT_CPU_ID_NONE, TEST_PERIOD_US,
+            &Gate::Tick, &gate);
+        DeadlineThreadPtr deadline = CreateDeadlineThreadEx("test_deadline", UT_CPU_ID_NONE, TEST_PERIOD_US,
+            DeadlinePolicy(), &Gate::Tick, &gate);
+        RealtimeThreadPtr realtime = CreateRealtimeThreadEx("test_realtime",
+            RealtimeProfile(SCHED_OTHER, 0, UT_CPU_ID_NONE, false), &Gate::Hold, &gate);
+
+        while (gate.mTicks < TEST_PERIOD_NUM)
+        {
+            usleep(1000);
+        }
+
+        /*
+         * registered once however many periods ran.
+         */
+        UT_TEST_CHECK(WaitRegistered("test_recurrent", 1));
+        UT_TEST_CHECK(WaitRegistered("test_deadline", 1));
+        UT_TEST_CHECK(WaitRegistered("test_realtime", 1));
+
+        gate.mOpen = true;
+        recurrent->Wait();
+        deadline->Wait();
+        realtime->Wait();
+    }
+
+    UT_TEST_CHECK(WaitRegistered("test_recurrent", 0));
+    UT_TEST_CHECK(WaitRegistered("test_deadline", 0));
+    UT_TEST_CHECK(WaitRegistered("test_realtime", 0));
+}
+
+static void TestPool()
+{
+    {
+        WorkStealingThreadPool pool(TEST_POOL_THREADS, WorkStealingThreadPool::DEFAULT_QUEUE_SIZE, "test_pool");
+        UT_TEST_CHECK(WaitRegistered("test_pool", TEST_POOL_THREADS));
+    }
+
+    UT_TEST_CHECK(WaitRegistered("test_pool", 0));
+}
+
+static void TestScope()
+{
+    size_t before = ThreadRegistry::Instance()->GetRegisteredSize();
+
+    /*
+     * a full snapshot also lists threads nobody registered.
+     */
+    std::vector<ThreadCpuStat> list;
+    ThreadRegistry::Instance()->Snapshot(list);
+
+    bool unregisteredMain = false;
+    for (size_t i=0; i<list.size(); i++)
+    {
+        if (list[i].mTid == ThreadRegistry::GetTid())
+        {
+            unregisteredMain = !list[i].mRegistered && !list[i].mName.empty();
+        }
+    }
+    UT_TEST_CHECK(unregisteredMain);
+
+    {
+        ThreadRegistry::Scope scope("test_main");
+
+        ThreadCpuStat stat;
+        size_t count = 0;
+        UT_TEST_CHECK(FindRegistered("test_main", stat, count) && count == 1);
+        UT_TEST_CHECK(stat.mTid == ThreadRegistry::GetTid());
+    }
+
+    UT_TEST_CHECK(ThreadRegistry::Instance()->GetRegisteredSize() == before);
+
+    ThreadCpuStat gone;
+    gone.mTid = -1;
+    UT_TEST_CHECK(!ThreadRegistry::Sample(gone));
+}
+
+int main()
+{
+    TestThread();
+    TestRecurrent();
+    TestPool();
+    TestScope();
+
+    return unitree::test::TestResult();
+}
@@ -0,0 +1,111 @@
+#include <unitree/common/thread/timer_service.hpp>
+
+#include "test_util.hpp"
+
+/*
+ * the wheel fires every node on its exact expire tick, across cascades
+ * and beyond the wheel range, and Cancel waits for a running callback.
+ */
+#define TEST_NODE_NUM   2000
+
+using namespace unitree::common;
+
+static void CheckWheel()
+{
+    TimerWheel wheel;
+    std::vector<TimerWheel::Node> nodes(TEST_NODE_NUM);
+    std::vector<uint64_t> expires(TEST_NODE_NUM, 0);
+    std::vector<uint64_t> fired(TEST_NODE_NUM, 0);
+
+    /*
+     * expire ticks around every level boundary, and some beyond the range.
+     */
+    uint64_t seed = 1;
+    for (size_t i=0; i<nodes.size(); i++)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+
+        uint64_t bits = 1 + (seed >> 33) % 26;
+        uint64_t expire = 1 + ((seed >> 7) & ((1ULL << bits) - 1));
+        if (i < 64)
+        {
+            expire = (1ULL << (TimerWheel::SLOT_BITS * (1 + i % 3))) + i / 3 - 10;
+        }
+
+        nodes[i].mId = i;
+        nodes[i].mExpireTick = expire;
+        expires[i] = expire;
+        wheel.Insert(&nodes[i]);
+    }
+
+    std::vector<TimerWheel::Node*> expired;
+    uint64_t last = 1ULL << 26;
+    while (wheel.GetCurrentTick() < last + 1)
+    {
+        wheel.Advance(expired);
+        for (size_t i=0; i<expired.size(); i++)
+        {
+            fired[expired[i]->mId] = wheel.GetCurrentTick();
+        }
+        expired.clear();
+    }
+
+    uint64_t wrong = 0;
+    for (size_t i=0; i<nodes.size(); i++)
+    {
+        if (fired[i] != expires[i])
+        {
+            wrong++;
+        }
+    }
+
+    UT_TEST_CHECK(wrong == 0);
+}
+
+static void CheckCancelWaits()
+{
+    TimerService service(1000);
+
+    std::atomic<int32_t> state(0);
+    uint64_t id = service.AddOnce(1000, [&state]()
+    {
+        state = 1;
+        usleep(100000);
+        state = 2;
+    });
+
+    while (state.load() == 0)
+    {
+        usleep(1000);
+    }
+
+    UT_TEST_CHECK(service.Cancel(id));
+    UT_TEST_CHECK(state.load() == 2);
+
+    /*
+     * a callback cancelling its own recurrent timer does not wait for itself.
+     */
+    std::atomic<int32_t> count(0);
+    std::atomic<uint64_t> selfId(0);
+    selfId = service.AddRecurrent(1000, [&service, &count, &selfId]()
+    {
+        uint64_t id = selfId.load();
+        if (id != 0)
+        {
+            count++;
+            service.Cancel(id);
+        }
+    });
+
+    usleep(100000);
+    UT_TEST_CHECK(count.load() == 1);
+    UT_TEST_CHECK(service.Size(UT_TIMER_GROUP_NORMAL) == 0);
+}
+
+int main()
+{
+    CheckWheel();
+    CheckCancelWaits();
+
+    return unitree::test::TestResult();
+}
@@ -0,0 +1,323 @@
+#include <unitree/robot/low_level/trajectory.hpp>
+#include <cstring>
+#include <random>
+
+#include "test_util.hpp"
+
+/*
+ * JointTrajectory passes through the frames in hermite mode, is c1 at
+ * every frame, its dq matches a central difference of q, and outside the
+ * sequence holds the end frame with zero dq. the vector evaluation equals
+ * JointCubicT<JointScalarOps> on the same segment. PoseTrajectory stays
+ * unit length and turns along the shorter arc.
+ */
+#define TEST_FRAME_NUM      12
+#define TEST_WIDTH          13
+#define TEST_STRIDE         16
+#define TEST_FRAME_RATE     50.0f
+#define TEST_SAMPLE_NUM     500
+#define TEST_STEP           1e-3
+
+using namespace unitree::robot;
+
+/*
+ * see test_joint_math, scalar code may be contracted to fused multiply-add.
+ */
+#if defined(__FP_FAST_FMAF)
+#define TEST_MUL_TOLERANCE  1e-5f
+#else
+#define TEST_MUL_TOLERANCE  0.0f
+#endif
+
+static bool Near(float a, float b, float tolerance)
+{
+    return std::fabs(a - b) <= tolerance * std::max(1.0f, std::fabs(b));
+}
+
+/*
+ * frames of TEST_WIDTH joints, TEST_STRIDE floats apart.
+ */
+static std::vector<float> MakeFrames(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> value(-1.5f, 1.5f);
+
+    std::vector<float> frames(TEST_FRAME_NUM * TEST_STRIDE);
+    for (size_t i=0; i<frames.size(); i++)
+    {
+        frames[i] = value(rng);
+    }
+
+    return frames;
+}
+
+static float Frame(const std::vector<float>& frames, int32_t i, uint32_t j)
+{
+    i = std::min(std::max(i, 0), TEST_FRAME_NUM - 1);
+    return frames[i * TEST_STRIDE + j];
+}
+
+static void TestKnots(const std::vector<float>& frames)
+{
+    JointTrajectory hermite(frames.data(), TEST_STRIDE, TEST_FRAME_NUM, TEST_WIDTH, TEST_FRAME_RATE);
+    JointTrajectory bspline(frames.data(), TEST_STRIDE, TEST_FRAME_NUM, TEST_WIDTH, TEST_FRAME_RATE,
+        UT_TRAJECTORY_BSPLINE);
+
+    UT_TEST_CHECK(hermite.GetWidth() == TEST_WIDTH);
+    UT_TEST_CHECK(hermite.GetDuration() == (TEST_FRAME_NUM - 1) / (double)TEST_FRAME_RATE);
+
+    bool hermiteKnots = true, bsplineKnots = true, tangents = true;
+    for (int32_t k=0; k<TEST_FRAME_NUM; k++)
+    {
+        float q[TEST_WIDTH], dq[TEST_WIDTH], b[TEST_WIDTH];
+        hermite.Evaluate(k / (double)TEST_FRAME_RATE, q, dq);
+        bspline.Evaluate(k / (double)TEST_FRAME_RATE, b);
+
+        for (uint32_t j=0; j<TEST_WIDTH; j++)
+        {
+            float p0 = Frame(frames, k - 1, j);
+            float p1 = Frame(frames, k, j);
+            float p2 = Frame(frames, k + 1, j);
+
+            /*
+             * the catmull-rom tangent, one sided at the ends.
+             */
+            hermiteKnots = hermiteKnots && Near(q[j], p1, 1e-5f);
+            tangents = tangents && Near(dq[j], (p2 - p0) * 0.5f * TEST_FRAME_RATE, 1e-4f);
+            bsplineKnots = bsplineKnots && Near(b[j], (p0 + 4.0f * p1 + p2) / 6.0f, 1e-5f);
+        }
+    }
+
+    UT_TEST_CHECK(hermiteKnots);
+    UT_TEST_CHECK(tangents);
+    UT_TEST_CHECK(bsplineKnots);
+}
+
+/*
+ * dq is the same on both sides of every inner frame, and close to the
+ * central difference of q anywhere inside the sequence.
+ */
+static void TestSlope(const std::vector<float>& frames, int32_t mode, std::mt19937& rng)
+{
+    JointTrajectory trajectory(frames.data(), TEST_STRIDE, TEST_FRAME_NUM, TEST_WIDTH, TEST_FRAME_RATE, mode);
+
+    float before[TEST_WIDTH], after[TEST_WIDTH], q[TEST_WIDTH];
+    bool continuous = true;
+    for (int32_t k=1; k<TEST_FRAME_NUM-1; k++)
+    {
+        double t = k / (double)TEST_FRAME_RATE;
+        trajectory.Evaluate(std::nextafter(t, 0.0), q, before);
+        trajectory.Evaluate(std::nextafter(t, 1.0), q, after);
+
+        for (uint32_t j=0; j<TEST_WIDTH; j++)
+        {
+            continuous = continuous && Near(before[j], after[j], 1e-3f);
+        }
+    }
+    UT_TEST_CHECK(continuous);
+
+    double h = TEST_STEP / TEST_FRAME_RATE;
+    std::uniform_real_distribution<double> time(h, trajectory.GetDuration() - h);
+
+    bool difference = true;
+    for (int32_t i=0; i<TEST_SAMPLE_NUM; i++)
+    {
+        double t = time(rng);
+        float dq[TEST_WIDTH], q0[TEST_WIDTH], q1[TEST_WIDTH];
+        trajectory.Evaluate(t, q, dq);
+        trajectory.Evaluate(t - h, q0);
+        trajectory.Evaluate(t + h, q1);
+
+        for (uint32_t j=0; j<TEST_WIDTH; j++)
+        {
+            float central = (float)((q1[j] - q0[j]) / (2.0 * h));
+            difference = difference && std::fabs(dq[j] - central) <= 0.02f * TEST_FRAME_RATE;
+        }
+    }
+    UT_TEST_CHECK(difference);
+}
+
+/*
+ * before the first frame and after the last the end frames hold and the
+ * velocity is zero, at the ends themselves it is the curve slope.
+ */
+static void TestClamp(const std::vector<float>& frames)
+{
+    JointTrajectory trajectory(frames.data(), TEST_STRIDE, TEST_FRAME_NUM, TEST_WIDTH, TEST_FRAME_RATE);
+    double end = trajectory.GetDuration();
+
+    const double outside[] = {-1.0, -1e-9, end + 1e-9, end + 1.0, 1e9, NAN};
+    bool held = true;
+    for (double t : outside)
+    {
+        float q[TEST_WIDTH], dq[TEST_WIDTH];
+        trajectory.Evaluate(t, q, dq);
+
+        int32_t k = (t > 0.0) ? TEST_FRAME_NUM - 1 : 0;
+        for (uint32_t j=0; j<TEST_WIDTH; j++)
+        {
+            held = held && Near(q[j], Frame(frames, k, j), 1e-5f) && dq[j] == 0.0f;
+        }
+    }
+    UT_TEST_CHECK(held);
+
+    float q[TEST_WIDTH], first[TEST_WIDTH], last[TEST_WIDTH];
+    trajectory.Evaluate(0.0, q, first);
+    trajectory.Evaluate(end, q, last);
+
+    bool moving = true;
+    for (uint32_t j=0; j<TEST_WIDTH; j++)
+    {
+        moving = moving && Near(first[j], (Frame(frames, 1, j) - Frame(frames, 0, j)) * 0.5f * TEST_FRAME_RATE, 1e-4f);
+        moving = moving && Near(last[j], (Frame(frames, TEST_FRAME_NUM - 1, j) -
+            Frame(frames, TEST_FRAME_NUM - 2, j)) * 0.5f * TEST_FRAME_RATE, 1e-4f);
+    }
+    UT_TEST_CHECK(moving);
+
+    /*
+     * a single frame is a constant.
+     */
+    JointTrajectory single(frames.data(), TEST_STRIDE, 1, TEST_WIDTH, TEST_FRAME_RATE);
+    bool constant = true;
+    const double times[] = {-1.0, 0.0, 0.01, 1.0};
+    for (double t : times)
+    {
+        float dq[TEST_WIDTH];
+        single.Evaluate(t, q, dq);
+        for (uint32_t j=0; j<TEST_WIDTH; j++)
+        {
+            constant = constant && q[j] == frames[j] && dq[j] == 0.0f;
+        }
+    }
+    UT_TEST_CHECK(constant);
+}
+
+/*
+ * Evaluate on the vector ops against JointCubicT<JointScalarOps> on the
+ * hermite coefficients of the same segment.
+ */
+static void TestScalar(const std::vector<float>& frames, std::mt19937& rng)
+{
+    JointTrajectory trajectory(frames.data(), TEST_STRIDE, TEST_FRAME_NUM, TEST_WIDTH, TEST_FRAME_RATE);
+    std::uniform_real_distribution<double> time(0.0, trajectory.GetDuration());
+
+    bool same = true;
+    for (int32_t i=0; i<TEST_SAMPLE_NUM; i++)
+    {
+        double t = time(rng);
+        float u;
+        int32_t k = (int32_t)TrajectorySegment(t, TEST_FRAME_RATE, TEST_FRAME_NUM - 1, u);
+
+        float c[4 * TEST_WIDTH];
+        for (uint32_t j=0; j<TEST_WIDTH; j++)
+        {
+            float p0 = Frame(frames, k - 1, j);
+            float p1 = Frame(frames, k, j);
+            float p2 = Frame(frames, k + 1, j);
+            float p3 = Frame(frames, k + 2, j);
+            float m1 = (p2 - p0) * 0.5f;
+            float m2 = (p3 - p1) * 0.5f;
+
+            c[j] = p1;
+            c[TEST_WIDTH + j] = m1;
+            c[2 * TEST_WIDTH + j] = 3.0f * (p2 - p1) - 2.0f * m1 - m2;
+            c[3 * TEST_WIDTH + j] = 2.0f * (p1 - p2) + m1 + m2;
+        }
+
+        float q[TEST_WIDTH], dq[TEST_WIDTH], sq[TEST_WIDTH], sdq[TEST_WIDTH];
+        trajectory.Evaluate(t, q, dq);
+        JointCubicT<JointScalarOps>(sq, c, TEST_WIDTH, TEST_WIDTH, u);
+        JointCubicSlopeT<JointScalarOps>(sdq, c, TEST_WIDTH, TEST_WIDTH, u, TEST_FRAME_RATE);
+
+        for (uint32_t j=0; j<TEST_WIDTH; j++)
+        {
+            same = same && Near(q[j], sq[j], TEST_MUL_TOLERANCE) && Near(dq[j], sdq[j], TEST_MUL_TOLERANCE);
+        }
+    }
+    UT_TEST_CHECK(same);
+}
+
+static float Dot(const float* a, const float* b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+}
+
+static void TestPose()
+{
+    /*
+     * part 0 turns 60 degrees about x with the end quaternion negated,
+     * part 1 barely turns and takes the nlerp path, part 2 has a scaled
+     * quaternion.
+     */
+    const float half = (float)(M_PI / 6.0);
+    const float frames[2 * 3 * UT_TRAJECTORY_POSE_SIZE] =
+    {
+        0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f,
+        1.0f, 2.0f, 3.0f, 1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 2.0f, 0.0f,
+
+        2.0f, -4.0f, 1.0f, -std::cos(half), -std::sin(half), 0.0f, 0.0f,
+        1.0f, 2.0f, 3.0f, std::cos(1e-5f), 0.0f, std::sin(1e-5f), 0.0f,
+        0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 3.0f,
+    };
+
+    PoseTrajectory trajectory(frames, 3 * UT_TRAJECTORY_POSE_SIZE, 2, 3, TEST_FRAME_RATE);
+    UT_TEST_CHECK(trajectory.GetPartNum() == 3);
+
+    bool unit = true, shorter = true, linear = true;
+    for (int32_t i=0; i<=TEST_SAMPLE_NUM; i++)
+    {
+        double t = trajectory.GetDuration() * i / TEST_SAMPLE_NUM;
+        float u = (float)i / TEST_SAMPLE_NUM;
+
+        float pose[3 * UT_TRAJECTORY_POSE_SIZE];
+        trajectory.Evaluate(t, pose);
+
+        for (uint32_t p=0; p<3; p++)
+        {
+            const float* r = pose + p * UT_TRAJECTORY_POSE_SIZE + 3;
+            unit = unit && std::fabs(Dot(r, r) - 1.0f) < 1e-5f;
+        }
+
+        /*
+         * on the shorter arc the angle from the start grows evenly to 60
+         * degrees, the longer one would pass through 180.
+         */
+        const float* r = pose + 3;
+        shorter = shorter && std::fabs(r[0] - std::cos(u * half)) < 1e-4f && std::fabs(r[1] - std::sin(u * half)) < 1e-4f;
+        linear = linear && Near(pose[0], 2.0f * u, 1e-5f) && Near(pose[1], -4.0f * u, 1e-5f) && Near(pose[2], u, 1e-5f);
+    }
+
+    UT_TEST_CHECK(unit);
+    UT_TEST_CHECK(shorter);
+    UT_TEST_CHECK(linear);
+
+    /*
+     * a zero quaternion is refused.
+     */
+    float zero[UT_TRAJECTORY_POSE_SIZE] = {0.0f};
+    bool thrown = false;
+    try
+    {
+        PoseTrajectory bad(zero, UT_TRAJECTORY_POSE_SIZE, 1, 1, TEST_FRAME_RATE);
+    }
+    catch (const unitree::common::CommonException&)
+    {
+        thrown = true;
+    }
+    UT_TEST_CHECK(thrown);
+}
+
+int main()
+{
+    std::mt19937 rng(7);
+    std::vector<float> frames = MakeFrames(rng);
+
+    TestKnots(frames);
+    TestSlope(frames, UT_TRAJECTORY_HERMITE, rng);
+    TestSlope(frames, UT_TRAJECTORY_BSPLINE, rng);
+    TestClamp(frames);
+    TestScalar(frames, rng);
+    TestPose();
+
+    return unitree::test::TestResult();
+}
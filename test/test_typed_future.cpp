@@ -0,0 +1,168 @@
+#include <unitree/common/thread/typed_future.hpp>
+
+#include "test_util.hpp"
+
+using namespace unitree;
+using namespace unitree::common;
+
+/*
+ * executor which runs tasks inline, or rejects them.
+ */
+class InlineExecutor
+{
+public:
+    explicit InlineExecutor(bool accept) : mAccept(accept)
+    {}
+
+    template<typename F>
+    bool AddTask(F&& f)
+    {
+        if (!mAccept)
+        {
+            return false;
+        }
+
+        f();
+        return true;
+    }
+
+private:
+    bool mAccept;
+};
+
+/*
+ * true if a continuation on a future which is never set is released with
+ * the last promise and future, so the state did not keep itself alive.
+ */
+template<typename F>
+bool ReleasedUnset(F&& attach)
+{
+    std::shared_ptr<int32_t> sentinel = std::make_shared<int32_t>(0);
+    std::weak_ptr<int32_t> weak = sentinel;
+
+    {
+        TypedPromise<int32_t> promise;
+        attach(promise.GetFuture(), sentinel);
+        sentinel.reset();
+    }
+
+    return weak.expired();
+}
+
+int main()
+{
+    InlineExecutor accept(true);
+    InlineExecutor reject(false);
+
+    /*
+     * Then and OnReady on an executor, both inline.
+     */
+    {
+        TypedPromise<int32_t> promise;
+        TypedFuture<int32_t> future = promise.GetFuture();
+
+        TypedFuture<int32_t> twice = future.Then([](int32_t v) { return v * 2; });
+        TypedFuture<int32_t> thrice = future.Then(accept, [](int32_t v) { return v * 3; });
+
+        int32_t seen = 0;
+        TypedFuture<void> done = future.OnReady(accept, [&seen](const TypedFuture<int32_t>& f)
+        {
+            seen = f.GetValue();
+        });
+
+        promise.SetValue(7);
+
+        UT_TEST_CHECK(twice.GetValue() == 14);
+        UT_TEST_CHECK(thrice.GetValue() == 21);
+        UT_TEST_CHECK(done.IsReady());
+        UT_TEST_CHECK(seen == 7);
+    }
+
+    /*
+     * a rejecting executor faults the continuation of Then and OnReady.
+     */
+    {
+        TypedPromise<int32_t> promise;
+        TypedFuture<int32_t> future = promise.GetFuture();
+
+        TypedFuture<int32_t> then = future.Then(reject, [](int32_t v) { return v; });
+        TypedFuture<void> done = future.OnReady(reject, [](const TypedFuture<int32_t>&) {});
+
+        promise.SetValue(1);
+
+        UT_TEST_CHECK(then.IsFault());
+        UT_TEST_CHECK(then.GetFaultCode() == UT_ERR_FUTURE);
+        UT_TEST_CHECK(done.IsFault());
+        UT_TEST_CHECK(done.GetFaultCode() == UT_ERR_FUTURE);
+    }
+
+    /*
+     * a fault and a throwing OnReady callback reach the returned future.
+     */
+    {
+        TypedPromise<int32_t> promise;
+        TypedFuture<int32_t> then = promise.GetFuture().Then([](int32_t v) { return v; });
+        TypedFuture<void> done = promise.GetFuture().OnReady(accept, [](const TypedFuture<int32_t>& f)
+        {
+            f.GetValue();
+        });
+
+        promise.SetFault(5, "fault");
+
+        UT_TEST_CHECK(then.GetFaultCode() == 5);
+        UT_TEST_CHECK(done.IsFault());
+    }
+
+    /*
+     * WhenAll keeps the list in order, whatever the completion order.
+     */
+    {
+        std::vector<TypedPromise<int32_t>> promises(3);
+        std::vector<TypedFuture<int32_t>> futures;
+        for (size_t i=0; i<promises.size(); i++)
+        {
+            futures.push_back(promises[i].GetFuture());
+        }
+
+        TypedFuture<std::vector<TypedFuture<int32_t>>> all = WhenAll(futures);
+
+        promises[2].SetValue(2);
+        promises[0].SetValue(0);
+        UT_TEST_CHECK(all.IsDeferred());
+        promises[1].SetFault("one");
+
+        UT_TEST_CHECK(all.IsReady());
+        const std::vector<TypedFuture<int32_t>>& list = all.GetValue();
+        UT_TEST_CHECK(list.size() == 3);
+        UT_TEST_CHECK(list[0].GetValue() == 0);
+        UT_TEST_CHECK(list[1].IsFault());
+        UT_TEST_CHECK(list[2].GetValue() == 2);
+    }
+
+    /*
+     * continuations of a future which is never set do not leak it.
+     */
+    UT_TEST_CHECK(ReleasedUnset([](const TypedFuture<int32_t>& f, std::shared_ptr<int32_t> s)
+    {
+        f.OnReady([s](const TypedFuture<int32_t>&) {});
+    }));
+
+    UT_TEST_CHECK(ReleasedUnset([&accept](const TypedFuture<int32_t>& f, std::shared_ptr<int32_t> s)
+    {
+        f.OnReady(accept, [s](const TypedFuture<int32_t>&) {});
+    }));
+
+    UT_TEST_CHECK(ReleasedUnset([&accept](const TypedFuture<int32_t>& f, std::shared_ptr<int32_t> s)
+    {
+        f.Then([s](int32_t v) { return v; });
+        f.Then(accept, [s](int32_t v) { return v; });
+    }));
+
+    UT_TEST_CHECK(ReleasedUnset([](const TypedFuture<int32_t>& f, std::shared_ptr<int32_t> s)
+    {
+        std::vector<TypedFuture<int32_t>> futures(1, f);
+        WhenAll(futures).OnReady([s](const TypedFuture<std::vector<TypedFuture<int32_t>>>&) {});
+    }));
+
+    return unitree::test::TestResult();
+}
@@ -0,0 +1,76 @@
+#ifndef __UT_TEST_UTIL_HPP__
+#define __UT_TEST_UTIL_HPP__
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+/*
+ * report a failed check and go on, main returns TestResult().
+ */
+#define UT_TEST_CHECK(cond)                                                         \
+    do                                                                              \
+    {                                                                               \
+        if (!(cond))                                                                \
+        {                                                                           \
+            unitree::test::FailureCount()++;                                        \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);         \
+        }                                                                           \
+    } while (0)
+
+namespace unitree
+{
+namespace test
+{
+inline int32_t& FailureCount()
+{
+    static int32_t count = 0;
+    return count;
+}
+
+inline int TestResult()
+{
+    if (FailureCount() == 0)
+    {
+        printf("all checks passed\n");
+        return 0;
+    }
+
+    printf("%d checks failed\n", FailureCount());
+    return 1;
+}
+
+/*
+ * keeps value and the work producing it from being optimized away.
+ */
+template<typename T>
+inline void DoNotOptimize(const T& value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+/*
+ * average time of f(i) in nanoseconds over count calls.
+ */
+template<typename F>
+inline double MeasureNs(uint64_t count, F&& f)
+{
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (uint64_t i=0; i<count; i++)
+    {
+        f(i);
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - begin).count() / count;
+}
+
+inline void PrintNs(const char* name, double ns)
+{
+    printf("%-40s %10.1f ns\n", name, ns);
+}
+
+}
+}
+
+#endif//__UT_TEST_UTIL_HPP__
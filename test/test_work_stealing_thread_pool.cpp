@@ -0,0 +1,73 @@
+#include <unitree/common/thread/work_stealing_thread_pool.hpp>
+
+#include "alloc_counter.hpp"
+#include "test_util.hpp"
+
+using namespace unitree::common;
+using unitree::test::AllocCounter;
+
+static std::atomic<uint32_t> gDone(0);
+
+static void CountTask()
+{
+    gDone.fetch_add(1, std::memory_order_relaxed);
+}
+
+static int32_t Square(int32_t x)
+{
+    return x * x;
+}
+
+int main()
+{
+    /*
+     * every task runs once, and submitting does not allocate once the
+     * task slots exist.
+     */
+    {
+        WorkStealingThreadPool pool(4, 1024);
+
+        for (uint32_t i=0; i<1000; i++)
+        {
+            UT_TEST_CHECK(pool.AddTask(&CountTask));
+        }
+        while (gDone.load() < 1000)
+        {
+            UT_CPU_RELAX();
+        }
+
+        uint64_t alloc = AllocCounter::GetThreadCount();
+        for (uint32_t i=0; i<1000; i++)
+        {
+            UT_TEST_CHECK(pool.AddTask(&CountTask));
+        }
+        UT_TEST_CHECK(AllocCounter::GetThreadCount() == alloc);
+
+        while (gDone.load() < 2000)
+        {
+            UT_CPU_RELAX();
+        }
+
+        TypedFuture<int32_t> future = pool.AddTaskFuture(&Square, 7);
+        UT_TEST_CHECK(future.GetValue() == 49);
+    }
+
+    /*
+     * Quit(false) leaves the workers running, the destructor still waits
+     * for them before the members they use are destroyed.
+     */
+    for (uint32_t round=0; round<100; round++)
+    {
+        WorkStealingThreadPool pool(4, 1024);
+        for (uint32_t i=0; i<100; i++)
+        {
+            pool.AddTask(&CountTask);
+        }
+
+        pool.Quit(false);
+        UT_TEST_CHECK(pool.IsQuit());
+        UT_TEST_CHECK(!pool.AddTask(&CountTask));
+    }
+
+    return unitree::test::TestResult();
+}